@@ -4,8 +4,13 @@ Configuration settings for phased array antenna sweep automation
 ================================================================================
 """
 
+import os
+
 import numpy as np
 
+# Back-end: "hardware" for the serial port and chamber, "simulator" for lib/simulator.py
+BACKEND = "hardware"
+
 # Hardware Interface Configuration
 ARRAY_INTERFACE = ""
 SYSTEM_CONFIGURATION = ""
@@ -13,9 +18,19 @@ SYSTEM_CONFIGURATION = ""
 # Serial Communication Settings
 SERIAL_PORT = 'COM6'
 SERIAL_BAUD = 115200
+SERIAL_PIPELINE_DEPTH = 8  # Commands written ahead of their 'OK'
+SERIAL_COMMAND_PACING = 0.0  # Seconds between command writes
+SERIAL_RESPONSE_TIMEOUT = 0.5  # Seconds per command
+ARRAY_PROTOCOL = "ascii"  # "ascii" for SystemMessages commands, "binary" for one bulk update frame
 
 # Test Output Configuration
 PLOT_SAVE_PATH = r"C:\tests"
+# Stream every sample of a campaign to one columnar store. Needs a sweep runner that returns its
+# measurements (last_measurement), which only the simulator does; with ChamberClass it is skipped
+MEASUREMENT_STORE = True
+MEASUREMENT_STORE_PATH = PLOT_SAVE_PATH  # One directory per campaign is created here
+MEASUREMENT_CHUNK_ROWS = 65536  # Samples buffered before a part file is written
+COMMAND_CACHE_PATH = os.path.join(PLOT_SAVE_PATH, "array_command_cache.json")  # Compiled commands, None keeps them in memory only
 
 # Frequency Settings
 MODEM_FREQ = 1500000000  # 1.5 GHz
@@ -30,6 +45,10 @@ SWEEP_BOTH_DIRECTIONS = False
 ELEVATION_PHI_ADJUSTMENT = False
 PHI_RANGE_RANDOM = False
 THETA_RANGE_RANDOM = False
+THETA_RANGE_ADAPTIVE = False  # Coarse theta grid refined where the pattern changes, between the THETA_RANGE ends
+ADAPTIVE_COARSE_STEP = 10  # Degrees
+ADAPTIVE_FINE_STEP = 1  # Degrees, the closest theta spacing refinement goes to
+ADAPTIVE_TOLERANCE_DB = 0.5  # Peak gain or sidelobe change that triggers refinement
 
 # Turn Table Configuration
 TURN_TABLE_ELV_LIMIT = 20
@@ -42,5 +61,32 @@ AZ_FINISH = 35
 HORN_START = 90
 HORN_FINISH = 90
 
+# Sweep Planner Configuration
+SWEEP_PIPELINED = False  # Plan the campaign and overlap array setup with positioner moves
+POSITIONER_SPEED = {"az": 6.0, "el": 3.0, "pol": 10.0, "horn": 10.0}  # Degrees per second per axis
+POSITIONER_SETTLE_TIME = 1.0  # Seconds after every move
+SWEEP_SPEED = 2.0  # Degrees per second while measuring
+ARRAY_CONFIG_TIME = 0.05  # Estimated seconds to configure the array per pointing step
+
+# Frequency-Stepped Sweeps: every KU_FREQ_RANGE frequency is captured at each positioner
+# step of a cut, so the chamber moves once per cut instead of once per cut and frequency
+SWEEP_FREQUENCY_STEPPED = False  # Planned like SWEEP_PIPELINED, needs a runner with stepped sweeps
+FREQUENCY_STEP = 0.5  # Degrees between positioner steps along a cut
+FREQUENCY_STEP_SETTLE_TIME = 0.1  # Seconds after each step
+# Assumed seconds to retune the array to one frequency: one bulk update frame, or the ASCII
+# commands of one configuration, answered at about SIM_ARRAY_LATENCY each. Not yet measured
+# on the array; replace with the retune time printed by a stepped hardware campaign
+FREQUENCY_RETUNE_TIME = 0.0024 if ARRAY_PROTOCOL == "binary" else 0.032
+
+# Simulator Configuration (BACKEND = "simulator")
+SIM_ARRAY_LATENCY = 0.002  # Seconds from a command to its 'OK'
+SIM_TIME_SCALE = 0.0  # Fraction of positioner and sweep time actually waited, 0 runs as fast as possible
+SIM_SWEEP_STEP = 0.5  # Degrees between samples along a cut
+SIM_NOISE_DB = 0.05  # Measurement noise, 1 sigma
+
+# Array Geometry, for the predicted pattern used by the simulator and adaptive sampling
+ARRAY_SIZE = (16, 16)  # Elements in x and y
+ARRAY_ELEMENT_SPACING = 0.0125  # Metres
+
 # Polarization Angle
 POL_ANGLE = 0 if ARRAY_INTERFACE == "" else 90 
\ No newline at end of file
@@ -0,0 +1,91 @@
+"""
+================================================================================
+Adaptive angular sampling for sweeps
+Samples the theta axis of each (frequency, phi) cut set on a coarse grid, then
+bisects only the intervals where the measured peak gain or sidelobe level moves
+by more than a tolerance, where the pattern predicted from the array geometry
+is curved, or where the measurement departs from the prediction differently at
+the two ends. Smooth regions stay coarse; interval ends are never closer than
+the fine step.
+================================================================================
+"""
+
+from typing import Callable, Dict, List
+
+import numpy as np
+
+METRICS = ("peak_db", "sidelobe_db")
+
+
+class AdaptiveSampler:
+    def __init__(
+        self,
+        theta_min: float,
+        theta_max: float,
+        coarse_step: float,
+        fine_step: float,
+        tolerance_db: float,
+        predict: Callable[[float], Dict[str, float]]
+    ):
+        self.theta_min = theta_min
+        self.theta_max = theta_max
+        self.coarse_step = coarse_step
+        self.fine_step = fine_step
+        self.tolerance_db = tolerance_db
+        self.predict = predict
+        self.measured: Dict[float, Dict[str, float]] = {}
+        self._predicted: Dict[float, Dict[str, float]] = {}
+
+    @property
+    def full_count(self) -> int:
+        """Points a fixed grid at the fine step would measure."""
+        return int(round((self.theta_max - self.theta_min) / self.fine_step)) + 1
+
+    def initial(self) -> List[float]:
+        """The coarse grid, always including both ends."""
+        thetas = list(np.arange(self.theta_min, self.theta_max, self.coarse_step)) + [self.theta_max]
+        return [self._snap(theta) for theta in thetas]
+
+    def record(self, theta: float, metrics: Dict[str, float]) -> None:
+        self.measured[self._snap(theta)] = metrics
+
+    def refine(self) -> List[float]:
+        """Midpoints of the intervals that still need samples, empty when done."""
+        thetas = sorted(self.measured)
+        new_thetas = []
+
+        for low, high in zip(thetas, thetas[1:]):
+            middle = self._snap((low + high) / 2)
+            if middle in (low, high) or middle in self.measured:
+                continue
+            if self._score(low, middle, high) > self.tolerance_db:
+                new_thetas.append(middle)
+
+        return new_thetas
+
+    def _score(self, low: float, middle: float, high: float) -> float:
+        measured_low, measured_high = self.measured[low], self.measured[high]
+        predicted_low, predicted_middle, predicted_high = (
+            self._prediction(low), self._prediction(middle), self._prediction(high)
+        )
+
+        score = 0.0
+        for metric in METRICS:
+            # Measured gradient across the interval
+            score = max(score, abs(measured_high[metric] - measured_low[metric]))
+            # Predicted curvature: error of a straight line through the ends at the midpoint
+            score = max(score, abs(predicted_middle[metric] - (predicted_low[metric] + predicted_high[metric]) / 2))
+            # The measurement departs from the prediction differently at the two ends
+            score = max(score, abs((measured_high[metric] - predicted_high[metric]) -
+                                   (measured_low[metric] - predicted_low[metric])))
+        return score
+
+    def _prediction(self, theta: float) -> Dict[str, float]:
+        if theta not in self._predicted:
+            self._predicted[theta] = self.predict(theta)
+        return self._predicted[theta]
+
+    def _snap(self, theta: float) -> float:
+        """Round to the fine grid so repeated bisection lands on the same angles."""
+        steps = round((theta - self.theta_min) / self.fine_step)
+        return float(round(self.theta_min + steps * self.fine_step, 6))
@@ -6,15 +6,26 @@ Handles array-specific commands and control functions
 """
 
 import time
-from typing import List, Tuple, Optional
+from functools import lru_cache
+from typing import Dict, List, Tuple, Optional
 
+from .array_protocol import ArrayProtocol, ArraySteer, BulkUpdate
+from .command_cache import CommandCompiler
 from .hardware_interface import HardwareInterface
 from .system_messages import SystemMessages
-from ..config import ARRAY_INTERFACE, MODEM_FREQ, POL_ANGLE
+from ..config import ARRAY_INTERFACE, ARRAY_PROTOCOL, MODEM_FREQ, POL_ANGLE
 
 class ArrayController:
     def __init__(self):
         self.hardware = HardwareInterface()
+        self.compiler = CommandCompiler()
+        self.sequence = 0
+
+    def close(self) -> None:
+        """Close the serial session to the array and save the compiled commands."""
+        self.hardware.close()
+        self.compiler.save()
+        print(f"Command cache: {self.compiler.summary()}")
 
     def power_cycle(self) -> None:
         """Perform power cycle of the array."""
@@ -25,7 +36,7 @@ class ArrayController:
         # Power off
         self.hardware.send_commands([SystemMessages.get_power_command(False)])
         time.sleep(1)
-        # Power on
+        # Power on, the session stays open across the cycle
         self.hardware.send_commands([SystemMessages.get_power_command(True)])
         time.sleep(3)
 
@@ -36,46 +47,57 @@ class ArrayController:
 
         atten_codes = self._get_default_attenuation_codes()
         
-        # Set attenuation
-        self.hardware.send_commands(
-            self._get_rx_atten_commands(ku_freq, atten_codes)
-        )
-        
-        # Set pointing
-        self.hardware.send_commands(
-            SystemMessages.get_pointing_commands(ku_freq, azimuth, elevation, POL_ANGLE)
-        )
+        # Set attenuation and pointing in one pipelined batch
+        self.apply_array(self.compiler.compile(
+            ("setup", int(ku_freq), MODEM_FREQ, float(azimuth), float(elevation), POL_ANGLE, atten_codes),
+            lambda: ("commands", self._get_rx_atten_commands(ku_freq, atten_codes) +
+                     SystemMessages.get_pointing_commands(ku_freq, azimuth, elevation, POL_ANGLE))
+        ))
 
     def control_array(self, ku_freq: int, phi_angle: int, theta_angle: int) -> None:
-        """Control array pointing and configuration."""
+        """
+        Control array pointing and configuration. Sends the same messages as the
+        pipelined path, chosen by _build_array for the interface and protocol.
+        """
         print(f"Pointing antenna to phi: {phi_angle}, theta: {theta_angle}")
+        self.apply_array(self.prepare_array(ku_freq, phi_angle, theta_angle))
 
-        if ARRAY_INTERFACE == "":
-            atten_codes = self._get_default_attenuation_codes()
-            commands = []
-            
-            # Add band and channel configuration
-            f_khz = ku_freq // 1000
-            f_if_khz = MODEM_FREQ // 1000
-            commands.extend([
-                SystemMessages.BAND_CONFIG_CMD.format(channel=0, band_code=SystemMessages.BAND_CODES['L']),
-                SystemMessages.CHANNEL_CONFIG_CMD.format(channel=0, freq_khz=f_khz, if_freq_khz=f_if_khz)
-            ])
-            
-            # Add attenuation commands
-            for i in range(4):
-                commands.append(
-                    SystemMessages.BPL_ATTEN_CMD.format(channel=0, array=i, atten_code=atten_codes[0][i])
-                )
-            commands.append(
-                SystemMessages.IF_ATTEN_CMD.format(channel=0, atten_code=atten_codes[1][0])
-            )
+    @staticmethod
+    def config_key(ku_freq: int, phi_angle: float, theta_angle: float) -> tuple:
+        """Everything that determines the array configuration for one pointing step, as plain literals."""
+        return (
+            ARRAY_INTERFACE, ARRAY_PROTOCOL, int(ku_freq), MODEM_FREQ, float(phi_angle), float(theta_angle),
+            POL_ANGLE, ArrayController._get_default_attenuation_codes()
+        )
+
+    def prepare_array(self, ku_freq: int, phi_angle: float, theta_angle: float) -> Tuple[str, List[bytes]]:
+        """
+        Get the ready-to-send messages for one pointing step without sending them,
+        compiling them on the first use of the configuration.
+        Returns ("frames", [bytes]) for the binary protocol or ("commands", [bytes]).
+        """
+        return self.compiler.compile(
+            self.config_key(ku_freq, phi_angle, theta_angle),
+            lambda: self._build_array(ku_freq, phi_angle, theta_angle)
+        )
+
+    def _build_array(self, ku_freq: int, phi_angle: float, theta_angle: float) -> Tuple[str, list]:
+        """
+        Format the messages for one pointing step, ("frames", [bytes]) or ("commands", [str]).
+        The array message interface gets one bulk update frame with ARRAY_PROTOCOL = "binary"
+        or the ASCII array commands, every other interface gets pose commands.
+        """
+        if ARRAY_INTERFACE == "" and ARRAY_PROTOCOL == "binary":
+            return ("frames", [self._get_bulk_update_frame(ku_freq, phi_angle, theta_angle)])
+        elif ARRAY_INTERFACE == "":
+            # Band, channel and attenuation configuration
+            commands = self._get_rx_atten_commands(ku_freq, self._get_default_attenuation_codes())
             
             # Add array commands
             for array in ['', '', '', '']:
                 commands.extend(
                     SystemMessages.get_phased_array_commands(
-                        array=array,
+                        phased_array=array,
                         phi=phi_angle,
                         theta=theta_angle,
                         gain=0,
@@ -84,29 +106,74 @@ class ArrayController:
                     )
                 )
             
-            self.hardware.send_commands(commands)
+            return ("commands", commands)
         else:
-            self._control_pose(phi_angle, theta_angle)
+            return ("commands", self._get_pose_commands(phi_angle, theta_angle))
+
+    def prepare_frequencies(self, ku_freqs: List[int], phi_angle: float, theta_angle: float) -> Dict[int, Tuple[str, List[bytes]]]:
+        """
+        Build the messages for one pointing step at every frequency, so a frequency-stepped
+        sweep retunes from this cache instead of formatting commands at each step.
+        """
+        return {ku_freq: self.prepare_array(ku_freq, phi_angle, theta_angle) for ku_freq in ku_freqs}
+
+    def apply_array(self, prepared: Tuple[str, List[bytes]], report: bool = True) -> None:
+        """Send messages compiled by prepare_array. Frames are stamped with the next sequence number."""
+        kind, messages = prepared
+        if kind == "frames":
+            messages = [ArrayProtocol.restamp(frame, self._next_sequence()) for frame in messages]
+        self.hardware.send_messages(messages, report)
+
+    def _next_sequence(self) -> int:
+        self.sequence = (self.sequence + 1) & 0xFF
+        return self.sequence
+
+    def _get_bulk_update_frame(self, ku_freq: int, phi_angle: float, theta_angle: float) -> bytes:
+        """
+        Encode band, channel, attenuation and steering of all four arrays as one frame.
+        The sequence number is left at 0 and stamped when the frame is sent.
+        """
+        atten_codes = self._get_default_attenuation_codes()
 
-    def _control_pose(self, phi_angle: int, theta_angle: int) -> None:
+        return ArrayProtocol.encode(BulkUpdate(
+            sequence=0,
+            channel=0,
+            band_code=SystemMessages.BAND_CODES['L'],
+            freq_khz=ku_freq // 1000,
+            if_freq_khz=MODEM_FREQ // 1000,
+            if_atten_code=atten_codes[1][0],
+            arrays=[
+                ArraySteer(array=i, phi=phi_angle, theta=theta_angle, gain=0, pol=POL_ANGLE,
+                           atten_code=atten_codes[0][i])
+                for i in range(4)
+            ]
+        ))
+
+    def control_pose(self, phi_angle: int, theta_angle: int) -> None:
         """Control array pose for pointing interface."""
+        self.hardware.send_commands(self._get_pose_commands(phi_angle, theta_angle))
+
+    @staticmethod
+    def _get_pose_commands(phi_angle: int, theta_angle: int) -> List[str]:
+        """Generate pose commands for pointing interface."""
         pitch = theta_angle if phi_angle > 90 else 360 - theta_angle
-        self.hardware.send_commands(SystemMessages.get_pose_commands(pitch))
+        return SystemMessages.get_pose_commands(pitch)
 
     @staticmethod
-    def _get_default_attenuation_codes() -> Tuple[List[int], List[int]]:
+    @lru_cache(maxsize=None)
+    def _get_default_attenuation_codes() -> Tuple[Tuple[int, ...], Tuple[int, ...]]:
         """Get default attenuation codes for arrays and SM."""
-        atten_values_arrays = [
+        atten_values_arrays = tuple(
             HardwareInterface.to_attenuation_code(0.0, 1.6) 
             for _ in range(4)
-        ]
-        atten_codes_sm = [HardwareInterface.to_attenuation_code(0.0, 0.0)]
+        )
+        atten_codes_sm = (HardwareInterface.to_attenuation_code(0.0, 0.0),)
         return (atten_values_arrays, atten_codes_sm)
 
     def _get_rx_atten_commands(
         self,
         f_hz: int,
-        atten: Tuple[List[int], List[int]],
+        atten: Tuple[Tuple[int, ...], Tuple[int, ...]],
         arrays_list: Optional[List[str]] = None
     ) -> List[str]:
         """Generate RX attenuation commands."""
@@ -0,0 +1,92 @@
+"""
+================================================================================
+Predicted array pattern from the array geometry
+Array factor of a uniform planar array with a cos^q element pattern, and the
+pattern metrics (peak gain, beam direction, sidelobe level) used to compare a
+measured cut against the prediction.
+================================================================================
+"""
+
+import math
+from typing import Dict
+
+import numpy as np
+
+from ..config import ARRAY_SIZE, ARRAY_ELEMENT_SPACING
+
+SPEED_OF_LIGHT = 299792458.0
+ELEMENT_PATTERN_EXPONENT = 1.2  # cos(theta)^q element gain
+PREDICTION_STEP = 0.5  # Degrees between predicted samples along a cut
+MINIMUM_RISE_DB = 1.0  # Rise past a minimum that ends the main lobe, above measurement ripple
+
+
+def pattern(az, el, phi: float, theta: float, freq_hz: float):
+    """
+    Gain and phase of the array steered to (phi, theta), seen from positioner
+    angles (az, el) in degrees.
+    """
+    nx, ny = ARRAY_SIZE
+    k = 2.0 * math.pi * freq_hz / SPEED_OF_LIGHT
+    az_rad, el_rad = np.radians(az), np.radians(el)
+
+    # Direction cosines of the source in the array frame
+    u = np.sin(az_rad) * np.cos(el_rad)
+    v = np.sin(el_rad)
+    w = np.cos(az_rad) * np.cos(el_rad)
+    u0 = math.sin(math.radians(theta)) * math.cos(math.radians(phi))
+    v0 = math.sin(math.radians(theta)) * math.sin(math.radians(phi))
+
+    m = np.arange(nx)[:, None]
+    n = np.arange(ny)[:, None]
+    af_x = np.exp(1j * k * ARRAY_ELEMENT_SPACING * m * (u - u0)).sum(axis=0) / nx
+    af_y = np.exp(1j * k * ARRAY_ELEMENT_SPACING * n * (v - v0)).sum(axis=0) / ny
+    af = af_x * af_y
+
+    element = np.clip(w, 1e-3, None) ** ELEMENT_PATTERN_EXPONENT
+    peak_db = 10.0 * math.log10(math.pi * nx * ny)
+    gain_db = peak_db + 20.0 * np.log10(np.abs(af) + 1e-9) + 10.0 * np.log10(element)
+
+    return gain_db, np.degrees(np.angle(af))
+
+
+def _first_minimum(gain_db, start: int, step: int, rise_db: float = MINIMUM_RISE_DB) -> int:
+    """Index of the first minimum from start, ignoring ripples smaller than rise_db."""
+    index = minimum = start
+    while 0 <= index + step < len(gain_db):
+        index += step
+        if gain_db[index] < gain_db[minimum]:
+            minimum = index
+        elif gain_db[index] > gain_db[minimum] + rise_db:
+            break
+    return minimum
+
+
+def pattern_metrics(az, gain_db) -> Dict[str, float]:
+    """
+    Peak gain, beam direction and the highest sidelobe relative to the peak of a cut.
+    The main lobe extends from the peak down to the first minimum on each side.
+    """
+    gain_db = np.asarray(gain_db)
+    peak = int(np.argmax(gain_db))
+
+    left = _first_minimum(gain_db, peak, -1)
+    right = _first_minimum(gain_db, peak, 1)
+
+    outside = np.concatenate((gain_db[:left], gain_db[right + 1:]))
+    sidelobe = float(outside.max() - gain_db[peak]) if len(outside) else -60.0
+
+    return {
+        "peak_db": float(gain_db[peak]),
+        "peak_az": float(np.asarray(az)[peak]),
+        "sidelobe_db": max(sidelobe, -60.0),
+    }
+
+
+def predicted_metrics(angles: Dict[str, float], phi: float, theta: float, freq_hz: float,
+                      step: float = PREDICTION_STEP) -> Dict[str, float]:
+    """Metrics of the predicted pattern along a cut given as sweep start and finish angles."""
+    samples = max(2, int(round(abs(angles["az_finish"] - angles["az_start"]) / step)) + 1)
+    az = np.linspace(angles["az_start"], angles["az_finish"], samples)
+    el = np.linspace(angles["el_start"], angles["el_finish"], samples)
+    gain_db, _ = pattern(az, el, phi, theta, freq_hz)
+    return pattern_metrics(az, gain_db)
@@ -0,0 +1,161 @@
+"""
+================================================================================
+Binary array control protocol
+Encodes one bulk update frame carrying the band, channel and IF attenuation and
+the steering and BPL attenuation of every array, in place of one ASCII command
+per array and per attenuator. The frame layout and CRC match the C decoder in
+code/array_control_protocol/array_control_protocol.h.
+
+Run as a script to encode a JSON update to hex, or decode hex to JSON:
+    python3 array_protocol.py encode '<json>'
+    python3 array_protocol.py decode <hex>
+================================================================================
+"""
+
+import json
+import math
+import struct
+import sys
+from typing import List, NamedTuple
+
+
+class ArraySteer(NamedTuple):
+    array: int
+    phi: float
+    theta: float
+    gain: float
+    pol: float
+    atten_code: int
+    enable: bool = True
+
+
+class BulkUpdate(NamedTuple):
+    sequence: int
+    channel: int
+    band_code: int
+    freq_khz: int
+    if_freq_khz: int
+    if_atten_code: int
+    arrays: List[ArraySteer]
+
+
+class ArrayProtocol:
+    """Encoder and decoder for bulk update frames."""
+
+    SYNC = b'\xa5\x5a'
+    VERSION = 1
+    TYPE_BULK_UPDATE = 0x01
+    MAX_ARRAYS = 4
+    FLAG_ENABLE = 0x01
+
+    _HEADER = struct.Struct('<2sBBBH')
+    _COMMON = struct.Struct('<BBIIBB')
+    _ARRAY = struct.Struct('<BBHhhhB')
+    _CRC = struct.Struct('<H')
+
+    @staticmethod
+    def _crc_table() -> List[int]:
+        table = []
+        for value in range(256):
+            crc = value << 8
+            for _ in range(8):
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+            table.append(crc)
+        return table
+
+    @staticmethod
+    def crc16(data: bytes) -> int:
+        """CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)."""
+        crc = 0xFFFF
+        for byte in data:
+            crc = ((crc << 8) & 0xFFFF) ^ _CRC_TABLE[(crc >> 8) ^ byte]
+        return crc
+
+    @staticmethod
+    def _to_centi(value: float) -> int:
+        """Scale to hundredths, rounding half away from zero, and saturate to int16."""
+        centi = int(math.copysign(math.floor(abs(value) * 100 + 0.5), value))
+        return min(max(centi, -32768), 32767)
+
+    @classmethod
+    def encode(cls, update: BulkUpdate) -> bytes:
+        """Encode a bulk update frame."""
+        if len(update.arrays) > cls.MAX_ARRAYS:
+            raise ValueError(f"At most {cls.MAX_ARRAYS} arrays per frame")
+
+        payload = cls._COMMON.pack(
+            update.channel, update.band_code, update.freq_khz, update.if_freq_khz,
+            update.if_atten_code, len(update.arrays)
+        )
+        for steer in update.arrays:
+            phi_centi = int(math.floor((steer.phi % 360.0) * 100 + 0.5)) % 36000
+            payload += cls._ARRAY.pack(
+                steer.array, cls.FLAG_ENABLE if steer.enable else 0, phi_centi,
+                cls._to_centi(steer.theta), cls._to_centi(steer.gain), cls._to_centi(steer.pol),
+                steer.atten_code
+            )
+
+        frame = cls._HEADER.pack(cls.SYNC, cls.VERSION, cls.TYPE_BULK_UPDATE, update.sequence & 0xFF, len(payload))
+        frame += payload
+        return frame + cls._CRC.pack(cls.crc16(frame[2:]))
+
+    @classmethod
+    def restamp(cls, frame: bytes, sequence: int) -> bytes:
+        """Copy of an encoded frame with a new sequence number and CRC."""
+        body = frame[2:4] + bytes((sequence & 0xFF,)) + frame[5:-2]
+        return cls.SYNC + body + cls._CRC.pack(cls.crc16(body))
+
+    @classmethod
+    def decode(cls, frame: bytes) -> BulkUpdate:
+        """Decode a bulk update frame, raising ValueError if it is invalid."""
+        if len(frame) < cls._HEADER.size + cls._COMMON.size + cls._CRC.size:
+            raise ValueError("Frame too short")
+
+        sync, version, frame_type, sequence, length = cls._HEADER.unpack_from(frame)
+        if sync != cls.SYNC or version != cls.VERSION or frame_type != cls.TYPE_BULK_UPDATE:
+            raise ValueError("Not a bulk update frame")
+        if len(frame) != cls._HEADER.size + length + cls._CRC.size:
+            raise ValueError("Length mismatch")
+        if cls.crc16(frame[2:-2]) != cls._CRC.unpack_from(frame, len(frame) - 2)[0]:
+            raise ValueError("CRC mismatch")
+
+        offset = cls._HEADER.size
+        channel, band_code, freq_khz, if_freq_khz, if_atten_code, count = cls._COMMON.unpack_from(frame, offset)
+        if count > cls.MAX_ARRAYS or length != cls._COMMON.size + count * cls._ARRAY.size:
+            raise ValueError("Bad array count")
+        offset += cls._COMMON.size
+
+        arrays = []
+        for _ in range(count):
+            array, flags, phi, theta, gain, pol, atten_code = cls._ARRAY.unpack_from(frame, offset)
+            arrays.append(ArraySteer(
+                array, phi / 100, theta / 100, gain / 100, pol / 100, atten_code, bool(flags & cls.FLAG_ENABLE)
+            ))
+            offset += cls._ARRAY.size
+
+        return BulkUpdate(sequence, channel, band_code, freq_khz, if_freq_khz, if_atten_code, arrays)
+
+
+_CRC_TABLE = ArrayProtocol._crc_table()
+
+
+def _update_from_json(text: str) -> BulkUpdate:
+    fields = json.loads(text)
+    fields['arrays'] = [ArraySteer(**steer) for steer in fields['arrays']]
+    return BulkUpdate(**fields)
+
+
+def _update_to_json(update: BulkUpdate) -> str:
+    fields = update._asdict()
+    fields['arrays'] = [steer._asdict() for steer in update.arrays]
+    return json.dumps(fields)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) == 3 and sys.argv[1] == 'encode':
+        print(ArrayProtocol.encode(_update_from_json(sys.argv[2])).hex())
+    elif len(sys.argv) == 3 and sys.argv[1] == 'decode':
+        print(_update_to_json(ArrayProtocol.decode(bytes.fromhex(sys.argv[2]))))
+    else:
+        print(__doc__)
+        sys.exit(1)
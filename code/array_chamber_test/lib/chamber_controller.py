@@ -6,23 +6,259 @@ Chamber controller module for anechoic chamber control
 
 import math
 import random
+import time
 from datetime import datetime
-from typing import Dict, Union, List
+from typing import Dict, Union, List, Optional
 
+import numpy as np
+
+from . import array_model
+from .adaptive_sampler import AdaptiveSampler
+from .command_cache import config_hash
 from .hardware_interface import HardwareInterface
+from .measurement_store import MeasurementStore
+from .sweep_planner import SweepPipeline, SweepPlanner, SweepPoint
 from ..config import (
     ARRAY_INTERFACE, SYSTEM_CONFIGURATION, PLOT_SAVE_PATH,
     SWEEP_BOTH_DIRECTIONS, ELEVATION_PHI_ADJUSTMENT, TURN_TABLE_ELV_LIMIT,
     AZ_START, AZ_FINISH, EL_START, EL_FINISH,
     POL_START, POL_FINISH, HORN_START, HORN_FINISH,
-    PHI_RANGE, THETA_RANGE, PHI_RANGE_RANDOM, THETA_RANGE_RANDOM
+    PHI_RANGE, THETA_RANGE, PHI_RANGE_RANDOM, THETA_RANGE_RANDOM,
+    SWEEP_PIPELINED, THETA_RANGE_ADAPTIVE, ADAPTIVE_COARSE_STEP, ADAPTIVE_FINE_STEP,
+    ADAPTIVE_TOLERANCE_DB, SWEEP_FREQUENCY_STEPPED
 )
 
 class ChamberController:
-    def __init__(self, sweep_runner):
-        """Initialize chamber controller with sweep runner object."""
+    def __init__(self, sweep_runner, store: Optional[MeasurementStore] = None):
+        """Initialize chamber controller with sweep runner object and optional measurement store."""
         self.sweep_runner = sweep_runner
+        self.store = store
         self.direction_forward = True
+        self.metrics: Dict[tuple, Dict[str, float]] = {}  # Pattern metrics per (ku_freq, phi, theta)
+        self.frequency_cache: Dict[int, tuple] = {}  # Prepared configurations of the current stepped cut
+
+    def run_campaign(self, array_ctrl, ku_freqs: List[int], l_band_freq: int) -> None:
+        """
+        Run the sweeps for every frequency. With SWEEP_PIPELINED the whole grid is
+        planned and estimated up front and run through the sweep pipeline. With
+        SWEEP_FREQUENCY_STEPPED each cut is measured once, at every frequency.
+        """
+        array_ctrl.compiler.validate()
+
+        adaptive = SWEEP_PIPELINED and THETA_RANGE_ADAPTIVE
+        if adaptive and not hasattr(self.sweep_runner, "last_measurement"):
+            print("Warning: adaptive sampling needs a sweep runner that returns measurements, "
+                  "sweeping THETA_RANGE without refinement")
+            adaptive = False
+
+        stepped = SWEEP_FREQUENCY_STEPPED and not adaptive
+        if stepped and ARRAY_INTERFACE != "":
+            print("Warning: frequency-stepped sweeps need the array message interface, "
+                  "sweeping each frequency separately")
+            stepped = False
+        elif stepped and not hasattr(self.sweep_runner, "run_frequency_stepped_sweep"):
+            print("Warning: the sweep runner cannot step a cut through the frequencies, "
+                  "sweeping each frequency separately")
+            stepped = False
+
+        if not SWEEP_PIPELINED and not stepped:
+            for ku_freq in ku_freqs:
+                self.run_sweep_sequence(array_ctrl, ku_freq, l_band_freq)
+            return
+
+        # The pointing generator is set up once per frequency, so plan each one separately
+        if ARRAY_INTERFACE == "app_cli_pointing_generator":
+            groups = [[ku_freq] for ku_freq in ku_freqs]
+        else:
+            groups = [list(ku_freqs)]
+
+        phi_angles = self._select_phi_angles()
+        planner = SweepPlanner()
+        theta_angles = [] if adaptive else self._select_theta_angles()
+
+        for group in groups:
+            if ARRAY_INTERFACE == "app_cli_pointing_generator":
+                array_ctrl.setup_array(group[0], 0, 90)
+
+            if adaptive:
+                self._run_adaptive(array_ctrl, planner, group, phi_angles, l_band_freq)
+            elif stepped:
+                points = [
+                    SweepPoint(group[0], phi_angle, theta_angle,
+                               self._calculate_sweep_angles(True, phi_angle, theta_angle), tuple(group))
+                    for phi_angle in phi_angles
+                    for theta_angle in theta_angles
+                ]
+                separate = planner.estimate(planner.plan([
+                    point._replace(ku_freq=ku_freq, ku_freqs=()) for point in points for ku_freq in group
+                ]))
+                print(f"\nStepping {len(group)} frequencies at each position of {len(points)} cuts, "
+                      f"estimated {separate[self._estimate_key()] / 60:.1f} min sweeping each frequency separately")
+                self._run_points(array_ctrl, planner, points, l_band_freq)
+            else:
+                self._run_points(array_ctrl, planner, [
+                    SweepPoint(ku_freq, phi_angle, theta_angle,
+                               self._calculate_sweep_angles(True, phi_angle, theta_angle))
+                    for ku_freq in group
+                    for phi_angle in phi_angles
+                    for theta_angle in theta_angles
+                ], l_band_freq)
+
+    def _estimate_key(self) -> str:
+        """
+        The planner estimate that applies to the sweep runner. Array setup only overlaps
+        the positioner move when the runner can be moved separately from the sweep.
+        """
+        return "pipelined" if getattr(self.sweep_runner, "move_to", None) is not None else "sequential"
+
+    def _run_points(self, array_ctrl, planner: SweepPlanner, points: List[SweepPoint], l_band_freq: int) -> float:
+        """Plan, estimate and run a set of sweep points. Returns the estimated time."""
+        plan = planner.plan(points)
+        estimate = planner.estimate(plan)
+        key = self._estimate_key()
+        print(
+            f"\nPlanned {len(plan)} sweeps, {planner.travel(plan):.0f} deg of positioner travel "
+            f"(grid order {planner.travel(points):.0f} deg)"
+        )
+        if key == "pipelined":
+            print(
+                f"Estimated campaign time {estimate['pipelined'] / 60:.1f} min "
+                f"(sequential {estimate['sequential'] / 60:.1f} min): "
+                f"sweep {estimate['sweep'] / 60:.1f} min, move {estimate['move'] / 60:.1f} min\n"
+            )
+        else:
+            print(
+                f"Estimated campaign time {estimate['sequential'] / 60:.1f} min, the sweep runner moves "
+                f"the positioner itself so array setup is not overlapped: "
+                f"sweep {estimate['sweep'] / 60:.1f} min, move {estimate['move'] / 60:.1f} min\n"
+            )
+
+        pipeline = SweepPipeline(
+            prepare=lambda point: (
+                array_ctrl.prepare_frequencies(list(point.ku_freqs), point.phi, point.theta) if point.ku_freqs
+                else array_ctrl.prepare_array(point.ku_freq, point.phi, point.theta)
+            ),
+            apply=lambda prepared: self._apply_prepared(array_ctrl, prepared),
+            sweep=lambda point: (
+                self._run_stepped_sweep(array_ctrl, point, l_band_freq) if point.ku_freqs
+                else self._run_chamber_sweep(
+                    point.ku_freq, l_band_freq, point.theta, point.phi, point.angles,
+                    array_config=config_hash(array_ctrl.config_key(point.ku_freq, point.phi, point.theta))
+                )
+            ),
+            move_to=getattr(self.sweep_runner, "move_to", None)
+        )
+        elapsed = pipeline.run(plan)
+        print(
+            f"\nCampaign took {elapsed:.1f} s against {estimate[key] / 60:.1f} min estimated; "
+            + ", ".join(f"{stage} {seconds:.1f} s" for stage, seconds in pipeline.stage_times.items())
+        )
+        return estimate[key]
+
+    def _apply_prepared(self, array_ctrl, prepared) -> None:
+        """
+        Send a prepared configuration. A per-frequency cache for a stepped cut is kept
+        for retuning during the cut and its first frequency is sent.
+        """
+        if isinstance(prepared, dict):
+            self.frequency_cache = prepared
+            prepared = next(iter(prepared.values()))
+        array_ctrl.apply_array(prepared)
+
+    def _run_stepped_sweep(self, array_ctrl, point: SweepPoint, l_band_freq: int) -> None:
+        """Measure one cut at every frequency of the point, retuning from the frequency cache."""
+        tuned = {"ku_freq": point.ku_freqs[0], "count": 0, "time": 0.0}
+
+        def retune(ku_freq: int) -> None:
+            if ku_freq != tuned["ku_freq"]:
+                start_time = time.perf_counter()
+                array_ctrl.apply_array(self.frequency_cache[ku_freq], report=False)
+                tuned["ku_freq"] = ku_freq
+                tuned["count"] += 1
+                tuned["time"] += time.perf_counter() - start_time
+
+        self.sweep_runner.sweep_name = self._generate_sweep_name(point.ku_freq, l_band_freq, point.phi, point.theta)
+        print('\nRun frequency-stepped sweep')
+        self.sweep_runner.run_frequency_stepped_sweep(
+            angles_list=point.angles,
+            ku_freqs=list(point.ku_freqs),
+            retune=retune
+        )
+        if tuned["count"]:
+            print(f"Retuned {tuned['count']} times, {tuned['time'] / tuned['count'] * 1000:.1f} ms each")
+
+        for ku_freq, measurement in self.sweep_runner.last_measurements.items():
+            self._record_measurement(
+                self._generate_sweep_name(ku_freq, l_band_freq, point.phi, point.theta),
+                ku_freq, l_band_freq, point.phi, point.theta,
+                config_hash(array_ctrl.config_key(ku_freq, point.phi, point.theta)), measurement
+            )
+
+    def _run_adaptive(self, array_ctrl, planner: SweepPlanner, ku_freqs: List[int],
+                      phi_angles: List[float], l_band_freq: int) -> None:
+        """
+        Sweep a coarse theta grid per (frequency, phi), then refine it round by round.
+        If the runner returns no measurement for a sweep, the rest of THETA_RANGE is
+        swept without refinement instead.
+        """
+        samplers = {
+            (ku_freq, phi_angle): AdaptiveSampler(
+                min(THETA_RANGE), max(THETA_RANGE), ADAPTIVE_COARSE_STEP, ADAPTIVE_FINE_STEP,
+                ADAPTIVE_TOLERANCE_DB,
+                predict=lambda theta, ku_freq=ku_freq, phi_angle=phi_angle: array_model.predicted_metrics(
+                    self._calculate_sweep_angles(True, phi_angle, theta), phi_angle, theta, ku_freq
+                )
+            )
+            for ku_freq in ku_freqs
+            for phi_angle in phi_angles
+        }
+        pending = {key: sampler.initial() for key, sampler in samplers.items()}
+        estimated = 0.0
+        refinement = 0
+
+        while any(pending.values()):
+            print(f"\nAdaptive sampling round {refinement}")
+            estimated += self._run_points(array_ctrl, planner, [
+                SweepPoint(ku_freq, phi_angle, theta, self._calculate_sweep_angles(True, phi_angle, theta))
+                for (ku_freq, phi_angle), thetas in pending.items()
+                for theta in thetas
+            ], l_band_freq)
+
+            unmeasured = sum(
+                (ku_freq, phi_angle, theta) not in self.metrics
+                for (ku_freq, phi_angle), thetas in pending.items()
+                for theta in thetas
+            )
+            if unmeasured:
+                print(f"Warning: the sweep runner returned no measurement for {unmeasured} sweeps, "
+                      f"sweeping THETA_RANGE without refinement")
+                self._run_points(array_ctrl, planner, [
+                    SweepPoint(ku_freq, phi_angle, theta, self._calculate_sweep_angles(True, phi_angle, theta))
+                    for (ku_freq, phi_angle), sampler in samplers.items()
+                    for theta in self._select_theta_angles()
+                    if theta not in sampler.measured and theta not in pending[(ku_freq, phi_angle)]
+                ], l_band_freq)
+                return
+
+            for (ku_freq, phi_angle), thetas in pending.items():
+                for theta in thetas:
+                    samplers[(ku_freq, phi_angle)].record(theta, self.metrics[(ku_freq, phi_angle, theta)])
+            pending = {key: sampler.refine() for key, sampler in samplers.items()}
+            refinement += 1
+
+        # Compare with the fixed grid at the fine step
+        full_grid = [
+            SweepPoint(ku_freq, phi_angle, theta, self._calculate_sweep_angles(True, phi_angle, theta))
+            for (ku_freq, phi_angle), sampler in samplers.items()
+            for theta in np.linspace(sampler.theta_min, sampler.theta_max, sampler.full_count)
+        ]
+        full_estimate = planner.estimate(planner.plan(full_grid))[self._estimate_key()]
+        measured = sum(len(sampler.measured) for sampler in samplers.values())
+        print(
+            f"\nAdaptive sampling measured {measured} of {len(full_grid)} points at {ADAPTIVE_FINE_STEP} deg, "
+            f"saving {len(full_grid) - measured} points and about "
+            f"{(full_estimate - estimated) / 60:.1f} of {full_estimate / 60:.1f} min of chamber time"
+        )
 
     def run_sweep_sequence(self, array_ctrl, ku_freq: int, l_band_freq: int) -> None:
         """Run a complete sweep sequence for given frequencies."""
@@ -33,11 +269,8 @@ class ChamberController:
 
         for phi_angle in self._select_phi_angles():
             for theta_angle in self._select_theta_angles():
-                # Configure array
-                if ARRAY_INTERFACE == "app_cli_message_forewarding":
-                    array_ctrl.control_array(ku_freq, phi_angle, theta_angle)
-                else:
-                    array_ctrl.control_pose(phi_angle, theta_angle)
+                # Configure array, dispatched on the interface as in the pipelined path
+                array_ctrl.control_array(ku_freq, phi_angle, theta_angle)
 
                 # Perform sweep
                 self.direction_forward = self.perform_sweep(
@@ -45,7 +278,8 @@ class ChamberController:
                     ku_freq,
                     l_band_freq,
                     phi_angle,
-                    theta_angle
+                    theta_angle,
+                    array_config=config_hash(array_ctrl.config_key(ku_freq, phi_angle, theta_angle))
                 )
 
     def perform_sweep(
@@ -54,7 +288,8 @@ class ChamberController:
         ku_freq: int,
         l_band_freq: int,
         phi_angle: float,
-        theta_angle: float
+        theta_angle: float,
+        array_config: str = ""
     ) -> bool:
         """
         Perform a sweep test with the given parameters.
@@ -69,7 +304,8 @@ class ChamberController:
             l_band_freq,
             theta_angle,
             phi_angle,
-            sweep_angles
+            sweep_angles,
+            array_config
         )
 
         return not direction_forward if SWEEP_BOTH_DIRECTIONS else direction_forward
@@ -138,9 +374,10 @@ class ChamberController:
         l_band_freq: int,
         theta_angle: float,
         phi_angle: float,
-        sweep_angles: Dict[str, float]
+        sweep_angles: Dict[str, float],
+        array_config: str = ""
     ) -> None:
-        """Execute chamber sweep with specified parameters."""
+        """Execute chamber sweep with specified parameters and store the result."""
         # Generate sweep name with test parameters
         sweep_name = self._generate_sweep_name(
             ku_freq, l_band_freq, phi_angle, theta_angle
@@ -156,6 +393,33 @@ class ChamberController:
             sPar=False
         )
 
+        # Runners that expose their last measurement also stream it to the campaign store
+        measurement = getattr(self.sweep_runner, "last_measurement", None)
+        if measurement is not None:
+            self._record_measurement(
+                sweep_name, ku_freq, l_band_freq, phi_angle, theta_angle, array_config, measurement
+            )
+
+    def _record_measurement(
+        self,
+        sweep_name: str,
+        ku_freq: int,
+        l_band_freq: int,
+        phi_angle: float,
+        theta_angle: float,
+        array_config: str,
+        measurement: Dict[str, object]
+    ) -> None:
+        """Store a measured cut and keep its pattern metrics."""
+        if self.store is not None:
+            self.store.append(
+                sweep_name, ku_freq, l_band_freq, phi_angle, theta_angle, array_config,
+                measurement["az"], measurement["el"], measurement["gain_db"], measurement["phase_deg"]
+            )
+        self.metrics[(ku_freq, phi_angle, theta_angle)] = array_model.pattern_metrics(
+            measurement["az"], measurement["gain_db"]
+        )
+
     @staticmethod
     def _generate_sweep_name(
         ku_freq: int,
@@ -0,0 +1,153 @@
+"""
+================================================================================
+Compiled array command cache
+Memoises the messages of each array configuration as ready-to-send bytes, keyed
+by everything that determines them (interface, protocol, frequency, phi, theta,
+polarisation and attenuation profile). A pointing step seen before is sent
+without formatting or encoding anything.
+
+The cache is saved between campaigns as JSON next to the test output, tagged
+with a fingerprint of the SystemMessages templates, the source of the functions
+that build the messages and the binary protocol version; when any of them
+changes the saved entries are discarded. validate() does
+the same check for a running cache and is called at the start of a campaign,
+which keeps the lookup itself to one dictionary access. Keys must be tuples of
+plain literals so they survive the round trip through the saved file.
+================================================================================
+"""
+
+import ast
+import hashlib
+import inspect
+import json
+import os
+import threading
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .array_protocol import ArrayProtocol
+from .system_messages import SystemMessages
+from ..config import COMMAND_CACHE_PATH
+
+
+def _source(function) -> str:
+    """Source of a function, or its bytecode when the source is not available."""
+    try:
+        return inspect.getsource(function)
+    except (OSError, TypeError):
+        return function.__code__.co_code.hex()
+
+
+def messages_fingerprint() -> str:
+    """
+    Hash of every SystemMessages template and code map, the source of the functions
+    that build the messages from them, and the protocol version.
+    """
+    from .array_controller import ArrayController
+
+    fields = sorted(
+        (name, value) for name, value in vars(SystemMessages).items()
+        if not name.startswith('_') and isinstance(value, (str, dict))
+    )
+    builders = [_source(function) for function in (
+        SystemMessages.get_pose_commands,
+        SystemMessages.get_phased_array_commands,
+        SystemMessages.get_pointing_commands,
+        ArrayController._build_array,
+        ArrayController._get_bulk_update_frame,
+        ArrayController._get_pose_commands,
+        ArrayController._get_rx_atten_commands,
+        ArrayController.setup_array,
+    )]
+    return hashlib.sha1(repr((ArrayProtocol.VERSION, fields, builders)).encode()).hexdigest()[:16]
+
+
+def config_hash(key) -> str:
+    """Short stable hash of an array configuration key."""
+    return hashlib.sha1(repr(key).encode()).hexdigest()[:16]
+
+
+class CommandCompiler:
+    def __init__(self, path: Optional[str] = COMMAND_CACHE_PATH):
+        self.path = path
+        self.hits = 0
+        self.misses = 0
+        self._lock = threading.Lock()
+        self._entries: Dict[tuple, Tuple[str, List[bytes]]] = {}
+        self._fingerprint = messages_fingerprint()
+        self._changed = False
+        self.load()
+
+    def compile(self, key: tuple, build: Callable[[], Tuple[str, list]]) -> Tuple[str, List[bytes]]:
+        """
+        Return ("frames" | "commands", [bytes]) for the configuration key, building it
+        with build() on a miss. Commands are encoded with their line ending.
+        """
+        entry = self._entries.get(key)
+        if entry is not None:
+            self.hits += 1
+            return entry
+
+        kind, messages = build()
+        entry = (kind, [
+            message if isinstance(message, bytes) else f'{message}\r\n'.encode() for message in messages
+        ])
+
+        with self._lock:
+            self.misses += 1
+            self._entries[key] = entry
+            self._changed = True
+        return entry
+
+    def validate(self) -> None:
+        """Drop every compiled entry if SystemMessages changed since they were compiled."""
+        fingerprint = messages_fingerprint()
+        with self._lock:
+            if fingerprint != self._fingerprint:
+                if self._entries:
+                    print("SystemMessages changed, recompiling array commands")
+                self._entries.clear()
+                self._fingerprint = fingerprint
+                self._changed = True
+
+    def load(self) -> None:
+        """Load the saved cache, ignoring it if it was compiled from other messages."""
+        if not self.path or not os.path.exists(self.path):
+            return
+        try:
+            with open(self.path) as f:
+                saved = json.load(f)
+            if saved.get("fingerprint") != self._fingerprint:
+                print("SystemMessages changed since the command cache was saved, recompiling")
+                return
+            self._entries = {
+                ast.literal_eval(key): (kind, [bytes.fromhex(message) for message in messages])
+                for key, (kind, messages) in saved.get("entries", {}).items()
+            }
+        except (OSError, ValueError, SyntaxError) as e:
+            print(f"Ignoring command cache {self.path}: {str(e)}")
+
+    def save(self) -> None:
+        """Write the cache if anything was compiled since it was loaded."""
+        self.validate()
+        if not self.path or not self._changed:
+            return
+        with self._lock:
+            saved = {
+                "fingerprint": self._fingerprint,
+                "entries": {
+                    repr(key): [kind, [message.hex() for message in messages]]
+                    for key, (kind, messages) in self._entries.items()
+                },
+            }
+            self._changed = False
+
+        directory = os.path.dirname(self.path)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        temporary = self.path + ".tmp"
+        with open(temporary, "w") as f:
+            json.dump(saved, f)
+        os.replace(temporary, self.path)
+
+    def summary(self) -> str:
+        return f"{len(self._entries)} compiled configurations, {self.hits} hits, {self.misses} misses"
@@ -5,46 +5,169 @@ Hardware interface module for system communication
 """
 
 import time
+from functools import lru_cache
+
 import serial
+from collections import deque
 from typing import List, Optional
 
-from ..config import SERIAL_PORT, SERIAL_BAUD
+from .array_protocol import ArrayProtocol
+from .simulator import SimulatedSerial
+from ..config import (
+    BACKEND, SERIAL_PORT, SERIAL_BAUD, SERIAL_PIPELINE_DEPTH,
+    SERIAL_COMMAND_PACING, SERIAL_RESPONSE_TIMEOUT
+)
 
 class HardwareInterface:
+    """
+    Long-lived serial session to the array controller.
+
+    The port is opened once and kept open between batches. Commands are pipelined:
+    up to `pipeline_depth` are written before the first response is read, and each
+    response line, 'OK' or an error, completes the oldest outstanding command. Echoes
+    of the commands themselves are skipped. Every command has its own response
+    deadline, counted from when it was written. Responses carry no command
+    identifier, so a command that never answers shifts later acknowledgements onto
+    the command before them; the count of acknowledged commands stays correct.
+    """
+
+    def __init__(
+        self,
+        port: str = SERIAL_PORT,
+        baud: int = SERIAL_BAUD,
+        pipeline_depth: int = SERIAL_PIPELINE_DEPTH,
+        pacing: float = SERIAL_COMMAND_PACING,
+        response_timeout: float = SERIAL_RESPONSE_TIMEOUT
+    ):
+        self.port = port
+        self.baud = baud
+        self.pipeline_depth = max(1, pipeline_depth)
+        self.pacing = pacing
+        self.response_timeout = response_timeout
+        self.last_batch_time = 0.0
+        self._serial: Optional[serial.Serial] = None
+        self._rx_buffer = b''
+
+    def __enter__(self):
+        self.open()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    def open(self) -> None:
+        """Open the serial port if it is not already open."""
+        if self._serial is None or not self._serial.is_open:
+            if BACKEND == "simulator":
+                self._serial = SimulatedSerial(self.port, self.baud, timeout=0)
+            else:
+                self._serial = serial.Serial(self.port, self.baud, timeout=0)
+            self._rx_buffer = b''
+
+    def close(self) -> None:
+        """Close the serial port."""
+        if self._serial is not None:
+            self._serial.close()
+            self._serial = None
+
+    def send_commands(self, commands: List[str], report: bool = True) -> List[bool]:
+        """
+        Send a batch of ASCII commands and wait for their responses.
+        Returns one flag per command, False if it was rejected or not acknowledged in time.
+        """
+        return self._send_batch([f'{command}\r\n'.encode() for command in commands], commands, report)
+
+    def send_frames(self, frames: List[bytes], report: bool = True) -> List[bool]:
+        """
+        Send a batch of binary protocol frames, each acknowledged with 'OK' like a command.
+        Returns one flag per frame, False if it was rejected or not acknowledged in time.
+        """
+        return self._send_batch(frames, [f"frame {frame[4]}" for frame in frames], report)
+
+    def send_messages(self, messages: List[bytes], report: bool = True) -> List[bool]:
+        """
+        Send a batch of ready-to-send messages, encoded commands or frames, as compiled by
+        CommandCompiler. Returns one flag per message, False if it was rejected or not
+        acknowledged in time.
+        """
+        return self._send_batch(messages, [self._label(message) for message in messages], report)
+
     @staticmethod
-    def send_commands(commands: List[str], port: str = SERIAL_PORT, baud: int = SERIAL_BAUD) -> None:
-        """Send commands to hardware over serial interface."""
-        ser = serial.Serial(port, baud, timeout=0.5)
-        start_time = time.time()
+    def _label(message: bytes) -> str:
+        if message.startswith(ArrayProtocol.SYNC):
+            return f"frame {message[4]}"
+        return message.decode(errors='replace').strip()
+
+    def _send_batch(self, messages: List[bytes], labels: List[str], report: bool = True) -> List[bool]:
+        """Pipeline the messages and match each response to the oldest outstanding one."""
+        self.open()
+        self._serial.reset_input_buffer()
+        self._rx_buffer = b''
+
+        start_time = time.perf_counter()
+        results = [False] * len(messages)
+        outstanding = deque()  # (index, deadline) in the order written
+        next_command = 0
+
         try:
-            for command in commands:
-                ser.write(f'{command}\r\n'.encode())
-                time.sleep(0.1)
-                print(f"Sent: {command}")
-
-                while True:
-                    response = ser.readline().decode()
-                    if time.time() - start_time > 2:
-                        print("No response")
-                        break
-                    if 'OK' in response or response == '':
-                        break
-        finally:
-            ser.close()
-        time.sleep(0.1)
+            while next_command < len(messages) or outstanding:
+                # Keep the pipeline full
+                while next_command < len(messages) and len(outstanding) < self.pipeline_depth:
+                    self._serial.write(messages[next_command])
+                    outstanding.append((next_command, time.perf_counter() + self.response_timeout))
+                    next_command += 1
+                    if self.pacing > 0:
+                        time.sleep(self.pacing)
 
-    @staticmethod
-    def check_connection(port: str = SERIAL_PORT, baud: int = SERIAL_BAUD) -> bool:
+                # Match each response to the oldest outstanding command, so an error
+                # does not shift later acknowledgements onto the wrong command
+                for line in self._read_lines(outstanding[0][1]):
+                    if not line or not outstanding or any(line == labels[index] for index, _ in outstanding):
+                        continue
+                    index, _ = outstanding.popleft()
+                    results[index] = 'OK' in line
+                    if not results[index]:
+                        print(f"Rejected ({line}): {labels[index]}")
+
+                # Drop commands whose deadline has passed
+                now = time.perf_counter()
+                while outstanding and now > outstanding[0][1]:
+                    index, _ = outstanding.popleft()
+                    print(f"No response: {labels[index]}")
+        except serial.SerialException as e:
+            print(f"Serial error: {str(e)}")
+            self.close()
+
+        self.last_batch_time = time.perf_counter() - start_time
+        if report or not all(results):
+            print(f"Sent {sum(results)}/{len(messages)} messages in {self.last_batch_time * 1000:.1f} ms")
+
+        return results
+
+    def _read_lines(self, deadline: float) -> List[str]:
+        """Read until at least one complete line has arrived or the deadline passes."""
+        while b'\n' not in self._rx_buffer and time.perf_counter() < deadline:
+            waiting = self._serial.in_waiting
+            if waiting:
+                self._rx_buffer += self._serial.read(waiting)
+            else:
+                time.sleep(0.0005)
+
+        *lines, self._rx_buffer = self._rx_buffer.split(b'\n')
+        return [line.decode(errors='replace').strip() for line in lines]
+
+    def check_connection(self) -> bool:
         """Verify serial connection to hardware."""
         try:
-            with serial.Serial(port, baud, timeout=1):
-                return True
+            self.open()
+            return True
         except Exception as e:
             print(f"Failed to open serial port: {str(e)}")
             return False
 
     @staticmethod
+    @lru_cache(maxsize=None)
     def to_attenuation_code(db: float, insertion_loss_db: float) -> int:
         """Convert dB value to attenuation code."""
         db -= insertion_loss_db
-        return int(round(db * 4)) if db >= 0 else 0 
\ No newline at end of file
+        return int(round(db * 4)) if db >= 0 else 0
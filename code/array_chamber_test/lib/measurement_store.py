@@ -0,0 +1,192 @@
+"""
+================================================================================
+Streaming columnar storage for sweep measurements
+Appends every measured sample of a campaign to chunked Parquet files as sweeps
+complete, in place of one file per sweep. Rows are buffered up to a fixed chunk
+size, so memory stays bounded however long the campaign runs, and each flushed
+chunk is a complete file, so a crash loses at most the chunk being buffered.
+
+Campaign directory layout:
+    part-00000.parquet, part-00001.parquet, ...   One row per sample
+    index.parquet                                  One row per sweep
+
+The index maps each sweep (frequency, phi, theta, array configuration hash) to
+its part file, so reading one cut opens only the files that hold it.
+
+pyarrow is imported when a store is opened or read, so campaigns that do not
+store their measurements run without it.
+================================================================================
+"""
+
+import os
+import time
+from typing import TYPE_CHECKING, Dict, List, Optional, Tuple
+
+import numpy as np
+
+from ..config import MEASUREMENT_CHUNK_ROWS
+
+if TYPE_CHECKING:
+    import pyarrow as pa
+
+SAMPLE_COLUMNS: List[Tuple[str, str]] = [
+    ("sweep_id", "int32"),
+    ("ku_freq_hz", "int64"),
+    ("phi", "float32"),
+    ("theta", "float32"),
+    ("az", "float32"),
+    ("el", "float32"),
+    ("gain_db", "float32"),
+    ("phase_deg", "float32"),
+]
+
+INDEX_COLUMNS: List[Tuple[str, str]] = [
+    ("sweep_id", "int32"),
+    ("sweep_name", "string"),
+    ("time", "float64"),
+    ("ku_freq_hz", "int64"),
+    ("l_band_freq_hz", "int64"),
+    ("phi", "float32"),
+    ("theta", "float32"),
+    ("config_hash", "string"),
+    ("part", "int32"),
+    ("rows", "int32"),
+]
+
+
+def _schema(columns: List[Tuple[str, str]]) -> "pa.Schema":
+    import pyarrow as pa
+    return pa.schema([(name, getattr(pa, type_name)()) for name, type_name in columns])
+
+
+class MeasurementStore:
+    def __init__(self, path: str, chunk_rows: int = MEASUREMENT_CHUNK_ROWS):
+        # Fail before the campaign starts rather than at the first flush
+        import pyarrow
+
+        self.path = path
+        self.chunk_rows = chunk_rows
+        self.sweep_count = 0
+        self.part_count = 0
+        self._columns: Dict[str, List[np.ndarray]] = {name: [] for name, _ in SAMPLE_COLUMNS}
+        self._buffered_rows = 0
+        self._index: Dict[str, list] = {name: [] for name, _ in INDEX_COLUMNS}
+        os.makedirs(path, exist_ok=True)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    def append(
+        self,
+        sweep_name: str,
+        ku_freq: int,
+        l_band_freq: int,
+        phi: float,
+        theta: float,
+        config_hash: str,
+        az: np.ndarray,
+        el: np.ndarray,
+        gain_db: np.ndarray,
+        phase_deg: np.ndarray
+    ) -> None:
+        """Append one sweep's samples, flushing a chunk once it is full."""
+        rows = len(az)
+        sweep_id = self.sweep_count
+        self.sweep_count += 1
+
+        self._columns["sweep_id"].append(np.full(rows, sweep_id, dtype=np.int32))
+        self._columns["ku_freq_hz"].append(np.full(rows, ku_freq, dtype=np.int64))
+        self._columns["phi"].append(np.full(rows, phi, dtype=np.float32))
+        self._columns["theta"].append(np.full(rows, theta, dtype=np.float32))
+        self._columns["az"].append(np.asarray(az, dtype=np.float32))
+        self._columns["el"].append(np.asarray(el, dtype=np.float32))
+        self._columns["gain_db"].append(np.asarray(gain_db, dtype=np.float32))
+        self._columns["phase_deg"].append(np.asarray(phase_deg, dtype=np.float32))
+        self._buffered_rows += rows
+
+        for name, value in (
+            ("sweep_id", sweep_id), ("sweep_name", sweep_name), ("time", time.time()),
+            ("ku_freq_hz", ku_freq), ("l_band_freq_hz", l_band_freq), ("phi", phi), ("theta", theta),
+            ("config_hash", config_hash), ("part", self.part_count), ("rows", rows)
+        ):
+            self._index[name].append(value)
+
+        if self._buffered_rows >= self.chunk_rows:
+            self.flush()
+
+    def flush(self) -> None:
+        """Write the buffered rows as the next part file and rewrite the index."""
+        if self._buffered_rows == 0:
+            return
+
+        import pyarrow as pa
+
+        table = pa.table(
+            {name: np.concatenate(chunks) for name, chunks in self._columns.items()},
+            schema=_schema(SAMPLE_COLUMNS)
+        )
+        self._write_atomic(table, os.path.join(self.path, f"part-{self.part_count:05d}.parquet"))
+        self._write_atomic(pa.table(self._index, schema=_schema(INDEX_COLUMNS)), os.path.join(self.path, "index.parquet"))
+
+        self.part_count += 1
+        self._columns = {name: [] for name, _ in SAMPLE_COLUMNS}
+        self._buffered_rows = 0
+
+    def close(self) -> None:
+        self.flush()
+
+    @staticmethod
+    def _write_atomic(table: "pa.Table", path: str) -> None:
+        import pyarrow.parquet as pq
+
+        temporary = path + ".tmp"
+        pq.write_table(table, temporary, compression="zstd")
+        os.replace(temporary, path)
+
+    @staticmethod
+    def read_index(path: str) -> "pa.Table":
+        """Read the per-sweep index of a campaign."""
+        import pyarrow.parquet as pq
+
+        return pq.read_table(os.path.join(path, "index.parquet"))
+
+    @staticmethod
+    def read_cut(
+        path: str,
+        ku_freq: Optional[int] = None,
+        phi: Optional[float] = None,
+        theta: Optional[float] = None,
+        columns: Optional[List[str]] = None
+    ) -> "pa.Table":
+        """
+        Read the samples of every sweep matching the given frequency, phi and theta.
+        Only the part files that hold matching sweeps are opened.
+        """
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+
+        index = MeasurementStore.read_index(path).to_pydict()
+        selected = [
+            i for i in range(len(index["sweep_id"]))
+            if (ku_freq is None or index["ku_freq_hz"][i] == ku_freq)
+            and (phi is None or abs(index["phi"][i] - phi) < 1e-3)
+            and (theta is None or abs(index["theta"][i] - theta) < 1e-3)
+        ]
+
+        tables = []
+        for part in sorted({index["part"][i] for i in selected}):
+            sweep_ids = [index["sweep_id"][i] for i in selected if index["part"][i] == part]
+            tables.append(pq.read_table(
+                os.path.join(path, f"part-{part:05d}.parquet"),
+                columns=columns,
+                filters=[("sweep_id", "in", sweep_ids)]
+            ))
+
+        if not tables:
+            schema = _schema(SAMPLE_COLUMNS)
+            return schema.empty_table() if columns is None else \
+                pa.schema([schema.field(name) for name in columns]).empty_table()
+        return pa.concat_tables(tables)
@@ -0,0 +1,302 @@
+"""
+================================================================================
+Simulated back-end for offline sweep runs
+Stands in for the array's serial port and for the chamber positioner and VNA,
+so the whole sweep pipeline runs without hardware and its orchestration overhead
+can be measured. Selected with BACKEND = "simulator" in config.py.
+
+- SimulatedSerial acknowledges each ASCII command or binary bulk update frame
+  with 'OK' after SIM_ARRAY_LATENCY, one message at a time like the target CLI,
+  and tracks the steering it was sent.
+- SimulatedChamber replaces ChamberClass: it moves a simulated positioner and
+  returns the pattern of lib/array_model.py steered as the simulated array was
+  last commanded, sampled along each cut. Frequency-stepped cuts retune the
+  array through the serial port at every step and capture each frequency.
+================================================================================
+"""
+
+import threading
+import time
+from collections import deque
+from typing import Callable, Dict, List, Optional
+
+import numpy as np
+
+from . import array_model
+from .array_protocol import ArrayProtocol
+from .system_messages import SystemMessages
+from ..config import (
+    SIM_ARRAY_LATENCY, SIM_TIME_SCALE, SIM_SWEEP_STEP, SIM_NOISE_DB,
+    POSITIONER_SPEED, POSITIONER_SETTLE_TIME, SWEEP_SPEED,
+    FREQUENCY_STEP, FREQUENCY_STEP_SETTLE_TIME, FREQUENCY_RETUNE_TIME
+)
+
+# Command templates used when system_messages.py has not been filled in
+SIM_MESSAGES = {
+    "POWER_ON_CMD": "power 1",
+    "POWER_OFF_CMD": "power 0",
+    "BAND_CONFIG_CMD": "band {channel} {band_code}",
+    "CHANNEL_CONFIG_CMD": "channel {channel} {freq_khz} {if_freq_khz}",
+    "BPL_ATTEN_CMD": "bpl {channel} {array} {atten_code}",
+    "IF_ATTEN_CMD": "if {channel} {atten_code}",
+    "ARRAY_STEER_CMD": "steer {phased_array} {phi} {theta} {gain} {freq_hz} {pol} {enable}",
+    "ARRAY_RF_ENABLE_CMD": "rf {phased_array} {enable}",
+    "POSE_CMD": "pose {roll} {pitch} {yaw} {x} {y}",
+    "POINTING_GEN_CMD": "pointing",
+    "MODEM_IF_CMD": "modem {freq_hz} {enable}",
+    "BEAM_INFO_CMD": "beam {az} {el} {freq_hz} {pol} {enable}",
+}
+SIM_BAND_CODES = {"L": 1, "Ku": 2}
+
+
+def install_messages() -> None:
+    """Fill in any empty SystemMessages templates with the simulator's command set."""
+    for name, template in SIM_MESSAGES.items():
+        if not getattr(SystemMessages, name):
+            setattr(SystemMessages, name, template)
+    if not SystemMessages.BAND_CODES:
+        SystemMessages.BAND_CODES = dict(SIM_BAND_CODES)
+
+
+class SimulatedArray:
+    """Steering state shared by the simulated serial port and the simulated VNA."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.phi = 0.0
+        self.theta = 0.0
+        self.freq_hz = 11.6e9
+        self.enabled = True
+        self.message_count = 0
+
+    def steer(self, phi: float, theta: float, freq_hz: float, enabled: bool) -> None:
+        with self.lock:
+            self.phi, self.theta, self.freq_hz, self.enabled = phi, theta, freq_hz, enabled
+
+    def state(self):
+        with self.lock:
+            return self.phi, self.theta, self.freq_hz, self.enabled
+
+
+simulated_array = SimulatedArray()
+
+
+class SimulatedSerial:
+    """Subset of serial.Serial used by HardwareInterface."""
+
+    def __init__(self, port: str = "", baud: int = 0, timeout: float = 0, latency: float = SIM_ARRAY_LATENCY):
+        self.port = port
+        self.latency = latency
+        self.is_open = True
+        self._lock = threading.Condition()
+        self._pending = deque()
+        self._tx_buffer = b''
+        self._rx_buffer = b''
+        self._worker = threading.Thread(target=self._respond, daemon=True)
+        self._worker.start()
+
+    @property
+    def in_waiting(self) -> int:
+        with self._lock:
+            return len(self._rx_buffer)
+
+    def read(self, size: int = 1) -> bytes:
+        with self._lock:
+            data, self._rx_buffer = self._rx_buffer[:size], self._rx_buffer[size:]
+            return data
+
+    def write(self, data: bytes) -> int:
+        with self._lock:
+            self._tx_buffer += data
+            self._split_messages()
+            self._lock.notify()
+        return len(data)
+
+    def reset_input_buffer(self) -> None:
+        with self._lock:
+            self._rx_buffer = b''
+
+    def close(self) -> None:
+        with self._lock:
+            self.is_open = False
+            self._lock.notify()
+
+    def _split_messages(self) -> None:
+        """Move complete frames and lines from the transmit buffer to the pending queue."""
+        while self._tx_buffer:
+            if self._tx_buffer.startswith(ArrayProtocol.SYNC):
+                if len(self._tx_buffer) < 7:
+                    return
+                size = 7 + int.from_bytes(self._tx_buffer[5:7], 'little') + 2
+                if len(self._tx_buffer) < size:
+                    return
+                message, self._tx_buffer = self._tx_buffer[:size], self._tx_buffer[size:]
+            else:
+                end = self._tx_buffer.find(b'\n')
+                if end < 0:
+                    return
+                message, self._tx_buffer = self._tx_buffer[:end + 1], self._tx_buffer[end + 1:]
+            self._pending.append(message)
+
+    def _respond(self) -> None:
+        """Handle one message at a time, acknowledging each after the configured latency."""
+        while True:
+            with self._lock:
+                while not self._pending and self.is_open:
+                    self._lock.wait()
+                if not self.is_open:
+                    return
+                message = self._pending.popleft()
+
+            if self.latency > 0:
+                time.sleep(self.latency)
+            reply = b'OK\r\n' if self._apply(message) else b'ERROR\r\n'
+
+            with self._lock:
+                self._rx_buffer += reply
+
+    @staticmethod
+    def _apply(message: bytes) -> bool:
+        simulated_array.message_count += 1
+
+        if message.startswith(ArrayProtocol.SYNC):
+            try:
+                update = ArrayProtocol.decode(message)
+            except ValueError:
+                return False
+            if update.arrays:
+                steer = update.arrays[0]
+                simulated_array.steer(steer.phi, steer.theta, update.freq_khz * 1000.0, steer.enable)
+            return True
+
+        fields = message.decode(errors='replace').split()
+        if fields and fields[0] == "steer" and len(fields) >= 7:
+            # The array id may be empty, so take the fields from the end
+            phi, theta, _, freq_hz, _, enable = fields[-6:]
+            simulated_array.steer(float(phi), float(theta), float(freq_hz), enable == "1")
+        return True
+
+
+class SimulatedChamber:
+    """
+    Stand-in for ChamberClass with a positioner and a VNA. Times are taken from the
+    planner's positioner model and waited for scaled by SIM_TIME_SCALE.
+    """
+
+    def __init__(self, sweep_name: str = "", frequency_GHz: float = 0.0, seed: int = 0):
+        self.sweep_name = sweep_name
+        self.frequency_GHz = frequency_GHz
+        self.position = {"az": 0.0, "el": 0.0, "pol": 0.0, "horn": 0.0}
+        self.sweep_count = 0
+        self.simulated_time = 0.0
+        self.last_measurement: Optional[Dict[str, object]] = None
+        self.last_measurements: Dict[int, Dict[str, object]] = {}  # Per frequency, from a stepped cut
+        self.listeners = []  # Called with each measurement
+        self._rng = np.random.default_rng(seed)
+
+    def move_to(self, position: Dict[str, float]) -> None:
+        """Move the positioner, all axes together."""
+        longest = max(abs(position[axis] - self.position[axis]) / POSITIONER_SPEED[axis] for axis in position)
+        if longest > 0:
+            self._wait(longest + POSITIONER_SETTLE_TIME)
+        self.position.update(position)
+
+    def run_sweep_test_swt(self, angles_list: Dict[str, float], save_path: str = "", sPar: bool = False) -> None:
+        """Move to the start of the cut, sweep it and record the measured pattern."""
+        self.move_to({axis: angles_list[f"{axis}_start"] for axis in self.position})
+
+        span = max(abs(angles_list[f"{axis}_finish"] - angles_list[f"{axis}_start"]) for axis in self.position)
+        samples = max(2, int(round(span / SIM_SWEEP_STEP)) + 1)
+        az = np.linspace(angles_list["az_start"], angles_list["az_finish"], samples)
+        el = np.linspace(angles_list["el_start"], angles_list["el_finish"], samples)
+        phi, theta, freq_hz, enabled = simulated_array.state()
+
+        gain_db, phase_deg = array_model.pattern(az, el, phi, theta, freq_hz)
+        if not enabled:
+            gain_db = gain_db - 60.0
+        gain_db = gain_db + self._rng.normal(0.0, SIM_NOISE_DB, samples)
+
+        self._wait(span / SWEEP_SPEED)
+        self.position.update({axis: angles_list[f"{axis}_finish"] for axis in self.position})
+        self.sweep_count += 1
+
+        self.last_measurement = {
+            "sweep_name": self.sweep_name,
+            "freq_hz": freq_hz,
+            "phi": phi,
+            "theta": theta,
+            "az": az,
+            "el": el,
+            "gain_db": gain_db,
+            "phase_deg": phase_deg,
+        }
+        for listener in self.listeners:
+            listener(self.last_measurement)
+
+    def run_frequency_stepped_sweep(
+        self,
+        angles_list: Dict[str, float],
+        ku_freqs: List[int],
+        retune: Callable[[int], None],
+        step: float = FREQUENCY_STEP
+    ) -> None:
+        """
+        Step along the cut and at every position retune the array to each frequency in
+        turn and capture it, reversing the frequency order at alternate positions.
+        Records one measurement per frequency in last_measurements.
+        """
+        self.move_to({axis: angles_list[f"{axis}_start"] for axis in self.position})
+
+        travel = max(
+            abs(angles_list[f"{axis}_finish"] - angles_list[f"{axis}_start"]) / POSITIONER_SPEED[axis]
+            for axis in self.position
+        )
+        span = max(abs(angles_list[f"{axis}_finish"] - angles_list[f"{axis}_start"]) for axis in self.position)
+        steps = max(1, int(round(span / step)))
+        az = np.linspace(angles_list["az_start"], angles_list["az_finish"], steps + 1)
+        el = np.linspace(angles_list["el_start"], angles_list["el_finish"], steps + 1)
+        gain_db = {ku_freq: np.empty(steps + 1) for ku_freq in ku_freqs}
+        phase_deg = {ku_freq: np.empty(steps + 1) for ku_freq in ku_freqs}
+        steering = {}
+
+        for index in range(steps + 1):
+            if index > 0:
+                self._wait(travel / steps + FREQUENCY_STEP_SETTLE_TIME)
+            # Alternate the frequency order so each position starts where the last one ended
+            for ku_freq in (ku_freqs if index % 2 == 0 else ku_freqs[::-1]):
+                retune(ku_freq)
+                phi, theta, freq_hz, enabled = simulated_array.state()
+                gain, phase = array_model.pattern(az[index], el[index], phi, theta, freq_hz)
+                gain_db[ku_freq][index] = gain[0] - (0.0 if enabled else 60.0)
+                phase_deg[ku_freq][index] = phase[0]
+                steering[ku_freq] = (phi, theta, freq_hz)
+                self._wait(FREQUENCY_RETUNE_TIME)
+
+        self.position.update({axis: angles_list[f"{axis}_finish"] for axis in self.position})
+        self.sweep_count += 1
+
+        self.last_measurements = {}
+        for ku_freq in ku_freqs:
+            phi, theta, freq_hz = steering[ku_freq]
+            self.last_measurements[ku_freq] = {
+                "sweep_name": self.sweep_name,
+                "freq_hz": freq_hz,
+                "phi": phi,
+                "theta": theta,
+                "az": az,
+                "el": el,
+                "gain_db": gain_db[ku_freq] + self._rng.normal(0.0, SIM_NOISE_DB, steps + 1),
+                "phase_deg": phase_deg[ku_freq],
+            }
+            for listener in self.listeners:
+                listener(self.last_measurements[ku_freq])
+        self.last_measurement = self.last_measurements[ku_freqs[-1]]
+
+    def summary(self) -> str:
+        return (f"{self.sweep_count} simulated sweeps, {self.simulated_time / 60:.1f} min of chamber time, "
+                f"{simulated_array.message_count} array messages")
+
+    def _wait(self, seconds: float) -> None:
+        self.simulated_time += seconds
+        if SIM_TIME_SCALE > 0:
+            time.sleep(seconds * SIM_TIME_SCALE)
@@ -0,0 +1,222 @@
+"""
+================================================================================
+Sweep planner for chamber campaigns
+Orders the (phi, theta, frequency) grid to minimise positioner travel, estimates
+the campaign time before it starts, and runs the sweeps as a pipeline in which
+the next array configuration is built while the current sweep runs and is sent
+while the positioner moves to the next start position. A frequency-stepped point
+captures several frequencies at every step of one cut.
+================================================================================
+"""
+
+import asyncio
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, Dict, List, NamedTuple, Optional, Tuple
+
+from ..config import (
+    POSITIONER_SPEED, POSITIONER_SETTLE_TIME, SWEEP_SPEED, ARRAY_CONFIG_TIME,
+    SWEEP_BOTH_DIRECTIONS, FREQUENCY_STEP, FREQUENCY_STEP_SETTLE_TIME, FREQUENCY_RETUNE_TIME
+)
+
+AXES = ("az", "el", "pol", "horn")
+
+
+class SweepPoint(NamedTuple):
+    ku_freq: int
+    phi: float
+    theta: float
+    angles: Dict[str, float]  # Sweep start and finish per axis, as for run_sweep_test_swt
+    ku_freqs: Tuple[int, ...] = ()  # Frequencies captured at each step of a frequency-stepped cut
+
+
+def _start(angles: Dict[str, float]) -> Dict[str, float]:
+    return {axis: angles[f"{axis}_start"] for axis in AXES}
+
+
+def _finish(angles: Dict[str, float]) -> Dict[str, float]:
+    return {axis: angles[f"{axis}_finish"] for axis in AXES}
+
+
+def _reversed(angles: Dict[str, float]) -> Dict[str, float]:
+    """The same cut swept from finish to start."""
+    result = dict(angles)
+    for axis in AXES:
+        result[f"{axis}_start"], result[f"{axis}_finish"] = angles[f"{axis}_finish"], angles[f"{axis}_start"]
+    return result
+
+
+class SweepPlanner:
+    def __init__(
+        self,
+        speeds: Dict[str, float] = POSITIONER_SPEED,
+        settle_time: float = POSITIONER_SETTLE_TIME,
+        sweep_speed: float = SWEEP_SPEED,
+        config_time: float = ARRAY_CONFIG_TIME,
+        allow_reverse: bool = SWEEP_BOTH_DIRECTIONS,
+        step: float = FREQUENCY_STEP,
+        step_settle_time: float = FREQUENCY_STEP_SETTLE_TIME,
+        retune_time: float = FREQUENCY_RETUNE_TIME
+    ):
+        self.speeds = speeds
+        self.settle_time = settle_time
+        self.sweep_speed = sweep_speed
+        self.config_time = config_time
+        self.allow_reverse = allow_reverse
+        self.step = step
+        self.step_settle_time = step_settle_time
+        self.retune_time = retune_time
+
+    def move_time(self, source: Dict[str, float], target: Dict[str, float]) -> float:
+        """Time for a move with all axes running together."""
+        longest = max(abs(target[axis] - source[axis]) / self.speeds[axis] for axis in AXES)
+        return longest + self.settle_time if longest > 0 else 0.0
+
+    def sweep_time(self, angles: Dict[str, float]) -> float:
+        """Time for the measured sweep itself."""
+        start, finish = _start(angles), _finish(angles)
+        return max(abs(finish[axis] - start[axis]) for axis in AXES) / self.sweep_speed
+
+    def step_count(self, angles: Dict[str, float]) -> int:
+        """Positioner steps along a frequency-stepped cut, at least one."""
+        start, finish = _start(angles), _finish(angles)
+        return max(1, int(round(max(abs(finish[axis] - start[axis]) for axis in AXES) / self.step)))
+
+    def stepped_sweep_time(self, angles: Dict[str, float], frequency_count: int) -> float:
+        """
+        Time for a frequency-stepped cut: the travel of the cut, a settle after every
+        step, and a retune and capture per frequency at each of the steps + 1 positions.
+        """
+        start, finish = _start(angles), _finish(angles)
+        steps = self.step_count(angles)
+        travel = max(abs(finish[axis] - start[axis]) / self.speeds[axis] for axis in AXES)
+        return travel + steps * self.step_settle_time + (steps + 1) * frequency_count * self.retune_time
+
+    def point_time(self, point: SweepPoint) -> float:
+        """Measurement time of a point, stepped or swept."""
+        if point.ku_freqs:
+            return self.stepped_sweep_time(point.angles, len(point.ku_freqs))
+        return self.sweep_time(point.angles)
+
+    def plan(self, points: List[SweepPoint], position: Optional[Dict[str, float]] = None) -> List[SweepPoint]:
+        """
+        Order the points greedily by the move time from the end of the previous sweep.
+        When reversing is allowed each cut may also be swept from finish to start, which
+        turns a grid of identical cuts into a back-and-forth with no return moves.
+        Points at the same position keep their order, so frequencies at one angle stay
+        together.
+        """
+        remaining = list(points)
+        ordered = []
+        if position is None and remaining:
+            position = _start(remaining[0].angles)
+
+        while remaining:
+            best_index, best_angles, best_time = 0, None, None
+            for index, point in enumerate(remaining):
+                options = [point.angles, _reversed(point.angles)] if self.allow_reverse else [point.angles]
+                for angles in options:
+                    move = self.move_time(position, _start(angles))
+                    if best_time is None or move < best_time:
+                        best_index, best_angles, best_time = index, angles, move
+
+            point = remaining.pop(best_index)._replace(angles=best_angles)
+            ordered.append(point)
+            position = _finish(point.angles)
+
+        return ordered
+
+    def estimate(self, plan: List[SweepPoint], position: Optional[Dict[str, float]] = None) -> Dict[str, float]:
+        """
+        Estimate the campaign time. In the pipeline the array is configured during the
+        move to each start position, so a step costs the longer of the two.
+        """
+        totals = {"move": 0.0, "sweep": 0.0, "config": 0.0, "sequential": 0.0, "pipelined": 0.0}
+        if plan and position is None:
+            position = _start(plan[0].angles)
+
+        for point in plan:
+            move = self.move_time(position, _start(point.angles))
+            sweep = self.point_time(point)
+            totals["move"] += move
+            totals["sweep"] += sweep
+            totals["config"] += self.config_time
+            totals["sequential"] += self.config_time + move + sweep
+            totals["pipelined"] += max(self.config_time, move) + sweep
+            position = _finish(point.angles)
+
+        return totals
+
+    @staticmethod
+    def travel(plan: List[SweepPoint], position: Optional[Dict[str, float]] = None) -> float:
+        """Total positioner travel between sweeps in degrees, summed over axes."""
+        total = 0.0
+        if plan and position is None:
+            position = _start(plan[0].angles)
+        for point in plan:
+            start = _start(point.angles)
+            total += sum(abs(start[axis] - position[axis]) for axis in AXES)
+            position = _finish(point.angles)
+        return total
+
+
+class SweepPipeline:
+    """
+    Runs a planned campaign with three stages per point: build the array messages,
+    send them while the positioner moves to the sweep start, then sweep. The messages
+    for point i + 1 are built while point i is being swept. The array is never
+    reconfigured during a sweep.
+    """
+
+    def __init__(
+        self,
+        prepare: Callable[[SweepPoint], object],
+        apply: Callable[[object], None],
+        sweep: Callable[[SweepPoint], None],
+        move_to: Optional[Callable[[Dict[str, float]], None]] = None
+    ):
+        self.prepare = prepare
+        self.apply = apply
+        self.sweep = sweep
+        self.move_to = move_to
+        self.stage_times = {"prepare": 0.0, "apply": 0.0, "move": 0.0, "sweep": 0.0}
+
+    def run(self, plan: List[SweepPoint]) -> float:
+        """Run the plan and return the elapsed time in seconds."""
+        start_time = time.perf_counter()
+        asyncio.run(self._run(plan))
+        return time.perf_counter() - start_time
+
+    def _timed(self, stage: str, function: Callable, *args):
+        start_time = time.perf_counter()
+        try:
+            return function(*args)
+        finally:
+            self.stage_times[stage] += time.perf_counter() - start_time
+
+    async def _run(self, plan: List[SweepPoint]) -> None:
+        if not plan:
+            return
+
+        loop = asyncio.get_running_loop()
+        with ThreadPoolExecutor(max_workers=2) as pool:
+            prepared = await loop.run_in_executor(pool, self._timed, "prepare", self.prepare, plan[0])
+
+            for index, point in enumerate(plan):
+                # Configure the array while the positioner moves to the start of the cut
+                stages = [loop.run_in_executor(pool, self._timed, "apply", self.apply, prepared)]
+                if self.move_to is not None:
+                    stages.append(loop.run_in_executor(
+                        pool, self._timed, "move", self.move_to, _start(point.angles)
+                    ))
+                await asyncio.gather(*stages)
+
+                # Build the next configuration while this cut is measured
+                next_prepared = None
+                if index + 1 < len(plan):
+                    next_prepared = loop.run_in_executor(pool, self._timed, "prepare", self.prepare, plan[index + 1])
+
+                await loop.run_in_executor(pool, self._timed, "sweep", self.sweep, point)
+
+                if next_prepared is not None:
+                    prepared = await next_prepared
@@ -12,39 +12,76 @@ Date: 2024-10-16
 ================================================================================
 """
 
-# from ChamberClass import ChamberClass
-# from ChamberInfo import CHAMBER
+import os
+from datetime import datetime
 
-from lib.array_controller import ArrayController
-from lib.chamber_controller import ChamberController
-from config import MODEM_FREQ, KU_FREQ_RANGE
+from .lib.array_controller import ArrayController
+from .lib.chamber_controller import ChamberController
+from .lib import simulator
+from .lib.measurement_store import MeasurementStore
+from .config import (
+    BACKEND, MODEM_FREQ, KU_FREQ_RANGE, MEASUREMENT_STORE, MEASUREMENT_STORE_PATH
+)
 
 
-def run_static_pose_sweep():
+def create_chamber():
+    """Create the chamber sweep object for the configured back-end."""
+    if BACKEND == "simulator":
+        return simulator.SimulatedChamber(
+            sweep_name="Default_file_name",
+            frequency_GHz=(MODEM_FREQ / 1000000000)
+        )
+
+    from ChamberClass import ChamberClass
+    from ChamberInfo import CHAMBER
+    return ChamberClass(
+        sweep_name="Default_file_name",
+        range=CHAMBER,
+        frequency_GHz=(MODEM_FREQ / 1000000000)
+    )
+
+
+def run_static_pose_sweep(array_ctrl: ArrayController):
     """Execute static pose sweep test sequence."""
     print('\n=================================')
     print('Static Pose Sweep')
     print('=================================\n')
 
     # Initialize controllers
-    array_ctrl = ArrayController()
-    chamber_sweep_object = ChamberClass(
-        sweep_name="Default_file_name",
-        range=CHAMBER,
-        frequency_GHz=(MODEM_FREQ / 1000000000)
-    )
-    chamber_ctrl = ChamberController(chamber_sweep_object)
+    chamber_sweep_object = create_chamber()
+    store = None
+    if MEASUREMENT_STORE and not hasattr(chamber_sweep_object, "last_measurement"):
+        # ChamberClass saves its own files and does not return the measured cut
+        print("Warning: the measurement store needs a sweep runner that returns measurements, "
+              "this campaign is not stored")
+    elif MEASUREMENT_STORE:
+        campaign = datetime.now().strftime('campaign_%Y-%m-%d_%H-%M-%S')
+        store = MeasurementStore(os.path.join(MEASUREMENT_STORE_PATH, campaign))
+    chamber_ctrl = ChamberController(chamber_sweep_object, store)
+
+    # Run the sweeps for every frequency
+    try:
+        chamber_ctrl.run_campaign(array_ctrl, KU_FREQ_RANGE, MODEM_FREQ)
+    finally:
+        if store is not None:
+            store.close()
+            print(f"{store.sweep_count} sweeps stored in {store.path}")
 
-    # Run sweep sequence for each frequency
-    for ku_freq in KU_FREQ_RANGE:
-        chamber_ctrl.run_sweep_sequence(array_ctrl, ku_freq, MODEM_FREQ)
+    if BACKEND == "simulator":
+        print(chamber_sweep_object.summary())
 
 
 def main():
     """Main execution function."""
+    if BACKEND == "simulator":
+        simulator.install_messages()
+
     array_ctrl = ArrayController()
-    array_ctrl.power_cycle()
-    run_static_pose_sweep()
+    try:
+        array_ctrl.power_cycle()
+        run_static_pose_sweep(array_ctrl)
+    finally:
+        array_ctrl.close()
 
 
 if __name__ == "__main__":
@@ -0,0 +1,108 @@
+"""
+================================================================================
+Tests for the array controller message dispatch
+Run from the code/ directory:
+    python3 -m unittest discover -s array_chamber_test/tests -t .
+================================================================================
+"""
+
+import unittest
+from typing import List
+from unittest import mock
+
+from array_chamber_test.lib import array_controller, chamber_controller, simulator
+from array_chamber_test.lib.array_controller import ArrayController
+from array_chamber_test.lib.array_protocol import ArrayProtocol
+from array_chamber_test.lib.chamber_controller import ChamberController
+from array_chamber_test.lib.command_cache import CommandCompiler
+
+
+class RecordingHardware:
+    """Stands in for HardwareInterface and keeps every message it is sent, encoded."""
+
+    def __init__(self):
+        self.messages: List[bytes] = []
+
+    def send_commands(self, commands: List[str], report: bool = True) -> List[bool]:
+        return self.send_messages([f'{command}\r\n'.encode() for command in commands], report)
+
+    def send_frames(self, frames: List[bytes], report: bool = True) -> List[bool]:
+        return self.send_messages(frames, report)
+
+    def send_messages(self, messages: List[bytes], report: bool = True) -> List[bool]:
+        self.messages.extend(messages)
+        return [True] * len(messages)
+
+    def check_connection(self) -> bool:
+        return True
+
+    def close(self) -> None:
+        pass
+
+
+def recording_controller() -> ArrayController:
+    """An array controller with recorded hardware and an in-memory command cache."""
+    controller = ArrayController()
+    controller.hardware = RecordingHardware()
+    controller.compiler = CommandCompiler(path=None)
+    return controller
+
+
+class ArrayControllerTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        simulator.install_messages()
+
+    def test_binary_protocol_through_control_array(self):
+        with mock.patch.object(array_controller, "ARRAY_INTERFACE", ""), \
+                mock.patch.object(array_controller, "ARRAY_PROTOCOL", "binary"):
+            controller = recording_controller()
+            controller.control_array(11600000000, 180, 20)
+            controller.control_array(11600000000, 180, 20)
+
+        messages = controller.hardware.messages
+        self.assertEqual(len(messages), 2)
+        first, second = (ArrayProtocol.decode(message) for message in messages)
+        self.assertEqual((first.sequence, second.sequence), (1, 2))
+        self.assertEqual(first.freq_khz, 11600000)
+        self.assertEqual(len(first.arrays), 4)
+        for steer in first.arrays:
+            self.assertAlmostEqual(steer.phi, 180.0)
+            self.assertAlmostEqual(steer.theta, 20.0)
+
+    def test_binary_protocol_through_the_sequential_sweep(self):
+        with mock.patch.object(array_controller, "ARRAY_INTERFACE", ""), \
+                mock.patch.object(chamber_controller, "ARRAY_INTERFACE", ""), \
+                mock.patch.object(array_controller, "ARRAY_PROTOCOL", "binary"):
+            controller = recording_controller()
+            chamber = ChamberController(simulator.SimulatedChamber())
+            chamber.run_sweep_sequence(controller, 11600000000, 1500000000)
+
+        messages = controller.hardware.messages
+        self.assertEqual(len(messages), chamber.sweep_runner.sweep_count)
+        self.assertTrue(all(message.startswith(ArrayProtocol.SYNC) for message in messages))
+
+    def test_ascii_protocol_through_control_array(self):
+        with mock.patch.object(array_controller, "ARRAY_INTERFACE", ""), \
+                mock.patch.object(array_controller, "ARRAY_PROTOCOL", "ascii"):
+            controller = recording_controller()
+            controller.control_array(11600000000, 180, 20)
+
+        messages = controller.hardware.messages
+        self.assertGreater(len(messages), 1)
+        self.assertFalse(any(message.startswith(ArrayProtocol.SYNC) for message in messages))
+
+    def test_pose_interface_through_control_array(self):
+        with mock.patch.object(array_controller, "ARRAY_INTERFACE", "app_cli_message_forewarding"), \
+                mock.patch.object(array_controller, "ARRAY_PROTOCOL", "binary"):
+            controller = recording_controller()
+            controller.control_array(11600000000, 180, 20)
+            count = len(controller.hardware.messages)
+            controller.control_pose(180, 20)
+
+        messages = controller.hardware.messages
+        self.assertGreater(count, 0)
+        self.assertEqual(messages[:count], messages[count:])
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,131 @@
+"""
+================================================================================
+Tests for the chamber controller sweep paths
+Run from the code/ directory:
+    python3 -m unittest discover -s array_chamber_test/tests -t .
+================================================================================
+"""
+
+import contextlib
+import io
+import unittest
+from collections import Counter
+from unittest import mock
+
+from array_chamber_test.lib import array_controller, chamber_controller, simulator
+from array_chamber_test.lib.array_protocol import ArrayProtocol
+from array_chamber_test.lib.chamber_controller import ChamberController
+from array_chamber_test.lib.sweep_planner import SweepPlanner, SweepPoint
+from array_chamber_test.tests.test_array_controller import recording_controller
+
+
+class StaticChamber:
+    """Stands in for ChamberClass: it moves the positioner itself and returns no measurements."""
+
+    def __init__(self):
+        self.sweep_name = ""
+        self.sweep_count = 0
+
+    def run_sweep_test_swt(self, angles_list, save_path: str = "", sPar: bool = False) -> None:
+        self.sweep_count += 1
+
+
+class ChamberControllerTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        simulator.install_messages()
+
+    @staticmethod
+    def _campaign_messages(interface: str, protocol: str, pipelined: bool) -> Counter:
+        """Messages sent by one campaign, with frames restamped so the two paths compare."""
+        with mock.patch.object(array_controller, "ARRAY_INTERFACE", interface), \
+                mock.patch.object(chamber_controller, "ARRAY_INTERFACE", interface), \
+                mock.patch.object(array_controller, "ARRAY_PROTOCOL", protocol), \
+                mock.patch.object(chamber_controller, "SWEEP_PIPELINED", pipelined), \
+                mock.patch.object(chamber_controller, "SWEEP_FREQUENCY_STEPPED", False), \
+                mock.patch.object(chamber_controller, "THETA_RANGE_ADAPTIVE", False):
+            controller = recording_controller()
+            ChamberController(simulator.SimulatedChamber()).run_campaign(
+                controller, [11600000000, 12000000000], 1500000000
+            )
+
+        return Counter(
+            ArrayProtocol.restamp(message, 0) if message.startswith(ArrayProtocol.SYNC) else message
+            for message in controller.hardware.messages
+        )
+
+    def test_pipelined_and_sequential_paths_send_the_same_messages(self):
+        for interface, protocol in [
+            ("", "ascii"),
+            ("", "binary"),
+            ("app_cli_message_forewarding", "ascii"),
+            ("app_cli_pointing_generator", "ascii"),
+        ]:
+            with self.subTest(interface=interface, protocol=protocol):
+                sequential = self._campaign_messages(interface, protocol, pipelined=False)
+                pipelined = self._campaign_messages(interface, protocol, pipelined=True)
+                self.assertGreater(sum(sequential.values()), 0)
+                self.assertEqual(sequential, pipelined)
+
+    def test_runner_without_moves_is_estimated_sequentially(self):
+        chamber_ctrl = ChamberController(StaticChamber())
+        planner = SweepPlanner()
+        points = [
+            SweepPoint(11600000000, 0, theta, chamber_ctrl._calculate_sweep_angles(True, 0, theta))
+            for theta in (10, 20, 30)
+        ]
+        expected = planner.estimate(planner.plan(points))
+
+        with contextlib.redirect_stdout(io.StringIO()):
+            estimated = chamber_ctrl._run_points(recording_controller(), planner, points, 1500000000)
+
+        self.assertEqual(chamber_ctrl.sweep_runner.sweep_count, len(points))
+        self.assertEqual(estimated, expected["sequential"])
+        self.assertGreater(expected["sequential"], expected["pipelined"])
+
+    def _adaptive_campaign(self, runner) -> str:
+        """Output of an adaptive campaign over one cut set."""
+        output = io.StringIO()
+        with mock.patch.object(chamber_controller, "SWEEP_PIPELINED", True), \
+                mock.patch.object(chamber_controller, "THETA_RANGE_ADAPTIVE", True), \
+                mock.patch.object(chamber_controller, "SWEEP_FREQUENCY_STEPPED", False), \
+                mock.patch.object(chamber_controller, "PHI_RANGE", [0]), \
+                contextlib.redirect_stdout(output):
+            ChamberController(runner).run_campaign(recording_controller(), [11600000000], 1500000000)
+        return output.getvalue()
+
+    def test_adaptive_sampling_falls_back_without_measurements(self):
+        runner = StaticChamber()
+        output = self._adaptive_campaign(runner)
+
+        self.assertIn("Warning: adaptive sampling needs a sweep runner that returns measurements", output)
+        self.assertNotIn("saving", output)
+        self.assertEqual(runner.sweep_count, len(chamber_controller.THETA_RANGE))
+
+    def test_adaptive_sampling_falls_back_when_no_measurement_arrives(self):
+        runner = StaticChamber()
+        runner.last_measurement = None
+        output = self._adaptive_campaign(runner)
+
+        self.assertIn("Warning: the sweep runner returned no measurement", output)
+        self.assertNotIn("saving", output)
+        self.assertEqual(runner.sweep_count, len(chamber_controller.THETA_RANGE))
+
+    def test_stepped_sweep_falls_back_without_a_stepping_runner(self):
+        runner = StaticChamber()
+        output = io.StringIO()
+        with mock.patch.object(chamber_controller, "ARRAY_INTERFACE", ""), \
+                mock.patch.object(chamber_controller, "SWEEP_PIPELINED", False), \
+                mock.patch.object(chamber_controller, "THETA_RANGE_ADAPTIVE", False), \
+                mock.patch.object(chamber_controller, "SWEEP_FREQUENCY_STEPPED", True), \
+                mock.patch.object(chamber_controller, "PHI_RANGE", [0]), \
+                contextlib.redirect_stdout(output):
+            ChamberController(runner).run_campaign(recording_controller(), [11600000000, 12000000000], 1500000000)
+
+        self.assertIn("Warning: the sweep runner cannot step a cut", output.getvalue())
+        self.assertNotIn("Stepping", output.getvalue())
+        self.assertEqual(runner.sweep_count, 2 * len(chamber_controller.THETA_RANGE))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,43 @@
+"""
+================================================================================
+Tests for the compiled array command cache
+Run from the code/ directory:
+    python3 -m unittest discover -s array_chamber_test/tests -t .
+================================================================================
+"""
+
+import os
+import tempfile
+import unittest
+from unittest import mock
+
+from array_chamber_test.lib import simulator
+from array_chamber_test.lib.array_controller import ArrayController
+from array_chamber_test.lib.command_cache import CommandCompiler, messages_fingerprint
+
+
+def _pose_commands_v2(phi_angle: int, theta_angle: int) -> list:
+    return [f"pose v2 {phi_angle} {theta_angle}"]
+
+
+class CommandCacheTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        simulator.install_messages()
+
+    def test_builder_change_discards_the_saved_cache(self):
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "cache.json")
+            compiler = CommandCompiler(path)
+            compiler.compile(("pose", 180.0, 20.0), lambda: ("commands", ["pose 1"]))
+            compiler.save()
+            self.assertEqual(len(CommandCompiler(path)._entries), 1)
+
+            fingerprint = messages_fingerprint()
+            with mock.patch.object(ArrayController, "_get_pose_commands", staticmethod(_pose_commands_v2)):
+                self.assertNotEqual(messages_fingerprint(), fingerprint)
+                self.assertEqual(len(CommandCompiler(path)._entries), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
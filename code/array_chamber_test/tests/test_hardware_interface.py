@@ -0,0 +1,37 @@
+"""
+================================================================================
+Tests for the pipelined serial session to the array controller
+Run from the code/ directory:
+    python3 -m unittest discover -s array_chamber_test/tests -t .
+================================================================================
+"""
+
+import unittest
+from unittest import mock
+
+from array_chamber_test.lib import hardware_interface
+from array_chamber_test.lib.array_protocol import ArrayProtocol, ArraySteer, BulkUpdate
+from array_chamber_test.lib.hardware_interface import HardwareInterface
+
+
+def _frame(sequence: int) -> bytes:
+    update = BulkUpdate(sequence, 0, 1, 11600000, 1000000, 0, [ArraySteer(0, 180.0, 20.0, 0.0, 0.0, 0)])
+    return ArrayProtocol.encode(update)
+
+
+class HardwareInterfaceTest(unittest.TestCase):
+    def test_error_response_completes_its_own_command(self):
+        # The simulated array answers the corrupted frame with ERROR
+        corrupted = bytearray(_frame(2))
+        corrupted[-1] ^= 0xFF
+        messages = [_frame(1), bytes(corrupted), _frame(3), _frame(4)]
+
+        with mock.patch.object(hardware_interface, "BACKEND", "simulator"):
+            with HardwareInterface(pipeline_depth=4, pacing=0.0, response_timeout=1.0) as hardware:
+                results = hardware.send_messages(messages, report=False)
+
+        self.assertEqual(results, [True, False, True, True])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,329 @@
+/**
+ * @file array_control_protocol.c
+ * @brief Implementation of the binary array control protocol.
+ *
+ * The decoder is fed one byte at a time from the UART receive path and needs no
+ * heap and no string parsing: it hunts for the sync bytes, takes the frame size
+ * from the length field and runs a table-driven CRC as the bytes arrive, so a
+ * completed frame only needs a compare before its fields are unpacked. A frame that
+ * fails any check is dropped and the decoder goes back to hunting for sync.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include "array_control_protocol.h"
+
+#define CENTI                       100.0f
+
+static const uint16_t crc16_table[256] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+ *
+ * @param data The bytes to check.
+ * @param size Number of bytes.
+ * @return The CRC.
+ */
+uint16_t array_control_crc16(const uint8_t *data, size_t size)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ data[i]]);
+    }
+
+    return crc;
+}
+
+static uint8_t *_put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+static uint8_t *_put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+static uint16_t _get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t _get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Scale to hundredths and saturate to a signed 16-bit field.
+ */
+static int16_t _to_centi(float value)
+{
+    long centi = lroundf(value * CENTI);
+
+    if (centi > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (centi < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)centi;
+}
+
+/**
+ * @brief Encode a bulk update frame.
+ *
+ * @param update The update to encode.
+ * @param frame Output buffer.
+ * @param frame_size Size of the output buffer.
+ * @param size Output number of bytes written.
+ * @return OK if the frame was encoded, ERROR if the update or buffer is invalid.
+ */
+STATUS array_control_encode(const struct array_control_update_t *update, uint8_t *frame, size_t frame_size,
+                            size_t *size)
+{
+    if (update->array_count > ARRAY_CONTROL_MAX_ARRAYS)
+    {
+        return ERROR;
+    }
+
+    const uint16_t payload_size = ARRAY_CONTROL_COMMON_SIZE + update->array_count * ARRAY_CONTROL_ARRAY_SIZE;
+    const size_t total = ARRAY_CONTROL_HEADER_SIZE + payload_size + ARRAY_CONTROL_CRC_SIZE;
+
+    if (frame_size < total)
+    {
+        return ERROR;
+    }
+
+    uint8_t *p = frame;
+    *p++ = ARRAY_CONTROL_SYNC_0;
+    *p++ = ARRAY_CONTROL_SYNC_1;
+    *p++ = ARRAY_CONTROL_VERSION;
+    *p++ = ARRAY_CONTROL_TYPE_BULK_UPDATE;
+    *p++ = update->sequence;
+    p = _put_u16(p, payload_size);
+
+    *p++ = update->channel;
+    *p++ = update->band_code;
+    p = _put_u32(p, update->freq_khz);
+    p = _put_u32(p, update->if_freq_khz);
+    *p++ = update->if_atten_code;
+    *p++ = update->array_count;
+
+    for (int i = 0; i < update->array_count; i++)
+    {
+        const struct array_control_steer_t *steer = &update->arrays[i];
+        float phi = fmodf(steer->phi, 360.0f);
+
+        *p++ = steer->array;
+        *p++ = steer->enable ? ARRAY_CONTROL_FLAG_ENABLE : 0;
+        p = _put_u16(p, (uint16_t)(lroundf(((phi < 0.0f) ? phi + 360.0f : phi) * CENTI) % 36000));
+        p = _put_u16(p, (uint16_t)_to_centi(steer->theta));
+        p = _put_u16(p, (uint16_t)_to_centi(steer->gain));
+        p = _put_u16(p, (uint16_t)_to_centi(steer->pol));
+        *p++ = steer->atten_code;
+    }
+
+    p = _put_u16(p, array_control_crc16(frame + 2, (size_t)(p - frame) - 2));
+    *size = (size_t)(p - frame);
+
+    return OK;
+}
+
+/**
+ * @brief Decode the fields of a frame whose size and CRC have been checked.
+ */
+static STATUS _decode_fields(const uint8_t *frame, struct array_control_update_t *update)
+{
+    const uint16_t payload_size = _get_u16(&frame[5]);
+
+    if (frame[2] != ARRAY_CONTROL_VERSION || frame[3] != ARRAY_CONTROL_TYPE_BULK_UPDATE ||
+        payload_size < ARRAY_CONTROL_COMMON_SIZE)
+    {
+        return ERROR;
+    }
+
+    const uint8_t *p = &frame[ARRAY_CONTROL_HEADER_SIZE];
+    const uint8_t array_count = p[11];
+    if (array_count > ARRAY_CONTROL_MAX_ARRAYS ||
+        payload_size != ARRAY_CONTROL_COMMON_SIZE + array_count * ARRAY_CONTROL_ARRAY_SIZE)
+    {
+        return ERROR;
+    }
+
+    memset(update, 0, sizeof(*update));
+    update->sequence = frame[4];
+    update->channel = p[0];
+    update->band_code = p[1];
+    update->freq_khz = _get_u32(&p[2]);
+    update->if_freq_khz = _get_u32(&p[6]);
+    update->if_atten_code = p[10];
+    update->array_count = array_count;
+    p += ARRAY_CONTROL_COMMON_SIZE;
+
+    for (int i = 0; i < array_count; i++, p += ARRAY_CONTROL_ARRAY_SIZE)
+    {
+        struct array_control_steer_t *steer = &update->arrays[i];
+
+        steer->array = p[0];
+        steer->enable = (p[1] & ARRAY_CONTROL_FLAG_ENABLE) != 0;
+        steer->phi = _get_u16(&p[2]) / CENTI;
+        steer->theta = (int16_t)_get_u16(&p[4]) / CENTI;
+        steer->gain = (int16_t)_get_u16(&p[6]) / CENTI;
+        steer->pol = (int16_t)_get_u16(&p[8]) / CENTI;
+        steer->atten_code = p[10];
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Decode a complete bulk update frame.
+ *
+ * @param frame The frame, starting at the sync bytes.
+ * @param size Number of bytes in the frame.
+ * @param update Output update.
+ * @return OK if the frame is a valid bulk update, ERROR otherwise.
+ */
+STATUS array_control_decode(const uint8_t *frame, size_t size, struct array_control_update_t *update)
+{
+    if (size < ARRAY_CONTROL_HEADER_SIZE + ARRAY_CONTROL_CRC_SIZE ||
+        frame[0] != ARRAY_CONTROL_SYNC_0 || frame[1] != ARRAY_CONTROL_SYNC_1 ||
+        size != (size_t)ARRAY_CONTROL_HEADER_SIZE + _get_u16(&frame[5]) + ARRAY_CONTROL_CRC_SIZE)
+    {
+        return ERROR;
+    }
+    if (array_control_crc16(frame + 2, size - 2 - ARRAY_CONTROL_CRC_SIZE) != _get_u16(&frame[size - 2]))
+    {
+        return ERROR;
+    }
+
+    return _decode_fields(frame, update);
+}
+
+/**
+ * @brief Initialize a byte stream decoder.
+ *
+ * @param decoder The decoder.
+ */
+void array_control_decoder_init(struct array_control_decoder_t *decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/**
+ * @brief Feed one received byte to the decoder.
+ *
+ * @param decoder The decoder.
+ * @param byte The received byte.
+ * @param update Output update, written when a frame completes.
+ * @return True if the byte completed a valid frame.
+ */
+bool array_control_decoder_feed(struct array_control_decoder_t *decoder, uint8_t byte,
+                                struct array_control_update_t *update)
+{
+    if (decoder->size == 0 && byte != ARRAY_CONTROL_SYNC_0)
+    {
+        return false;
+    }
+    if (decoder->size == 1 && byte != ARRAY_CONTROL_SYNC_1)
+    {
+        decoder->size = (byte == ARRAY_CONTROL_SYNC_0) ? 1 : 0;
+        return false;
+    }
+    if (decoder->size == 0)
+    {
+        decoder->crc = 0xFFFF;
+    }
+
+    decoder->frame[decoder->size++] = byte;
+
+    // The CRC runs as the bytes arrive, up to the CRC field itself
+    if (decoder->size > 2 && (decoder->expected == 0 || decoder->size <= decoder->expected - ARRAY_CONTROL_CRC_SIZE))
+    {
+        decoder->crc = (uint16_t)((decoder->crc << 8) ^ crc16_table[(decoder->crc >> 8) ^ byte]);
+    }
+
+    if (decoder->size == ARRAY_CONTROL_HEADER_SIZE)
+    {
+        const uint16_t payload_size = _get_u16(&decoder->frame[5]);
+
+        if (payload_size > ARRAY_CONTROL_MAX_PAYLOAD_SIZE)
+        {
+            decoder->format_errors++;
+            decoder->size = 0;
+            return false;
+        }
+        decoder->expected = ARRAY_CONTROL_HEADER_SIZE + payload_size + ARRAY_CONTROL_CRC_SIZE;
+    }
+
+    if (decoder->size < ARRAY_CONTROL_HEADER_SIZE || decoder->size < decoder->expected)
+    {
+        return false;
+    }
+
+    const size_t size = decoder->size;
+    decoder->size = 0;
+    decoder->expected = 0;
+
+    if (decoder->crc != _get_u16(&decoder->frame[size - 2]))
+    {
+        decoder->crc_errors++;
+        return false;
+    }
+    if (_decode_fields(decoder->frame, update) != OK)
+    {
+        decoder->format_errors++;
+        return false;
+    }
+
+    decoder->frame_count++;
+    return true;
+}
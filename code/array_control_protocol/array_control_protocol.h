@@ -0,0 +1,91 @@
+/**
+ * @file array_control_protocol.h
+ * @brief Header file for the binary array control protocol.
+ *
+ * A bulk update frame carries the band and channel configuration, the IF attenuation
+ * and the steering, gain, polarisation and BPL attenuation of every array in one
+ * CRC protected frame, in place of one ASCII command per array and per attenuator.
+ * The same frame layout is produced by `array_chamber_test/lib/array_protocol.py`.
+ *
+ * Frame layout, multi-byte fields little-endian:
+ *
+ *   0   sync        0xA5 0x5A
+ *   2   version     ARRAY_CONTROL_VERSION
+ *   3   type        ARRAY_CONTROL_TYPE_BULK_UPDATE
+ *   4   sequence    Echoed in the acknowledgement
+ *   5   length      Payload bytes (u16)
+ *   7   payload     channel, band code, RF kHz (u32), IF kHz (u32), IF attenuation,
+ *                   array count, then per array: id, flags, phi (u16), theta (i16),
+ *                   gain (i16), pol (i16), BPL attenuation
+ *   7+n crc         CRC-16/CCITT-FALSE over version to the end of the payload (u16)
+ *
+ * Angles are in 0.01 degree and gain in 0.01 dB.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+#define ARRAY_CONTROL_SYNC_0                0xA5
+#define ARRAY_CONTROL_SYNC_1                0x5A
+#define ARRAY_CONTROL_VERSION               1
+#define ARRAY_CONTROL_TYPE_BULK_UPDATE      0x01
+
+#define ARRAY_CONTROL_MAX_ARRAYS            4
+#define ARRAY_CONTROL_HEADER_SIZE           7
+#define ARRAY_CONTROL_CRC_SIZE              2
+#define ARRAY_CONTROL_COMMON_SIZE           12      // Payload bytes before the arrays
+#define ARRAY_CONTROL_ARRAY_SIZE            11      // Payload bytes per array
+#define ARRAY_CONTROL_MAX_PAYLOAD_SIZE      (ARRAY_CONTROL_COMMON_SIZE + ARRAY_CONTROL_MAX_ARRAYS * ARRAY_CONTROL_ARRAY_SIZE)
+#define ARRAY_CONTROL_MAX_FRAME_SIZE        (ARRAY_CONTROL_HEADER_SIZE + ARRAY_CONTROL_MAX_PAYLOAD_SIZE + ARRAY_CONTROL_CRC_SIZE)
+
+#define ARRAY_CONTROL_FLAG_ENABLE           0x01
+
+struct array_control_steer_t
+{
+    uint8_t array;
+    bool enable;
+    float phi;                  // Degrees, 0 to 360
+    float theta;                // Degrees
+    float gain;                 // dB
+    float pol;                  // Degrees
+    uint8_t atten_code;         // BPL attenuation code
+};
+
+struct array_control_update_t
+{
+    uint8_t sequence;
+    uint8_t channel;
+    uint8_t band_code;
+    uint32_t freq_khz;
+    uint32_t if_freq_khz;
+    uint8_t if_atten_code;
+    uint8_t array_count;
+    struct array_control_steer_t arrays[ARRAY_CONTROL_MAX_ARRAYS];
+};
+
+struct array_control_decoder_t
+{
+    uint8_t frame[ARRAY_CONTROL_MAX_FRAME_SIZE];
+    size_t size;
+    size_t expected;            // Frame size once the length field has arrived, 0 before
+    uint16_t crc;               // Running CRC of the bytes received so far
+    uint32_t frame_count;
+    uint32_t crc_errors;
+    uint32_t format_errors;     // Bad version, type, length or array count
+};
+
+uint16_t array_control_crc16(const uint8_t *data, size_t size);
+STATUS array_control_encode(const struct array_control_update_t *update, uint8_t *frame, size_t frame_size,
+                            size_t *size);
+STATUS array_control_decode(const uint8_t *frame, size_t size, struct array_control_update_t *update);
+
+void array_control_decoder_init(struct array_control_decoder_t *decoder);
+bool array_control_decoder_feed(struct array_control_decoder_t *decoder, uint8_t byte,
+                                struct array_control_update_t *update);
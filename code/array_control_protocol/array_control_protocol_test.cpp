@@ -0,0 +1,287 @@
+/**
+ * @file array_control_protocol_test.cpp
+ * @brief Unit tests for the binary array control protocol.
+ *
+ * This file contains Google Test-based unit tests for the C encoder, decoder and
+ * byte stream decoder. Frames are also round-tripped through the Python encoder in
+ * `array_chamber_test/lib/array_protocol.py`, so both sides are held to the same
+ * layout and CRC. Those tests are skipped when python3 is not available.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+    #include "array_control_protocol.h"
+}
+
+const int BENCHMARK_FRAMES = 1000000;
+
+// Frame produced by array_protocol.py for _reference_update()
+const char *PYTHON_REFERENCE_FRAME =
+    "a55a010107220000028000b10060e316000002000150461efb7d0028230001009f8cb80bd4fe6cee7f2c2e";
+
+static std::string _script_path(void)
+{
+    std::string file(__FILE__);
+    return file.substr(0, file.find_last_of('/') + 1) + "../array_chamber_test/lib/array_protocol.py";
+}
+
+/**
+ * @brief Run the Python encoder or decoder and return its output line.
+ */
+static std::string _run_python(const std::string &command, const std::string &argument)
+{
+    std::string line = "python3 " + _script_path() + " " + command + " '" + argument + "' 2>/dev/null";
+    std::string output;
+    char buffer[1024];
+
+    FILE *pipe = popen(line.c_str(), "r");
+    if (pipe == NULL)
+    {
+        return "";
+    }
+    while (fgets(buffer, sizeof(buffer), pipe) != NULL)
+    {
+        output += buffer;
+    }
+    if (pclose(pipe) != 0)
+    {
+        return "";
+    }
+    while (!output.empty() && (output.back() == '\n' || output.back() == '\r'))
+    {
+        output.pop_back();
+    }
+
+    return output;
+}
+
+static std::string _to_hex(const uint8_t *data, size_t size)
+{
+    std::string hex;
+    char digits[3];
+    for (size_t i = 0; i < size; ++i)
+    {
+        snprintf(digits, sizeof(digits), "%02x", data[i]);
+        hex += digits;
+    }
+    return hex;
+}
+
+static std::vector<uint8_t> _from_hex(const std::string &hex)
+{
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    {
+        bytes.push_back((uint8_t)std::stoul(hex.substr(i, 2), nullptr, 16));
+    }
+    return bytes;
+}
+
+static struct array_control_update_t _reference_update(void)
+{
+    struct array_control_update_t update = {};
+    update.sequence = 7;
+    update.band_code = 2;
+    update.freq_khz = 11600000;
+    update.if_freq_khz = 1500000;
+    update.array_count = 2;
+    update.arrays[0] = {0, true, 180.0f, -12.5f, 1.25f, 90.0f, 0};
+    update.arrays[1] = {1, false, 359.99f, 30.0f, -3.0f, -45.0f, 127};
+    return update;
+}
+
+static void _expect_reference(const struct array_control_update_t &update)
+{
+    EXPECT_EQ(update.sequence, 7);
+    EXPECT_EQ(update.channel, 0);
+    EXPECT_EQ(update.band_code, 2);
+    EXPECT_EQ(update.freq_khz, 11600000u);
+    EXPECT_EQ(update.if_freq_khz, 1500000u);
+    EXPECT_EQ(update.if_atten_code, 0);
+    ASSERT_EQ(update.array_count, 2);
+    EXPECT_TRUE(update.arrays[0].enable);
+    EXPECT_FLOAT_EQ(update.arrays[0].phi, 180.0f);
+    EXPECT_FLOAT_EQ(update.arrays[0].theta, -12.5f);
+    EXPECT_FLOAT_EQ(update.arrays[0].gain, 1.25f);
+    EXPECT_FLOAT_EQ(update.arrays[0].pol, 90.0f);
+    EXPECT_EQ(update.arrays[1].array, 1);
+    EXPECT_FALSE(update.arrays[1].enable);
+    EXPECT_NEAR(update.arrays[1].phi, 359.99f, 1e-3f);
+    EXPECT_FLOAT_EQ(update.arrays[1].pol, -45.0f);
+    EXPECT_EQ(update.arrays[1].atten_code, 127);
+}
+
+TEST(array_control_protocol, Crc16CheckValue) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(array_control_crc16(check, sizeof(check)), 0x29B1);
+}
+
+TEST(array_control_protocol, EncodesTheReferenceFrame) {
+    struct array_control_update_t update = _reference_update();
+    uint8_t frame[ARRAY_CONTROL_MAX_FRAME_SIZE];
+    size_t size = 0;
+
+    ASSERT_EQ(array_control_encode(&update, frame, sizeof(frame), &size), OK);
+    EXPECT_EQ(size, (size_t)ARRAY_CONTROL_HEADER_SIZE + ARRAY_CONTROL_COMMON_SIZE +
+                    2 * ARRAY_CONTROL_ARRAY_SIZE + ARRAY_CONTROL_CRC_SIZE);
+    EXPECT_EQ(_to_hex(frame, size), PYTHON_REFERENCE_FRAME);
+
+    struct array_control_update_t decoded;
+    ASSERT_EQ(array_control_decode(frame, size, &decoded), OK);
+    _expect_reference(decoded);
+
+    // Too small a buffer and too many arrays are refused
+    EXPECT_EQ(array_control_encode(&update, frame, size - 1, &size), ERROR);
+    update.array_count = ARRAY_CONTROL_MAX_ARRAYS + 1;
+    EXPECT_EQ(array_control_encode(&update, frame, sizeof(frame), &size), ERROR);
+}
+
+TEST(array_control_protocol, QuantisesAndWrapsAngles) {
+    struct array_control_update_t update = {};
+    update.array_count = ARRAY_CONTROL_MAX_ARRAYS;
+    update.arrays[0].phi = -90.0f;
+    update.arrays[1].phi = 720.004f;
+    update.arrays[2].theta = 500.0f;
+    update.arrays[3].gain = -0.006f;
+
+    uint8_t frame[ARRAY_CONTROL_MAX_FRAME_SIZE];
+    size_t size;
+    struct array_control_update_t decoded;
+    ASSERT_EQ(array_control_encode(&update, frame, sizeof(frame), &size), OK);
+    EXPECT_EQ(size, (size_t)ARRAY_CONTROL_MAX_FRAME_SIZE);
+    ASSERT_EQ(array_control_decode(frame, size, &decoded), OK);
+
+    EXPECT_FLOAT_EQ(decoded.arrays[0].phi, 270.0f);
+    EXPECT_FLOAT_EQ(decoded.arrays[1].phi, 0.0f);
+    EXPECT_FLOAT_EQ(decoded.arrays[2].theta, 327.67f);
+    EXPECT_FLOAT_EQ(decoded.arrays[3].gain, -0.01f);
+}
+
+TEST(array_control_protocol, RejectsDamagedFrames) {
+    std::vector<uint8_t> frame = _from_hex(PYTHON_REFERENCE_FRAME);
+    struct array_control_update_t update;
+
+    ASSERT_EQ(array_control_decode(frame.data(), frame.size(), &update), OK);
+    EXPECT_EQ(array_control_decode(frame.data(), frame.size() - 1, &update), ERROR);
+
+    for (size_t i = 0; i < frame.size(); ++i)
+    {
+        std::vector<uint8_t> damaged = frame;
+        damaged[i] ^= 0x10;
+        EXPECT_EQ(array_control_decode(damaged.data(), damaged.size(), &update), ERROR) << "byte " << i;
+    }
+}
+
+TEST(array_control_protocol, StreamDecoderResynchronises) {
+    std::vector<uint8_t> frame = _from_hex(PYTHON_REFERENCE_FRAME);
+    std::vector<uint8_t> damaged = frame;
+    damaged[20] ^= 0xFF;
+
+    // ASCII traffic, a false sync, a damaged frame, an oversize length and two good frames
+    std::string text = "OK\r\n> \xa5 status\r\n";
+    std::vector<uint8_t> stream(text.begin(), text.end());
+    stream.insert(stream.end(), damaged.begin(), damaged.end());
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    const uint8_t oversize[] = {0xA5, 0x5A, 0x01, 0x01, 0x00, 0xFF, 0x00};
+    stream.insert(stream.end(), oversize, oversize + sizeof(oversize));
+    stream.push_back(0xA5);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    struct array_control_decoder_t decoder;
+    struct array_control_update_t update;
+    array_control_decoder_init(&decoder);
+    int frames = 0;
+
+    for (uint8_t byte : stream)
+    {
+        if (array_control_decoder_feed(&decoder, byte, &update))
+        {
+            _expect_reference(update);
+            frames++;
+        }
+    }
+
+    EXPECT_EQ(frames, 2);
+    EXPECT_EQ(decoder.frame_count, 2u);
+    EXPECT_EQ(decoder.crc_errors, 1u);
+    EXPECT_EQ(decoder.format_errors, 1u);
+}
+
+TEST(array_control_protocol, RoundTripsThroughPython) {
+    const std::string update_json =
+        "{\"sequence\": 7, \"channel\": 0, \"band_code\": 2, \"freq_khz\": 11600000, \"if_freq_khz\": 1500000, "
+        "\"if_atten_code\": 0, \"arrays\": [{\"array\": 0, \"phi\": 180, \"theta\": -12.5, \"gain\": 1.25, "
+        "\"pol\": 90, \"atten_code\": 0}, {\"array\": 1, \"phi\": 359.99, \"theta\": 30, \"gain\": -3, "
+        "\"pol\": -45, \"atten_code\": 127, \"enable\": false}]}";
+
+    std::string python_frame = _run_python("encode", update_json);
+    if (python_frame.empty())
+    {
+        GTEST_SKIP() << "python3 or " << _script_path() << " not available";
+    }
+
+    // Python encoder to C decoder
+    std::vector<uint8_t> frame = _from_hex(python_frame);
+    struct array_control_update_t update;
+    ASSERT_EQ(array_control_decode(frame.data(), frame.size(), &update), OK);
+    _expect_reference(update);
+
+    // C encoder to Python decoder and back
+    uint8_t encoded[ARRAY_CONTROL_MAX_FRAME_SIZE];
+    size_t size;
+    ASSERT_EQ(array_control_encode(&update, encoded, sizeof(encoded), &size), OK);
+    std::string decoded_json = _run_python("decode", _to_hex(encoded, size));
+    EXPECT_NE(decoded_json.find("\"theta\": -12.5"), std::string::npos) << decoded_json;
+    EXPECT_NE(decoded_json.find("\"enable\": false"), std::string::npos) << decoded_json;
+    EXPECT_EQ(_run_python("encode", decoded_json), python_frame);
+}
+
+/**
+ * @brief Benchmark the byte stream decoder on full four-array frames.
+ */
+TEST(array_control_protocol, BenchmarkStreamDecoder) {
+    struct array_control_update_t update = _reference_update();
+    update.array_count = ARRAY_CONTROL_MAX_ARRAYS;
+    uint8_t frame[ARRAY_CONTROL_MAX_FRAME_SIZE];
+    size_t size;
+    ASSERT_EQ(array_control_encode(&update, frame, sizeof(frame), &size), OK);
+
+    struct array_control_decoder_t decoder;
+    array_control_decoder_init(&decoder);
+    volatile float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < BENCHMARK_FRAMES; ++n)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (array_control_decoder_feed(&decoder, frame[i], &update))
+            {
+                sink = sink + update.arrays[3].theta;
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Bulk update, " << (int)ARRAY_CONTROL_MAX_ARRAYS << " arrays: " << size << " bytes, "
+              << elapsed.count() / BENCHMARK_FRAMES << " ns to decode" << std::endl;
+
+    EXPECT_EQ(decoder.frame_count, (uint32_t)BENCHMARK_FRAMES);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
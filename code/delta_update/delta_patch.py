@@ -0,0 +1,540 @@
+"""
+================================================================================
+Delta firmware patches
+Builds a patch that turns the firmware image running on a tile MCU into a new
+one, so only the change crosses the production link. Unchanged code that moved
+is found with a hash index of the old image and extended bsdiff-style through
+small differences such as relocated addresses; those regions become ADD bytes
+that are mostly zero, new code becomes INSERT bytes, and the record stream is
+LZSS compressed. The layout matches the C applier in
+code/delta_update/delta_update.h.
+
+The flash simulation applies a patch in fixed-size blocks to an A/B slot model
+that enforces sector erase and 1 to 0 programming, checks the CRC, reads the
+staging slot back and swaps, as the target does.
+
+Images are raw binaries or Intel HEX files.
+    python3 delta_patch.py diff <old> <new> <patch> [--window-bits 12]
+    python3 delta_patch.py apply <old> <patch> <new.bin>
+    python3 delta_patch.py simulate <old> <new> [--baud 115200]
+================================================================================
+"""
+
+import argparse
+import struct
+import sys
+import time
+import zlib
+from typing import Dict, Iterator, List, NamedTuple, Tuple
+
+MAGIC = b'DPTC'
+VERSION = 1
+MIN_WINDOW_BITS = 8
+MAX_WINDOW_BITS = 12
+DEFAULT_WINDOW_BITS = 12
+MIN_MATCH = 3
+
+# Diff tuning
+GRAM = 8                # Bytes hashed per old image position
+INDEX_STEP = 4          # Old positions indexed; matches of GRAM + INDEX_STEP bytes are always found
+CANDIDATES = 8          # Old positions kept per hash
+MIN_COPY = 12           # Shortest exact match worth a record
+FUZZ_LIMIT = 16         # Mismatch score below the best before a fuzzy extension stops
+CHAIN_DEPTH = 32        # LZSS hash chain positions searched
+
+# Target defaults, see delta_update.h
+WRITE_BLOCK_SIZE = 256
+PROGRAM_UNIT = 32
+SECTOR_SIZE = 2048
+SLOT_SIZE = 256 * 1024
+
+_HEADER = struct.Struct('<4sBBHIIIII')
+HEADER_SIZE = _HEADER.size + 4
+
+
+class PatchHeader(NamedTuple):
+    window_bits: int
+    old_size: int
+    old_crc: int
+    new_size: int
+    new_crc: int
+    body_size: int
+
+
+class Record(NamedTuple):
+    add: int        # Bytes added to the old image from the current position
+    insert: int     # New bytes that follow
+    seek: int       # Old position change after the record
+
+
+def crc32(data: bytes) -> int:
+    """CRC-32 as zlib and delta_update_crc32()."""
+    return zlib.crc32(data) & 0xFFFFFFFF
+
+
+def load_image(path: str) -> bytes:
+    """Read a raw binary, or an Intel HEX file as one image from its lowest address with gaps of 0xFF."""
+    if not path.lower().endswith('.hex'):
+        with open(path, 'rb') as f:
+            return f.read()
+
+    chunks: Dict[int, bytes] = {}
+    base = 0
+    with open(path) as f:
+        for number, line in enumerate(f, start=1):
+            line = line.strip()
+            if not line:
+                continue
+            record = bytes.fromhex(line[1:]) if line.startswith(':') else b''
+            if len(record) < 5 or len(record) != record[0] + 5 or sum(record) & 0xFF:
+                raise ValueError(f"{path}:{number}: bad Intel HEX record")
+            address, record_type, data = (record[1] << 8) | record[2], record[3], record[4:-1]
+            if record_type == 0x00:
+                chunks[base + address] = data
+            elif record_type == 0x01:
+                break
+            elif record_type == 0x02:
+                base = int.from_bytes(data, 'big') << 4
+            elif record_type == 0x04:
+                base = int.from_bytes(data, 'big') << 16
+
+    if not chunks:
+        return b''
+    start = min(chunks)
+    image = bytearray(b'\xff' * (max(a + len(d) for a, d in chunks.items()) - start))
+    for address, data in chunks.items():
+        image[address - start:address - start + len(data)] = data
+    return bytes(image)
+
+
+# Diff
+
+def _index(old: bytes) -> Dict[bytes, List[int]]:
+    index: Dict[bytes, List[int]] = {}
+    for i in range(0, len(old) - GRAM + 1, INDEX_STEP):
+        positions = index.setdefault(old[i:i + GRAM], [])
+        if len(positions) < CANDIDATES:
+            positions.append(i)
+    return index
+
+
+def _forward(old: bytes, new: bytes, old_pos: int, new_pos: int) -> int:
+    """Length of the exact match, compared a chunk at a time while it holds."""
+    limit = min(len(old) - old_pos, len(new) - new_pos)
+    length, chunk = 0, 64
+    while length < limit:
+        size = min(chunk, limit - length)
+        if old[old_pos + length:old_pos + length + size] == new[new_pos + length:new_pos + length + size]:
+            length += size
+            chunk *= 2
+        elif chunk > 1:
+            chunk = max(1, chunk // 8)
+        else:
+            break
+    return length
+
+
+def _fuzzy(old: bytes, new: bytes, old_pos: int, new_pos: int) -> int:
+    """Extend a match through mismatches while matches still outweigh them."""
+    limit = min(len(old) - old_pos, len(new) - new_pos)
+    score = best = best_length = length = 0
+    while length < limit and score > best - FUZZ_LIMIT:
+        run = _forward(old, new, old_pos + length, new_pos + length)
+        if run:
+            length += run
+            score += run
+            if score > best:
+                best, best_length = score, length
+        else:
+            length += 1
+            score -= 1
+    return best_length
+
+
+def diff(old: bytes, new: bytes) -> List[Tuple[Record, bytes]]:
+    """Records and their ADD and INSERT bytes rebuilding new from old."""
+    if not new:
+        return []
+    index = _index(old)
+    # Matches as (new start, old start, length), length including the fuzzy extension
+    matches: List[Tuple[int, int, int]] = []
+    new_pos = last_new = last_old = 0
+
+    while new_pos + GRAM <= len(new):
+        candidates = list(index.get(new[new_pos:new_pos + GRAM], ()))
+        # Prefer carrying on with the previous alignment, as bsdiff does
+        expected = last_old + (new_pos - last_new)
+        if matches and 0 <= expected < len(old):
+            candidates.insert(0, expected)
+
+        best_old, best_length = 0, 0
+        for candidate in candidates:
+            length = _forward(old, new, candidate, new_pos)
+            if length > best_length:
+                best_old, best_length = candidate, length
+        if best_length < MIN_COPY:
+            new_pos += 1
+            continue
+
+        # Back over bytes the hash step skipped, not into the previous match
+        back = 0
+        while (new_pos - back > last_new and best_old - back > 0 and
+               old[best_old - back - 1] == new[new_pos - back - 1]):
+            back += 1
+        start_new, start_old = new_pos - back, best_old - back
+        length = back + best_length
+        length += _fuzzy(old, new, start_old + length, start_new + length)
+
+        matches.append((start_new, start_old, length))
+        new_pos = last_new = start_new + length
+        last_old = start_old + length
+
+    # A record is the ADD of one match, the new bytes up to the next, and the seek to it
+    records: List[Tuple[Record, bytes]] = []
+    old_end, add_new, add_old, add_length = 0, 0, 0, 0
+    for start_new, start_old, length in matches + [(len(new), None, 0)]:
+        insert_start = add_new + add_length
+        added = bytes((new[add_new + i] - old[add_old + i]) & 0xFF for i in range(add_length))
+        old_end = add_old + add_length
+        seek = (start_old - old_end) if start_old is not None else 0
+        records.append((Record(add_length, start_new - insert_start, seek), added + new[insert_start:start_new]))
+        add_new, add_old, add_length = start_new, start_old, length
+    return records
+
+
+def _leb128(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _read_leb128(data: bytes, pos: int) -> Tuple[int, int]:
+    value = shift = 0
+    while True:
+        if pos >= len(data) or shift > 28:
+            raise ValueError("Truncated or oversized LEB128 value")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def _zigzag(value: int) -> int:
+    return (value << 1) if value >= 0 else ((-value - 1) << 1) | 1
+
+
+def _unzigzag(value: int) -> int:
+    return -(value >> 1) - 1 if value & 1 else value >> 1
+
+
+def serialise(records: List[Tuple[Record, bytes]]) -> bytes:
+    out = bytearray()
+    for record, data in records:
+        out += _leb128(record.add) + _leb128(record.insert) + _leb128(_zigzag(record.seek)) + data
+    return bytes(out)
+
+
+# LZSS
+
+def lzss_compress(data: bytes, window_bits: int = DEFAULT_WINDOW_BITS) -> bytes:
+    """Greedy LZSS with hash chains; see delta_update.h for the item layout."""
+    window = 1 << window_bits
+    length_bits = 16 - window_bits
+    length_mask = (1 << length_bits) - 1
+    out = bytearray()
+    heads: Dict[bytes, int] = {}
+    chain: Dict[int, int] = {}
+    flags_pos, flag_count = 0, 8
+    pos = 0
+
+    def insert(i: int) -> None:
+        key = data[i:i + MIN_MATCH]
+        if i in chain or len(key) < MIN_MATCH:
+            return
+        previous = heads.get(key)
+        if previous is not None:
+            chain[i] = previous
+        heads[key] = i
+
+    while pos < len(data):
+        if flag_count == 8:
+            flags_pos, flag_count = len(out), 0
+            out.append(0)
+
+        best_offset, best_length = 0, 0
+        candidate = heads.get(data[pos:pos + MIN_MATCH])
+        depth = 0
+        while candidate is not None and pos - candidate <= window and depth < CHAIN_DEPTH:
+            length = _forward(data, data, candidate, pos)
+            if length > best_length:
+                best_offset, best_length = pos - candidate, length
+            candidate = chain.get(candidate)
+            depth += 1
+
+        if best_length >= MIN_MATCH:
+            code = best_length - MIN_MATCH
+            field = min(code, length_mask)
+            out += struct.pack('<H', ((best_offset - 1) << length_bits) | field)
+            if field == length_mask:
+                out += _leb128(code - length_mask)
+            # Index the start and end of long matches only, where later matches begin
+            for i in range(pos, pos + best_length):
+                if i - pos < 16 or pos + best_length - i <= window:
+                    insert(i)
+            pos += best_length
+        else:
+            out[flags_pos] |= 1 << flag_count
+            out.append(data[pos])
+            insert(pos)
+            pos += 1
+        flag_count += 1
+
+    return bytes(out)
+
+
+def lzss_decompress(body: bytes, window_bits: int) -> bytes:
+    length_bits = 16 - window_bits
+    length_mask = (1 << length_bits) - 1
+    out = bytearray()
+    pos = 0
+    while pos < len(body):
+        flags = body[pos]
+        pos += 1
+        for bit in range(8):
+            if pos >= len(body):
+                break
+            if flags & (1 << bit):
+                out.append(body[pos])
+                pos += 1
+                continue
+            if pos + 2 > len(body):
+                raise ValueError("Truncated reference")
+            reference = body[pos] | (body[pos + 1] << 8)
+            pos += 2
+            offset, length = (reference >> length_bits) + 1, (reference & length_mask) + MIN_MATCH
+            if reference & length_mask == length_mask:
+                extra, pos = _read_leb128(body, pos)
+                length += extra
+            if offset > len(out) or offset > (1 << window_bits):
+                raise ValueError("Reference before the start of the window")
+            for _ in range(length):
+                out.append(out[-offset])
+    return bytes(out)
+
+
+# Patches
+
+def make_patch(old: bytes, new: bytes, window_bits: int = DEFAULT_WINDOW_BITS) -> bytes:
+    if not MIN_WINDOW_BITS <= window_bits <= MAX_WINDOW_BITS:
+        raise ValueError(f"Window bits must be {MIN_WINDOW_BITS} to {MAX_WINDOW_BITS}")
+    body = lzss_compress(serialise(diff(old, new)), window_bits)
+    header = _HEADER.pack(MAGIC, VERSION, window_bits, 0, len(old), crc32(old), len(new), crc32(new), len(body))
+    return header + struct.pack('<I', crc32(header)) + body
+
+
+def parse_header(patch: bytes) -> PatchHeader:
+    if len(patch) < HEADER_SIZE:
+        raise ValueError("Patch too short")
+    magic, version, window_bits, _, *sizes = _HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION or not MIN_WINDOW_BITS <= window_bits <= MAX_WINDOW_BITS:
+        raise ValueError("Not a delta patch")
+    if struct.unpack_from('<I', patch, _HEADER.size)[0] != crc32(patch[:_HEADER.size]):
+        raise ValueError("Header CRC mismatch")
+    return PatchHeader(window_bits, *sizes)
+
+
+def patch_bytes(old: bytes, patch: bytes) -> Iterator[int]:
+    """New image bytes in order, as the target produces them."""
+    header = parse_header(patch)
+    if len(old) != header.old_size or crc32(old) != header.old_crc:
+        raise ValueError("The old image is not the one the patch was made from")
+    body = patch[HEADER_SIZE:]
+    if len(body) != header.body_size:
+        raise ValueError("Body size mismatch")
+
+    stream = lzss_decompress(body, header.window_bits)
+    pos = old_pos = produced = 0
+    while produced < header.new_size:
+        add, pos = _read_leb128(stream, pos)
+        insert, pos = _read_leb128(stream, pos)
+        seek, pos = _read_leb128(stream, pos)
+        if produced + add + insert > header.new_size or old_pos + add > len(old) or pos + add + insert > len(stream):
+            raise ValueError("Corrupt record")
+        for i in range(add):
+            yield (old[old_pos + i] + stream[pos + i]) & 0xFF
+        pos += add
+        old_pos += add
+        yield from stream[pos:pos + insert]
+        pos += insert
+        produced += add + insert
+        old_pos += _unzigzag(seek)
+        if not 0 <= old_pos <= len(old):
+            raise ValueError("Corrupt record")
+    if pos != len(stream):
+        raise ValueError("Trailing data after the last record")
+
+
+def apply_patch(old: bytes, patch: bytes) -> bytes:
+    """Rebuild and check the new image."""
+    new = bytes(patch_bytes(old, patch))
+    if crc32(new) != parse_header(patch).new_crc:
+        raise ValueError("New image CRC mismatch")
+    return new
+
+
+# Flash simulation
+
+class SimulatedFlash:
+    """Two image slots with sector erase and programming that only clears bits, as on the tile MCUs."""
+
+    def __init__(self, slot_size: int = SLOT_SIZE, sector_size: int = SECTOR_SIZE):
+        self.slot_size = slot_size
+        self.sector_size = sector_size
+        self.memory = bytearray(b'\xff' * (2 * slot_size))
+        self.active = 0
+        self.boot_size = 0
+        self.erases = 0
+
+    def slot_address(self, slot: int) -> int:
+        return slot * self.slot_size
+
+    def erase(self, address: int) -> None:
+        if address % self.sector_size:
+            raise ValueError(f"Erase at {address:#x} is not sector aligned")
+        self.memory[address:address + self.sector_size] = b'\xff' * self.sector_size
+        self.erases += 1
+
+    def write(self, address: int, data: bytes) -> None:
+        if address % PROGRAM_UNIT or len(data) % PROGRAM_UNIT:
+            raise ValueError(f"Write at {address:#x} is not program unit aligned")
+        for i, byte in enumerate(data):
+            if byte & ~self.memory[address + i] & 0xFF:
+                raise ValueError(f"Write to {address + i:#x} sets bits, the sector was not erased")
+            self.memory[address + i] &= byte
+
+    def read(self, address: int, size: int) -> bytes:
+        return bytes(self.memory[address:address + size])
+
+    def load(self, image: bytes) -> None:
+        """Program an image into the active slot, as the full flash does."""
+        base = self.slot_address(self.active)
+        for offset in range(0, self.slot_size, self.sector_size):
+            self.erase(base + offset)
+        padded = image + b'\xff' * (-len(image) % PROGRAM_UNIT)
+        self.write(base, padded)
+        self.boot_size = len(image)
+
+    def running_image(self) -> bytes:
+        return self.read(self.slot_address(self.active), self.boot_size)
+
+    def update(self, patch: bytes) -> None:
+        """Apply a patch to the staging slot in write blocks and swap to it once verified."""
+        header = parse_header(patch)
+        if header.old_size > self.slot_size or header.new_size > self.slot_size:
+            raise ValueError("Image larger than its slot")
+        old = self.read(self.slot_address(self.active), header.old_size)
+        staging = self.slot_address(1 - self.active)
+        written = erased = 0
+        crc = 0
+        block = bytearray()
+
+        def flush() -> None:
+            nonlocal written, erased, crc
+            crc = zlib.crc32(block, crc)
+            data = bytes(block) + b'\xff' * (-len(block) % PROGRAM_UNIT)
+            while erased < written + len(data):
+                self.erase(staging + erased)
+                erased += self.sector_size
+            self.write(staging + written, data)
+            written += len(block)
+            block.clear()
+
+        for byte in patch_bytes(old, patch):
+            block.append(byte)
+            if len(block) == WRITE_BLOCK_SIZE:
+                flush()
+        if block:
+            flush()
+
+        if crc & 0xFFFFFFFF != header.new_crc or crc32(self.read(staging, header.new_size)) != header.new_crc:
+            raise ValueError("Staging image does not verify, not swapping")
+        self.active, self.boot_size = 1 - self.active, header.new_size
+
+
+def link_seconds(size: int, baud: int) -> float:
+    """Transfer time of a UART link with 10 bit characters."""
+    return size * 10 / baud
+
+
+def _simulate(old: bytes, new: bytes, window_bits: int, baud: int, sector_size: int) -> None:
+    start = time.perf_counter()
+    patch = make_patch(old, new, window_bits)
+    diff_time = time.perf_counter() - start
+
+    slot_size = -(-max(len(old), len(new), 1) // sector_size) * sector_size
+    flash = SimulatedFlash(slot_size, sector_size)
+    flash.load(old)
+    flash.update(patch)
+    if flash.running_image() != new:
+        raise ValueError("Simulated update produced the wrong image")
+
+    print(f"Old image {len(old)} bytes, new image {len(new)} bytes, diff in {diff_time:.2f} s")
+    print(f"Full image: {len(new):8d} bytes, {link_seconds(len(new), baud):7.1f} s at {baud} baud")
+    print(f"Patch:      {len(patch):8d} bytes, {link_seconds(len(patch), baud):7.1f} s at {baud} baud "
+          f"({100 * len(patch) / max(len(new), 1):.1f}%)")
+    print(f"Simulated flash: swapped to slot {flash.active}, {flash.erases} sector erases, image verified")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Delta firmware patches for the tile MCUs')
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    make = commands.add_parser('diff', help='Build a patch from the old to the new image')
+    make.add_argument('old')
+    make.add_argument('new')
+    make.add_argument('patch')
+    make.add_argument('--window-bits', type=int, default=DEFAULT_WINDOW_BITS)
+
+    apply = commands.add_parser('apply', help='Apply a patch on the host')
+    apply.add_argument('old')
+    apply.add_argument('patch')
+    apply.add_argument('output')
+
+    simulate = commands.add_parser('simulate', help='Apply a patch to a simulated target flash')
+    simulate.add_argument('old')
+    simulate.add_argument('new')
+    simulate.add_argument('--window-bits', type=int, default=DEFAULT_WINDOW_BITS)
+    simulate.add_argument('--baud', type=int, default=115200)
+    simulate.add_argument('--sector-size', type=int, default=SECTOR_SIZE)
+
+    args = parser.parse_args()
+    try:
+        if args.command == 'diff':
+            old, new = load_image(args.old), load_image(args.new)
+            patch = make_patch(old, new, args.window_bits)
+            with open(args.patch, 'wb') as f:
+                f.write(patch)
+            print(f"{len(patch)} byte patch for a {len(new)} byte image")
+        elif args.command == 'apply':
+            with open(args.patch, 'rb') as f:
+                new = apply_patch(load_image(args.old), f.read())
+            with open(args.output, 'wb') as f:
+                f.write(new)
+        else:
+            _simulate(load_image(args.old), load_image(args.new), args.window_bits, args.baud, args.sector_size)
+    except (OSError, ValueError) as e:
+        print(f"Error: {str(e)}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,612 @@
+/**
+ * @file delta_update.c
+ * @brief Implementation of the delta firmware update applier.
+ *
+ * Patch bytes pass through three stages as they arrive: the LZSS decoder writes
+ * each decompressed byte into its window and hands it to the record parser, the
+ * record parser turns ADD and INSERT bytes into new image bytes using a small read
+ * cache of the running image, and the output stage collects them into a write block
+ * that is programmed into the staging slot when full, erasing each sector as the
+ * write position reaches it. No stage keeps more than its fixed buffer, so the RAM
+ * used is the same for any image or patch size.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "delta_update.h"
+
+#define LEB128_CONTINUE             0x80
+#define LEB128_MAX_SHIFT            28
+
+enum lz_state_t
+{
+    LZ_FLAGS = 0,
+    LZ_LITERAL,
+    LZ_REFERENCE_LOW,
+    LZ_REFERENCE_HIGH,
+    LZ_LENGTH
+};
+
+enum record_state_t
+{
+    RECORD_ADD_SIZE = 0,
+    RECORD_INSERT_SIZE,
+    RECORD_SEEK,
+    RECORD_ADD,
+    RECORD_INSERT,
+    RECORD_DONE
+};
+
+static const uint32_t crc32_table[256] =
+{
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as zlib), continued from a previous value.
+ *
+ * @param crc CRC of the bytes before, 0 to start.
+ * @param data The bytes to check.
+ * @param size Number of bytes.
+ * @return The CRC.
+ */
+uint32_t delta_update_crc32(uint32_t crc, const uint8_t *data, size_t size)
+{
+    crc = ~crc;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = (crc >> 8) ^ crc32_table[(crc ^ data[i]) & 0xFF];
+    }
+
+    return ~crc;
+}
+
+static uint32_t _get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static STATUS _fail(struct delta_update_t *update, enum delta_error_t error)
+{
+    if (update->error == DELTA_ERROR_NONE)
+    {
+        update->error = error;
+    }
+    return ERROR;
+}
+
+/**
+ * @brief CRC-32 of a flash region, read through the block buffer.
+ */
+static STATUS _flash_crc32(struct delta_update_t *update, uint32_t address, uint32_t size, uint32_t *crc)
+{
+    *crc = 0;
+
+    for (uint32_t offset = 0; offset < size; offset += DELTA_WRITE_BLOCK_SIZE)
+    {
+        const size_t chunk = (size - offset < DELTA_WRITE_BLOCK_SIZE) ? size - offset : DELTA_WRITE_BLOCK_SIZE;
+
+        RETURN_ON_ERROR(update->flash->read(update->flash->context, address + offset, update->block, chunk));
+        *crc = delta_update_crc32(*crc, update->block, chunk);
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Check the header and that the running image is the one the patch was made from.
+ */
+static STATUS _start(struct delta_update_t *update)
+{
+    const uint8_t *p = update->header_bytes;
+    struct delta_header_t *header = &update->header;
+
+    header->window_bits = p[5];
+    header->old_size = _get_u32(&p[8]);
+    header->old_crc = _get_u32(&p[12]);
+    header->new_size = _get_u32(&p[16]);
+    header->new_crc = _get_u32(&p[20]);
+    header->body_size = _get_u32(&p[24]);
+
+    if (_get_u32(&p[0]) != DELTA_MAGIC || p[4] != DELTA_VERSION ||
+        _get_u32(&p[28]) != delta_update_crc32(0, p, DELTA_HEADER_SIZE - 4) ||
+        header->window_bits < DELTA_MIN_WINDOW_BITS || header->window_bits > DELTA_MAX_WINDOW_BITS ||
+        header->old_size > update->flash->slot_size || header->new_size > update->flash->slot_size)
+    {
+        return _fail(update, DELTA_ERROR_HEADER);
+    }
+
+    uint32_t crc;
+    if (_flash_crc32(update, update->flash->active_address, header->old_size, &crc) != OK)
+    {
+        return _fail(update, DELTA_ERROR_FLASH);
+    }
+    if (crc != header->old_crc)
+    {
+        return _fail(update, DELTA_ERROR_OLD_IMAGE);
+    }
+
+    update->window_mask = (1u << header->window_bits) - 1;
+    update->length_bits = (uint8_t)(16 - header->window_bits);
+    update->record_state = (header->new_size == 0) ? RECORD_DONE : RECORD_ADD_SIZE;
+
+    return OK;
+}
+
+/**
+ * @brief Program the write block into the staging slot, erasing the sectors it reaches first.
+ */
+static STATUS _flush(struct delta_update_t *update)
+{
+    const struct delta_flash_t *flash = update->flash;
+    size_t size = update->block_size;
+
+    if (size == 0)
+    {
+        return OK;
+    }
+
+    update->crc = delta_update_crc32(update->crc, update->block, size);
+    while (size % DELTA_PROGRAM_UNIT != 0)
+    {
+        update->block[size++] = 0xFF;
+    }
+
+    while (update->erased < update->written + size)
+    {
+        if (flash->erase(flash->context, flash->staging_address + update->erased, flash->sector_size) != OK)
+        {
+            return _fail(update, DELTA_ERROR_FLASH);
+        }
+        update->erased += flash->sector_size;
+        update->sectors_erased++;
+    }
+
+    if (flash->write(flash->context, flash->staging_address + update->written, update->block, size) != OK)
+    {
+        return _fail(update, DELTA_ERROR_FLASH);
+    }
+
+    update->written += (uint32_t)update->block_size;
+    update->block_size = 0;
+
+    return OK;
+}
+
+static STATUS _output(struct delta_update_t *update, uint8_t byte)
+{
+    update->block[update->block_size++] = byte;
+    update->new_position++;
+
+    if (update->block_size == DELTA_WRITE_BLOCK_SIZE)
+    {
+        return _flush(update);
+    }
+    return OK;
+}
+
+/**
+ * @brief Next byte of the running image, through the read cache.
+ */
+static STATUS _old_byte(struct delta_update_t *update, uint8_t *byte)
+{
+    const uint32_t position = update->old_position;
+
+    if (position >= update->header.old_size)
+    {
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+
+    if (position < update->cache_position || position >= update->cache_position + update->cache_size)
+    {
+        const uint32_t left = update->header.old_size - position;
+
+        update->cache_position = position;
+        update->cache_size = (left < DELTA_READ_CACHE_SIZE) ? left : DELTA_READ_CACHE_SIZE;
+        if (update->flash->read(update->flash->context, update->flash->active_address + position,
+                                update->cache, update->cache_size) != OK)
+        {
+            update->cache_size = 0;
+            return _fail(update, DELTA_ERROR_FLASH);
+        }
+    }
+
+    *byte = update->cache[position - update->cache_position];
+    update->old_position++;
+
+    return OK;
+}
+
+/**
+ * @brief Accumulate a LEB128 value. Returns true when its last byte has arrived.
+ */
+static bool _leb128(uint32_t *value, uint8_t *shift, uint8_t byte, bool *overflow)
+{
+    if (*shift > LEB128_MAX_SHIFT)
+    {
+        *overflow = true;
+        return true;
+    }
+
+    *value |= (uint32_t)(byte & ~LEB128_CONTINUE) << *shift;
+    if (byte & LEB128_CONTINUE)
+    {
+        *shift += 7;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Start the next record field once a size or seek value is complete.
+ */
+static STATUS _record_field(struct delta_update_t *update)
+{
+    const uint32_t left = update->header.new_size - update->new_position;
+    const uint32_t value = update->value;
+
+    update->value = 0;
+    update->shift = 0;
+
+    switch (update->record_state)
+    {
+    case RECORD_ADD_SIZE:
+        update->remaining = value;
+        update->record_state = RECORD_INSERT_SIZE;
+        return (value > left) ? _fail(update, DELTA_ERROR_CORRUPT) : OK;
+
+    case RECORD_INSERT_SIZE:
+        if (value > left - update->remaining)
+        {
+            return _fail(update, DELTA_ERROR_CORRUPT);
+        }
+        update->insert_size = value;
+        update->record_state = RECORD_SEEK;
+        return OK;
+
+    case RECORD_SEEK:
+        update->seek = value;
+        break;
+
+    default:
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+
+    // The sizes and seek are known, the data follows
+    if (update->remaining > 0)
+    {
+        update->record_state = RECORD_ADD;
+        return OK;
+    }
+    if (update->insert_size > 0)
+    {
+        update->remaining = update->insert_size;
+        update->record_state = RECORD_INSERT;
+        return OK;
+    }
+    update->record_state = RECORD_DONE;
+    return OK;
+}
+
+/**
+ * @brief Move the running image position by the record's seek once its data is done.
+ */
+static STATUS _end_record(struct delta_update_t *update)
+{
+    // Zigzag: even values are positive, odd values negative
+    const uint32_t seek = update->seek;
+    const int64_t position = (int64_t)update->old_position +
+                             ((seek & 1) ? -(int64_t)(seek >> 1) - 1 : (int64_t)(seek >> 1));
+
+    if (position < 0 || position > (int64_t)update->header.old_size)
+    {
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+
+    update->old_position = (uint32_t)position;
+    update->record_state = (update->new_position == update->header.new_size) ? RECORD_DONE : RECORD_ADD_SIZE;
+
+    return OK;
+}
+
+/**
+ * @brief Apply one decompressed byte of the record stream.
+ */
+static STATUS _record_byte(struct delta_update_t *update, uint8_t byte)
+{
+    bool overflow = false;
+    uint8_t old;
+
+    switch (update->record_state)
+    {
+    case RECORD_ADD_SIZE:
+    case RECORD_INSERT_SIZE:
+    case RECORD_SEEK:
+        if (!_leb128(&update->value, &update->shift, byte, &overflow))
+        {
+            return OK;
+        }
+        if (overflow)
+        {
+            return _fail(update, DELTA_ERROR_CORRUPT);
+        }
+        RETURN_ON_ERROR(_record_field(update));
+        if (update->record_state == RECORD_DONE)
+        {
+            // An empty record only moves the running image position
+            return _end_record(update);
+        }
+        return OK;
+
+    case RECORD_ADD:
+        RETURN_ON_ERROR(_old_byte(update, &old));
+        RETURN_ON_ERROR(_output(update, (uint8_t)(old + byte)));
+        if (--update->remaining == 0)
+        {
+            if (update->insert_size > 0)
+            {
+                update->remaining = update->insert_size;
+                update->record_state = RECORD_INSERT;
+                return OK;
+            }
+            return _end_record(update);
+        }
+        return OK;
+
+    case RECORD_INSERT:
+        RETURN_ON_ERROR(_output(update, byte));
+        if (--update->remaining == 0)
+        {
+            return _end_record(update);
+        }
+        return OK;
+
+    default:
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+}
+
+static STATUS _decompressed(struct delta_update_t *update, uint8_t byte)
+{
+    update->window[update->window_count & update->window_mask] = byte;
+    update->window_count++;
+    return _record_byte(update, byte);
+}
+
+/**
+ * @brief Expand a back-reference from the decompression window.
+ */
+static STATUS _copy_reference(struct delta_update_t *update, uint32_t length)
+{
+    const uint32_t offset = (uint32_t)(update->reference >> update->length_bits) + 1;
+
+    if (offset > update->window_count)
+    {
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        RETURN_ON_ERROR(_decompressed(update, update->window[(update->window_count - offset) & update->window_mask]));
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Choose the next item of the flag group.
+ */
+static void _next_item(struct delta_update_t *update)
+{
+    if (update->flag_count == 0)
+    {
+        update->lz_state = LZ_FLAGS;
+        return;
+    }
+
+    update->lz_state = (update->flags & 1) ? LZ_LITERAL : LZ_REFERENCE_LOW;
+    update->flags >>= 1;
+    update->flag_count--;
+}
+
+/**
+ * @brief Decode one compressed body byte.
+ */
+static STATUS _body_byte(struct delta_update_t *update, uint8_t byte)
+{
+    const uint16_t length_mask = (uint16_t)((1u << update->length_bits) - 1);
+    bool overflow = false;
+
+    switch (update->lz_state)
+    {
+    case LZ_FLAGS:
+        update->flags = byte;
+        update->flag_count = 8;
+        break;
+
+    case LZ_LITERAL:
+        RETURN_ON_ERROR(_decompressed(update, byte));
+        break;
+
+    case LZ_REFERENCE_LOW:
+        update->reference = byte;
+        update->lz_state = LZ_REFERENCE_HIGH;
+        return OK;
+
+    case LZ_REFERENCE_HIGH:
+        update->reference |= (uint16_t)(byte << 8);
+        if ((update->reference & length_mask) == length_mask)
+        {
+            update->lz_value = 0;
+            update->lz_shift = 0;
+            update->lz_state = LZ_LENGTH;
+            return OK;
+        }
+        RETURN_ON_ERROR(_copy_reference(update, (update->reference & length_mask) + DELTA_MIN_MATCH));
+        break;
+
+    case LZ_LENGTH:
+        if (!_leb128(&update->lz_value, &update->lz_shift, byte, &overflow))
+        {
+            return OK;
+        }
+        if (overflow)
+        {
+            return _fail(update, DELTA_ERROR_CORRUPT);
+        }
+        RETURN_ON_ERROR(_copy_reference(update, length_mask + DELTA_MIN_MATCH + update->lz_value));
+        break;
+
+    default:
+        return _fail(update, DELTA_ERROR_CORRUPT);
+    }
+
+    _next_item(update);
+    return OK;
+}
+
+/**
+ * @brief Prepare to apply a patch.
+ *
+ * @param update Applier state, typically static; it holds all buffers.
+ * @param flash Flash access and slot layout, kept by reference.
+ */
+void delta_update_init(struct delta_update_t *update, const struct delta_flash_t *flash)
+{
+    memset(update, 0, sizeof(*update));
+    update->flash = flash;
+    update->lz_state = LZ_FLAGS;
+    update->record_state = RECORD_ADD_SIZE;
+}
+
+/**
+ * @brief Apply the next bytes of the patch as they arrive, in chunks of any size.
+ *
+ * The header is checked, and the running image verified against it, when its last
+ * byte arrives. New image bytes are programmed into the staging slot as they are
+ * produced.
+ *
+ * @param update Applier state.
+ * @param data Patch bytes.
+ * @param size Number of bytes.
+ * @return OK, or ERROR with update->error set; later calls then fail too.
+ */
+STATUS delta_update_feed(struct delta_update_t *update, const uint8_t *data, size_t size)
+{
+    if (update->error != DELTA_ERROR_NONE)
+    {
+        return ERROR;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (update->header_received < DELTA_HEADER_SIZE)
+        {
+            update->header_bytes[update->header_received++] = data[i];
+            if (update->header_received == DELTA_HEADER_SIZE)
+            {
+                RETURN_ON_ERROR(_start(update));
+            }
+            continue;
+        }
+
+        if (update->body_received == update->header.body_size)
+        {
+            return _fail(update, DELTA_ERROR_SIZE);
+        }
+        update->body_received++;
+        RETURN_ON_ERROR(_body_byte(update, data[i]));
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Complete the update once the whole patch has been fed.
+ *
+ * Writes the last block, checks the CRC of the rebuilt image, reads the staging slot
+ * back and checks it again, and only then calls the swap callback.
+ *
+ * @param update Applier state.
+ * @return OK if the new image was verified and swapped in, ERROR with update->error set.
+ */
+STATUS delta_update_finish(struct delta_update_t *update)
+{
+    if (update->error != DELTA_ERROR_NONE)
+    {
+        return ERROR;
+    }
+    if (update->header_received < DELTA_HEADER_SIZE || update->body_received != update->header.body_size ||
+        update->record_state != RECORD_DONE || update->new_position != update->header.new_size)
+    {
+        return _fail(update, DELTA_ERROR_SIZE);
+    }
+
+    RETURN_ON_ERROR(_flush(update));
+    if (update->crc != update->header.new_crc)
+    {
+        return _fail(update, DELTA_ERROR_CRC);
+    }
+
+    uint32_t crc;
+    if (_flash_crc32(update, update->flash->staging_address, update->header.new_size, &crc) != OK)
+    {
+        return _fail(update, DELTA_ERROR_FLASH);
+    }
+    if (crc != update->header.new_crc)
+    {
+        return _fail(update, DELTA_ERROR_READBACK);
+    }
+
+    if (update->flash->swap(update->flash->context, update->header.new_size, update->header.new_crc) != OK)
+    {
+        return _fail(update, DELTA_ERROR_FLASH);
+    }
+
+    return OK;
+}
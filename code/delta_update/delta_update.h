@@ -0,0 +1,149 @@
+/**
+ * @file delta_update.h
+ * @brief Header file for the delta firmware update applier.
+ *
+ * Rebuilds a new firmware image in the staging slot from the running image and a
+ * patch streamed over the production link, so only the change is transferred. The
+ * patch is produced on the host by `delta_patch.py`. Bytes are applied as they
+ * arrive with a fixed amount of RAM: the decompression window, one flash write block
+ * and a small read cache of the running image. The staging image is checked against
+ * the CRC in the patch, and read back from flash, before the swap callback marks it
+ * for boot.
+ *
+ * Patch layout, multi-byte fields little-endian:
+ *
+ *   0   magic       "DPTC"
+ *   4   version     DELTA_VERSION
+ *   5   window bits Decompression window, 2^bits bytes
+ *   6   reserved    (u16)
+ *   8   old size    Running image bytes the patch applies to (u32)
+ *   12  old crc     CRC-32 of the running image (u32)
+ *   16  new size    (u32)
+ *   20  new crc     CRC-32 of the new image (u32)
+ *   24  body size   Compressed body bytes (u32)
+ *   28  header crc  CRC-32 of bytes 0 to 27 (u32)
+ *   32  body        LZSS compressed record stream
+ *
+ * LZSS: a flag byte precedes each group of eight items, bit 0 first; a set bit is a
+ * literal byte, a clear bit a u16 reference with the offset - 1 in the top window bits
+ * and the length - DELTA_MIN_MATCH below. A length field of all ones is followed by a
+ * LEB128 count added to the length, so runs of any size cost a few bytes.
+ *
+ * Record stream, repeated until the new image is complete: ADD length, INSERT length
+ * (LEB128) and SEEK (zigzag LEB128), then ADD bytes, each added to the next byte of the
+ * running image, then INSERT bytes copied as they are. After the record the running
+ * image position moves by SEEK.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+#define DELTA_MAGIC                     0x43545044u     // "DPTC"
+#define DELTA_VERSION                   1
+#define DELTA_HEADER_SIZE               32
+
+#define DELTA_MIN_WINDOW_BITS           8
+#define DELTA_MAX_WINDOW_BITS           12              // Largest window accepted, sets the RAM used
+#define DELTA_MIN_MATCH                 3
+
+#define DELTA_WRITE_BLOCK_SIZE          256             // Bytes buffered per flash write
+#define DELTA_PROGRAM_UNIT              32              // Flash program granularity, the last block is padded with 0xFF
+#define DELTA_READ_CACHE_SIZE           64              // Running image bytes read at a time
+
+enum delta_error_t
+{
+    DELTA_ERROR_NONE = 0,
+    DELTA_ERROR_HEADER,         // Bad magic, version, window or header CRC, or an image larger than its slot
+    DELTA_ERROR_OLD_IMAGE,      // The running image is not the one the patch was made from
+    DELTA_ERROR_CORRUPT,        // The body decodes to an invalid record
+    DELTA_ERROR_SIZE,           // More or fewer body bytes than the header gives
+    DELTA_ERROR_FLASH,          // A flash callback failed
+    DELTA_ERROR_CRC,            // The rebuilt image does not match the new CRC
+    DELTA_ERROR_READBACK        // The staging slot does not read back as written
+};
+
+/**
+ * @brief Flash access for the applier. Addresses are absolute; the slots must not overlap.
+ */
+struct delta_flash_t
+{
+    STATUS (*read)(void *context, uint32_t address, uint8_t *data, size_t size);
+    STATUS (*erase)(void *context, uint32_t address, size_t size);              // One sector at a time
+    STATUS (*write)(void *context, uint32_t address, const uint8_t *data, size_t size);
+    STATUS (*swap)(void *context, uint32_t size, uint32_t crc);                 // Mark the staging image for boot
+    void *context;
+    uint32_t active_address;        // Running image
+    uint32_t staging_address;       // Image being built
+    uint32_t slot_size;
+    uint32_t sector_size;
+};
+
+struct delta_header_t
+{
+    uint8_t window_bits;
+    uint32_t old_size;
+    uint32_t old_crc;
+    uint32_t new_size;
+    uint32_t new_crc;
+    uint32_t body_size;
+};
+
+struct delta_update_t
+{
+    const struct delta_flash_t *flash;
+    struct delta_header_t header;
+    enum delta_error_t error;
+
+    uint8_t header_bytes[DELTA_HEADER_SIZE];
+    size_t header_received;
+    uint32_t body_received;
+
+    // Decompression
+    uint8_t window[1u << DELTA_MAX_WINDOW_BITS];
+    uint32_t window_mask;
+    uint32_t window_count;          // Bytes decompressed so far
+    uint8_t length_bits;
+    uint8_t lz_state;
+    uint8_t flags;
+    uint8_t flag_count;             // Items left in the current flag group
+    uint16_t reference;
+    uint32_t lz_value;
+    uint8_t lz_shift;
+
+    // Record stream
+    uint8_t record_state;
+    uint32_t value;
+    uint8_t shift;
+    uint32_t remaining;             // Bytes left in the current ADD or INSERT
+    uint32_t insert_size;
+    uint32_t seek;
+    uint32_t old_position;
+
+    // Running image read cache
+    uint8_t cache[DELTA_READ_CACHE_SIZE];
+    uint32_t cache_position;
+    uint32_t cache_size;
+
+    // Output
+    uint8_t block[DELTA_WRITE_BLOCK_SIZE];
+    size_t block_size;
+    uint32_t new_position;          // Image bytes produced
+    uint32_t written;               // Image bytes written to flash
+    uint32_t erased;                // Staging bytes erased
+    uint32_t crc;
+
+    uint32_t sectors_erased;
+};
+
+uint32_t delta_update_crc32(uint32_t crc, const uint8_t *data, size_t size);
+
+void delta_update_init(struct delta_update_t *update, const struct delta_flash_t *flash);
+STATUS delta_update_feed(struct delta_update_t *update, const uint8_t *data, size_t size);
+STATUS delta_update_finish(struct delta_update_t *update);
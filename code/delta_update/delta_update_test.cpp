@@ -0,0 +1,506 @@
+/**
+ * @file delta_update_test.cpp
+ * @brief Unit tests for the delta firmware update applier.
+ *
+ * This file contains Google Test-based unit tests for the C applier running against a
+ * simulated A/B flash that, like the tile MCUs, only erases whole sectors and only
+ * programs bits from 1 to 0. Patches come from the host generator `delta_patch.py`,
+ * so both sides are held to the same format; those tests are skipped when python3 is
+ * not available. Patches for the failure cases are built here.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+extern "C"
+{
+    #include "delta_update.h"
+}
+
+const uint32_t SLOT_SIZE = 128 * 1024;
+const uint32_t SECTOR_SIZE = 2048;
+const uint32_t FLASH_BASE = 0x08000000;
+const int BENCHMARK_UPDATES = 20;
+
+/**
+ * @brief Two image slots with the erase and program rules of the target flash.
+ */
+class SimulatedFlash
+{
+public:
+    std::vector<uint8_t> memory;
+    struct delta_flash_t flash;
+    bool swapped = false;
+    bool fail_writes = false;
+    bool corrupt_writes = false;
+    int erases = 0;
+    int rule_violations = 0;
+
+    SimulatedFlash() : memory(2 * SLOT_SIZE, 0xFF)
+    {
+        flash.read = _read;
+        flash.erase = _erase;
+        flash.write = _write;
+        flash.swap = _swap;
+        flash.context = this;
+        flash.active_address = FLASH_BASE;
+        flash.staging_address = FLASH_BASE + SLOT_SIZE;
+        flash.slot_size = SLOT_SIZE;
+        flash.sector_size = SECTOR_SIZE;
+    }
+
+    void load(const std::vector<uint8_t> &image)
+    {
+        std::copy(image.begin(), image.end(), memory.begin());
+    }
+
+    std::vector<uint8_t> staging(size_t size) const
+    {
+        return std::vector<uint8_t>(memory.begin() + SLOT_SIZE, memory.begin() + SLOT_SIZE + size);
+    }
+
+private:
+    static bool _in_range(uint32_t address, size_t size)
+    {
+        return address >= FLASH_BASE && address - FLASH_BASE + size <= 2 * SLOT_SIZE;
+    }
+
+    static STATUS _read(void *context, uint32_t address, uint8_t *data, size_t size)
+    {
+        SimulatedFlash *self = (SimulatedFlash *)context;
+        if (!_in_range(address, size))
+        {
+            return ERROR;
+        }
+        memcpy(data, &self->memory[address - FLASH_BASE], size);
+        return OK;
+    }
+
+    static STATUS _erase(void *context, uint32_t address, size_t size)
+    {
+        SimulatedFlash *self = (SimulatedFlash *)context;
+        if (!_in_range(address, size) || (address - FLASH_BASE) % SECTOR_SIZE != 0 || size != SECTOR_SIZE ||
+            address < FLASH_BASE + SLOT_SIZE)
+        {
+            self->rule_violations++;
+            return ERROR;
+        }
+        memset(&self->memory[address - FLASH_BASE], 0xFF, size);
+        self->erases++;
+        return OK;
+    }
+
+    static STATUS _write(void *context, uint32_t address, const uint8_t *data, size_t size)
+    {
+        SimulatedFlash *self = (SimulatedFlash *)context;
+        if (self->fail_writes)
+        {
+            return ERROR;
+        }
+        if (!_in_range(address, size) || address % DELTA_PROGRAM_UNIT != 0 || size % DELTA_PROGRAM_UNIT != 0)
+        {
+            self->rule_violations++;
+            return ERROR;
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            uint8_t &cell = self->memory[address - FLASH_BASE + i];
+            if (data[i] & ~cell)
+            {
+                self->rule_violations++;
+            }
+            cell &= data[i];
+        }
+        if (self->corrupt_writes)
+        {
+            self->memory[address - FLASH_BASE] &= 0x7F;
+        }
+        return OK;
+    }
+
+    static STATUS _swap(void *context, uint32_t size, uint32_t crc)
+    {
+        (void)size;
+        (void)crc;
+        ((SimulatedFlash *)context)->swapped = true;
+        return OK;
+    }
+};
+
+/**
+ * @brief Firmware-like image: short functions drawn from a small instruction vocabulary.
+ */
+static std::vector<uint8_t> _firmware(size_t size, uint32_t seed)
+{
+    uint32_t state = seed;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    uint16_t vocabulary[256];
+    for (uint16_t &word : vocabulary)
+    {
+        word = (uint16_t)next();
+    }
+
+    std::vector<uint8_t> image;
+    while (image.size() < size)
+    {
+        const uint16_t word = vocabulary[next() % 256];
+        image.push_back((uint8_t)word);
+        image.push_back((uint8_t)(word >> 8));
+    }
+    image.resize(size);
+    return image;
+}
+
+/**
+ * @brief The next firmware version: a function inserted, one rewritten and literal pool addresses moved.
+ */
+static std::vector<uint8_t> _revise(const std::vector<uint8_t> &old)
+{
+    std::vector<uint8_t> image = old;
+    std::vector<uint8_t> added = _firmware(600, 99);
+    image.insert(image.begin() + image.size() / 3, added.begin(), added.end());
+    std::vector<uint8_t> rewritten = _firmware(300, 7);
+    std::copy(rewritten.begin(), rewritten.end(), image.begin() + image.size() * 2 / 3);
+    for (size_t i = image.size() / 3; i + 4 <= image.size(); i += 1021)
+    {
+        const uint32_t address = FLASH_BASE + (uint32_t)i + 600;
+        memcpy(&image[i], &address, sizeof(address));
+    }
+    return image;
+}
+
+static std::string _script_path(void)
+{
+    std::string file(__FILE__);
+    return file.substr(0, file.find_last_of('/') + 1) + "delta_patch.py";
+}
+
+static std::string _write_temp(const std::vector<uint8_t> &data)
+{
+    char path[] = "/tmp/delta_update_testXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        return "";
+    }
+    bool ok = write(fd, data.data(), data.size()) == (ssize_t)data.size();
+    close(fd);
+    return ok ? path : "";
+}
+
+/**
+ * @brief Build a patch with the Python generator, empty if it is not available.
+ */
+static std::vector<uint8_t> _python_patch(const std::vector<uint8_t> &old, const std::vector<uint8_t> &image,
+                                          int window_bits = DELTA_MAX_WINDOW_BITS)
+{
+    std::string old_path = _write_temp(old);
+    std::string new_path = _write_temp(image);
+    std::string patch_path = _write_temp({});
+    std::vector<uint8_t> patch;
+
+    std::string line = "python3 " + _script_path() + " diff " + old_path + " " + new_path + " " + patch_path +
+                       " --window-bits " + std::to_string(window_bits) + " >/dev/null 2>&1";
+    if (!old_path.empty() && !new_path.empty() && !patch_path.empty() && system(line.c_str()) == 0)
+    {
+        std::ifstream file(patch_path, std::ios::binary);
+        patch.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    unlink(old_path.c_str());
+    unlink(new_path.c_str());
+    unlink(patch_path.c_str());
+    return patch;
+}
+
+static void _put_u32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+static void _put_leb128(std::vector<uint8_t> &out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static std::vector<uint8_t> _with_header(const std::vector<uint8_t> &old, const std::vector<uint8_t> &image,
+                                         const std::vector<uint8_t> &body)
+{
+    std::vector<uint8_t> patch = {'D', 'P', 'T', 'C', DELTA_VERSION, DELTA_MAX_WINDOW_BITS, 0, 0};
+    _put_u32(patch, (uint32_t)old.size());
+    _put_u32(patch, delta_update_crc32(0, old.data(), old.size()));
+    _put_u32(patch, (uint32_t)image.size());
+    _put_u32(patch, delta_update_crc32(0, image.data(), image.size()));
+    _put_u32(patch, (uint32_t)body.size());
+    _put_u32(patch, delta_update_crc32(0, patch.data(), patch.size()));
+    patch.insert(patch.end(), body.begin(), body.end());
+    return patch;
+}
+
+/**
+ * @brief A patch carrying the whole new image as one INSERT of LZSS literals.
+ */
+static std::vector<uint8_t> _literal_patch(const std::vector<uint8_t> &old, const std::vector<uint8_t> &image)
+{
+    std::vector<uint8_t> records;
+    _put_leb128(records, 0);
+    _put_leb128(records, (uint32_t)image.size());
+    _put_leb128(records, 0);
+    records.insert(records.end(), image.begin(), image.end());
+
+    std::vector<uint8_t> body;
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (i % 8 == 0)
+        {
+            body.push_back(0xFF);
+        }
+        body.push_back(records[i]);
+    }
+    return _with_header(old, image, body);
+}
+
+/**
+ * @brief Feed a patch in chunks of the given size and finish.
+ */
+static STATUS _apply(SimulatedFlash &sim, const std::vector<uint8_t> &patch, size_t chunk,
+                     struct delta_update_t *update)
+{
+    delta_update_init(update, &sim.flash);
+    for (size_t i = 0; i < patch.size(); i += chunk)
+    {
+        RETURN_ON_ERROR(delta_update_feed(update, &patch[i], std::min(chunk, patch.size() - i)));
+    }
+    return delta_update_finish(update);
+}
+
+static struct delta_update_t update;
+
+TEST(delta_update, Crc32CheckValue) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(delta_update_crc32(0, check, sizeof(check)), 0xCBF43926u);
+    EXPECT_EQ(delta_update_crc32(delta_update_crc32(0, check, 4), check + 4, 5), 0xCBF43926u);
+}
+
+TEST(delta_update, AppliesPythonPatch) {
+    std::vector<uint8_t> old = _firmware(100 * 1024, 1);
+    std::vector<uint8_t> image = _revise(old);
+    std::vector<uint8_t> patch = _python_patch(old, image);
+    if (patch.empty())
+    {
+        GTEST_SKIP() << "python3 or " << _script_path() << " not available";
+    }
+
+    // Only the change is sent
+    EXPECT_LT(patch.size(), image.size() / 10);
+
+    for (size_t chunk : {(size_t)1, (size_t)7, (size_t)64, patch.size()})
+    {
+        SimulatedFlash sim;
+        sim.load(old);
+        ASSERT_EQ(_apply(sim, patch, chunk, &update), OK) << "chunk " << chunk << " error " << update.error;
+        EXPECT_TRUE(sim.swapped);
+        EXPECT_EQ(sim.staging(image.size()), image);
+        EXPECT_EQ(sim.rule_violations, 0);
+        EXPECT_EQ(sim.erases, (int)((image.size() + SECTOR_SIZE - 1) / SECTOR_SIZE));
+    }
+
+    std::cout << "Patch " << patch.size() << " bytes for a " << image.size() << " byte image" << std::endl;
+}
+
+TEST(delta_update, AppliesPythonPatchesOfEveryWindow) {
+    std::vector<uint8_t> old = _firmware(20 * 1024, 3);
+    std::vector<std::vector<uint8_t>> images = {old, _revise(old), _firmware(5000, 4), {}};
+
+    for (int window_bits = DELTA_MIN_WINDOW_BITS; window_bits <= DELTA_MAX_WINDOW_BITS; window_bits += 2)
+    {
+        for (const std::vector<uint8_t> &image : images)
+        {
+            std::vector<uint8_t> patch = _python_patch(old, image, window_bits);
+            if (patch.empty())
+            {
+                GTEST_SKIP() << "python3 or " << _script_path() << " not available";
+            }
+            SimulatedFlash sim;
+            sim.load(old);
+            ASSERT_EQ(_apply(sim, patch, 100, &update), OK) << "window bits " << window_bits;
+            EXPECT_EQ(sim.staging(image.size()), image);
+        }
+    }
+}
+
+TEST(delta_update, RejectsWrongOldImage) {
+    std::vector<uint8_t> old = _firmware(4096, 5);
+    std::vector<uint8_t> patch = _literal_patch(old, _firmware(4096, 6));
+    SimulatedFlash sim;
+    old[100] ^= 1;
+    sim.load(old);
+
+    delta_update_init(&update, &sim.flash);
+    EXPECT_EQ(delta_update_feed(&update, patch.data(), patch.size()), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_OLD_IMAGE);
+    EXPECT_EQ(delta_update_finish(&update), ERROR);
+    EXPECT_FALSE(sim.swapped);
+    EXPECT_EQ(sim.erases, 0);
+}
+
+TEST(delta_update, DamagedPatchNeverSwaps) {
+    std::vector<uint8_t> old = _firmware(2048, 8);
+    std::vector<uint8_t> image = _firmware(3000, 9);
+    std::vector<uint8_t> patch = _literal_patch(old, image);
+
+    SimulatedFlash good;
+    good.load(old);
+    ASSERT_EQ(_apply(good, patch, patch.size(), &update), OK);
+    EXPECT_EQ(good.staging(image.size()), image);
+
+    for (size_t i = 0; i < patch.size(); i += 13)
+    {
+        std::vector<uint8_t> damaged = patch;
+        damaged[i] ^= 0x04;
+        SimulatedFlash sim;
+        sim.load(old);
+        EXPECT_EQ(_apply(sim, damaged, 256, &update), ERROR) << "byte " << i;
+        EXPECT_NE(update.error, DELTA_ERROR_NONE);
+        EXPECT_FALSE(sim.swapped) << "byte " << i;
+        EXPECT_EQ(sim.rule_violations, 0);
+    }
+
+    // Truncated, and with trailing bytes
+    std::vector<uint8_t> truncated(patch.begin(), patch.end() - 1);
+    SimulatedFlash sim;
+    sim.load(old);
+    EXPECT_EQ(_apply(sim, truncated, 256, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_SIZE);
+    std::vector<uint8_t> extended = patch;
+    extended.push_back(0);
+    EXPECT_EQ(_apply(sim, extended, 256, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_SIZE);
+    EXPECT_FALSE(sim.swapped);
+}
+
+TEST(delta_update, RejectsMalformedBodies) {
+    std::vector<uint8_t> old = _firmware(1024, 10);
+    std::vector<uint8_t> image(16, 0xAA);
+    SimulatedFlash sim;
+    sim.load(old);
+
+    // A reference before anything was decompressed
+    std::vector<uint8_t> body = {0x00, 0x00, 0x00};
+    EXPECT_EQ(_apply(sim, _with_header(old, image, body), 64, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_CORRUPT);
+
+    // An INSERT longer than the new image
+    body = {0xFF, 0x00, 0x20, 0x00};
+    EXPECT_EQ(_apply(sim, _with_header(old, image, body), 64, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_CORRUPT);
+
+    // An ADD reading past the end of the old image
+    std::vector<uint8_t> small_old(8, 0x00);
+    std::vector<uint8_t> records = {0x10, 0x00, 0x00};
+    records.resize(records.size() + image.size(), 0xAA);
+    body.clear();
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        if (i % 8 == 0)
+        {
+            body.push_back(0xFF);
+        }
+        body.push_back(records[i]);
+    }
+    sim.load(small_old);
+    EXPECT_EQ(_apply(sim, _with_header(small_old, image, body), 64, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_CORRUPT);
+
+    // Header damage and a window larger than the applier holds
+    std::vector<uint8_t> patch = _literal_patch(old, image);
+    patch[5] = DELTA_MAX_WINDOW_BITS + 1;
+    sim.load(old);
+    EXPECT_EQ(_apply(sim, patch, 64, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_HEADER);
+    EXPECT_FALSE(sim.swapped);
+}
+
+TEST(delta_update, ReportsFlashFailures) {
+    std::vector<uint8_t> old = _firmware(2048, 11);
+    std::vector<uint8_t> image = _firmware(2048, 12);
+    std::vector<uint8_t> patch = _literal_patch(old, image);
+
+    SimulatedFlash failing;
+    failing.load(old);
+    failing.fail_writes = true;
+    EXPECT_EQ(_apply(failing, patch, 512, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_FLASH);
+    EXPECT_FALSE(failing.swapped);
+
+    // Written data that does not read back is caught before the swap
+    SimulatedFlash corrupting;
+    corrupting.load(old);
+    corrupting.corrupt_writes = true;
+    EXPECT_EQ(_apply(corrupting, patch, 512, &update), ERROR);
+    EXPECT_EQ(update.error, DELTA_ERROR_READBACK);
+    EXPECT_FALSE(corrupting.swapped);
+}
+
+TEST(delta_update, RamIsBounded) {
+    std::cout << "Applier state: " << sizeof(struct delta_update_t) << " bytes" << std::endl;
+    EXPECT_LT(sizeof(struct delta_update_t), (size_t)5 * 1024);
+}
+
+/**
+ * @brief Benchmark applying a full-size patch to the simulated flash.
+ */
+TEST(delta_update, BenchmarkApply) {
+    std::vector<uint8_t> old = _firmware(SLOT_SIZE, 13);
+    std::vector<uint8_t> image = _revise(std::vector<uint8_t>(old.begin(), old.end() - 4096));
+    std::vector<uint8_t> patch = _python_patch(old, image);
+    if (patch.empty())
+    {
+        patch = _literal_patch(old, image);
+    }
+
+    SimulatedFlash sim;
+    sim.load(old);
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < BENCHMARK_UPDATES; ++n)
+    {
+        ASSERT_EQ(_apply(sim, patch, 128, &update), OK);
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Patch " << patch.size() << " bytes for a " << image.size() << " byte image: "
+              << elapsed.count() / BENCHMARK_UPDATES << " ms to apply" << std::endl;
+
+    EXPECT_EQ(sim.staging(image.size()), image);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
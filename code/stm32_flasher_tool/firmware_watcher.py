@@ -0,0 +1,272 @@
+"""
+firmware_watcher.py
+
+Firmware discovery for the STM32 Flasher tool. Finds the `*CM?.hex` files of
+every device under a base directory and keeps the list current:
+- On Linux, inotify reports file writes, moves and deletions as they happen,
+  so the tree is walked once instead of being globbed every few seconds
+- Elsewhere, the tree is polled and changes are reported only when the set of
+  files or their modification times differ
+
+Files are expected at `<base>/**/CM?/<Debug|Release>/<device>CM?.hex`.
+
+Author: Nicholas Antoniades
+"""
+
+import ctypes
+import ctypes.util
+import glob
+import os
+import select
+import struct
+import sys
+import threading
+from fnmatch import fnmatch
+from pathlib import Path
+from typing import Callable, Dict, List, Optional
+
+COMPILE_TYPES = ('Debug', 'Release')
+POLL_INTERVAL = 2.0  # Seconds between scans where inotify is unavailable
+SETTLE_TIME = 0.5  # Seconds without further changes before reporting
+
+# inotify event masks, from <sys/inotify.h>
+IN_CLOSE_WRITE = 0x00000008
+IN_MOVED_FROM = 0x00000040
+IN_MOVED_TO = 0x00000080
+IN_CREATE = 0x00000100
+IN_DELETE = 0x00000200
+IN_DELETE_SELF = 0x00000400
+IN_MOVE_SELF = 0x00000800
+IN_Q_OVERFLOW = 0x00004000
+IN_IGNORED = 0x00008000
+IN_ONLYDIR = 0x01000000
+IN_ISDIR = 0x40000000
+IN_CLOEXEC = 0o2000000
+WATCH_MASK = (IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_CREATE | IN_DELETE |
+              IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+_EVENT = struct.Struct('iIII')
+
+
+def is_firmware_file(path: str) -> bool:
+    """True for `CM?/<Debug|Release>/*CM?.hex`."""
+    p = Path(path)
+    return (fnmatch(p.name, '*CM?.hex') and p.parent.name in COMPILE_TYPES
+            and fnmatch(p.parent.parent.name, 'CM?'))
+
+
+def group_firmware(paths: List[str], compile_type: str) -> Dict[str, List[str]]:
+    """Group the hex files of one build type by device, one file per core."""
+    firmware_files: Dict[str, List[str]] = {}
+    for path in sorted(paths):
+        if Path(path).parent.name == compile_type:
+            device_name = Path(path).stem[:-3]  # Remove CM? suffix
+            firmware_files.setdefault(device_name, []).append(path)
+    return firmware_files
+
+
+def find_firmware(firmware_path: str, compile_type: str) -> Dict[str, List[str]]:
+    """Glob the firmware files of one build type once."""
+    pattern = os.path.join(os.path.abspath(firmware_path), '**', 'CM?', compile_type, '*CM?.hex')
+    return group_firmware(glob.glob(pattern, recursive=True), compile_type)
+
+
+class FirmwareWatcher:
+    """
+    Tracks the firmware files under a base directory in a background thread and
+    calls on_change() once they have been quiet for SETTLE_TIME after a change.
+    on_change runs on the watcher thread.
+    """
+
+    def __init__(self, firmware_path: str, on_change: Optional[Callable[[], None]] = None,
+                 settle_time: float = SETTLE_TIME):
+        self.firmware_path = os.path.abspath(firmware_path)
+        self.on_change = on_change
+        self.settle_time = settle_time
+        self.backend = 'inotify' if sys.platform.startswith('linux') else 'polling'
+        self._lock = threading.Lock()
+        self._files: Dict[str, float] = {}
+        self._watches: Dict[int, str] = {}
+        self._fd = -1
+        self._stop_read = self._stop_write = -1
+        self._thread: Optional[threading.Thread] = None
+
+    def start(self) -> None:
+        """Scan the tree and start watching it."""
+        self._stop_read, self._stop_write = os.pipe()
+        if self.backend == 'inotify':
+            try:
+                self._start_inotify()
+            except OSError as e:
+                print(f"inotify unavailable ({str(e)}), polling every {POLL_INTERVAL:.0f} s")
+                self._close_inotify()
+                self.backend = 'polling'
+        if self.backend == 'polling':
+            self._files = self._scan()
+
+        self._thread = threading.Thread(
+            target=self._run_inotify if self.backend == 'inotify' else self._run_polling, daemon=True)
+        self._thread.start()
+
+    def stop(self) -> None:
+        if self._thread is not None:
+            os.write(self._stop_write, b'x')
+            self._thread.join()
+            self._thread = None
+        self._close_inotify()
+        for fd in (self._stop_read, self._stop_write):
+            if fd >= 0:
+                os.close(fd)
+        self._stop_read = self._stop_write = -1
+
+    def firmware(self, compile_type: str) -> Dict[str, List[str]]:
+        """Current firmware files of one build type, grouped by device."""
+        with self._lock:
+            return group_firmware(list(self._files), compile_type)
+
+    def modified_times(self) -> Dict[str, float]:
+        with self._lock:
+            return dict(self._files)
+
+    # Polling
+
+    def _scan(self) -> Dict[str, float]:
+        files = {}
+        for compile_type in COMPILE_TYPES:
+            pattern = os.path.join(self.firmware_path, '**', 'CM?', compile_type, '*CM?.hex')
+            for path in glob.glob(pattern, recursive=True):
+                try:
+                    files[path] = os.path.getmtime(path)
+                except OSError:
+                    pass
+        return files
+
+    def _run_polling(self) -> None:
+        while not select.select([self._stop_read], [], [], POLL_INTERVAL)[0]:
+            files = self._scan()
+            with self._lock:
+                changed = files != self._files
+                self._files = files
+            if changed and self.on_change is not None:
+                self.on_change()
+
+    # inotify
+
+    def _start_inotify(self) -> None:
+        self._libc = ctypes.CDLL(ctypes.util.find_library('c') or 'libc.so.6', use_errno=True)
+        self._fd = self._libc.inotify_init1(IN_CLOEXEC)
+        if self._fd < 0:
+            errno = ctypes.get_errno()
+            raise OSError(errno, os.strerror(errno))
+        self._add_tree(self.firmware_path)
+
+    def _close_inotify(self) -> None:
+        if self._fd >= 0:
+            os.close(self._fd)
+            self._fd = -1
+        self._watches.clear()
+
+    def _add_watch(self, directory: str) -> None:
+        wd = self._libc.inotify_add_watch(self._fd, os.fsencode(directory), WATCH_MASK)
+        if wd < 0:
+            errno = ctypes.get_errno()
+            raise OSError(errno, f"Cannot watch {directory}: {os.strerror(errno)}")
+        self._watches[wd] = directory
+
+    def _remove_watches(self, root: str) -> None:
+        """Stop watching a directory and everything below it, once it has been moved away."""
+        prefix = root.rstrip(os.sep) + os.sep
+        for wd, directory in list(self._watches.items()):
+            if directory == root or directory.startswith(prefix):
+                self._libc.inotify_rm_watch(self._fd, wd)
+                del self._watches[wd]
+
+    def _add_tree(self, root: str) -> None:
+        """Watch a directory and everything below it, and record the firmware files in it."""
+        for directory, subdirectories, files in os.walk(root):
+            subdirectories[:] = [name for name in subdirectories if not name.startswith('.')]
+            self._add_watch(directory)
+            for name in files:
+                self._update(os.path.join(directory, name))
+
+    def _update(self, path: str) -> bool:
+        """Record or forget one file after an event. Returns True if the firmware set changed."""
+        if not is_firmware_file(path):
+            return False
+        try:
+            mtime = os.path.getmtime(path)
+        except OSError:
+            mtime = None
+        with self._lock:
+            if mtime is None:
+                return self._files.pop(path, None) is not None
+            changed = self._files.get(path) != mtime
+            self._files[path] = mtime
+            return changed
+
+    def _forget_tree(self, root: str) -> bool:
+        prefix = root.rstrip(os.sep) + os.sep
+        with self._lock:
+            removed = [path for path in self._files if path.startswith(prefix)]
+            for path in removed:
+                del self._files[path]
+        return bool(removed)
+
+    def _handle(self, data: bytes) -> bool:
+        """Apply a buffer of inotify events. Returns True if the firmware set changed."""
+        changed = False
+        offset = 0
+        while offset + _EVENT.size <= len(data):
+            wd, mask, _, length = _EVENT.unpack_from(data, offset)
+            name = data[offset + _EVENT.size:offset + _EVENT.size + length].split(b'\0', 1)[0]
+            offset += _EVENT.size + length
+
+            if mask & IN_Q_OVERFLOW:
+                # Events were lost, rebuild from the tree
+                files = self._scan()
+                with self._lock:
+                    changed |= files != self._files
+                    self._files = files
+                continue
+            if mask & IN_IGNORED:
+                self._watches.pop(wd, None)
+                continue
+
+            directory = self._watches.get(wd)
+            if directory is None:
+                continue
+            path = os.path.join(directory, os.fsdecode(name)) if name else directory
+
+            if mask & IN_ISDIR:
+                if mask & (IN_CREATE | IN_MOVED_TO) and not os.path.basename(path).startswith('.'):
+                    # Files may have been written before the watch was in place
+                    before = self.modified_times()
+                    self._add_tree(path)
+                    changed |= self.modified_times() != before
+                elif mask & (IN_DELETE | IN_MOVED_FROM):
+                    # A moved directory keeps its watches, which would report under the old path
+                    if mask & IN_MOVED_FROM:
+                        self._remove_watches(path)
+                    changed |= self._forget_tree(path)
+            elif mask & (IN_DELETE_SELF | IN_MOVE_SELF):
+                changed |= self._forget_tree(path)
+            elif mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM):
+                changed |= self._update(path)
+        return changed
+
+    def _run_inotify(self) -> None:
+        pending = False
+        while True:
+            timeout = self.settle_time if pending else None
+            ready = select.select([self._fd, self._stop_read], [], [], timeout)[0]
+            if self._stop_read in ready:
+                return
+            if self._fd in ready:
+                try:
+                    pending |= self._handle(os.read(self._fd, 65536))
+                except OSError as e:
+                    print(f"Firmware watch error: {str(e)}")
+                continue
+            # Quiet for the settle time after a change
+            pending = False
+            if self.on_change is not None:
+                self.on_change()
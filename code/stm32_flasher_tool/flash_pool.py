@@ -0,0 +1,123 @@
+"""
+flash_pool.py
+
+Concurrent flashing for the STM32 Flasher tool. Each job programs one device's
+firmware through one probe; jobs on different probes run in parallel on a
+worker pool, and jobs sharing a probe run one after another. Progress is
+reported per job as it arrives from the programmer.
+
+The programmer is any module or object with the stm32_prog_windows flashing
+API: flash_all(hex_files, probe=..., progress=...) and list_probes().
+
+Author: Nicholas Antoniades
+"""
+
+import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Callable, Dict, List, NamedTuple, Optional
+
+MAX_WORKERS = 16
+
+class FlashJob(NamedTuple):
+    device: str
+    hex_files: List[str]
+    probe: Optional[str] = None  # ST-Link serial number or UART port, None for the first ST-Link
+
+class FlashResult(NamedTuple):
+    job: FlashJob
+    ok: bool
+    seconds: float
+    error: str = ''
+
+class FlashPool:
+    """Worker pool flashing jobs concurrently, at most one job per probe at a time."""
+
+    def __init__(
+        self,
+        programmer,
+        workers: int = MAX_WORKERS,
+        progress: Optional[Callable[[FlashJob, float, str], None]] = None
+    ):
+        """
+        Args:
+            programmer: Flashing back-end, e.g. stm32_prog_windows or mock_programmer
+            workers: Maximum number of jobs in flight
+            progress: Called from the worker threads with (job, percent, stage)
+        """
+        self.programmer = programmer
+        self.progress = progress
+        self._executor = ThreadPoolExecutor(max_workers=max(1, workers), thread_name_prefix='flash')
+        self._probe_locks: Dict[Optional[str], threading.Lock] = {}
+        self._lock = threading.Lock()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    def submit(self, job: FlashJob) -> Future:
+        """Queue a job. The future resolves to its FlashResult."""
+        with self._lock:
+            self._probe_locks.setdefault(job.probe, threading.Lock())
+        return self._executor.submit(self._flash, job)
+
+    def run(self, jobs: List[FlashJob]) -> List[FlashResult]:
+        """Flash every job and wait for all of them, in job order."""
+        futures = [self.submit(job) for job in jobs]
+        return [future.result() for future in futures]
+
+    def close(self) -> None:
+        """Wait for queued jobs and stop the workers."""
+        self._executor.shutdown(wait=True)
+
+    def _flash(self, job: FlashJob) -> FlashResult:
+        with self._probe_locks[job.probe]:
+            self._report(job, 0.0, 'start')
+            start_time = time.perf_counter()
+            try:
+                self.programmer.flash_all(
+                    job.hex_files,
+                    probe=job.probe,
+                    progress=lambda percent, stage: self._report(job, percent, stage)
+                )
+            except Exception as e:
+                result = FlashResult(job, False, time.perf_counter() - start_time, str(e))
+                self._report(job, -1.0, 'failed')
+                return result
+            result = FlashResult(job, True, time.perf_counter() - start_time)
+            self._report(job, 100.0, 'done')
+            return result
+
+    def _report(self, job: FlashJob, percent: float, stage: str) -> None:
+        if self.progress is not None:
+            self.progress(job, percent, stage)
+
+def assign_jobs(
+    firmware_files: Dict[str, List[str]],
+    devices: List[str],
+    probes: List[Optional[str]]
+) -> List[FlashJob]:
+    """
+    Pair devices with probes: one device goes to every probe, otherwise devices
+    and probes are paired in order and their counts must match. Without probes
+    only one device can be flashed, through the first ST-Link.
+
+    Raises:
+        ValueError: If a device has no firmware, the counts do not match or several
+            devices are given without probes
+    """
+    missing = [device for device in devices if device not in firmware_files]
+    if missing:
+        raise ValueError(f"No firmware for: {', '.join(missing)}")
+    if not probes:
+        if len(devices) > 1:
+            raise ValueError(f"No probes found for {len(devices)} devices, give one probe per device")
+        probes = [None]
+
+    if len(devices) == 1:
+        return [FlashJob(devices[0], firmware_files[devices[0]], probe) for probe in probes]
+    if len(devices) != len(probes):
+        raise ValueError(f"{len(devices)} devices for {len(probes)} probes, give one probe per device")
+    return [FlashJob(device, firmware_files[device], probe) for device, probe in zip(devices, probes)]
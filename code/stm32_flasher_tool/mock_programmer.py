@@ -0,0 +1,88 @@
+"""
+mock_programmer.py
+
+Stand-in for stm32_prog_windows with the same flashing API, for exercising the
+flasher's worker pool, progress reporting and CLI without probes or targets.
+Programming takes time in proportion to the hex file size, each probe can be
+used by one job at a time (as with a real ST-Link), and probes listed in
+FAIL_PROBES fail verification.
+
+Author: Nicholas Antoniades
+"""
+
+import os
+import threading
+import time
+from pathlib import Path
+from typing import Callable, List, Optional, Union
+
+MOCK_PROBES = ['MOCK0', 'MOCK1', 'MOCK2', 'MOCK3']
+FLASH_RATE = 64 * 1024  # Hex file bytes programmed per second
+RESET_TIME = 0.2  # Seconds
+PROGRESS_STEPS = 10
+FAIL_PROBES = set()
+
+_busy = set()
+_busy_lock = threading.Lock()
+
+def list_probes() -> List[str]:
+    """List the mock probes."""
+    return list(MOCK_PROBES)
+
+def _claim(probe: Optional[str]) -> None:
+    with _busy_lock:
+        if probe in _busy:
+            raise RuntimeError(f"Probe {probe} is already in use")
+        _busy.add(probe)
+
+def _release(probe: Optional[str]) -> None:
+    with _busy_lock:
+        _busy.discard(probe)
+
+def flash(
+    hex_file: Union[str, Path],
+    go: bool = False,
+    probe: Optional[str] = None,
+    progress: Optional[Callable[[float], None]] = None
+) -> None:
+    """Pretend to program and verify a hex file."""
+    hex_path = Path(hex_file)
+    if not hex_path.exists():
+        raise FileNotFoundError(f"Hex file not found: {hex_path}")
+
+    _claim(probe)
+    try:
+        step_time = os.path.getsize(hex_path) / FLASH_RATE / PROGRESS_STEPS
+        for step in range(1, PROGRESS_STEPS + 1):
+            time.sleep(step_time)
+            if progress is not None:
+                progress(100.0 * step / PROGRESS_STEPS)
+        if probe in FAIL_PROBES:
+            raise RuntimeError(f"Verify failed on {probe}")
+    finally:
+        _release(probe)
+
+def target_reset(probe: Optional[str] = None) -> None:
+    """Pretend to reset the target."""
+    _claim(probe)
+    try:
+        time.sleep(RESET_TIME)
+    finally:
+        _release(probe)
+
+def flash_all(
+    hex_files: List[Union[str, Path]],
+    probe: Optional[str] = None,
+    progress: Optional[Callable[[float, str], None]] = None
+) -> None:
+    """Flash multiple hex files and reset target, as stm32_prog_windows.flash_all."""
+    for index, hex_file in enumerate(hex_files):
+        file_progress = None
+        if progress is not None:
+            name = Path(hex_file).name
+            file_progress = lambda percent, index=index, name=name: progress(
+                100.0 * (index + percent / 100.0) / len(hex_files), name)
+        flash(hex_file, probe=probe, progress=file_progress)
+    if progress is not None:
+        progress(100.0, 'reset')
+    target_reset(probe)
@@ -7,131 +7,220 @@ Features:
 - Support for Debug/Release builds
 - Real-time file monitoring
 - Simple one-click flashing
+- Parallel flashing of several targets, one probe each, with per-device progress
 
 Author: Nicholas Antoniades
 """
 
 import os
-import glob
 import sys
 import time
+from concurrent.futures import Future
 from pathlib import Path
-from typing import Dict, List
+from typing import Dict, List, Optional
 
-from PyQt5.QtWidgets import (QApplication, QWidget, QGridLayout, QLabel, QPushButton, QMessageBox, QCheckBox)
-from PyQt5.QtCore import QTimer, Qt
-from stm32_prog_windows import flash_all
+from PyQt5.QtWidgets import (QApplication, QWidget, QGridLayout, QLabel, QPushButton, QMessageBox, QCheckBox,
+                             QComboBox, QProgressBar)
+from PyQt5.QtCore import Qt, pyqtSignal
+from firmware_watcher import FirmwareWatcher
+from flash_pool import FlashJob, FlashPool, FlashResult
+import mock_programmer
 import argparse
 
+DEFAULT_PROBE = 'First ST-Link'
+
 class FlasherApp(QWidget):
     """Main application window for the STM32 Flasher tool."""
-    
-    def __init__(self, firmware_path: str):
+
+    # Emitted from the watcher and worker threads, handled on the GUI thread
+    firmware_changed = pyqtSignal()
+    flash_progress = pyqtSignal(str, float, str)
+    flash_finished = pyqtSignal(object)
+
+    def __init__(self, firmware_path: str, programmer):
         super().__init__()
         self.firmware_path = firmware_path
+        self.programmer = programmer
         self.compile_type = 'Debug'
         self.firmware_files: Dict[str, List[str]] = {}
-        
+        self.device_probes: Dict[str, Optional[str]] = {}
+        self.progress: Dict[str, QProgressBar] = {}
+        self._row_widgets: List[QWidget] = []
+
+        try:
+            self.probes = programmer.list_probes()
+        except (OSError, RuntimeError) as e:
+            print(f"Could not list probes: {str(e)}")
+            self.probes = []
+        self.pool = FlashPool(programmer, progress=lambda job, percent, stage: self.flash_progress.emit(
+            job.device, percent, stage))
+
         self._init_ui()
-        self._setup_timer()
+        self.firmware_changed.connect(self._load_firmware_files)
+        self.flash_progress.connect(self._on_flash_progress)
+        self.flash_finished.connect(self._on_flash_finished)
+        self._setup_watcher()
         self._load_firmware_files()
 
     def _init_ui(self) -> None:
         """Initialize the user interface."""
         self.setWindowTitle("STM32 Firmware Flasher")
-        self.setGeometry(100, 100, 600, 300)
-        
+        self.setGeometry(100, 100, 800, 300)
+
         self.grid = QGridLayout()
         self.setLayout(self.grid)
-        
+
         # Create header labels
-        headers = ["Device", "Firmware Files", "Last Modified", "Actions"]
+        headers = ["Device", "Firmware Files", "Last Modified", "Probe", "Progress", "Actions"]
         for col, header in enumerate(headers):
             self.grid.addWidget(QLabel(header), 0, col)
-        
+
         # Add compile type selector
         self.compile_checkbox = QCheckBox("Release Mode")
         self.compile_checkbox.stateChanged.connect(self._on_compile_type_changed)
-        self.grid.addWidget(self.compile_checkbox, 0, 4)
+        self.grid.addWidget(self.compile_checkbox, 0, 6)
 
-    def _setup_timer(self) -> None:
-        """Setup automatic UI refresh timer."""
-        self.refresh_timer = QTimer(self)
-        self.refresh_timer.setInterval(2000)  # 2 second refresh
-        self.refresh_timer.timeout.connect(self._refresh_ui)
-        self.refresh_timer.start()
+        # Flash every device at once, each through its own probe
+        self.flash_all_button = QPushButton('Flash All')
+        self.flash_all_button.clicked.connect(self._flash_all_devices)
+        self.grid.addWidget(self.flash_all_button, 0, 7)
+
+    def _setup_watcher(self) -> None:
+        """Watch the firmware tree, refreshing the UI only when files change."""
+        self.watcher = FirmwareWatcher(self.firmware_path, on_change=self.firmware_changed.emit)
+        self.watcher.start()
 
     def _load_firmware_files(self) -> None:
-        """Load firmware files from the specified path."""
-        pattern = os.path.join(self.firmware_path, '**', 'CM?', 
-                             self.compile_type, '*CM?.hex')
-        firmware_paths = glob.glob(pattern, recursive=True)
-        
-        self.firmware_files = {}
-        for i in range(0, len(firmware_paths), 2):
-            if i + 1 < len(firmware_paths):
-                device_name = Path(firmware_paths[i]).stem[:-3]  # Remove CM? suffix
-                self.firmware_files[device_name] = firmware_paths[i:i+2]
+        """Load firmware files from the watched tree."""
+        self.firmware_files = self.watcher.firmware(self.compile_type)
+        self._refresh_ui()
 
     def _on_compile_type_changed(self, state: int) -> None:
         """Handle compile type checkbox state changes."""
         self.compile_type = 'Release' if state == Qt.Checked else 'Debug'
         self._load_firmware_files()
-        self._refresh_ui()
 
     def _refresh_ui(self) -> None:
         """Refresh the UI with current firmware information."""
-        # Clear existing widgets except headers and checkbox
-        for i in reversed(range(self.grid.count())):
-            widget = self.grid.itemAt(i).widget()
-            if isinstance(widget, (QLabel, QPushButton)) and widget != self.compile_checkbox:
-                widget.deleteLater()
+        # Clear the device rows, keeping headers and controls
+        for widget in self._row_widgets:
+            widget.deleteLater()
+        self._row_widgets = []
+        previous = {device: (bar.value(), bar.format()) for device, bar in self.progress.items()}
+        self.progress = {}
 
         # Add firmware information
         for row, (device_name, hex_files) in enumerate(self.firmware_files.items(), start=1):
             # Device name
-            self.grid.addWidget(QLabel(device_name), row, 0)
-            
+            self._add_row_widget(QLabel(device_name), row, 0)
+
             # Firmware files
-            self.grid.addWidget(QLabel('\n'.join(Path(f).name for f in hex_files)), row, 1)
-            
+            self._add_row_widget(QLabel('\n'.join(Path(f).name for f in hex_files)), row, 1)
+
             # Last modified times
             try:
                 mtimes = [time.ctime(os.path.getmtime(f)) for f in hex_files]
-                self.grid.addWidget(QLabel('\n'.join(mtimes)), row, 2)
-                
-                # Flash button
-                flash_btn = QPushButton('Flash')
-                flash_btn.clicked.connect(lambda checked, d=device_name: self._flash_device(d))
-                self.grid.addWidget(flash_btn, row, 3)
+                self._add_row_widget(QLabel('\n'.join(mtimes)), row, 2)
             except OSError as e:
-                self.grid.addWidget(QLabel(f"Error: {str(e)}"), row, 2)
+                self._add_row_widget(QLabel(f"Error: {str(e)}"), row, 2)
+                continue
+
+            # Probe, a different one per row by default
+            if device_name not in self.device_probes:
+                self.device_probes[device_name] = self.probes[(row - 1) % len(self.probes)] if self.probes else None
+            probe_box = QComboBox()
+            probe_box.addItems([DEFAULT_PROBE, *self.probes])
+            probe_box.setCurrentText(self.device_probes[device_name] or DEFAULT_PROBE)
+            probe_box.currentTextChanged.connect(
+                lambda text, d=device_name: self.device_probes.update({d: None if text == DEFAULT_PROBE else text}))
+            self._add_row_widget(probe_box, row, 3)
+
+            # Progress
+            progress_bar = QProgressBar()
+            progress_bar.setRange(0, 100)
+            value, text = previous.get(device_name, (0, '%p%'))
+            progress_bar.setValue(value)
+            progress_bar.setFormat(text)
+            self.progress[device_name] = progress_bar
+            self._add_row_widget(progress_bar, row, 4)
+
+            # Flash button
+            flash_btn = QPushButton('Flash')
+            flash_btn.clicked.connect(lambda checked, d=device_name: self._flash_device(d))
+            self._add_row_widget(flash_btn, row, 5)
+
+    def _add_row_widget(self, widget: QWidget, row: int, col: int) -> None:
+        self.grid.addWidget(widget, row, col)
+        self._row_widgets.append(widget)
 
     def _flash_device(self, device_name: str) -> None:
-        """Flash firmware to the selected device."""
-        try:
-            flash_all(self.firmware_files[device_name])
-        except Exception as e:
+        """Queue firmware flashing of the selected device; it runs alongside other probes."""
+        job = FlashJob(device_name, list(self.firmware_files[device_name]), self.device_probes.get(device_name))
+        # Shown until the job's probe is free
+        progress_bar = self.progress.get(device_name)
+        if progress_bar is not None:
+            progress_bar.setValue(0)
+            progress_bar.setFormat('queued')
+        future: Future = self.pool.submit(job)
+        future.add_done_callback(lambda done: self.flash_finished.emit(done.result()))
+
+    def _flash_all_devices(self) -> None:
+        """Flash every listed device in parallel, or one at a time when no probes were found."""
+        if not self.probes and len(self.firmware_files) > 1:
+            QMessageBox.warning(
+                self,
+                "No Probes",
+                "No probes were found, so the devices are flashed one at a time through the first ST-Link.",
+                QMessageBox.Ok
+            )
+        for device_name in self.firmware_files:
+            self._flash_device(device_name)
+
+    def _on_flash_progress(self, device_name: str, percent: float, stage: str) -> None:
+        progress_bar = self.progress.get(device_name)
+        if progress_bar is None:
+            return
+        if percent < 0:
+            progress_bar.setFormat('Failed')
+            return
+        progress_bar.setValue(int(percent))
+        progress_bar.setFormat(f"{stage} %p%" if stage not in ('start', 'done') else '%p%')
+
+    def _on_flash_finished(self, result: FlashResult) -> None:
+        if not result.ok:
             QMessageBox.critical(
                 self,
                 "Flashing Error",
-                f"Failed to flash {device_name}:\n{str(e)}",
+                f"Failed to flash {result.job.device}:\n{result.error}",
                 QMessageBox.Ok
             )
 
+    def closeEvent(self, event) -> None:
+        """Stop watching and wait for flashing in progress before closing."""
+        self.watcher.stop()
+        self.pool.close()
+        super().closeEvent(event)
+
 def main():
     """Application entry point."""
     parser = argparse.ArgumentParser(description='STM32 Firmware Flasher Tool')
-    parser.add_argument('--base-dir', type=str, 
+    parser.add_argument('--base-dir', type=str,
                        default=os.path.dirname(os.path.abspath(__file__)),
                        help='Base directory path containing firmware files')
-    
+    parser.add_argument('--mock', action='store_true', help='Use the mock programmer back-end')
+
     args = parser.parse_args()
     fw_path = os.path.join(args.base_dir, '..', '..', '..')
     print(f"Searching for firmware in: {fw_path}")
 
+    if args.mock:
+        programmer = mock_programmer
+    else:
+        import stm32_prog_windows
+        programmer = stm32_prog_windows
+
     app = QApplication(sys.argv)
-    window = FlasherApp(fw_path)
+    window = FlasherApp(fw_path, programmer)
     window.show()
     sys.exit(app.exec_())
 
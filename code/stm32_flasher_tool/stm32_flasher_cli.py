@@ -0,0 +1,161 @@
+"""
+stm32_flasher_cli.py
+
+Headless command line mode of the STM32 Flasher tool, for benches without a
+display. Lists firmware and probes, flashes devices through several probes at
+once with per-probe progress, and can watch the firmware tree and reflash
+whenever a build finishes.
+
+Examples:
+    python stm32_flasher_cli.py --list
+    python stm32_flasher_cli.py --flash array_ctrl                  # to every ST-Link found
+    python stm32_flasher_cli.py --flash array_ctrl --probe 0670FF --probe 0671AA
+    python stm32_flasher_cli.py --flash array_ctrl --watch --release
+    python stm32_flasher_cli.py --flash array_ctrl --mock           # no hardware
+
+Author: Nicholas Antoniades
+"""
+
+import argparse
+import os
+import sys
+import threading
+import time
+from typing import Dict, List
+
+import mock_programmer
+from firmware_watcher import FirmwareWatcher, find_firmware
+from flash_pool import FlashJob, FlashPool, FlashResult, assign_jobs
+
+class ProgressPrinter:
+    """Prints per-job progress: one status line on a terminal, milestones otherwise."""
+
+    MILESTONE = 25  # Percent between lines when not on a terminal
+
+    def __init__(self):
+        self.interactive = sys.stdout.isatty()
+        self._lock = threading.Lock()
+        self._status: Dict[str, str] = {}
+        self._milestones: Dict[str, int] = {}
+
+    def __call__(self, job: FlashJob, percent: float, stage: str) -> None:
+        label = f"{job.device}@{job.probe or 'SWD'}"
+        with self._lock:
+            if self.interactive:
+                self._status[label] = 'FAILED' if percent < 0 else f"{percent:3.0f}%"
+                line = '  '.join(f"{name} {status}" for name, status in self._status.items())
+                print(f"\r{line}", end='', flush=True)
+            else:
+                milestone = -1 if percent < 0 else int(percent // self.MILESTONE) * self.MILESTONE
+                if self._milestones.get(label) != milestone:
+                    self._milestones[label] = milestone
+                    print(f"{label}: {stage} {max(percent, 0):.0f}%", flush=True)
+
+    def finish(self) -> None:
+        with self._lock:
+            if self.interactive and self._status:
+                print()
+            self._status.clear()
+            self._milestones.clear()
+
+def print_results(results: List[FlashResult], elapsed: float) -> bool:
+    """Print one line per job and the time saved by flashing in parallel. Returns True if all passed."""
+    for result in results:
+        status = 'OK' if result.ok else f"FAILED: {result.error}"
+        print(f"  {result.job.device} via {result.job.probe or 'SWD'}: {status} ({result.seconds:.1f} s)")
+    sequential = sum(result.seconds for result in results)
+    print(f"Flashed {sum(result.ok for result in results)}/{len(results)} targets in {elapsed:.1f} s "
+          f"({sequential:.1f} s one at a time)")
+    return all(result.ok for result in results)
+
+def flash_jobs(pool: FlashPool, jobs: List[FlashJob], printer: ProgressPrinter) -> bool:
+    start_time = time.perf_counter()
+    results = pool.run(jobs)
+    printer.finish()
+    return print_results(results, time.perf_counter() - start_time)
+
+def main() -> int:
+    """Command line entry point."""
+    parser = argparse.ArgumentParser(description='STM32 Firmware Flasher Tool, headless mode')
+    parser.add_argument('--base-dir', type=str,
+                        default=os.path.dirname(os.path.abspath(__file__)),
+                        help='Base directory path containing firmware files')
+    parser.add_argument('--release', action='store_true', help='Use Release instead of Debug builds')
+    parser.add_argument('--list', action='store_true', help='List firmware files and probes')
+    parser.add_argument('--flash', nargs='+', metavar='DEVICE', default=[],
+                        help='Devices to flash: one device to every probe, or one device per probe')
+    parser.add_argument('--probe', action='append', default=[],
+                        help='ST-Link serial number or UART port, repeatable (default: every ST-Link found)')
+    parser.add_argument('--watch', action='store_true', help='Reflash whenever the firmware changes')
+    parser.add_argument('--mock', action='store_true', help='Use the mock programmer back-end')
+    parser.add_argument('--mock-fail', action='append', default=[], metavar='PROBE',
+                        help='Mock probe that fails verification, repeatable')
+
+    args = parser.parse_args()
+    fw_path = os.path.join(args.base_dir, '..', '..', '..')
+    compile_type = 'Release' if args.release else 'Debug'
+    print(f"Searching for firmware in: {fw_path}")
+
+    if args.mock:
+        mock_programmer.FAIL_PROBES.update(args.mock_fail)
+        programmer = mock_programmer
+    else:
+        import stm32_prog_windows
+        programmer = stm32_prog_windows
+
+    firmware_files = find_firmware(fw_path, compile_type)
+    probes = args.probe or programmer.list_probes()
+
+    if args.list or not args.flash:
+        for device_name, hex_files in firmware_files.items():
+            print(f"{device_name}:")
+            for hex_file in hex_files:
+                print(f"  {hex_file}  {time.ctime(os.path.getmtime(hex_file))}")
+        print(f"Probes: {', '.join(probes) if probes else 'none found'}")
+        return 0
+
+    try:
+        jobs = assign_jobs(firmware_files, args.flash, probes)
+    except ValueError as e:
+        print(str(e))
+        return 2
+
+    printer = ProgressPrinter()
+    with FlashPool(programmer, progress=printer) as pool:
+        ok = flash_jobs(pool, jobs, printer)
+        if not args.watch:
+            return 0 if ok else 1
+
+        # Reflash when a build of the selected devices finishes
+        changed = threading.Event()
+        watcher = FirmwareWatcher(fw_path, on_change=changed.set)
+        watcher.start()
+        print(f"Watching for new firmware ({watcher.backend}), Ctrl+C to stop")
+        flashed = {path: mtime for path, mtime in watcher.modified_times().items()
+                   if any(path in job.hex_files for job in jobs)}
+        try:
+            while True:
+                changed.wait()
+                changed.clear()
+                firmware_files = watcher.firmware(compile_type)
+                current = {path: mtime for path, mtime in watcher.modified_times().items()
+                           if any(path in hex_files for device, hex_files in firmware_files.items()
+                                  if device in args.flash)}
+                if current == flashed:
+                    continue
+                flashed = current
+                try:
+                    jobs = assign_jobs(firmware_files, args.flash, probes)
+                except ValueError as e:
+                    print(str(e))
+                    continue
+                print(f"\nFirmware changed, reflashing {', '.join(args.flash)}")
+                flash_jobs(pool, jobs, printer)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            watcher.stop()
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
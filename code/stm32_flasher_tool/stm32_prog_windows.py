@@ -7,98 +7,180 @@ STM32CubeProgrammer CLI. Provides a clean interface for common operations:
 - Memory reading and writing
 - Sector and full chip erasure
 - Device reset functionality
+- Probe selection, so several targets can be programmed at once
+
+Every operation takes an optional probe: an ST-Link serial number (SWD), or a
+UART port such as COM3 or /dev/ttyUSB0. Without one the first ST-Link is used.
+The CLI is also found on PATH or through the STM32_PROG_CLI environment variable,
+so the same API works on a Linux bench.
 
 Author: Nicholas Antoniades
 """
 
 import subprocess
 import os
+import shutil
 import time
 import re
-from typing import List, Union
+from typing import Callable, List, Optional, Union
 from pathlib import Path
 
 # STM32 Programmer CLI path
-STM32_PROG_CLI = Path(r'C:\Program Files\STMicroelectronics\STM32Cube\STM32CubeProgrammer\bin\STM32_Programmer_CLI.exe')
+STM32_PROG_CLI = Path(
+    os.environ.get('STM32_PROG_CLI')
+    or shutil.which('STM32_Programmer_CLI')
+    or r'C:\Program Files\STMicroelectronics\STM32Cube\STM32CubeProgrammer\bin\STM32_Programmer_CLI.exe'
+)
 
-# Verify programmer exists
-if not STM32_PROG_CLI.exists():
-    raise FileNotFoundError(f"STM32 Programmer CLI not found at: {STM32_PROG_CLI}")
+PROGRESS_PATTERN = re.compile(rb'(\d{1,3})\s*%')
+LINE_END = re.compile(rb'[\r\n]')  # The progress bar redraws its line with carriage returns
+OUTPUT_TAIL = 2000  # Characters of programmer output kept for error messages
 
-def _run_programmer(args: List[str], capture_output: bool = False) -> subprocess.CompletedProcess:
+def _connect_args(probe: Optional[str] = None, mode: Optional[str] = None) -> List[str]:
+    """
+    Connection arguments for a probe.
+    
+    Args:
+        probe: ST-Link serial number or UART port, None for the first ST-Link
+        mode: Optional connection mode, e.g. Normal or HOTPLUG
+    
+    Returns:
+        List of command arguments
+    """
+    if probe is None:
+        args = ['-c', 'port=SWD']
+    elif probe.upper().startswith('COM') or probe.startswith('/dev/'):
+        args = ['-c', f'port={probe}']
+    else:
+        args = ['-c', 'port=SWD', f'sn={probe}']
+    if mode:
+        args.append(f'mode={mode}')
+    return args
+
+def _run_programmer(
+    args: List[str],
+    capture_output: bool = False,
+    progress: Optional[Callable[[float], None]] = None
+) -> subprocess.CompletedProcess:
     """
     Execute STM32 programmer with given arguments and handle errors.
     
     Args:
         args: List of command arguments
         capture_output: Whether to capture command output
+        progress: Called with each percentage the programmer reports; the
+            output is then read as it arrives instead of printed
     
     Returns:
         CompletedProcess instance
     
     Raises:
+        FileNotFoundError: If the programmer CLI is not installed
         RuntimeError: If programmer command fails
     """
-    try:
-        result = subprocess.run(
-            [STM32_PROG_CLI, *args],
-            stdout=subprocess.PIPE if capture_output else None,
-            check=True
-        )
-        return result
-    except subprocess.CalledProcessError as e:
-        raise RuntimeError(f"STM32 Programmer command failed: {' '.join(args)}") from e
-
-def flash_erase() -> None:
+    if not STM32_PROG_CLI.exists():
+        raise FileNotFoundError(f"STM32 Programmer CLI not found at: {STM32_PROG_CLI}")
+
+    if progress is None:
+        try:
+            result = subprocess.run(
+                [STM32_PROG_CLI, *args],
+                stdout=subprocess.PIPE if capture_output else None,
+                check=True
+            )
+            return result
+        except subprocess.CalledProcessError as e:
+            raise RuntimeError(f"STM32 Programmer command failed: {' '.join(args)}") from e
+
+    output = b''
+    line = b''
+    with subprocess.Popen([STM32_PROG_CLI, *args], stdout=subprocess.PIPE, stderr=subprocess.STDOUT) as process:
+        while True:
+            chunk = process.stdout.read1(4096)
+            # Match complete lines only, a percentage can be split across reads
+            lines = LINE_END.split(line + chunk)
+            line = lines.pop() if chunk else b''
+            for complete in lines:
+                for match in PROGRESS_PATTERN.finditer(complete):
+                    progress(min(float(match.group(1)), 100.0))
+            if not chunk:
+                break
+            output = (output + chunk)[-OUTPUT_TAIL:]
+
+    if process.returncode != 0:
+        tail = output.decode(errors='replace').strip().splitlines()[-1:] or ['']
+        raise RuntimeError(f"STM32 Programmer command failed: {' '.join(args)}: {tail[0]}")
+    return subprocess.CompletedProcess(process.args, process.returncode, output if capture_output else None)
+
+def list_probes() -> List[str]:
+    """
+    List the serial numbers of the connected ST-Link probes.
+    
+    Returns:
+        List of serial numbers
+    """
+    result = _run_programmer(['-l', 'st-link'], capture_output=True)
+    return re.findall(r'ST-?LINK SN\s*:\s*(\w+)', result.stdout.decode(errors='replace'), re.IGNORECASE)
+
+def flash_erase(probe: Optional[str] = None) -> None:
     """Erase entire flash memory."""
-    _run_programmer(['-c', 'port=SWD', '-e', 'all'])
+    _run_programmer([*_connect_args(probe), '-e', 'all'])
 
-def erase_sectors(sectors: List[int]) -> None:
+def erase_sectors(sectors: List[int], probe: Optional[str] = None) -> None:
     """
     Erase specific flash sectors.
     
     Args:
         sectors: List of sector numbers to erase
+        probe: ST-Link serial number or UART port
     """
     sectors_str = ','.join(map(str, sectors))
-    _run_programmer(['-c', 'port=SWD', '-e', sectors_str])
-
-def flash(hex_file: Union[str, Path], go: bool = False) -> None:
+    _run_programmer([*_connect_args(probe), '-e', sectors_str])
+
+def flash(
+    hex_file: Union[str, Path],
+    go: bool = False,
+    probe: Optional[str] = None,
+    progress: Optional[Callable[[float], None]] = None
+) -> None:
     """
     Program hex file to device and optionally start execution.
     
     Args:
         hex_file: Path to hex file
         go: Whether to start program execution after flashing
+        probe: ST-Link serial number or UART port
+        progress: Called with the percentage programmed so far
     """
     hex_path = Path(hex_file)
     if not hex_path.exists():
         raise FileNotFoundError(f"Hex file not found: {hex_path}")
 
-    args = ['-c', 'port=SWD', '-w', str(hex_path), '-v']
+    args = [*_connect_args(probe), '-w', str(hex_path), '-v']
     if go:
         args.append('-g')
     
-    _run_programmer(args)
+    _run_programmer(args, progress=progress)
 
-def target_reset() -> None:
+def target_reset(probe: Optional[str] = None) -> None:
     """Reset target device and wait for it to initialize."""
-    _run_programmer(['-c', 'port=SWD', 'mode=Normal'])
+    _run_programmer(_connect_args(probe, 'Normal'))
     time.sleep(1)  # Allow device to initialize
 
-def read_mem(address: int, count: int = 1) -> List[int]:
+def read_mem(address: int, count: int = 1, probe: Optional[str] = None) -> List[int]:
     """
     Read 32-bit words from memory.
     
     Args:
         address: Starting memory address
         count: Number of 32-bit words to read
+        probe: ST-Link serial number or UART port
     
     Returns:
         List of read values
     """
     result = _run_programmer([
-        '-c', 'port=SWD', 'mode=HOTPLUG',
+        *_connect_args(probe, 'HOTPLUG'),
         '-r32', f'0x{address:x}', f'0x{4*count:x}'
     ], capture_output=True)
 
@@ -114,29 +196,43 @@ def read_mem(address: int, count: int = 1) -> List[int]:
     
     return data
 
-def write_mem(address: int, data: List[int]) -> None:
+def write_mem(address: int, data: List[int], probe: Optional[str] = None) -> None:
     """
     Write 32-bit words to memory.
     
     Args:
         address: Starting memory address
         data: List of values to write
+        probe: ST-Link serial number or UART port
     """
     data_str = [f'0x{d:x}' for d in data]
     _run_programmer([
-        '-c', 'port=SWD', 'mode=HOTPLUG',
+        *_connect_args(probe, 'HOTPLUG'),
         '-w32', f'0x{address:x}', *data_str
     ])
 
-def flash_all(hex_files: List[Union[str, Path]]) -> None:
+def flash_all(
+    hex_files: List[Union[str, Path]],
+    probe: Optional[str] = None,
+    progress: Optional[Callable[[float, str], None]] = None
+) -> None:
     """
     Flash multiple hex files and reset target.
     
     Args:
         hex_files: List of hex file paths to program
+        probe: ST-Link serial number or UART port
+        progress: Called with the overall percentage and the current stage
     """
-    for hex_file in hex_files:
-        print(f'Programming: {hex_file}')
-        flash(hex_file)
+    for index, hex_file in enumerate(hex_files):
+        print(f'Programming: {hex_file}' + (f' ({probe})' if probe else ''))
+        file_progress = None
+        if progress is not None:
+            name = Path(hex_file).name
+            file_progress = lambda percent, index=index, name=name: progress(
+                100.0 * (index + percent / 100.0) / len(hex_files), name)
+        flash(hex_file, probe=probe, progress=file_progress)
     print('Resetting target...')
-    target_reset()
+    if progress is not None:
+        progress(100.0, 'reset')
+    target_reset(probe)
@@ -0,0 +1,14 @@
+/**
+ * @file bsp_delay.h
+ * @brief Host build delay shim.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "config.h"
+
+void bsp_delay_ms(uint32_t delay_ms);
+uint32_t bsp_delay_get_tick_ms(void);
@@ -0,0 +1,43 @@
+/**
+ * @file command_line_interface.h
+ * @brief Host build command line interface shim.
+ *
+ * Commands registered by the applets are kept in a small table so the host build
+ * can execute them from a string, and all output goes to stdout.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "config.h"
+
+#define CLI_MAX_COMMANDS                        16
+#define CLI_MAX_ARGS                            16
+#define CLI_COMMAND_RETURN_CODE_OK              OK
+#define CLI_COMMAND_RETURN_CODE_INVALID_PARMS   ERROR
+
+struct cli_state_t;
+
+typedef STATUS (*cli_command_handler_t)(struct cli_state_t *cli_state, void *context, int argc, char const *argv[]);
+
+struct cli_command_t
+{
+    const char *name;
+    const char *help;
+    cli_command_handler_t handler;
+    void *context;
+};
+
+struct cli_state_t
+{
+    struct cli_command_t commands[CLI_MAX_COMMANDS];
+    int command_count;
+    bool quiet;
+};
+
+void cli_add_command(struct cli_state_t *cli_state, const char *name, const char *help, cli_command_handler_t handler, void *context);
+STATUS cli_execute(struct cli_state_t *cli_state, const char *line);
+void cli_printf(struct cli_state_t *cli_state, const char *format, ...);
+void cli_printf_line(struct cli_state_t *cli_state, const char *format, ...);
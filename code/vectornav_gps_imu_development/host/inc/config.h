@@ -0,0 +1,40 @@
+/**
+ * @file config.h
+ * @brief Host build replacement for the firmware project configuration.
+ *
+ * Provides the status codes and logging macros that the VN310 sources take from
+ * the firmware configuration header, so the real driver, parser and applet can be
+ * compiled and run off-target.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum {
+    OK = 0,
+    ERROR = -1
+} STATUS;
+
+#define RETURN_ON_ERROR(expr)           \
+    do                                  \
+    {                                   \
+        if ((expr) != OK)               \
+        {                               \
+            return ERROR;               \
+        }                               \
+    } while (0)
+
+#define WARN(...)                       \
+    do                                  \
+    {                                   \
+        fprintf(stderr, "WARN: ");      \
+        fprintf(stderr, __VA_ARGS__);   \
+        fprintf(stderr, "\n");          \
+    } while (0)
@@ -0,0 +1,11 @@
+/**
+ * @file console_commands.h
+ * @brief Host build console shim.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "command_line_interface.h"
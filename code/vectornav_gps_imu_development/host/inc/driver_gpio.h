@@ -0,0 +1,19 @@
+/**
+ * @file driver_gpio.h
+ * @brief Host build GPIO shim.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "config.h"
+
+struct bsp_pin_t
+{
+    void *port;
+    uint16_t number;
+};
+
+void bsp_gpio_write(const struct bsp_pin_t *pin, int value);
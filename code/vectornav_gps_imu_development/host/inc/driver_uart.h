@@ -0,0 +1,38 @@
+/**
+ * @file driver_uart.h
+ * @brief Host build UART shim.
+ *
+ * Replaces the firmware UART DMA driver. Received data is injected by the VN310
+ * simulator, which copies each burst into the receive buffer and raises the same
+ * event callback the DMA idle-line interrupt raises on target. Transmitted bytes
+ * are captured so commands sent by the driver can be inspected.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "config.h"
+
+#define HOST_UART_TX_LOG_SIZE   4096
+
+struct driver_uart_config_t
+{
+    uint8_t *rx_buf;
+    uint16_t rx_buf_size;
+    unsigned int baud_rate;
+};
+
+struct driver_uart_state_t
+{
+    struct driver_uart_config_t config;
+    uint8_t tx_log[HOST_UART_TX_LOG_SIZE];
+    size_t tx_log_size;
+    uint32_t tx_count;
+};
+
+STATUS driver_uart_init(struct driver_uart_state_t *state, const struct driver_uart_config_t *config);
+STATUS driver_uart_transmit(struct driver_uart_state_t *state, uint8_t *data, size_t data_size);
+STATUS driver_uart_read_byte(struct driver_uart_state_t *state, uint8_t *data);
+STATUS driver_uart_set_baud_rate(struct driver_uart_state_t *state, unsigned int baud_rate, uint8_t *rx_buf, uint16_t rx_buf_size);
@@ -0,0 +1,20 @@
+/**
+ * @file message_pose.h
+ * @brief Host build pose message shim.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "vn310_pose.h"
+
+struct message_pose_t
+{
+    uint16_t message_id;
+    struct vn310_pose_t pose;
+};
+
+void message_pose_init(struct message_pose_t *message);
+void message_pose_update_message(struct message_pose_t *message, struct vn310_pose_t pose);
@@ -0,0 +1,22 @@
+/**
+ * @file message_routing.h
+ * @brief Host build message routing shim.
+ *
+ * Routed messages are handed to a hook so the simulator can count and time every
+ * pose the applet publishes.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include "config.h"
+
+#define BOARD_TYPE_ACON_MAJ_INT     1
+#define TILE_INDEX_UNSPECIFIED      0xFF
+
+typedef void (*message_routing_hook_t)(void *context, const uint8_t *message, int board_type, int tile_index);
+
+void message_routing_set_hook(message_routing_hook_t hook, void *context);
+STATUS message_routing_send_message_to(uint8_t *message, int board_type, int tile_index);
@@ -0,0 +1,48 @@
+/**
+ * @file patch_position_calculation.h
+ * @brief Host build replacement for the firmware patch position header.
+ *
+ * Declares the patch layout functions with the status codes of config.h, so the
+ * VN310 frame transforms can reuse them off-target. The host build links the
+ * implementation from array_patch_calcualtions/array_patch_position_calculation.c.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+struct patch_pose_t {
+    double t_x;
+    double t_y;
+};
+
+struct algorithm_EW_patch_t {
+    struct patch_pose_t pose;
+};
+
+STATUS phased_array_calc_patch_pose(
+    const uint16_t array_array_col,
+    const uint16_t array_array_row,
+    const int nx,
+    const int ny,
+    const double spacing,
+    struct algorithm_EW_patch_t *patches);
+
+STATUS phased_array_rot_pos_update(
+    const uint16_t array_rotation,
+    int nx,
+    int ny,
+    struct algorithm_EW_patch_t *patches);
+
+STATUS phased_array_init_patches(
+    struct algorithm_EW_patch_t *patches,
+    const uint16_t array_rotation,
+    const uint16_t array_array_col,
+    const uint16_t array_array_row,
+    const uint16_t number_of_patches_x,
+    const uint16_t number_of_patches_y,
+    const double patch_spacing);
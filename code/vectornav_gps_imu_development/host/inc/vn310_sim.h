@@ -0,0 +1,116 @@
+/**
+ * @file vn310_sim.h
+ * @brief Header file for the host-side VN310 simulator.
+ *
+ * This file defines the simulator that feeds VN310 byte streams into the real
+ * driver, parser and applet through the host UART shim. Streams can be replayed
+ * from captures or generated from a synthetic trajectory, paced at real or
+ * accelerated line rate, and optionally corrupted or fragmented. The simulated
+ * sensor can also answer the commands the driver sends, including baud rate
+ * changes, so link negotiation can be exercised end to end. Two simulators can
+ * feed the primary and secondary inputs of one applet.
+ *
+ * In the dual-core configuration the calling thread plays the M4: frames go through
+ * vn310_ipc_receive into the shared rings, and a second thread started with
+ * vn310_sim_m7_start plays the M7 and runs the applet whenever the doorbell rings.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <stdio.h>
+#include "vn310_applet.h"
+
+#define VN310_SIM_RECORD_MAGIC      "VNREC01\n"
+#define VN310_SIM_RECORD_MAGIC_SIZE 8
+#define VN310_SIM_NEGOTIATE_TIMEOUT_MS  2000
+#define VN310_SIM_GPS_START_NS      (2332ULL * 604800ULL * 1000000000ULL + 250000000ULL)  // GPS time of the first trajectory sample, between two PPS pulses
+
+enum vn310_sim_format
+{
+    SIM_FORMAT_ASCII  = 0,  // $VNINS messages
+    SIM_FORMAT_BINARY = 1   // Binary output configuration 0
+};
+
+struct vn310_sim_config_t
+{
+    double speed;                   // Line rate multiple, 1.0 is real time, 0 runs unpaced
+    unsigned int baud_rate;
+    double corrupt_probability;     // Probability a frame has one byte flipped
+    double fragment_probability;    // Probability a frame arrives as two DMA events
+    uint32_t frames_per_run;        // Frames delivered between applet runs
+    uint32_t seed;
+    bool respond_to_commands;       // Answer commands sent by the driver
+    bool baud_change_fails;         // Acknowledge baud rate changes but stay at the old rate
+    bool ascii_rate_fails;          // Reject ASCII output rate changes with an error response
+    uint8_t port;                   // Applet input the sensor is wired to, enum vn310_merge_source
+    struct vn310_ipc_shared_t *ipc; // Deliver through the M4 receive path, NULL to call the driver directly
+};
+
+struct vn310_sim_trajectory_t
+{
+    enum vn310_sim_format format;
+    double output_rate_hz;
+    double duration_s;
+    double yaw_start_deg;
+    double yaw_rate_dps;
+    double pitch_amplitude_deg;
+    double roll_amplitude_deg;
+    double motion_period_s;
+    double latitude_deg;
+    double longitude_deg;
+    double altitude_m;
+    double ground_speed_mps;
+};
+
+struct vn310_sim_stats_t
+{
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t dma_events;
+    uint64_t corrupted;
+    uint64_t fragmented;
+    uint64_t applet_runs;
+    uint64_t poses_published;
+    uint64_t wire_time_ns;
+    uint64_t wall_time_ns;
+    uint64_t commands_answered;
+    uint64_t commands_garbled;      // Commands sent at a baud rate the sensor is not using
+};
+
+struct vn310_sim_state_t
+{
+    struct vn310_sim_config_t config;
+    struct vn310_applet_state_t *applet;
+    struct vn310_sim_stats_t stats;
+    FILE *record_file;
+    uint64_t start_wall_ns;
+    uint32_t frames_since_run;
+    uint32_t rng;
+    unsigned int device_baud;       // Baud rate the simulated sensor is using
+    size_t tx_consumed;             // UART transmit log bytes already answered
+    uint8_t m4_rx_buf[UART_DMA_READ_BUF_SIZE];  // M4 UART DMA buffer in the dual-core configuration
+    pthread_t m7_thread;
+    bool m7_running;
+};
+
+STATUS vn310_sim_init(struct vn310_sim_state_t *sim, const struct vn310_sim_config_t *config, struct vn310_applet_state_t *applet);
+STATUS vn310_sim_record_open(struct vn310_sim_state_t *sim, const char *path);
+STATUS vn310_sim_record_close(struct vn310_sim_state_t *sim);
+STATUS vn310_sim_deliver(struct vn310_sim_state_t *sim, const uint8_t *frame, uint16_t frame_size, uint64_t time_ns);
+STATUS vn310_sim_flush(struct vn310_sim_state_t *sim);
+STATUS vn310_sim_m7_start(struct vn310_sim_state_t *sim);
+STATUS vn310_sim_m7_stop(struct vn310_sim_state_t *sim);
+uint32_t vn310_sim_respond(struct vn310_sim_state_t *sim);
+STATUS vn310_sim_negotiate(struct vn310_sim_state_t *sim, uint32_t binary_rate_hz, uint32_t ascii_rate_hz);
+STATUS vn310_sim_replay_record(struct vn310_sim_state_t *sim, const char *path);
+STATUS vn310_sim_replay_raw(struct vn310_sim_state_t *sim, const char *path);
+STATUS vn310_sim_run_trajectory(struct vn310_sim_state_t *sim, const struct vn310_sim_trajectory_t *trajectory);
+size_t vn310_sim_build_ascii(const struct vn310_pose_t *pose, double time_of_week_s, char *buffer, size_t buffer_size);
+size_t vn310_sim_build_binary(const struct vn310_pose_t *pose, uint8_t *buffer, size_t buffer_size);
+void vn310_sim_print_stats(const struct vn310_sim_state_t *sim, FILE *out);
+void vn310_sim_print_latency(const struct vn310_sim_state_t *sim, FILE *out);
+uint64_t vn310_sim_now_ns(void);
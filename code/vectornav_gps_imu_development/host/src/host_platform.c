@@ -0,0 +1,181 @@
+/**
+ * @file host_platform.c
+ * @brief Host build implementation of the firmware platform services.
+ *
+ * This file implements the UART, GPIO, delay, CLI and message routing services
+ * the VN310 sources depend on, so the real driver, parser and applet code can be
+ * exercised on a development machine.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include "driver_uart.h"
+#include "driver_gpio.h"
+#include "bsp_delay.h"
+#include "command_line_interface.h"
+#include "message_pose.h"
+#include "message_routing.h"
+
+static message_routing_hook_t routing_hook = NULL;
+static void *routing_hook_context = NULL;
+
+STATUS driver_uart_init(struct driver_uart_state_t *state, const struct driver_uart_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+    state->config = *config;
+    return OK;
+}
+
+STATUS driver_uart_transmit(struct driver_uart_state_t *state, uint8_t *data, size_t data_size)
+{
+    if (state->tx_log_size + data_size > HOST_UART_TX_LOG_SIZE)
+    {
+        state->tx_log_size = 0;
+    }
+    if (data_size > HOST_UART_TX_LOG_SIZE)
+    {
+        return ERROR;
+    }
+
+    memcpy(&state->tx_log[state->tx_log_size], data, data_size);
+    state->tx_log_size += data_size;
+    state->tx_count++;
+
+    return OK;
+}
+
+STATUS driver_uart_read_byte(struct driver_uart_state_t *state, uint8_t *data)
+{
+    (void)state;
+    (void)data;
+
+    // Reception is only delivered through the DMA event callback on the host
+    return ERROR;
+}
+
+STATUS driver_uart_set_baud_rate(struct driver_uart_state_t *state, unsigned int baud_rate, uint8_t *rx_buf, uint16_t rx_buf_size)
+{
+    state->config.baud_rate = baud_rate;
+    state->config.rx_buf = rx_buf;
+    state->config.rx_buf_size = rx_buf_size;
+    return OK;
+}
+
+void bsp_gpio_write(const struct bsp_pin_t *pin, int value)
+{
+    (void)pin;
+    (void)value;
+}
+
+void bsp_delay_ms(uint32_t delay_ms)
+{
+    struct timespec delay = { delay_ms / 1000, (long)(delay_ms % 1000) * 1000000L };
+    nanosleep(&delay, NULL);
+}
+
+uint32_t bsp_delay_get_tick_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000u + (uint64_t)now.tv_nsec / 1000000u);
+}
+
+void cli_add_command(struct cli_state_t *cli_state, const char *name, const char *help, cli_command_handler_t handler, void *context)
+{
+    if (cli_state == NULL || cli_state->command_count >= CLI_MAX_COMMANDS)
+    {
+        return;
+    }
+
+    struct cli_command_t *command = &cli_state->commands[cli_state->command_count++];
+    command->name = name;
+    command->help = help;
+    command->handler = handler;
+    command->context = context;
+}
+
+STATUS cli_execute(struct cli_state_t *cli_state, const char *line)
+{
+    char buffer[256];
+    char const *argv[CLI_MAX_ARGS];
+    int argc = 0;
+
+    strncpy(buffer, line, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *token = strtok(buffer, " \t\r\n"); token != NULL && argc < CLI_MAX_ARGS; token = strtok(NULL, " \t\r\n"))
+    {
+        argv[argc++] = token;
+    }
+    if (argc == 0)
+    {
+        return ERROR;
+    }
+
+    for (int i = 0; i < cli_state->command_count; i++)
+    {
+        if (strcmp(cli_state->commands[i].name, argv[0]) == 0)
+        {
+            return cli_state->commands[i].handler(cli_state, cli_state->commands[i].context, argc, argv);
+        }
+    }
+
+    return ERROR;
+}
+
+void cli_printf(struct cli_state_t *cli_state, const char *format, ...)
+{
+    if (cli_state != NULL && cli_state->quiet)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void cli_printf_line(struct cli_state_t *cli_state, const char *format, ...)
+{
+    if (cli_state != NULL && cli_state->quiet)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
+
+void message_pose_init(struct message_pose_t *message)
+{
+    memset(message, 0, sizeof(*message));
+}
+
+void message_pose_update_message(struct message_pose_t *message, struct vn310_pose_t pose)
+{
+    message->pose = pose;
+}
+
+void message_routing_set_hook(message_routing_hook_t hook, void *context)
+{
+    routing_hook = hook;
+    routing_hook_context = context;
+}
+
+STATUS message_routing_send_message_to(uint8_t *message, int board_type, int tile_index)
+{
+    if (routing_hook != NULL)
+    {
+        routing_hook(routing_hook_context, message, board_type, tile_index);
+    }
+    return OK;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file vn310_log_main.c
+ * @brief Host converter for VN310 binary logs.
+ *
+ * Reads a log written by the applet (see vn310_log.h) and writes the raw frames
+ * and published poses as CSV, and the raw frames of one input as a simulator
+ * record file, so a logged mission can be replayed through vn310_sim --replay.
+ *
+ * Usage:
+ *   vn310_log <log.bin> [--frames <frames.csv>] [--poses <poses.csv>]
+ *                       [--vnrec <out.vnrec>] [--source <0|1>]
+ *
+ * ASCII frames are written to the CSV as text, binary frames as hex. Damaged
+ * records are skipped and counted.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vn310_log.h"
+#include "vn310_sim.h"
+
+#define NS_PER_MS   1000000ULL
+
+struct log_outputs_t
+{
+    FILE *frames;
+    FILE *poses;
+    FILE *vnrec;
+    int source;
+    uint64_t frame_count;
+    uint64_t pose_count;
+    uint64_t replay_count;
+};
+
+static void _usage(void)
+{
+    fprintf(stderr, "Usage: vn310_log <log.bin> [--frames <csv>] [--poses <csv>] [--vnrec <file>] [--source <0|1>]\n");
+}
+
+static void _write_frame(struct log_outputs_t *out, const struct vn310_log_header_t *header, const uint8_t *payload)
+{
+    uint8_t source = payload[0];
+    uint8_t type = payload[1];
+    const uint8_t *bytes = &payload[2];
+    uint16_t size = (uint16_t)(header->length - 2);
+
+    out->frame_count++;
+
+    if (out->frames != NULL)
+    {
+        fprintf(out->frames, "%lu,%u,%u,%u,", (unsigned long)header->tick_ms, source, type, size);
+        if (type == MSG_BINARY)
+        {
+            for (uint16_t i = 0; i < size; i++)
+            {
+                fprintf(out->frames, "%02X", bytes[i]);
+            }
+        }
+        else
+        {
+            // Drop the CRLF and quote the text, it contains commas
+            uint16_t text_size = (uint16_t)strcspn((const char *)bytes, "\r\n");
+            fprintf(out->frames, "\"%.*s\"", text_size < size ? text_size : size, (const char *)bytes);
+        }
+        fputc('\n', out->frames);
+    }
+
+    if (out->vnrec != NULL && source == out->source && (type == MSG_ASYNC || type == MSG_BINARY))
+    {
+        uint64_t time_ns = (uint64_t)header->tick_ms * NS_PER_MS;
+        fwrite(&time_ns, sizeof(time_ns), 1, out->vnrec);
+        fwrite(&size, sizeof(size), 1, out->vnrec);
+        fwrite(bytes, 1, size, out->vnrec);
+        out->replay_count++;
+    }
+}
+
+static void _write_pose(struct log_outputs_t *out, const struct vn310_log_header_t *header, const uint8_t *payload)
+{
+    struct vn310_log_pose_t pose;
+
+    if (header->length != sizeof(pose))
+    {
+        return;
+    }
+    memcpy(&pose, payload, sizeof(pose));
+    out->pose_count++;
+
+    if (out->poses != NULL)
+    {
+        fprintf(out->poses, "%lu,%llu,%.4f,%.4f,%.4f,%.7f,%.7f,%.3f,%.4f,%.4f,%.4f,%u,%.7f,%.7f,%.7f,%.7f\n",
+                (unsigned long)header->tick_ms, (unsigned long long)pose.time_gps_pps,
+                pose.roll, pose.pitch, pose.yaw, pose.latitude, pose.longitude, pose.altitude,
+                pose.rate[0], pose.rate[1], pose.rate[2], pose.ins_status,
+                pose.quaternion[0], pose.quaternion[1], pose.quaternion[2], pose.quaternion[3]);
+    }
+}
+
+static FILE *_open(const char *path, const char *header)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot create %s\n", path);
+        exit(1);
+    }
+    if (header != NULL)
+    {
+        fputs(header, file);
+    }
+
+    return file;
+}
+
+int main(int argc, char **argv)
+{
+    struct log_outputs_t out = { .source = 0 };
+    uint8_t block[VN310_LOG_BLOCK_SIZE];
+    uint64_t block_count = 0;
+    uint64_t damaged_blocks = 0;
+
+    if (argc < 2)
+    {
+        _usage();
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--frames") == 0)
+        {
+            out.frames = _open(argv[i + 1], "tick_ms,source,type,size,data\n");
+        }
+        else if (strcmp(argv[i], "--poses") == 0)
+        {
+            out.poses = _open(argv[i + 1], "tick_ms,time_gps_pps_ns,roll,pitch,yaw,latitude,longitude,altitude,"
+                                           "rate_x_dps,rate_y_dps,rate_z_dps,ins_status,qx,qy,qz,qw\n");
+        }
+        else if (strcmp(argv[i], "--vnrec") == 0)
+        {
+            out.vnrec = _open(argv[i + 1], NULL);
+            fwrite(VN310_SIM_RECORD_MAGIC, 1, VN310_SIM_RECORD_MAGIC_SIZE, out.vnrec);
+        }
+        else if (strcmp(argv[i], "--source") == 0)
+        {
+            out.source = atoi(argv[i + 1]);
+        }
+        else
+        {
+            _usage();
+            return 1;
+        }
+    }
+
+    size_t read;
+    while ((read = fread(block, 1, sizeof(block), in)) > 0)
+    {
+        size_t offset = 0;
+        size_t consumed;
+        uint64_t records = out.frame_count + out.pose_count;
+        struct vn310_log_header_t header;
+        const uint8_t *payload;
+
+        while ((consumed = vn310_log_parse(&block[offset], read - offset, &header, &payload)) > 0)
+        {
+            offset += consumed;
+            if (header.type == LOG_RECORD_FRAME && header.length >= 2)
+            {
+                _write_frame(&out, &header, payload);
+            }
+            else if (header.type == LOG_RECORD_POSE)
+            {
+                _write_pose(&out, &header, payload);
+            }
+        }
+
+        block_count++;
+        if (out.frame_count + out.pose_count == records)
+        {
+            damaged_blocks++;
+        }
+    }
+
+    fclose(in);
+    if (out.frames != NULL)
+    {
+        fclose(out.frames);
+    }
+    if (out.poses != NULL)
+    {
+        fclose(out.poses);
+    }
+    if (out.vnrec != NULL)
+    {
+        fclose(out.vnrec);
+    }
+
+    printf("blocks            %llu (%llu without records)\n", (unsigned long long)block_count, (unsigned long long)damaged_blocks);
+    printf("frames            %llu\n", (unsigned long long)out.frame_count);
+    printf("poses             %llu\n", (unsigned long long)out.pose_count);
+    if (out.vnrec != NULL)
+    {
+        printf("replay frames     %llu (input %d)\n", (unsigned long long)out.replay_count, out.source);
+    }
+
+    return 0;
+}
@@ -0,0 +1,886 @@
+/**
+ * @file vn310_sim.c
+ * @brief Implementation of the host-side VN310 simulator.
+ *
+ * Each VN310 message is delivered the way the UART DMA idle-line interrupt
+ * delivers it on target: the bytes are placed at the start of the receive buffer
+ * and vn310_driver_eventcallback is called with the burst length. The applet is
+ * run after a configurable number of frames, so mailbox bursts and overruns can
+ * be reproduced. Published poses are counted through the message routing hook.
+ *
+ * When responding to commands the simulated sensor reads the driver's UART transmit
+ * log after every applet run and answers each command with a correctly checksummed
+ * response. Bytes sent while the two ends disagree on the baud rate are treated as
+ * noise in both directions.
+ *
+ * With a shared IPC block configured, each DMA event goes to vn310_ipc_receive
+ * instead, as the M4 UART callback does on target, and the applet is only ever run
+ * by the M7 thread.
+ *
+ * Record files are a magic string followed by records of a little-endian 64-bit
+ * time stamp (ns), a 16-bit length and the raw frame bytes.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include "vn310_sim.h"
+#include "vn310_driver.h"
+#include "message_routing.h"
+#include "bsp_delay.h"
+
+#define NS_PER_S                1000000000ULL
+#define UART_BITS_PER_BYTE      10
+#define EARTH_RADIUS_M          6378137.0
+#define DEG_TO_RAD              (M_PI / 180.0)
+#define GPS_WEEK                2332
+
+uint64_t vn310_sim_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NS_PER_S + (uint64_t)now.tv_nsec;
+}
+
+static uint32_t _rand(struct vn310_sim_state_t *sim)
+{
+    // xorshift32
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static double _rand_unit(struct vn310_sim_state_t *sim)
+{
+    return (double)_rand(sim) / 4294967296.0;
+}
+
+static void _routing_hook(void *context, const uint8_t *message, int board_type, int tile_index)
+{
+    struct vn310_sim_state_t *sim = context;
+    (void)message;
+    (void)board_type;
+    (void)tile_index;
+
+    sim->stats.poses_published++;
+}
+
+/**
+ * @brief Hold off until the simulated line has carried the frame.
+ *
+ * The stream clock advances by the wire time of each frame and never runs ahead
+ * of the frame time stamp, so captures replay at their recorded rate and
+ * back-to-back data is limited by the baud rate. Both are scaled by the speed.
+ */
+static void _pace(struct vn310_sim_state_t *sim, uint16_t frame_size, uint64_t time_ns)
+{
+    uint64_t wire_ns = (uint64_t)frame_size * UART_BITS_PER_BYTE * NS_PER_S / sim->config.baud_rate;
+
+    if (time_ns > sim->stats.wire_time_ns)
+    {
+        sim->stats.wire_time_ns = time_ns;
+    }
+    sim->stats.wire_time_ns += wire_ns;
+
+    if (sim->config.speed <= 0.0)
+    {
+        return;
+    }
+
+    uint64_t target_ns = sim->start_wall_ns + (uint64_t)((double)sim->stats.wire_time_ns / sim->config.speed);
+    uint64_t now_ns = vn310_sim_now_ns();
+
+    if (target_ns > now_ns)
+    {
+        uint64_t wait_ns = target_ns - now_ns;
+        struct timespec delay = { (time_t)(wait_ns / NS_PER_S), (long)(wait_ns % NS_PER_S) };
+        nanosleep(&delay, NULL);
+    }
+}
+
+/**
+ * @brief Get the driver of the applet input the sensor is wired to.
+ */
+static struct vn310_driver_state_t *_driver(const struct vn310_sim_state_t *sim)
+{
+    return (sim->config.port == MERGE_SOURCE_SECONDARY) ? &sim->applet->secondary_driver_state : &sim->applet->driver_state;
+}
+
+/**
+ * @brief Raise one DMA receive event with the given bytes.
+ */
+static void _dma_event(struct vn310_sim_state_t *sim, const uint8_t *bytes, uint16_t size)
+{
+    struct vn310_driver_state_t *driver_state = _driver(sim);
+
+    if (sim->config.ipc != NULL)
+    {
+        memcpy(sim->m4_rx_buf, bytes, size);
+        sim->stats.dma_events++;
+        vn310_ipc_receive(sim->config.ipc, sim->config.port, (char *)sim->m4_rx_buf, size);
+        return;
+    }
+
+    uint8_t *rx_buf = driver_state->uart_state.config.rx_buf;
+
+    memset(rx_buf, 0, UART_DMA_READ_BUF_SIZE);
+    memcpy(rx_buf, bytes, size);
+    sim->stats.dma_events++;
+
+    vn310_driver_eventcallback(driver_state, size);
+}
+
+/**
+ * @brief Initialize the simulator.
+ *
+ * The applet must already be initialized and started, with its UART receive
+ * buffer configured.
+ *
+ * @param sim The simulator state.
+ * @param config The simulator configuration.
+ * @param applet The applet the simulated sensor is connected to.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_sim_init(struct vn310_sim_state_t *sim, const struct vn310_sim_config_t *config, struct vn310_applet_state_t *applet)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->applet = applet;
+    sim->rng = config->seed ? config->seed : 0x2545F491;
+    sim->device_baud = config->baud_rate;
+
+    if (sim->config.baud_rate == 0 || sim->config.frames_per_run == 0 ||
+        (sim->config.ipc != NULL && sim->config.respond_to_commands))
+    {
+        return ERROR;
+    }
+
+    message_routing_set_hook(_routing_hook, sim);
+    sim->start_wall_ns = vn310_sim_now_ns();
+
+    return OK;
+}
+
+/**
+ * @brief Record every delivered frame to a file.
+ *
+ * Frames are recorded before corruption or fragmentation is applied.
+ *
+ * @param sim The simulator state.
+ * @param path Path of the record file to create.
+ * @return OK if the file was opened.
+ */
+STATUS vn310_sim_record_open(struct vn310_sim_state_t *sim, const char *path)
+{
+    sim->record_file = fopen(path, "wb");
+    if (sim->record_file == NULL)
+    {
+        return ERROR;
+    }
+
+    fwrite(VN310_SIM_RECORD_MAGIC, 1, VN310_SIM_RECORD_MAGIC_SIZE, sim->record_file);
+    return OK;
+}
+
+STATUS vn310_sim_record_close(struct vn310_sim_state_t *sim)
+{
+    if (sim->record_file != NULL)
+    {
+        fclose(sim->record_file);
+        sim->record_file = NULL;
+    }
+    return OK;
+}
+
+/**
+ * @brief Deliver a single VN310 frame to the driver.
+ *
+ * @param sim The simulator state.
+ * @param frame The frame bytes as sent by the sensor.
+ * @param frame_size The frame length.
+ * @param time_ns Stream time of the frame, 0 to pace on wire time only.
+ * @return OK if the frame was delivered.
+ */
+STATUS vn310_sim_deliver(struct vn310_sim_state_t *sim, const uint8_t *frame, uint16_t frame_size, uint64_t time_ns)
+{
+    uint8_t bytes[UART_DMA_READ_BUF_SIZE];
+
+    if (frame_size == 0 || frame_size >= UART_DMA_READ_BUF_SIZE)
+    {
+        return ERROR;
+    }
+
+    if (sim->record_file != NULL)
+    {
+        fwrite(&time_ns, sizeof(time_ns), 1, sim->record_file);
+        fwrite(&frame_size, sizeof(frame_size), 1, sim->record_file);
+        fwrite(frame, 1, frame_size, sim->record_file);
+    }
+
+    _pace(sim, frame_size, time_ns);
+
+    memcpy(bytes, frame, frame_size);
+    sim->stats.frames++;
+    sim->stats.bytes += frame_size;
+
+    bool baud_mismatch = sim->config.respond_to_commands && _driver(sim)->baud_rate != sim->device_baud;
+
+    if (baud_mismatch || (sim->config.corrupt_probability > 0.0 && _rand_unit(sim) < sim->config.corrupt_probability))
+    {
+        bytes[_rand(sim) % frame_size] ^= (uint8_t)(1u << (_rand(sim) % 8));
+        sim->stats.corrupted++;
+    }
+
+    if (frame_size > 1 && sim->config.fragment_probability > 0.0 && _rand_unit(sim) < sim->config.fragment_probability)
+    {
+        uint16_t split = (uint16_t)(1 + _rand(sim) % (frame_size - 1));
+        _dma_event(sim, bytes, split);
+        _dma_event(sim, &bytes[split], frame_size - split);
+        sim->stats.fragmented++;
+    }
+    else
+    {
+        _dma_event(sim, bytes, frame_size);
+    }
+
+    if (++sim->frames_since_run >= sim->config.frames_per_run)
+    {
+        vn310_sim_flush(sim);
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Run the applet so every queued frame is processed.
+ *
+ * In the dual-core configuration the M7 thread runs the applet, so this only
+ * updates the wall time.
+ *
+ * @param sim The simulator state.
+ * @return The status of the applet run.
+ */
+STATUS vn310_sim_flush(struct vn310_sim_state_t *sim)
+{
+    sim->frames_since_run = 0;
+    if (sim->config.ipc != NULL)
+    {
+        sim->stats.wall_time_ns = vn310_sim_now_ns() - sim->start_wall_ns;
+        return OK;
+    }
+
+    sim->stats.applet_runs++;
+    STATUS status = vn310_applet_run(sim->applet);
+    // Stands in for the low-priority storage and console tasks
+    vn310_applet_log_task(sim->applet);
+    vn310_applet_console_task(sim->applet);
+    if (sim->config.respond_to_commands)
+    {
+        vn310_sim_respond(sim);
+    }
+    sim->stats.wall_time_ns = vn310_sim_now_ns() - sim->start_wall_ns;
+    return status;
+}
+
+/**
+ * @brief M7 thread: run the applet whenever the M4 rings the doorbell.
+ */
+static void *_m7_main(void *context)
+{
+    struct vn310_sim_state_t *sim = context;
+
+    while (__atomic_load_n(&sim->m7_running, __ATOMIC_ACQUIRE))
+    {
+        vn310_ipc_wait(sim->config.ipc, 1);
+        vn310_applet_run(sim->applet);
+        vn310_applet_log_task(sim->applet);
+        vn310_applet_console_task(sim->applet);
+        sim->stats.applet_runs++;
+    }
+
+    // Frames committed before the stop request
+    vn310_applet_run(sim->applet);
+    vn310_applet_log_task(sim->applet);
+    vn310_applet_console_task(sim->applet);
+    sim->stats.applet_runs++;
+
+    return NULL;
+}
+
+/**
+ * @brief Start the M7 thread of the dual-core configuration.
+ *
+ * The applet must have been started with the same shared block, so that its
+ * drivers drain the shared rings.
+ *
+ * @param sim The simulator state.
+ * @return OK if the thread was started.
+ */
+STATUS vn310_sim_m7_start(struct vn310_sim_state_t *sim)
+{
+    if (sim->config.ipc == NULL || sim->m7_running)
+    {
+        return ERROR;
+    }
+
+    sim->m7_running = true;
+    if (pthread_create(&sim->m7_thread, NULL, _m7_main, sim) != 0)
+    {
+        sim->m7_running = false;
+        return ERROR;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Stop the M7 thread once it has drained the rings.
+ *
+ * Call after the last frame was delivered and before reading the statistics.
+ *
+ * @param sim The simulator state.
+ * @return OK if the thread was stopped.
+ */
+STATUS vn310_sim_m7_stop(struct vn310_sim_state_t *sim)
+{
+    if (!sim->m7_running)
+    {
+        return ERROR;
+    }
+
+    __atomic_store_n(&sim->m7_running, false, __ATOMIC_RELEASE);
+    pthread_join(sim->m7_thread, NULL);
+    sim->stats.wall_time_ns = vn310_sim_now_ns() - sim->start_wall_ns;
+
+    return OK;
+}
+
+/**
+ * @brief Deliver a response to the driver, adding the 8-bit checksum.
+ *
+ * @param body The response without the leading '$' or the checksum.
+ */
+static void _send_response(struct vn310_sim_state_t *sim, const char *body)
+{
+    char response[VN310_COMMAND_MAX_LENGTH + 16];
+    uint8_t checksum = calculate_8_bit_crc((unsigned char *)body, (unsigned int)strlen(body));
+    int size = snprintf(response, sizeof(response), "$%s*%02X\r\n", body, checksum);
+
+    if (size > 0 && (size_t)size < sizeof(response))
+    {
+        _dma_event(sim, (const uint8_t *)response, (uint16_t)size);
+        sim->stats.commands_answered++;
+    }
+}
+
+/**
+ * @brief Answer one command the way the sensor does.
+ *
+ * Register reads return the baud rate for the serial baud rate register, the
+ * model for the model number register and zero otherwise. Everything else is
+ * echoed, unless ASCII rate changes are configured to fail. A baud rate change
+ * takes effect once its response has been sent.
+ *
+ * @param command The command from the '$' up to, not including, the '*'.
+ * @param size Length of the command.
+ */
+static void _answer(struct vn310_sim_state_t *sim, const char *command, size_t size)
+{
+    char body[VN310_COMMAND_MAX_LENGTH];
+    char id[4] = {0};
+    unsigned long register_id = 0;
+
+    if (size < 6 || size >= sizeof(body) || strncmp(command, "$VN", 3) != 0)
+    {
+        return;
+    }
+
+    memcpy(id, &command[3], 3);
+    if (size > 7 && command[6] == ',')
+    {
+        register_id = strtoul(&command[7], NULL, 10);
+    }
+
+    if (strcmp(id, VECTORNAV_RRG_CMD) == 0)
+    {
+        char value[16] = "0";
+        if (register_id == SERIAL_BAUD_RATE_REGISTER)
+        {
+            snprintf(value, sizeof(value), "%u", sim->device_baud);
+        }
+        else if (register_id == MODEL_NUMBER_REGISTER)
+        {
+            snprintf(value, sizeof(value), "VN-310");
+        }
+        snprintf(body, sizeof(body), "VNRRG,%02lu,%s", register_id, value);
+        _send_response(sim, body);
+        return;
+    }
+
+    if (strcmp(id, VECTORNAV_WRG_CMD) == 0 && register_id == ASYNC_DATA_OUTPUT_FREQUENCY_REGISTER && sim->config.ascii_rate_fails)
+    {
+        _send_response(sim, "VNERR,07");
+        return;
+    }
+
+    memcpy(body, &command[1], size - 1);
+    body[size - 1] = '\0';
+    _send_response(sim, body);
+
+    if (strcmp(id, VECTORNAV_WRG_CMD) == 0 && register_id == SERIAL_BAUD_RATE_REGISTER && !sim->config.baud_change_fails)
+    {
+        const char *value = strchr(&command[7], ',');
+        unsigned long baud_rate = (value != NULL) ? strtoul(value + 1, NULL, 10) : 0;
+        if (baud_rate != 0)
+        {
+            sim->device_baud = (unsigned int)baud_rate;
+            sim->config.baud_rate = sim->device_baud;
+        }
+    }
+}
+
+/**
+ * @brief Answer every command the driver has transmitted since the last call.
+ *
+ * Responses are placed in the driver mailbox and handled on the next applet run.
+ *
+ * @param sim The simulator state.
+ * @return Number of commands answered.
+ */
+uint32_t vn310_sim_respond(struct vn310_sim_state_t *sim)
+{
+    struct driver_uart_state_t *uart_state = &_driver(sim)->uart_state;
+    const char *log = (const char *)uart_state->tx_log;
+    uint64_t answered = sim->stats.commands_answered;
+
+    // The host UART shim restarts its log when it fills
+    if (uart_state->tx_log_size < sim->tx_consumed)
+    {
+        sim->tx_consumed = 0;
+    }
+
+    while (sim->tx_consumed < uart_state->tx_log_size)
+    {
+        const char *start = &log[sim->tx_consumed];
+        size_t remaining = uart_state->tx_log_size - sim->tx_consumed;
+        const char *end = memchr(start, '\n', remaining);
+
+        if (end == NULL)
+        {
+            break;
+        }
+        sim->tx_consumed += (size_t)(end - start) + 1;
+
+        if (_driver(sim)->baud_rate != sim->device_baud)
+        {
+            sim->stats.commands_garbled++;
+            continue;
+        }
+
+        const char *star = memchr(start, '*', (size_t)(end - start));
+        if (star != NULL)
+        {
+            _answer(sim, start, (size_t)(star - start));
+        }
+    }
+
+    return (uint32_t)(sim->stats.commands_answered - answered);
+}
+
+static void _negotiated(void *context, STATUS status, unsigned int baud_rate)
+{
+    STATUS *result = context;
+    (void)baud_rate;
+
+    *result = status;
+}
+
+/**
+ * @brief Negotiate the link with the simulated sensor before streaming.
+ *
+ * Runs the applet until the negotiation completes, so command timeouts and
+ * retries play out in real time. Requires respond_to_commands.
+ *
+ * @param sim The simulator state.
+ * @param binary_rate_hz Binary output rate.
+ * @param ascii_rate_hz ASCII output rate, 0 if off.
+ * @return The result of the negotiation.
+ */
+STATUS vn310_sim_negotiate(struct vn310_sim_state_t *sim, uint32_t binary_rate_hz, uint32_t ascii_rate_hz)
+{
+    struct vn310_driver_state_t *driver_state = _driver(sim);
+    volatile STATUS result = ERROR;
+
+    if (!sim->config.respond_to_commands ||
+        vn310_link_negotiate(driver_state, binary_rate_hz, ascii_rate_hz, _negotiated, (void *)&result) != OK)
+    {
+        return ERROR;
+    }
+
+    uint32_t start_ms = bsp_delay_get_tick_ms();
+    while (driver_state->link.phase != LINK_PHASE_IDLE)
+    {
+        if ((bsp_delay_get_tick_ms() - start_ms) > VN310_SIM_NEGOTIATE_TIMEOUT_MS)
+        {
+            return ERROR;
+        }
+        vn310_sim_flush(sim);
+        bsp_delay_ms(1);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Replay a record file written by vn310_sim_record_open.
+ *
+ * @param sim The simulator state.
+ * @param path Path of the record file.
+ * @return OK if the whole file was replayed.
+ */
+STATUS vn310_sim_replay_record(struct vn310_sim_state_t *sim, const char *path)
+{
+    char magic[VN310_SIM_RECORD_MAGIC_SIZE];
+    uint8_t frame[UART_DMA_READ_BUF_SIZE];
+    uint64_t time_ns;
+    uint64_t first_time_ns = 0;
+    uint16_t frame_size;
+    bool first = true;
+    STATUS status = OK;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return ERROR;
+    }
+
+    if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        memcmp(magic, VN310_SIM_RECORD_MAGIC, VN310_SIM_RECORD_MAGIC_SIZE) != 0)
+    {
+        fclose(file);
+        return ERROR;
+    }
+
+    while (fread(&time_ns, sizeof(time_ns), 1, file) == 1 &&
+           fread(&frame_size, sizeof(frame_size), 1, file) == 1)
+    {
+        if (frame_size >= UART_DMA_READ_BUF_SIZE || fread(frame, 1, frame_size, file) != frame_size)
+        {
+            status = ERROR;
+            break;
+        }
+        if (first)
+        {
+            first_time_ns = time_ns;
+            first = false;
+        }
+        vn310_sim_deliver(sim, frame, frame_size, time_ns - first_time_ns);
+    }
+
+    fclose(file);
+    vn310_sim_flush(sim);
+    return status;
+}
+
+/**
+ * @brief Replay a raw byte capture of the VN310 serial line.
+ *
+ * The capture is split into ASCII messages ('$' to line feed) and configuration 0
+ * binary packets. Bytes that start neither are skipped. A raw capture carries no
+ * time stamps, so it is paced on wire time only.
+ *
+ * @param sim The simulator state.
+ * @param path Path of the raw capture.
+ * @return OK if the capture was replayed.
+ */
+STATUS vn310_sim_replay_raw(struct vn310_sim_state_t *sim, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return ERROR;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t *capture = malloc((size_t)length);
+    if (capture == NULL || fread(capture, 1, (size_t)length, file) != (size_t)length)
+    {
+        free(capture);
+        fclose(file);
+        return ERROR;
+    }
+    fclose(file);
+
+    long i = 0;
+    while (i < length)
+    {
+        if (capture[i] == '$')
+        {
+            long end = i;
+            while (end < length && end - i < UART_DMA_READ_BUF_SIZE - 1 && capture[end] != '\n')
+            {
+                end++;
+            }
+            if (end < length && capture[end] == '\n')
+            {
+                vn310_sim_deliver(sim, &capture[i], (uint16_t)(end - i + 1), 0);
+                i = end + 1;
+                continue;
+            }
+        }
+        else if (capture[i] == VN310_BINARY_SYNC &&
+                 i + (long)VN310_BINARY_CONFIG0_SIZE <= length &&
+                 capture[i + 1] == VN310_BINARY_CONFIG0_GROUP &&
+                 capture[i + 2] == (VN310_BINARY_CONFIG0_FIELDS & 0xFF) &&
+                 capture[i + 3] == (VN310_BINARY_CONFIG0_FIELDS >> 8))
+        {
+            vn310_sim_deliver(sim, &capture[i], (uint16_t)VN310_BINARY_CONFIG0_SIZE, 0);
+            i += VN310_BINARY_CONFIG0_SIZE;
+            continue;
+        }
+        i++;
+    }
+
+    free(capture);
+    vn310_sim_flush(sim);
+    return OK;
+}
+
+/**
+ * @brief Build a $VNINS message with a valid 8-bit checksum.
+ *
+ * @param pose Attitude and position to encode.
+ * @param time_of_week_s GPS time of week (s).
+ * @param buffer Output buffer.
+ * @param buffer_size Size of the output buffer.
+ * @return Length of the message, 0 if it did not fit.
+ */
+size_t vn310_sim_build_ascii(const struct vn310_pose_t *pose, double time_of_week_s, char *buffer, size_t buffer_size)
+{
+    int length = snprintf(buffer, buffer_size,
+        "$VNINS,%.6f,%d,%04X,%+08.3f,%+07.3f,%+08.3f,%+012.8f,%+013.8f,%+010.3f,%+08.3f,%+08.3f,%+08.3f,%04.1f,%04.1f,%04.2f",
+        time_of_week_s, GPS_WEEK, pose->ins_status,
+        pose->yaw, pose->pitch, pose->roll,
+        pose->latitude, pose->longitude, pose->altitude,
+        0.0, 0.0, 0.0,
+        0.5, 1.2, 0.10);
+
+    if (length < 0 || (size_t)length + 6 > buffer_size)
+    {
+        return 0;
+    }
+
+    unsigned char checksum = calculate_8_bit_crc((unsigned char *)&buffer[1], (unsigned int)length - 1);
+    length += snprintf(&buffer[length], buffer_size - (size_t)length, "*%02X\r\n", checksum);
+
+    return (size_t)length;
+}
+
+/**
+ * @brief Build a configuration 0 binary packet with a valid CRC.
+ *
+ * @param pose Attitude, rates (degrees per second), position and time to encode.
+ * @param buffer Output buffer.
+ * @param buffer_size Size of the output buffer.
+ * @return Length of the packet, 0 if it did not fit.
+ */
+size_t vn310_sim_build_binary(const struct vn310_pose_t *pose, uint8_t *buffer, size_t buffer_size)
+{
+    struct vn310_driver_binout_config0_data_t data;
+
+    if (buffer_size < VN310_BINARY_CONFIG0_SIZE)
+    {
+        return 0;
+    }
+
+    double cy = cos(pose->yaw * DEG_TO_RAD * 0.5), sy = sin(pose->yaw * DEG_TO_RAD * 0.5);
+    double cp = cos(pose->pitch * DEG_TO_RAD * 0.5), sp = sin(pose->pitch * DEG_TO_RAD * 0.5);
+    double cr = cos(pose->roll * DEG_TO_RAD * 0.5), sr = sin(pose->roll * DEG_TO_RAD * 0.5);
+
+    memset(&data, 0, sizeof(data));
+    data.yaw_pitch_roll.yaw = pose->yaw;
+    data.yaw_pitch_roll.pitch = pose->pitch;
+    data.yaw_pitch_roll.roll = pose->roll;
+    data.quaternion.q[0] = (float)(sr * cp * cy - cr * sp * sy);
+    data.quaternion.q[1] = (float)(cr * sp * cy + sr * cp * sy);
+    data.quaternion.q[2] = (float)(cr * cp * sy - sr * sp * cy);
+    data.quaternion.q[3] = (float)(cr * cp * cy + sr * sp * sy);
+    data.angular_rate.rate[0] = (float)(pose->rate[0] * DEG_TO_RAD);
+    data.angular_rate.rate[1] = (float)(pose->rate[1] * DEG_TO_RAD);
+    data.angular_rate.rate[2] = (float)(pose->rate[2] * DEG_TO_RAD);
+    data.position.latitude = pose->latitude;
+    data.position.longitude = pose->longitude;
+    data.position.altitude = pose->altitude;
+    data.ins_status.sol_status = pose->ins_status;
+    data.gps_time.time_gps = pose->time_gps;
+
+    buffer[0] = VN310_BINARY_SYNC;
+    buffer[1] = VN310_BINARY_CONFIG0_GROUP;
+    buffer[2] = VN310_BINARY_CONFIG0_FIELDS & 0xFF;
+    buffer[3] = VN310_BINARY_CONFIG0_FIELDS >> 8;
+    memcpy(&buffer[VN310_BINARY_CONFIG0_HEADER_SIZE], &data, sizeof(data));
+
+    size_t crc_offset = VN310_BINARY_CONFIG0_HEADER_SIZE + sizeof(data);
+    unsigned short crc = calculate_16_bit_crc(&buffer[1], (unsigned int)crc_offset - 1);
+    buffer[crc_offset] = (uint8_t)(crc >> 8);
+    buffer[crc_offset + 1] = (uint8_t)(crc & 0xFF);
+
+    return VN310_BINARY_CONFIG0_SIZE;
+}
+
+/**
+ * @brief Generate and deliver a synthetic platform trajectory.
+ *
+ * Yaw turns at a constant rate while pitch and roll oscillate. The body rates are
+ * the exact derivatives of the generated attitude, so the stream is consistent
+ * for prediction tests. The platform moves north-east at the ground speed.
+ *
+ * @param sim The simulator state.
+ * @param trajectory The trajectory description.
+ * @return OK if every sample was delivered.
+ */
+STATUS vn310_sim_run_trajectory(struct vn310_sim_state_t *sim, const struct vn310_sim_trajectory_t *trajectory)
+{
+    uint8_t frame[UART_DMA_READ_BUF_SIZE];
+    uint64_t period_ns = (uint64_t)(NS_PER_S / trajectory->output_rate_hz);
+    uint64_t sample_count = (uint64_t)(trajectory->duration_s * trajectory->output_rate_hz);
+    double omega = 2.0 * M_PI / trajectory->motion_period_s;
+    double latitude = trajectory->latitude_deg;
+    double longitude = trajectory->longitude_deg;
+    double step_m = trajectory->ground_speed_mps / trajectory->output_rate_hz * M_SQRT1_2;
+
+    for (uint64_t n = 0; n < sample_count; n++)
+    {
+        double t = (double)(n * period_ns) / NS_PER_S;
+        struct vn310_pose_t pose = {0};
+
+        double yaw = trajectory->yaw_start_deg + trajectory->yaw_rate_dps * t;
+        double pitch = trajectory->pitch_amplitude_deg * sin(omega * t);
+        double roll = trajectory->roll_amplitude_deg * sin(1.3 * omega * t);
+        double yaw_dot = trajectory->yaw_rate_dps * DEG_TO_RAD;
+        double pitch_dot = trajectory->pitch_amplitude_deg * omega * cos(omega * t) * DEG_TO_RAD;
+        double roll_dot = trajectory->roll_amplitude_deg * 1.3 * omega * cos(1.3 * omega * t) * DEG_TO_RAD;
+        double sin_roll = sin(roll * DEG_TO_RAD), cos_roll = cos(roll * DEG_TO_RAD);
+        double sin_pitch = sin(pitch * DEG_TO_RAD), cos_pitch = cos(pitch * DEG_TO_RAD);
+
+        pose.yaw = (float)(fmod(yaw + 180.0, 360.0) - 180.0);
+        pose.pitch = (float)pitch;
+        pose.roll = (float)roll;
+        pose.rate[0] = (float)((roll_dot - yaw_dot * sin_pitch) / DEG_TO_RAD);
+        pose.rate[1] = (float)((pitch_dot * cos_roll + yaw_dot * sin_roll * cos_pitch) / DEG_TO_RAD);
+        pose.rate[2] = (float)((-pitch_dot * sin_roll + yaw_dot * cos_roll * cos_pitch) / DEG_TO_RAD);
+        pose.latitude = (float)latitude;
+        pose.longitude = (float)longitude;
+        pose.altitude = (float)trajectory->altitude_m;
+        pose.ins_status = 0x0206;
+        pose.time_gps = VN310_SIM_GPS_START_NS + n * period_ns;
+        pose.time_gps_pps = pose.time_gps % NS_PER_S;
+
+        size_t frame_size;
+        if (trajectory->format == SIM_FORMAT_BINARY)
+        {
+            frame_size = vn310_sim_build_binary(&pose, frame, sizeof(frame));
+        }
+        else
+        {
+            frame_size = vn310_sim_build_ascii(&pose, t, (char *)frame, sizeof(frame));
+        }
+        if (frame_size == 0)
+        {
+            return ERROR;
+        }
+
+        vn310_sim_deliver(sim, frame, (uint16_t)frame_size, n * period_ns);
+
+        latitude += step_m / EARTH_RADIUS_M / DEG_TO_RAD;
+        longitude += step_m / (EARTH_RADIUS_M * cos(latitude * DEG_TO_RAD)) / DEG_TO_RAD;
+    }
+
+    vn310_sim_flush(sim);
+    return OK;
+}
+
+/**
+ * @brief Print the simulator and pipeline statistics.
+ *
+ * @param sim The simulator state.
+ * @param out Output stream.
+ */
+void vn310_sim_print_stats(const struct vn310_sim_state_t *sim, FILE *out)
+{
+    const struct vn310_sim_stats_t *stats = &sim->stats;
+    const struct vn310_mailbox_t *mailbox = _driver(sim)->mailbox;
+    double wire_s = (double)stats->wire_time_ns / NS_PER_S;
+    double wall_s = (double)stats->wall_time_ns / NS_PER_S;
+
+    fprintf(out, "frames            %llu\n", (unsigned long long)stats->frames);
+    fprintf(out, "bytes             %llu\n", (unsigned long long)stats->bytes);
+    fprintf(out, "dma events        %llu\n", (unsigned long long)stats->dma_events);
+    fprintf(out, "corrupted         %llu\n", (unsigned long long)stats->corrupted);
+    fprintf(out, "fragmented        %llu\n", (unsigned long long)stats->fragmented);
+    fprintf(out, "mailbox overruns  %lu\n", (unsigned long)mailbox->overrun_count);
+    fprintf(out, "mailbox high      %lu\n", (unsigned long)mailbox->high_water);
+    fprintf(out, "applet runs       %llu\n", (unsigned long long)stats->applet_runs);
+    if (sim->config.ipc != NULL)
+    {
+        fprintf(out, "m4 received       %lu\n", (unsigned long)sim->config.ipc->received_count);
+        fprintf(out, "m4 checksum fail  %lu\n", (unsigned long)sim->config.ipc->checksum_failed_count);
+        fprintf(out, "m4 unknown        %lu\n", (unsigned long)sim->config.ipc->unknown_count);
+        fprintf(out, "m4 notifications  %lu\n", (unsigned long)sim->config.ipc->notify_count);
+    }
+    const struct vn310_pose_publisher_t *publisher = &sim->applet->publisher;
+    uint64_t suppressed = (uint64_t)publisher->suppressed_rate_count + publisher->suppressed_deadband_count;
+
+    fprintf(out, "poses published   %llu\n", (unsigned long long)stats->poses_published);
+    fprintf(out, "poses suppressed  %llu (rate %lu, dead-band %lu)\n", (unsigned long long)suppressed,
+            (unsigned long)publisher->suppressed_rate_count, (unsigned long)publisher->suppressed_deadband_count);
+    fprintf(out, "frames rejected   %llu\n", (unsigned long long)(stats->frames - stats->poses_published - suppressed));
+    fprintf(out, "stream time       %.3f s\n", wire_s);
+    fprintf(out, "wall time         %.3f s\n", wall_s);
+    if (wall_s > 0.0)
+    {
+        fprintf(out, "throughput        %.0f frames/s\n", (double)stats->frames / wall_s);
+        fprintf(out, "line rate         %.1fx at %u baud\n",
+                ((double)stats->bytes * UART_BITS_PER_BYTE / sim->config.baud_rate) / wall_s,
+                sim->config.baud_rate);
+    }
+}
+
+/**
+ * @brief Print the pipeline latency histograms recorded by the applet trace.
+ *
+ * Only meaningful if tracing was enabled before the run. With --speed 0 and a
+ * burst size above one, the parse stage includes the time frames wait in the
+ * mailbox for the next applet run.
+ *
+ * @param sim The simulator state.
+ * @param out Output stream.
+ */
+void vn310_sim_print_latency(const struct vn310_sim_state_t *sim, FILE *out)
+{
+    const struct vn310_trace_t *trace = &sim->applet->trace;
+
+    fprintf(out, "%-8s %6s %9s %9s %9s %9s (us, last %d frames)\n", "stage", "count", "min", "p50", "p99", "max", VN310_TRACE_DEPTH);
+    for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+    {
+        struct vn310_trace_summary_t summary;
+        vn310_trace_summarize(trace, stage, &summary);
+        fprintf(out, "%-8s %6lu %9.2f %9.2f %9.2f %9.2f\n", vn310_trace_stage_name(stage),
+                (unsigned long)summary.count, summary.min_ns / 1000.0, summary.p50_ns / 1000.0,
+                summary.p99_ns / 1000.0, summary.max_ns / 1000.0);
+    }
+    fprintf(out, "traced            %lu\n", (unsigned long)trace->traced_count);
+    fprintf(out, "parse failed      %lu\n", (unsigned long)trace->parse_failed_count);
+    fprintf(out, "unpublished       %lu\n", (unsigned long)trace->unpublished_count);
+}
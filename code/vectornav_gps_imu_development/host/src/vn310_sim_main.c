@@ -0,0 +1,311 @@
+/**
+ * @file vn310_sim_main.c
+ * @brief Command line front end for the host-side VN310 simulator.
+ *
+ * Runs the real VN310 driver, parser and applet against a replayed capture or a
+ * synthetic trajectory and prints pipeline statistics.
+ *
+ * Usage:
+ *   vn310_sim --synthetic <seconds> [--format ascii|binary] [--rate <hz>]
+ *   vn310_sim --replay <file.vnrec>
+ *   vn310_sim --raw <capture.bin>
+ *
+ * Common options:
+ *   --speed <x>       Line rate multiple, 0 runs unpaced (default 1)
+ *   --baud <n>        Simulated baud rate (default 115200)
+ *   --corrupt <p>     Probability of a flipped bit per frame
+ *   --fragment <p>    Probability of a frame arriving as two DMA events
+ *   --burst <n>       Frames delivered between applet runs (default 1)
+ *   --record <file>   Record the delivered stream
+ *   --seed <n>        Random seed for corruption and fragmentation
+ *   --max-rate <hz>   Maximum pose publish rate (default unlimited)
+ *   --deadband <deg>  Attitude dead-band for pose publishing (default 0)
+ *   --deadband-position <deg>  Latitude/longitude dead-band for pose publishing (default 0)
+ *   --keyframe <ms>   Pose keyframe interval (default off)
+ *   --trace           Print pipeline latency histograms after the run
+ *   --negotiate       Answer driver commands and size the link for --rate before a binary run
+ *   --log <file>      Write the applet binary log (raw frames and published poses)
+ *   --dual-core       Receive on an M4 thread and parse and publish on an M7 thread
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "vn310_sim.h"
+
+static uint8_t uart_rx_buf[UART_DMA_READ_BUF_SIZE];
+static struct cli_state_t cli_state;
+static struct vn310_applet_state_t applet;
+static struct vn310_sim_state_t sim;
+static struct vn310_ipc_shared_t ipc_shared;
+
+static STATUS _write_log_block(void *context, const uint8_t *block, size_t size)
+{
+    return (fwrite(block, 1, size, (FILE *)context) == size) ? OK : ERROR;
+}
+
+static void _usage(void)
+{
+    fprintf(stderr, "Usage: vn310_sim (--synthetic <s> | --replay <file> | --raw <file>) [options]\n");
+    fprintf(stderr, "  --format ascii|binary  --rate <hz>  --speed <x>  --baud <n>\n");
+    fprintf(stderr, "  --corrupt <p>  --fragment <p>  --burst <n>  --record <file>  --seed <n>\n");
+    fprintf(stderr, "  --max-rate <hz>  --deadband <deg>  --deadband-position <deg>  --keyframe <ms>  --trace  --negotiate  --log <file>  --dual-core\n");
+}
+
+int main(int argc, char **argv)
+{
+    struct vn310_sim_config_t sim_config = {
+        .speed = 1.0,
+        .baud_rate = 115200,
+        .corrupt_probability = 0.0,
+        .fragment_probability = 0.0,
+        .frames_per_run = 1,
+        .seed = 1,
+    };
+    struct vn310_sim_trajectory_t trajectory = {
+        .format = SIM_FORMAT_BINARY,
+        .output_rate_hz = 50.0,
+        .duration_s = 0.0,
+        .yaw_start_deg = 0.0,
+        .yaw_rate_dps = 10.0,
+        .pitch_amplitude_deg = 5.0,
+        .roll_amplitude_deg = 8.0,
+        .motion_period_s = 4.0,
+        .latitude_deg = 51.5199,
+        .longitude_deg = -0.1100,
+        .altitude_m = 89.0,
+        .ground_speed_mps = 15.0,
+    };
+    struct vn310_pose_publish_config_t publish_config = {0};
+    const char *replay_path = NULL;
+    const char *raw_path = NULL;
+    const char *record_path = NULL;
+    const char *log_path = NULL;
+    FILE *log_file = NULL;
+    bool trace = false;
+    bool negotiate = false;
+    bool dual_core = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--trace") == 0)
+        {
+            trace = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--dual-core") == 0)
+        {
+            dual_core = true;
+            continue;
+        }
+        if (strcmp(argv[i], "--negotiate") == 0)
+        {
+            negotiate = true;
+            sim_config.respond_to_commands = true;
+            continue;
+        }
+
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (value == NULL)
+        {
+            _usage();
+            return 1;
+        }
+        if (strcmp(argv[i], "--synthetic") == 0)
+        {
+            trajectory.duration_s = atof(value);
+        }
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            replay_path = value;
+        }
+        else if (strcmp(argv[i], "--raw") == 0)
+        {
+            raw_path = value;
+        }
+        else if (strcmp(argv[i], "--format") == 0)
+        {
+            trajectory.format = (strcmp(value, "ascii") == 0) ? SIM_FORMAT_ASCII : SIM_FORMAT_BINARY;
+        }
+        else if (strcmp(argv[i], "--rate") == 0)
+        {
+            trajectory.output_rate_hz = atof(value);
+        }
+        else if (strcmp(argv[i], "--speed") == 0)
+        {
+            sim_config.speed = atof(value);
+        }
+        else if (strcmp(argv[i], "--baud") == 0)
+        {
+            sim_config.baud_rate = (unsigned int)atoi(value);
+        }
+        else if (strcmp(argv[i], "--corrupt") == 0)
+        {
+            sim_config.corrupt_probability = atof(value);
+        }
+        else if (strcmp(argv[i], "--fragment") == 0)
+        {
+            sim_config.fragment_probability = atof(value);
+        }
+        else if (strcmp(argv[i], "--burst") == 0)
+        {
+            sim_config.frames_per_run = (uint32_t)atoi(value);
+        }
+        else if (strcmp(argv[i], "--record") == 0)
+        {
+            record_path = value;
+        }
+        else if (strcmp(argv[i], "--log") == 0)
+        {
+            log_path = value;
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            sim_config.seed = (uint32_t)strtoul(value, NULL, 0);
+        }
+        else if (strcmp(argv[i], "--max-rate") == 0)
+        {
+            double max_rate_hz = atof(value);
+            publish_config.min_interval_ns = (max_rate_hz > 0.0) ? (uint64_t)(1.0e9 / max_rate_hz) : 0;
+        }
+        else if (strcmp(argv[i], "--deadband") == 0)
+        {
+            float deadband_deg = (float)atof(value);
+            publish_config.deadband_deg[0] = deadband_deg;
+            publish_config.deadband_deg[1] = deadband_deg;
+            publish_config.deadband_deg[2] = deadband_deg;
+        }
+        else if (strcmp(argv[i], "--deadband-position") == 0)
+        {
+            publish_config.deadband_position_deg = (float)atof(value);
+        }
+        else if (strcmp(argv[i], "--keyframe") == 0)
+        {
+            publish_config.keyframe_interval_ns = (uint64_t)atoi(value) * 1000000ULL;
+        }
+        else
+        {
+            _usage();
+            return 1;
+        }
+        i++;
+    }
+
+    struct vn310_applet_config_t applet_config = {0};
+    applet_config.cli_state = &cli_state;
+    applet_config.publish_config = publish_config;
+    applet_config.driver_config.vectornav_uart_config.rx_buf = uart_rx_buf;
+    applet_config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(uart_rx_buf);
+    applet_config.driver_config.vectornav_uart_config.baud_rate = sim_config.baud_rate;
+    cli_state.quiet = true;
+
+    if (dual_core)
+    {
+        if (negotiate)
+        {
+            fprintf(stderr, "--negotiate is not supported with --dual-core\n");
+            return 1;
+        }
+        vn310_ipc_init(&ipc_shared);
+        applet_config.ipc_shared = &ipc_shared;
+        sim_config.ipc = &ipc_shared;
+    }
+
+    if (log_path != NULL)
+    {
+        log_file = fopen(log_path, "wb");
+        if (log_file == NULL)
+        {
+            fprintf(stderr, "Cannot create %s\n", log_path);
+            return 1;
+        }
+        applet_config.log_write = _write_log_block;
+        applet_config.log_context = log_file;
+    }
+
+    if (vn310_applet_init(&applet, &applet_config) != OK ||
+        vn310_applet_start(&applet) != OK)
+    {
+        fprintf(stderr, "Applet start failed\n");
+        return 1;
+    }
+    applet.driver_state.send_pose = true;
+    applet.trace.enabled = trace;
+    applet.log.enabled = (log_file != NULL);
+
+    if (vn310_sim_init(&sim, &sim_config, &applet) != OK)
+    {
+        fprintf(stderr, "Invalid simulator configuration\n");
+        return 1;
+    }
+    if (record_path != NULL && vn310_sim_record_open(&sim, record_path) != OK)
+    {
+        fprintf(stderr, "Cannot create %s\n", record_path);
+        return 1;
+    }
+
+    if (negotiate)
+    {
+        if (trajectory.format != SIM_FORMAT_BINARY ||
+            vn310_sim_negotiate(&sim, (uint32_t)trajectory.output_rate_hz, 0) != OK)
+        {
+            fprintf(stderr, "Link negotiation failed at %u baud\n", applet.driver_state.baud_rate);
+            return 1;
+        }
+        printf("link              %lu B/s at %u baud\n",
+               (unsigned long)applet.driver_state.link.required_bytes_per_s, applet.driver_state.baud_rate);
+    }
+
+    if (dual_core && vn310_sim_m7_start(&sim) != OK)
+    {
+        fprintf(stderr, "Cannot start the M7 thread\n");
+        return 1;
+    }
+
+    STATUS status;
+    if (replay_path != NULL)
+    {
+        status = vn310_sim_replay_record(&sim, replay_path);
+    }
+    else if (raw_path != NULL)
+    {
+        status = vn310_sim_replay_raw(&sim, raw_path);
+    }
+    else if (trajectory.duration_s > 0.0)
+    {
+        status = vn310_sim_run_trajectory(&sim, &trajectory);
+    }
+    else
+    {
+        _usage();
+        return 1;
+    }
+
+    if (dual_core)
+    {
+        vn310_sim_m7_stop(&sim);
+    }
+    vn310_sim_record_close(&sim);
+    if (log_file != NULL)
+    {
+        vn310_log_sync(&applet.log);
+        vn310_applet_log_task(&applet);
+        fclose(log_file);
+    }
+    vn310_sim_print_stats(&sim, stdout);
+    if (trace)
+    {
+        vn310_sim_print_latency(&sim, stdout);
+    }
+    if (log_path != NULL)
+    {
+        printf("log               %lu records, %lu dropped, %lu blocks\n", (unsigned long)applet.log.record_count,
+               (unsigned long)applet.log.dropped_count, (unsigned long)applet.log.block_count);
+    }
+
+    return (status == OK) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file vn310_track_main.c
+ * @brief Host front end for the satellite handover scheduler.
+ *
+ * Loads candidate satellites from a TLE file, runs the handover scheduler at the
+ * pointing rate for a platform at a fixed position and attitude, and reports the
+ * handovers, outages and the cost of each pointing update.
+ *
+ * Usage:
+ *   vn310_track <tles.txt> [--lat <deg>] [--lon <deg>] [--alt <m>] [--yaw <deg>]
+ *                          [--pitch <deg>] [--roll <deg>] [--duration <s>] [--rate <hz>]
+ *                          [--scan <deg>] [--mask <deg>] [--csv <targets.csv>]
+ *
+ * The run starts at the latest element epoch in the file. At most
+ * VN310_HANDOVER_MAX_SATELLITES candidates are used, in file order.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vn310_handover.h"
+#include "vn310_sim.h"
+
+#define MAX_TLE_FILE_SIZE   (1024 * 1024)
+
+static void _usage(void)
+{
+    fprintf(stderr, "Usage: vn310_track <tles.txt> [--lat <deg>] [--lon <deg>] [--alt <m>] [--yaw <deg>] [--pitch <deg>]\n"
+                    "                   [--roll <deg>] [--duration <s>] [--rate <hz>] [--scan <deg>] [--mask <deg>] [--csv <file>]\n");
+}
+
+static char *_read_file(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    char *text = malloc(MAX_TLE_FILE_SIZE + 1);
+    if (text != NULL)
+    {
+        size_t size = fread(text, 1, MAX_TLE_FILE_SIZE, file);
+        text[size] = '\0';
+    }
+    fclose(file);
+
+    return text;
+}
+
+int main(int argc, char **argv)
+{
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    struct vn310_handover_config_t config = {0};
+    struct vn310_pose_t pose = {0};
+    double duration_s = 600.0;
+    double rate_hz = 200.0;
+    FILE *csv = NULL;
+
+    config.max_scan_deg = VN310_HANDOVER_USE_DEFAULT;
+    config.min_elevation_deg = VN310_HANDOVER_USE_DEFAULT;
+
+    if (argc < 2)
+    {
+        _usage();
+        return 1;
+    }
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        double value = atof(argv[i + 1]);
+
+        if (strcmp(argv[i], "--lat") == 0)
+        {
+            pose.latitude = (float)value;
+        }
+        else if (strcmp(argv[i], "--lon") == 0)
+        {
+            pose.longitude = (float)value;
+        }
+        else if (strcmp(argv[i], "--alt") == 0)
+        {
+            pose.altitude = (float)value;
+        }
+        else if (strcmp(argv[i], "--yaw") == 0)
+        {
+            pose.yaw = (float)value;
+        }
+        else if (strcmp(argv[i], "--pitch") == 0)
+        {
+            pose.pitch = (float)value;
+        }
+        else if (strcmp(argv[i], "--roll") == 0)
+        {
+            pose.roll = (float)value;
+        }
+        else if (strcmp(argv[i], "--duration") == 0)
+        {
+            duration_s = value;
+        }
+        else if (strcmp(argv[i], "--rate") == 0)
+        {
+            rate_hz = value;
+        }
+        else if (strcmp(argv[i], "--scan") == 0)
+        {
+            config.max_scan_deg = (float)value;
+        }
+        else if (strcmp(argv[i], "--mask") == 0)
+        {
+            config.min_elevation_deg = (float)value;
+        }
+        else if (strcmp(argv[i], "--csv") == 0)
+        {
+            csv = fopen(argv[i + 1], "w");
+            if (csv == NULL)
+            {
+                fprintf(stderr, "Cannot open %s\n", argv[i + 1]);
+                return 1;
+            }
+            fprintf(csv, "time_s,satellite,theta_deg,phi_deg,elevation_deg,range_m,handover\n");
+        }
+        else
+        {
+            _usage();
+            return 1;
+        }
+    }
+
+    char *text = _read_file(argv[1]);
+    if (text == NULL)
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 1;
+    }
+    int count = vn310_orbit_parse_tles(text, orbits, VN310_HANDOVER_MAX_SATELLITES);
+    free(text);
+
+    if (count == 0 || rate_hz <= 0.0)
+    {
+        fprintf(stderr, "No near-earth element sets in %s\n", argv[1]);
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (orbits[i].epoch_jd > config.epoch_jd)
+        {
+            config.epoch_jd = orbits[i].epoch_jd;
+        }
+    }
+
+    vn310_attitude_quaternion_from_ypr(pose.yaw, pose.pitch, pose.roll, pose.quaternion);
+    vn310_handover_init(&handover, &config, orbits, count);
+
+    uint64_t updates = (uint64_t)(duration_s * rate_hz);
+    uint64_t start_ns = vn310_sim_now_ns();
+
+    for (uint64_t n = 0; n < updates; n++)
+    {
+        double time_s = (double)n / rate_hz;
+        struct vn310_handover_target_t target;
+        int previous = handover.serving;
+
+        STATUS status = vn310_handover_update(&handover, time_s, &pose, &target);
+
+        if (target.handover || (status == OK && previous == VN310_HANDOVER_NONE))
+        {
+            printf("%9.2f s  %-24s -> %-24s theta %5.1f phi %5.1f el %4.1f\n", time_s,
+                   previous == VN310_HANDOVER_NONE ? "(none)" : orbits[previous].name,
+                   orbits[target.satellite].name, target.theta, target.phi, target.elevation);
+        }
+        else if (status != OK && previous != VN310_HANDOVER_NONE)
+        {
+            printf("%9.2f s  %-24s -> (none)\n", time_s, orbits[previous].name);
+        }
+
+        if (csv != NULL)
+        {
+            fprintf(csv, "%.3f,%d,%.3f,%.3f,%.3f,%.0f,%d\n", time_s, target.satellite, target.theta, target.phi,
+                    target.elevation, target.range, target.handover);
+        }
+    }
+
+    double elapsed_ns = (double)(vn310_sim_now_ns() - start_ns);
+
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+
+    printf("%d candidates, %lu updates at %.0f Hz: %u handovers, %u updates without a satellite\n",
+           count, (unsigned long)updates, rate_hz, handover.handover_count, handover.outage_count);
+    printf("%u SGP4 batches, %.0f ns per pointing update\n", handover.propagation_count,
+           updates ? elapsed_ns / (double)updates : 0.0);
+
+    return 0;
+}
@@ -12,14 +12,48 @@
 #pragma once
 
 #include "vn310_cli.h"
+#include "vn310_driver.h"
 #include "vn310_pose.h"
 #include "vn310_parser.h"
+#include "vn310_predictor.h"
+#include "vn310_trace.h"
+#include "vn310_merge.h"
+#include "vn310_log.h"
+#include "vn310_ipc.h"
+#include "vn310_console.h"
+#include "vn310_frames.h"
 #include "driver_gpio.h"
 
+struct vn310_applet_config_t {
+    struct vn310_driver_config_t driver_config;
+    struct vn310_driver_config_t secondary_driver_config;  // Second port or second sensor
+    bool secondary_enabled;
+    struct cli_state_t *cli_state;
+    struct bsp_pin_t power_enable;
+    struct bsp_pin_t pri_r_en_l;  // Primary RS-422 receiver enable (active low)
+    struct bsp_pin_t pri_d_en;    // Primary RS-422 driver enable
+    struct bsp_pin_t sec_r_en_l;  // Secondary RS-422 receiver enable (active low)
+    struct bsp_pin_t sec_d_en;    // Secondary RS-422 driver enable
+    struct vn310_pose_publish_config_t publish_config;
+    struct vn310_merge_config_t merge_config;
+    vn310_log_write_t log_write;  // Log storage sink, e.g. flash or SD card
+    void *log_context;
+    struct vn310_ipc_shared_t *ipc_shared;  // Rings filled by the M4 in the dual-core split, NULL for single core
+};
+
 struct vn310_applet_state_t {
     struct vn310_applet_config_t config;
-    struct driver_vn310_state_t driver_state;
-    struct vn310_pose_t pose_data;  // Added pose data to state
+    struct vn310_driver_state_t driver_state;
+    struct vn310_driver_state_t secondary_driver_state;  // Fed by the secondary UART callback
+    struct vn310_pose_t source_pose[VN310_MERGE_MAX_SOURCES];  // Last sample parsed from each input
+    struct vn310_pose_t pose_data;  // Last published pose
+    struct vn310_merge_t merge;
+    struct vn310_log_t log;
+    struct vn310_predictor_state_t predictor;
+    struct vn310_pose_publisher_t publisher;
+    struct vn310_trace_t trace;
+    struct vn310_console_t console;  // Raw frames streamed to the CLI
+    struct vn310_frames_site_t site;  // Platform position for satellite pointing
 };
 
 /**
@@ -44,9 +78,84 @@ STATUS vn310_applet_start(struct vn310_applet_state_t *state);
 /**
  * @brief Run the vn310 app.
  *
- * This function handles message processing and pose updates.
+ * This function handles message processing and pose updates. With the secondary
+ * input enabled, frames from both inputs are handled in arrival order and merged.
  *
  * @param state The state of the vn310 app.
  * @return OK if the run was successful.
  */
-STATUS vn310_applet_run(struct vn310_applet_state_t *state); 
\ No newline at end of file
+STATUS vn310_applet_run(struct vn310_applet_state_t *state);
+
+/**
+ * @brief Get the pose predicted for the actuation time.
+ *
+ * This function propagates the last received attitude to the requested time
+ * using the angular rates reported by the VN310.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param pose The predicted pose.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_predicted_pose(struct vn310_applet_state_t *state, uint64_t actuation_time_ns, struct vn310_pose_t *pose);
+
+/**
+ * @brief Get antenna frame steering vectors at the actuation time.
+ *
+ * This function rotates lines of sight given in NED into the antenna frame
+ * using the attitude quaternion predicted for the requested time.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param los_ned Unit lines of sight in NED.
+ * @param los_antenna Output unit lines of sight in the antenna frame.
+ * @param count Number of lines of sight.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_steering_vectors(struct vn310_applet_state_t *state, uint64_t actuation_time_ns,
+                                         const float los_ned[][3], float los_antenna[][3], int count);
+
+/**
+ * @brief Get antenna frame lines of sight to satellites at the actuation time.
+ *
+ * This function maps satellite ECEF positions into the antenna frame using the
+ * position and attitude predicted for the requested time. The platform position
+ * trigonometry is cached and only recomputed once the platform has moved.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param x Satellite ECEF x (m).
+ * @param y Satellite ECEF y (m).
+ * @param z Satellite ECEF z (m).
+ * @param los_x Output antenna frame x of the unit lines of sight.
+ * @param los_y Output antenna frame y of the unit lines of sight.
+ * @param los_z Output antenna frame z of the unit lines of sight.
+ * @param range Output ranges (m).
+ * @param count Number of satellites.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_satellite_los(struct vn310_applet_state_t *state, uint64_t actuation_time_ns,
+                                      const double *x, const double *y, const double *z,
+                                      float *los_x, float *los_y, float *los_z, float *range, int count);
+
+/**
+ * @brief Write buffered log blocks to storage.
+ *
+ * Call from a low-priority task. Storage writes may block, the applet never
+ * waits for them.
+ *
+ * @param state The state of the vn310 app.
+ * @return Number of blocks written.
+ */
+uint32_t vn310_applet_log_task(struct vn310_applet_state_t *state);
+
+/**
+ * @brief Print streamed frames to the CLI.
+ *
+ * Call from a low-priority task. The applet only queues streamed frames; if the
+ * console falls behind, the oldest queued frames are dropped.
+ *
+ * @param state The state of the vn310 app.
+ * @return Number of lines printed.
+ */
+uint32_t vn310_applet_console_task(struct vn310_applet_state_t *state);
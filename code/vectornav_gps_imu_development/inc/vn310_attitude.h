@@ -0,0 +1,45 @@
+/**
+ * @file vn310_attitude.h
+ * @brief Header file for VN310 attitude representations and steering vectors.
+ *
+ * This file defines the direction cosine matrix used by beam pointing and the
+ * conversions between the attitude quaternion carried in the pose, the yaw, pitch,
+ * roll angles and the matrix. Quaternions are stored in the VN310 output order
+ * (x, y, z, w) and describe the body frame relative to the local NED frame.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+enum vn310_quaternion_index
+{
+    QUATERNION_X = 0,
+    QUATERNION_Y = 1,
+    QUATERNION_Z = 2,
+    QUATERNION_W = 3
+};
+
+/*
+ * Body to NED rotation, row major: v_ned = m * v_body. The antenna frame is the
+ * VN310 body frame, the array being mounted aligned with the sensor.
+ */
+struct vn310_dcm_t
+{
+    float m[3][3];
+};
+
+void vn310_attitude_quaternion_from_ypr(float yaw, float pitch, float roll, float q[4]);
+void vn310_attitude_quaternion_to_ypr(const float q[4], float *yaw, float *pitch, float *roll);
+void vn310_attitude_quaternion_from_ypr_double(double yaw, double pitch, double roll, double q[4]);
+void vn310_attitude_quaternion_to_ypr_double(const double q[4], double *yaw, double *pitch, double *roll);
+bool vn310_attitude_quaternion_valid(const float q[4]);
+void vn310_attitude_quaternion_to_dcm(const float q[4], struct vn310_dcm_t *dcm);
+void vn310_attitude_ypr_to_dcm(float yaw, float pitch, float roll, struct vn310_dcm_t *dcm);
+void vn310_attitude_los_from_az_el(float azimuth, float elevation, float los_ned[3]);
+void vn310_attitude_steering_vector(const struct vn310_dcm_t *dcm, const float los_ned[3], float los_antenna[3]);
@@ -11,7 +11,8 @@
 
 #pragma once
 
-#include "vn310_app.h"
 #include "command_line_interface.h"
 
-void vn310_cli_init(struct app_vn310_state_t *state, struct cli_state_t *cli_state); 
\ No newline at end of file
+struct vn310_applet_state_t;
+
+void vn310_cli_init(struct vn310_applet_state_t *state, struct cli_state_t *cli_state); 
\ No newline at end of file
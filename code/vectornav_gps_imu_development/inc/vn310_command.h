@@ -0,0 +1,88 @@
+/**
+ * @file vn310_command.h
+ * @brief Header file for the VectorNav command/response engine.
+ *
+ * This file defines a pipelined command queue for VN310 register I/O. Commands
+ * are sent up to a configurable number in flight, responses are matched to the
+ * command that caused them, and commands that are not answered in time are
+ * retried before completing with an error. Commands can be grouped in a batch
+ * that reports once every member has completed.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "driver_uart.h"
+
+#define VN310_COMMAND_QUEUE_DEPTH        16
+#define VN310_COMMAND_MAX_LENGTH         100
+#define VN310_COMMAND_DEFAULT_IN_FLIGHT  4
+#define VN310_COMMAND_DEFAULT_TIMEOUT_MS 100
+#define VN310_COMMAND_DEFAULT_RETRIES    2
+
+typedef void (*vn310_command_callback_t)(void *context, STATUS status, const char *response);
+typedef void (*vn310_command_batch_callback_t)(void *context, uint8_t failed_count);
+
+enum vn310_command_slot_state
+{
+    COMMAND_SLOT_FREE      = 0,
+    COMMAND_SLOT_QUEUED    = 1,
+    COMMAND_SLOT_IN_FLIGHT = 2,
+    COMMAND_SLOT_RESERVED  = 3     // Being built in place, not yet queued
+};
+
+struct vn310_command_t
+{
+    enum vn310_command_slot_state slot_state;
+    char text[VN310_COMMAND_MAX_LENGTH];    // Built in place and transmitted from here
+    uint16_t length;
+    char match_id[4];           // Three letter command id, e.g. "WRG"
+    int16_t match_register;     // Register id for RRG/WRG, -1 otherwise
+    bool barrier;               // Sent alone, nothing else in flight either side of it
+    bool in_batch;
+    uint8_t retries_left;
+    uint32_t sequence;
+    uint32_t sent_ms;
+    vn310_command_callback_t callback;
+    void *context;
+};
+
+struct vn310_command_config_t
+{
+    uint8_t max_in_flight;
+    uint32_t timeout_ms;
+    uint8_t retries;
+};
+
+struct vn310_command_engine_t
+{
+    struct vn310_command_config_t config;
+    struct vn310_command_t commands[VN310_COMMAND_QUEUE_DEPTH];
+    uint32_t next_sequence;
+    bool batch_open;
+    uint8_t batch_outstanding;
+    uint8_t batch_failed;
+    vn310_command_batch_callback_t batch_callback;
+    void *batch_context;
+    uint32_t completed_count;
+    uint32_t failed_count;
+    uint32_t timeout_count;
+    uint32_t retry_count;
+    uint32_t unmatched_count;
+};
+
+STATUS vn310_command_init(struct vn310_command_engine_t *engine, const struct vn310_command_config_t *config);
+struct vn310_command_t *vn310_command_reserve(struct vn310_command_engine_t *engine);
+STATUS vn310_command_commit(struct vn310_command_engine_t *engine, struct vn310_command_t *command, size_t command_size, bool barrier, vn310_command_callback_t callback, void *context);
+void vn310_command_cancel(struct vn310_command_engine_t *engine, struct vn310_command_t *command);
+STATUS vn310_command_submit(struct vn310_command_engine_t *engine, const char *command, size_t command_size, bool barrier, vn310_command_callback_t callback, void *context);
+STATUS vn310_command_process(struct vn310_command_engine_t *engine, struct driver_uart_state_t *uart_state, uint32_t now_ms);
+STATUS vn310_command_handle_response(struct vn310_command_engine_t *engine, const char *response);
+STATUS vn310_command_batch_begin(struct vn310_command_engine_t *engine, vn310_command_batch_callback_t callback, void *context);
+STATUS vn310_command_batch_end(struct vn310_command_engine_t *engine);
+uint8_t vn310_command_pending(const struct vn310_command_engine_t *engine);
@@ -0,0 +1,44 @@
+/**
+ * @file vn310_command_builder.h
+ * @brief Header file for the VectorNav ASCII command builder.
+ *
+ * This file defines a small formatter that appends a command id and its comma
+ * separated arguments straight into a command buffer, then terminates the command
+ * with a real 8-bit or 16-bit checksum. Numbers are formatted without the C
+ * library, so building a command costs a few hundred cycles instead of a full
+ * snprintf pass per field.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define VN310_BUILDER_MAX_DECIMALS   6
+
+enum vn310_checksum_type
+{
+    VN310_CHECKSUM_8BIT  = 0,   // XOR of the bytes between '$' and '*', two hex characters
+    VN310_CHECKSUM_16BIT = 1,   // CRC16-CCITT of the bytes between '$' and '*', four hex characters
+    VN310_CHECKSUM_NONE  = 2    // "XX" placeholder, accepted by the sensor without checking
+};
+
+struct vn310_command_builder_t
+{
+    char *buffer;
+    uint16_t capacity;
+    uint16_t length;
+    bool overflow;              // Set if any field did not fit or could not be formatted
+};
+
+void vn310_builder_begin(struct vn310_command_builder_t *builder, char *buffer, uint16_t capacity, const char *command_id);
+void vn310_builder_add_uint(struct vn310_command_builder_t *builder, uint32_t value);
+void vn310_builder_add_int(struct vn310_command_builder_t *builder, int32_t value);
+void vn310_builder_add_fixed(struct vn310_command_builder_t *builder, double value, uint8_t decimals);
+void vn310_builder_add_hex(struct vn310_command_builder_t *builder, uint32_t value, uint8_t digits);
+void vn310_builder_add_text(struct vn310_command_builder_t *builder, const char *text);
+STATUS vn310_builder_finish(struct vn310_command_builder_t *builder, enum vn310_checksum_type checksum);
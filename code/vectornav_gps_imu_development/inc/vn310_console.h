@@ -0,0 +1,62 @@
+/**
+ * @file vn310_console.h
+ * @brief Header file for the VN310 console stream queue.
+ *
+ * This file defines the bounded queue that decouples streaming raw VN310 frames to
+ * the CLI from frame processing. The applet formats each streamed frame into a line
+ * without printf and queues it; a low-priority console task prints queued lines. If
+ * the console falls behind, the oldest lines are overwritten, so the applet never
+ * waits for the console and the newest frames are always the ones shown.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "command_line_interface.h"
+#include "vn310_mailbox.h"
+
+#define VN310_CONSOLE_DEPTH          16      // Must be a power of two
+#define VN310_CONSOLE_MASK           (VN310_CONSOLE_DEPTH - 1)
+#define VN310_CONSOLE_LINE_SIZE      192     // Fits a configuration 0 packet as hex
+#define VN310_CONSOLE_DRAIN_LINES    4       // Lines printed per console task call
+
+#if (VN310_CONSOLE_DEPTH & VN310_CONSOLE_MASK) != 0
+#error "VN310_CONSOLE_DEPTH must be a power of two"
+#endif
+
+enum vn310_console_mode
+{
+    CONSOLE_MODE_TEXT = 0,      // ASCII frames as text, binary frames as hex
+    CONSOLE_MODE_HEX  = 1       // Every frame as hex
+};
+
+struct vn310_console_line_t
+{
+    uint16_t length;
+    char text[VN310_CONSOLE_LINE_SIZE];
+};
+
+struct vn310_console_t
+{
+    struct vn310_console_line_t lines[VN310_CONSOLE_DEPTH];
+    uint32_t head;              // Written by the producer only
+    uint32_t tail;              // Advanced by the consumer, or by the producer to drop the oldest line
+    enum vn310_console_mode mode;
+    uint32_t decimation;        // Stream every Nth frame, 0 or 1 for every frame
+    uint32_t frame_counter;
+    uint32_t queued_count;      // Producer side statistics
+    uint32_t dropped_count;
+    uint32_t decimated_count;
+    uint32_t printed_count;     // Consumer side statistics
+};
+
+STATUS vn310_console_init(struct vn310_console_t *console);
+void vn310_console_configure(struct vn310_console_t *console, uint32_t decimation, enum vn310_console_mode mode);
+void vn310_console_stream(struct vn310_console_t *console, const struct vn310_frame_t *frame, bool forced);
+bool vn310_console_pop(struct vn310_console_t *console, struct vn310_console_line_t *line);
+uint32_t vn310_console_drain(struct vn310_console_t *console, struct cli_state_t *cli_state, uint32_t max_lines);
@@ -18,9 +18,14 @@
 #include "config.h"
 #include "driver_uart.h"
 #include "console_commands.h"
+#include "vn310_mailbox.h"
+#include "vn310_command.h"
+#include "vn310_command_builder.h"
+#include "vn310_trace.h"
+#include "vn310_link.h"
 
-#define UART_DMA_READ_BUF_SIZE       256
-#define VN310_COMMAND_BUFFER_SIZE    100
+#define UART_DMA_READ_BUF_SIZE       VN310_FRAME_MAX_SIZE
+#define VN310_BASELINE_DEFAULT_UNCERTAINTY 0.0254  // m, for baselines up to 1 m
 
 #define VECTORNAV_HEADER             "$VN"
 #define VECTORNAV_ERR                "ERR"
@@ -31,15 +36,28 @@
 #define VECTORNAV_WRITE_SETTINGS_CMD "WNV"
 #define VECTORNAV_ASYNC_CMD          "ASY"
 #define VECTORNAV_BOM_CMD            "BOM"
-#define VECTORNAV_NO_CRC             "XX"
+#define VECTORNAV_SIH_CMD            "SIH"
 #define VECTORNAV_CRLF               "\r\n"
 #define VECTORNAV_SYNC_BYTE          "\xFA"
 
+/*
+ * Binary output configuration 0 uses the common group only, so the packet is
+ * sync, group byte, one 16-bit field mask, the payload and a 16-bit CRC.
+ * Payload fields appear in field bit order.
+ */
+#define VN310_BINARY_SYNC                 0xFA
+#define VN310_BINARY_CONFIG0_GROUP        0x01    // Common group
+#define VN310_BINARY_CONFIG0_FIELDS       0x107A  // TimeGps, YawPitchRoll, Quaternion, AngularRate, Position, InsStatus
+#define VN310_BINARY_CONFIG0_HEADER_SIZE  4
+#define VN310_BINARY_CRC_SIZE             2
+
 enum vectornav_msg_type
 {
-    MSG_ASYNC  = 0,
-    MSG_BINARY = 1,  
-    MSG_ERROR  = 2, 
+    MSG_ASYNC    = 0,
+    MSG_BINARY   = 1,  
+    MSG_ERROR    = 2, 
+    MSG_RESPONSE = 3,  // Command response, e.g. $VNRRG
+    MSG_UNKNOWN  = 4
 };
 
 enum vectornav_async_mode
@@ -133,19 +151,56 @@ enum vectornav_register_id
 
 };
 
+struct __attribute__((packed)) vn310_driver_binout_config0_data_t
+{
+    struct __attribute__((packed)) { uint64_t time_gps; } gps_time;                         // ns since the GPS epoch
+    struct __attribute__((packed)) { float yaw; float pitch; float roll; } yaw_pitch_roll;    // degrees
+    struct __attribute__((packed)) { float q[4]; } quaternion;                              // x, y, z, w
+    struct __attribute__((packed)) { float rate[3]; } angular_rate;                         // rad/s, body frame
+    struct __attribute__((packed)) { double latitude; double longitude; double altitude; } position;
+    struct __attribute__((packed)) { uint16_t sol_status; } ins_status;
+};
+
+#define VN310_BINARY_CONFIG0_SIZE   (VN310_BINARY_CONFIG0_HEADER_SIZE + sizeof(struct vn310_driver_binout_config0_data_t) + VN310_BINARY_CRC_SIZE)
+
+struct vn310_driver_sensor_config_t
+{
+    unsigned int baud_rate;
+    double antenna_a[3];              // Antenna A offset from the IMU, body frame (m)
+    double baseline[3];               // Antenna A to antenna B baseline, body frame (m)
+    double baseline_uncertainty[3];   // Baseline measurement uncertainty (m)
+    uint16_t binary_rate_divisor;     // Binary output rate divisor, 0 for RATE_DIVISOR_4
+    uint8_t binary_async_mode;        // enum vectornav_async_mode, 0 for ASYNC_MODE_PORT_1
+};
+
 struct vn310_driver_config_t
 {
     struct driver_uart_config_t vectornav_uart_config;
+    struct vn310_driver_sensor_config_t sensor_config;
+    struct vn310_command_config_t command_config;
+    enum vn310_checksum_type checksum;
+    struct vn310_mailbox_t *shared_mailbox;  // Ring filled by the M4 in the dual-core split, NULL to receive locally
 
 };
 
 struct vn310_driver_state_t
 {
     struct vn310_driver_config_t config;
-    char assembled_message[UART_DMA_READ_BUF_SIZE];
+    struct vn310_mailbox_t *mailbox;  // The local mailbox or the shared ring
+    struct vn310_mailbox_t local_mailbox;
+    struct vn310_command_engine_t commands;
     struct driver_uart_state_t uart_state;
+    unsigned int baud_rate;           // Current UART baud rate
+    unsigned int pending_baud_rate;
+    vn310_command_callback_t baud_callback;
+    void *baud_context;
+    uint16_t binary_rate_divisor;     // Current binary output rate divisor
+    uint16_t ascii_rate_hz;           // Current ASCII output rate, 0 if off
+    struct vn310_link_t link;
     bool uart_stream;
-    bool vectornav_message_ready;
+    bool pose_stream;
+    bool response_expected;
+    bool send_pose;
     uint8_t message_counter;
 
 };
@@ -154,11 +209,14 @@ STATUS vn310_driver_configure(struct vn310_driver_state_t *state);
 STATUS vn310_driver_eventcallback(struct vn310_driver_state_t *vectornav_driver_state, uint16_t message_size);
 STATUS vn310_driver_init(struct vn310_driver_state_t *state, const struct vn310_driver_config_t *config);
 enum vectornav_msg_type vn310_driver_message_check(char *received_data, char *assembled_data, uint16_t recieved_message_size, uint16_t uart_dma_buffer_size);
-STATUS vn310_driver_print_stream(struct vn310_driver_state_t *state, struct cli_state_t *cli_state);
 STATUS vn310_driver_read_byte(struct vn310_driver_state_t *state, uint8_t *pData);
 STATUS vn310_driver_send_byte(struct vn310_driver_state_t *state, uint8_t *data, size_t data_size);
-STATUS vn310_driver_write_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, const uint8_t *data, size_t data_size);
+STATUS vn310_driver_send_command(struct vn310_driver_state_t *state, const char *command, size_t command_size, vn310_command_callback_t callback, void *context);
+STATUS vn310_driver_process(struct vn310_driver_state_t *state, uint32_t now_ms);
+STATUS vn310_driver_configure_sensor(struct vn310_driver_state_t *state, vn310_command_batch_callback_t callback, void *context);
+STATUS vn310_driver_write_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, const char *const values[], size_t value_count);
 STATUS vn310_driver_read_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id);
+STATUS vn310_driver_read_register_async(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, vn310_command_callback_t callback, void *context);
 STATUS vn310_driver_write_settings(struct vn310_driver_state_t *state);
 STATUS vn310_driver_factory_settings(struct vn310_driver_state_t *state);
 STATUS vn310_driver_reset_device(struct vn310_driver_state_t *state);
@@ -167,13 +225,21 @@ STATUS vn310_driver_output_pause(struct vn310_driver_state_t *state);
 STATUS vn310_driver_output_enable_port_1(struct vn310_driver_state_t *state);
 STATUS vn310_driver_set_antenna_a(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate);
 STATUS vn310_driver_set_antenna_b(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate);
+STATUS vn310_driver_set_antenna_baseline(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate, double x_uncertainty, double y_uncertainty, double z_uncertainty);
+STATUS vn310_driver_set_initial_heading(struct vn310_driver_state_t *state, double heading);
 STATUS vn310_driver_set_configuration_0(struct vn310_driver_state_t *state);
+STATUS vn310_driver_get_configuration_0_data(const struct vn310_frame_t *frame, const struct vn310_driver_binout_config0_data_t **data);
 STATUS vn310_driver_set_asynchronous_output(struct vn310_driver_state_t *state, char const *setting);
-STATUS vn310_driver_set_output_data_freq(struct vn310_driver_state_t *state, uint8_t data_freq);
+STATUS vn310_driver_set_output_data_freq(struct vn310_driver_state_t *state, uint8_t data_freq, vn310_command_callback_t callback, void *context);
 STATUS vn310_driver_set_vectoranv_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate);
+STATUS vn310_driver_set_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate, vn310_command_callback_t callback, void *context);
+STATUS vn310_driver_set_binary_output_rate(struct vn310_driver_state_t *state, uint16_t rate_divisor, vn310_command_callback_t callback, void *context);
 STATUS vn310_driver_set_uart_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate);
 STATUS vn310_driver_binary_output_poll(struct vn310_driver_state_t *state, uint8_t register_num);
 STATUS vn310_driver_read_model_number(struct vn310_driver_state_t *state);
 STATUS vn310_driver_read_hardware_revision(struct vn310_driver_state_t *state);
 STATUS vn310_driver_read_serial_number(struct vn310_driver_state_t *state);
-STATUS vn310_driver_read_firmware_version(struct vn310_driver_state_t *state); 
+STATUS vn310_driver_read_firmware_version(struct vn310_driver_state_t *state);
+unsigned char calculate_8_bit_crc(unsigned char data[], unsigned int length);
+unsigned short calculate_16_bit_crc(unsigned char data[], unsigned int length);
+STATUS vn310_driver_verify_checksum(const char *message, size_t size);
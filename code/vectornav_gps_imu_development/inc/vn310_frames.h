@@ -0,0 +1,66 @@
+/**
+ * @file vn310_frames.h
+ * @brief Header file for the VN310 coordinate frame transforms.
+ *
+ * This file defines the transforms that map satellite positions into the array
+ * frame for beam pointing: geodetic (WGS84 latitude, longitude, altitude) to ECEF,
+ * ECEF to the local NED frame at the platform, and NED to the body frame using the
+ * VN310 attitude. The array frame is the body frame, the array being mounted
+ * aligned with the sensor, and element positions lie in its x/y plane.
+ *
+ * The batched functions take structure-of-arrays inputs (one array per coordinate)
+ * so the per-satellite loops are branch-free and vectorize. The ECEF, NED and body
+ * stages all use double elements, so their outputs chain without a copy. The trigonometry of the
+ * platform position is cached in a site and only recomputed when the platform has
+ * moved, so an update for many satellites costs a few multiplies and one square
+ * root per satellite.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_attitude.h"
+#include "patch_position_calculation.h"
+
+#define VN310_FRAMES_WGS84_A                6378137.0               // Semi-major axis (m)
+#define VN310_FRAMES_WGS84_F                (1.0 / 298.257223563)   // Flattening
+#define VN310_FRAMES_WGS84_E2               (VN310_FRAMES_WGS84_F * (2.0 - VN310_FRAMES_WGS84_F))
+
+#define VN310_FRAMES_SITE_TOLERANCE_DEG     1e-5    // About 1 m of horizontal movement
+#define VN310_FRAMES_SITE_TOLERANCE_M       1.0     // Altitude change before the site is recomputed
+
+/*
+ * Platform position with its cached trigonometry. The ECEF to NED rotation is
+ * row major: v_ned = ecef_to_ned * (p_ecef - origin_ecef).
+ */
+struct vn310_frames_site_t
+{
+    double latitude;            // Degrees
+    double longitude;           // Degrees
+    double altitude;            // Metres above the ellipsoid
+    double origin_ecef[3];
+    double ecef_to_ned[3][3];
+    bool valid;
+    uint32_t update_count;      // Times the trigonometry was recomputed
+};
+
+void vn310_frames_lla_to_ecef(double latitude, double longitude, double altitude, double ecef[3]);
+void vn310_frames_lla_to_ecef_batch(const double *latitude, const double *longitude, const double *altitude,
+                                    double *x, double *y, double *z, int count);
+bool vn310_frames_site_update(struct vn310_frames_site_t *site, double latitude, double longitude, double altitude);
+void vn310_frames_ecef_to_ned_batch(const struct vn310_frames_site_t *site, const double *x, const double *y, const double *z,
+                                    double *n, double *e, double *d, int count);
+void vn310_frames_ned_to_body_batch(const struct vn310_dcm_t *dcm, const double *n, const double *e, const double *d,
+                                    double *bx, double *by, double *bz, int count);
+void vn310_frames_ecef_to_body_los_batch(const struct vn310_frames_site_t *site, const struct vn310_dcm_t *dcm,
+                                         const double *x, const double *y, const double *z,
+                                         float *los_x, float *los_y, float *los_z, float *range, int count);
+STATUS vn310_frames_tile_offsets(uint16_t tile_col, uint16_t tile_row, int nx, int ny, double spacing,
+                                 struct algorithm_EW_patch_t *patches, float *element_x, float *element_y);
+void vn310_frames_path_difference_batch(const float *element_x, const float *element_y, const float los_body[3],
+                                        float *path, int count);
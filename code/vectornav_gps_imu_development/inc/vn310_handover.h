@@ -0,0 +1,92 @@
+/**
+ * @file vn310_handover.h
+ * @brief Header file for the satellite look-angle cache and handover scheduler.
+ *
+ * This file defines the scheduler that turns a set of candidate satellites into an
+ * array frame pointing target at the pointing rate. Satellite states are propagated
+ * with SGP4 only at coarse knots and interpolated in between with cubic Hermite
+ * polynomials on the ECEF position and velocity, so a 200 Hz pointing update costs a
+ * few multiplies per candidate instead of an SGP4 run.
+ *
+ * Targets are given as theta, the angle off the array boresight (body -z, up when
+ * level), and phi, the azimuth in the array plane from body +x towards +y. The
+ * serving satellite is kept while it stays inside the scan cone and above the
+ * elevation mask; when it leaves, the eligible candidate closest to boresight takes
+ * over.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_frames.h"
+#include "vn310_orbit.h"
+#include "vn310_pose.h"
+
+#define VN310_HANDOVER_MAX_SATELLITES       16
+#define VN310_HANDOVER_KNOT_INTERVAL_S      30.0    // Interpolation error below 1 m for LEO
+#define VN310_HANDOVER_MAX_SCAN_DEG         60.0f
+#define VN310_HANDOVER_MIN_ELEVATION_DEG    25.0f
+#define VN310_HANDOVER_NONE                 (-1)
+#define VN310_HANDOVER_USE_DEFAULT          NAN     // Angle limit sentinel, any number including 0 is taken as given
+
+struct vn310_handover_config_t
+{
+    double epoch_jd;            // UTC Julian date of time 0
+    double knot_interval_s;     // 0 for VN310_HANDOVER_KNOT_INTERVAL_S
+    float max_scan_deg;         // VN310_HANDOVER_USE_DEFAULT for VN310_HANDOVER_MAX_SCAN_DEG
+    float min_elevation_deg;    // VN310_HANDOVER_USE_DEFAULT for VN310_HANDOVER_MIN_ELEVATION_DEG
+};
+
+struct vn310_handover_target_t
+{
+    int satellite;              // Index into the candidates, VN310_HANDOVER_NONE if none is eligible
+    float theta;                // Degrees off boresight
+    float phi;                  // Degrees, 0 to 360
+    float elevation;            // Degrees above the local horizon
+    float range;                // Metres
+    bool handover;              // The serving satellite changed on this update
+};
+
+struct vn310_handover_t
+{
+    struct vn310_handover_config_t config;
+    const struct vn310_orbit_t *orbits;
+    int count;
+
+    // Knot states, one array per coordinate, knot 0 at knot_time_s and knot 1 one interval later
+    double knot_time_s;
+    bool knots_valid;
+    double p0[3][VN310_HANDOVER_MAX_SATELLITES];
+    double v0[3][VN310_HANDOVER_MAX_SATELLITES];
+    double p1[3][VN310_HANDOVER_MAX_SATELLITES];
+    double v1[3][VN310_HANDOVER_MAX_SATELLITES];
+    bool valid0[VN310_HANDOVER_MAX_SATELLITES];
+    bool valid1[VN310_HANDOVER_MAX_SATELLITES];
+
+    // Latest look angles of every candidate
+    double position[3][VN310_HANDOVER_MAX_SATELLITES];
+    float theta[VN310_HANDOVER_MAX_SATELLITES];
+    float phi[VN310_HANDOVER_MAX_SATELLITES];
+    float elevation[VN310_HANDOVER_MAX_SATELLITES];
+    float range[VN310_HANDOVER_MAX_SATELLITES];
+
+    struct vn310_frames_site_t site;
+    int serving;
+    uint32_t update_count;
+    uint32_t propagation_count;     // SGP4 batch runs
+    uint32_t handover_count;
+    uint32_t outage_count;          // Updates with no eligible satellite
+};
+
+STATUS vn310_handover_init(struct vn310_handover_t *handover, const struct vn310_handover_config_t *config,
+                           const struct vn310_orbit_t *orbits, int count);
+STATUS vn310_handover_interpolate(struct vn310_handover_t *handover, double time_s,
+                                  double *x, double *y, double *z, bool *valid);
+STATUS vn310_handover_update(struct vn310_handover_t *handover, double time_s, const struct vn310_pose_t *pose,
+                             struct vn310_handover_target_t *target);
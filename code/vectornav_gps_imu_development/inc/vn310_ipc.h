@@ -0,0 +1,67 @@
+/**
+ * @file vn310_ipc.h
+ * @brief Header file for the VN310 dual-core frame hand-off.
+ *
+ * This file defines the block shared between the two cores of the STM32H7 when the
+ * VN310 pipeline is split: the Cortex-M4 owns the UART DMA, frames each message and
+ * checks its checksum, then commits it to a frame ring in shared memory and signals
+ * the Cortex-M7 through a hardware semaphore. The M7 drains the rings with the
+ * applet, which parses and publishes exactly as in the single-core build, and keeps
+ * the command engine and UART transmit.
+ *
+ * The rings are the single-producer/single-consumer mailboxes of the single-core
+ * build, placed in SRAM4, which the M7 maps non-cacheable. On the host the shared
+ * block is ordinary memory, the two cores are two threads and the semaphore
+ * interrupt is a condition variable.
+ *
+ * On target each core stamps trace points with its own cycle counter, so the
+ * receive stage (stamped on the M4) and the later stages (on the M7) are only
+ * comparable on the host, where both threads read the same clock.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_mailbox.h"
+#include "vn310_merge.h"
+
+#if !defined(__arm__)
+#include <pthread.h>
+#endif
+
+#define VN310_IPC_READY_MAGIC       0x4D344D37u     // "M4M7", written by the M7 once the rings are set up
+#define VN310_IPC_HSEM_ID           7u              // Hardware semaphore used as the frame doorbell
+
+#if defined(__arm__)
+#define VN310_IPC_SHARED            __attribute__((section(".vn310_shared"), aligned(32)))  // SRAM4, see the linker scripts
+#else
+#define VN310_IPC_SHARED
+#endif
+
+struct vn310_ipc_shared_t
+{
+    uint32_t ready;                                         // VN310_IPC_READY_MAGIC
+    struct vn310_mailbox_t rings[VN310_MERGE_MAX_SOURCES];  // Indexed by enum vn310_merge_source
+    uint32_t received_count;                                // M4 side statistics
+    uint32_t checksum_failed_count;
+    uint32_t unknown_count;
+    uint32_t notify_count;
+#if !defined(__arm__)
+    pthread_mutex_t doorbell_lock;                          // Host emulation of the semaphore interrupt
+    pthread_cond_t doorbell;
+    bool doorbell_rung;
+#endif
+};
+
+STATUS vn310_ipc_init(struct vn310_ipc_shared_t *shared);
+bool vn310_ipc_ready(const struct vn310_ipc_shared_t *shared);
+STATUS vn310_ipc_receive(struct vn310_ipc_shared_t *shared, uint8_t source, char *rx_buf, uint16_t message_size);
+bool vn310_ipc_wait(struct vn310_ipc_shared_t *shared, uint32_t timeout_ms);
+#if defined(__arm__)
+void vn310_ipc_irq_handler(struct vn310_ipc_shared_t *shared);
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file vn310_link.h
+ * @brief Header file for VN310 link rate negotiation.
+ *
+ * This file defines the serial link budget for the VN310: the bytes per second the
+ * configured outputs need, the lowest standard baud rate that carries them with
+ * headroom, and a negotiation that changes the output rates and the baud rate at
+ * both ends of the link, then proves the new link with a checksummed register read.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define VN310_IMU_RATE_HZ                   800     // Binary output rates are this divided by an integer
+#define VN310_LINK_BITS_PER_BYTE            10      // 8N1 framing
+#define VN310_LINK_MAX_UTILIZATION_PERCENT  70      // Leave room for command responses and jitter
+#define VN310_LINK_ASCII_INS_SIZE           140     // Worst case $VNINS message, including CRLF
+
+struct vn310_driver_state_t;
+
+typedef void (*vn310_link_callback_t)(void *context, STATUS status, unsigned int baud_rate);
+
+enum vn310_link_phase
+{
+    LINK_PHASE_IDLE           = 0,
+    LINK_PHASE_LOWER_RATE     = 1,  // Output rates reduced before a lower baud rate
+    LINK_PHASE_SWITCH_BAUD    = 2,  // Baud rate change sent as a barrier command
+    LINK_PHASE_PROBE          = 3,  // Reading the baud rate register on the new link
+    LINK_PHASE_PROBE_PREVIOUS = 4,  // New link failed, probing the previous baud rate
+    LINK_PHASE_RAISE_RATE     = 5   // Output rates raised after a higher baud rate
+};
+
+struct vn310_link_t
+{
+    enum vn310_link_phase phase;
+    struct vn310_driver_state_t *driver;
+    unsigned int previous_baud;
+    unsigned int target_baud;
+    uint16_t target_divisor;
+    uint16_t target_ascii_hz;
+    uint32_t required_bytes_per_s;
+    bool rates_applied;
+    bool ascii_rate_failed;         // The ASCII rate change was rejected or not answered
+    vn310_link_callback_t callback;
+    void *context;
+    uint32_t negotiated_count;
+    uint32_t failed_count;
+    uint32_t recovered_count;       // Failed negotiations that fell back to the previous baud rate
+};
+
+uint32_t vn310_link_required_bytes_per_s(uint32_t binary_size, uint32_t binary_rate_hz, uint32_t ascii_size, uint32_t ascii_rate_hz);
+unsigned int vn310_link_select_baud(uint32_t bytes_per_s, uint8_t max_utilization_percent);
+bool vn310_link_baud_supported(unsigned int baud_rate);
+bool vn310_link_ascii_rate_valid(uint32_t rate_hz);
+STATUS vn310_link_divisor_for_rate(uint32_t rate_hz, uint16_t *divisor);
+STATUS vn310_link_negotiate(struct vn310_driver_state_t *state, uint32_t binary_rate_hz, uint32_t ascii_rate_hz, vn310_link_callback_t callback, void *context);
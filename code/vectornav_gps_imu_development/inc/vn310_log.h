@@ -0,0 +1,100 @@
+/**
+ * @file vn310_log.h
+ * @brief Header file for the VN310 binary log.
+ *
+ * This file defines a compact append-only log of raw VN310 frames and published
+ * poses. Records are appended by the applet into RAM blocks, and full blocks are
+ * handed to a storage sink (flash or SD card on target, a file on the host) by a
+ * low-priority task, so logging never waits on storage.
+ *
+ * Record layout, little-endian:
+ *   sync (0xA5), type, payload length (16 bit), tick (32 bit, ms), payload,
+ *   CRC16-CCITT over everything after the sync byte.
+ * Blocks are VN310_LOG_BLOCK_SIZE bytes, records never span blocks and unused
+ * space at the end of a block is 0xFF, as erased flash reads.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_mailbox.h"
+#include "vn310_pose.h"
+
+#define VN310_LOG_BLOCK_SIZE        4096    // Flash page / SD sector multiple
+#define VN310_LOG_BLOCK_COUNT       4       // Blocks buffered in RAM
+#define VN310_LOG_BLOCK_ALIGN       32      // Cache line, for DMA to storage
+#define VN310_LOG_SYNC              0xA5
+#define VN310_LOG_PAD               0xFF
+#define VN310_LOG_HEADER_SIZE       8
+#define VN310_LOG_CRC_SIZE          2
+#define VN310_LOG_MAX_PAYLOAD       (VN310_FRAME_MAX_SIZE + 2)
+
+enum vn310_log_record_type
+{
+    LOG_RECORD_FRAME = 1,       // Raw frame: input, message type, frame bytes
+    LOG_RECORD_POSE  = 2        // Published pose, struct vn310_log_pose_t
+};
+
+struct __attribute__((packed)) vn310_log_header_t
+{
+    uint8_t sync;
+    uint8_t type;
+    uint16_t length;
+    uint32_t tick_ms;
+};
+
+struct __attribute__((packed)) vn310_log_pose_t
+{
+    uint64_t time_gps_pps;
+    float roll;
+    float pitch;
+    float yaw;
+    float latitude;
+    float longitude;
+    float altitude;
+    float rate[3];
+    uint16_t ins_status;
+    float quaternion[4];
+};
+
+/**
+ * @brief Storage sink for a full block.
+ *
+ * Called from the low-priority task only. May block.
+ *
+ * @return OK if the block was stored.
+ */
+typedef STATUS (*vn310_log_write_t)(void *context, const uint8_t *block, size_t size);
+
+struct vn310_log_block_t
+{
+    uint8_t data[VN310_LOG_BLOCK_SIZE];
+} __attribute__((aligned(VN310_LOG_BLOCK_ALIGN)));
+
+struct vn310_log_t
+{
+    bool enabled;
+    vn310_log_write_t write;
+    void *context;
+    struct vn310_log_block_t blocks[VN310_LOG_BLOCK_COUNT];
+    uint32_t head;              // Blocks filled, written by the applet only
+    uint32_t tail;              // Blocks stored, written by the storage task only
+    uint16_t fill;              // Bytes used in the block being filled
+    uint32_t record_count;
+    uint32_t dropped_count;     // Records lost because every block was waiting for storage
+    uint32_t block_count;       // Blocks stored
+    uint32_t write_error_count;
+};
+
+STATUS vn310_log_init(struct vn310_log_t *log, vn310_log_write_t write, void *context);
+STATUS vn310_log_append(struct vn310_log_t *log, uint8_t type, uint32_t tick_ms, const void *payload, uint16_t length);
+STATUS vn310_log_frame(struct vn310_log_t *log, uint8_t source, const struct vn310_frame_t *frame, uint32_t tick_ms);
+STATUS vn310_log_pose(struct vn310_log_t *log, const struct vn310_pose_t *pose, uint32_t tick_ms);
+void vn310_log_sync(struct vn310_log_t *log);
+uint32_t vn310_log_flush(struct vn310_log_t *log);
+size_t vn310_log_parse(const uint8_t *data, size_t size, struct vn310_log_header_t *header, const uint8_t **payload);
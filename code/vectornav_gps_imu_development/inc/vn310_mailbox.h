@@ -0,0 +1,54 @@
+/**
+ * @file vn310_mailbox.h
+ * @brief Header file for the VectorNav frame mailbox.
+ *
+ * This file defines a lock-free single-producer/single-consumer ring of raw
+ * VN310 frames. The UART DMA callback is the only producer and the applet is
+ * the only consumer, so each frame slot is owned by exactly one side at a time
+ * and the applet can never see a frame being overwritten while it parses it.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define VN310_FRAME_MAX_SIZE         256     // Matches UART_DMA_READ_BUF_SIZE
+#define VN310_MAILBOX_DEPTH          8       // Must be a power of two
+#define VN310_MAILBOX_MASK           (VN310_MAILBOX_DEPTH - 1)
+
+#if (VN310_MAILBOX_DEPTH & VN310_MAILBOX_MASK) != 0
+#error "VN310_MAILBOX_DEPTH must be a power of two"
+#endif
+
+struct vn310_frame_t
+{
+    uint8_t type;               // enum vectornav_msg_type
+    uint16_t size;
+    bool checked;               // Checksum already verified by the receiving core
+    uint32_t time_dma;          // Trace timestamps, see vn310_trace.h
+    uint32_t time_ready;
+    char data[VN310_FRAME_MAX_SIZE];
+};
+
+struct vn310_mailbox_t
+{
+    struct vn310_frame_t frames[VN310_MAILBOX_DEPTH];
+    uint32_t head;              // Written by the producer only
+    uint32_t tail;              // Written by the consumer only
+    uint32_t committed_count;   // Producer side statistics
+    uint32_t overrun_count;
+    uint32_t consumed_count;    // Consumer side statistics
+    uint32_t high_water;
+};
+
+STATUS vn310_mailbox_init(struct vn310_mailbox_t *mailbox);
+struct vn310_frame_t *vn310_mailbox_reserve(struct vn310_mailbox_t *mailbox);
+void vn310_mailbox_commit(struct vn310_mailbox_t *mailbox);
+struct vn310_frame_t *vn310_mailbox_peek(struct vn310_mailbox_t *mailbox);
+void vn310_mailbox_release(struct vn310_mailbox_t *mailbox);
+uint32_t vn310_mailbox_count(struct vn310_mailbox_t *mailbox);
@@ -0,0 +1,71 @@
+/**
+ * @file vn310_merge.h
+ * @brief Header file for the VN310 redundancy merge.
+ *
+ * This file defines the merge that decides which samples from two VN310 inputs,
+ * the two serial ports of one sensor or two sensors, are published. Samples are
+ * aligned by GPS time: the first sample of an epoch to arrive is published, and
+ * copies of it or older samples arriving on the other input are discarded.
+ * Samples without a GPS time are taken from the active input only, with failover
+ * to the other input once the active one has been silent for the failover
+ * timeout.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define VN310_MERGE_MAX_SOURCES                 2
+#define VN310_MERGE_DEFAULT_EPOCH_WINDOW_NS     1000000ULL  // Below the 1.25 ms IMU period
+#define VN310_MERGE_DEFAULT_FAILOVER_MS         50
+
+enum vn310_merge_source
+{
+    MERGE_SOURCE_PRIMARY   = 0,
+    MERGE_SOURCE_SECONDARY = 1
+};
+
+enum vn310_merge_result
+{
+    MERGE_PUBLISH   = 0,    // Freshest valid sample, publish it
+    MERGE_DUPLICATE = 1,    // Same epoch already published from the other input
+    MERGE_STALE     = 2,    // Older than the last published epoch
+    MERGE_INACTIVE  = 3     // Untimed sample from the standby input
+};
+
+struct vn310_merge_config_t
+{
+    uint64_t epoch_window_ns;       // Samples this close in GPS time are the same epoch, 0 for the default
+    uint32_t failover_ms;           // Silence before untimed samples fail over, 0 for the default
+};
+
+struct vn310_merge_source_stats_t
+{
+    uint32_t published_count;       // Epochs this input delivered first
+    uint32_t duplicate_count;
+    uint32_t stale_count;
+    uint32_t inactive_count;
+    uint32_t failed_count;          // Frames that failed their CRC or did not parse
+    uint32_t last_valid_ms;
+    bool seen;
+};
+
+struct vn310_merge_t
+{
+    struct vn310_merge_config_t config;
+    struct vn310_merge_source_stats_t sources[VN310_MERGE_MAX_SOURCES];
+    uint64_t last_time_ns;          // GPS time of the last published epoch
+    uint32_t last_publish_ms;
+    uint8_t active_source;          // Input of the last published sample
+    uint32_t failover_count;
+};
+
+void vn310_merge_init(struct vn310_merge_t *merge, const struct vn310_merge_config_t *config);
+enum vn310_merge_result vn310_merge_offer(struct vn310_merge_t *merge, uint8_t source, uint64_t time_ns, uint32_t now_ms);
+void vn310_merge_failed(struct vn310_merge_t *merge, uint8_t source);
+bool vn310_merge_source_alive(const struct vn310_merge_t *merge, uint8_t source, uint32_t now_ms);
@@ -0,0 +1,59 @@
+/**
+ * @file vn310_orbit.h
+ * @brief Header file for satellite orbit propagation from two-line elements.
+ *
+ * This file defines the parsed two-line element set and the SGP4 near-earth
+ * propagator state used to predict satellite positions for beam pointing.
+ * Positions come out in ECEF (Earth rotation from GMST, polar motion neglected),
+ * ready for the VN310 frame transforms.
+ *
+ * Only near-earth orbits (period under 225 minutes) are supported, which covers
+ * the LEO constellations the array tracks. GEO satellites are fixed in ECEF to well
+ * within a beamwidth and are better given as a position directly.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define VN310_ORBIT_NAME_SIZE           25
+#define VN310_ORBIT_TLE_LINE_LENGTH     69
+#define VN310_ORBIT_MAX_PERIOD_MIN      225.0   // Deep-space (SDP4) orbits beyond this are rejected
+
+struct vn310_orbit_t
+{
+    char name[VN310_ORBIT_NAME_SIZE];
+    uint32_t catalog_number;
+    double epoch_jd;            // Element epoch, UTC Julian date
+
+    // Mean elements at epoch, radians and radians per minute
+    double bstar;
+    double inclination;
+    double raan;
+    double eccentricity;
+    double argument_of_perigee;
+    double mean_anomaly;
+    double mean_motion;         // Un-Kozai'd
+
+    // SGP4 initialization, constant for the element set
+    bool simple;                // Perigee below 220 km, drag terms truncated
+    double semi_major_axis;     // Earth radii
+    double eta, cc1, cc4, cc5, d2, d3, d4;
+    double t2cof, t3cof, t4cof, t5cof;
+    double mdot, argpdot, nodedot, nodecf;
+    double omgcof, xmcof, delmo, sinmao;
+    double con41, x1mth2, x7thm1, xlcof, aycof;
+};
+
+STATUS vn310_orbit_parse_tle(const char *line1, const char *line2, const char *name, struct vn310_orbit_t *orbit);
+int vn310_orbit_parse_tles(const char *text, struct vn310_orbit_t *orbits, int max_orbits);
+double vn310_orbit_gmst(double jd_ut1);
+STATUS vn310_orbit_propagate_teme(const struct vn310_orbit_t *orbit, double minutes_since_epoch, double r_km[3], double v_kms[3]);
+STATUS vn310_orbit_propagate_ecef(const struct vn310_orbit_t *orbit, double jd, double position[3], double velocity[3]);
+int vn310_orbit_propagate_batch(const struct vn310_orbit_t *orbits, int count, double jd,
+                                double *x, double *y, double *z, double *vx, double *vy, double *vz, bool *valid);
@@ -12,7 +12,12 @@
 #pragma once
 
 #include <math.h>
-#include "vn310_app.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_attitude.h"
+
+struct vn310_applet_state_t;
 
 struct vn310_pose_t {
     float roll;
@@ -22,9 +27,39 @@ struct vn310_pose_t {
     float longitude;
     float altitude;
     float rate[3];
+    uint64_t time_gps;      // Sample time since the GPS epoch (ns), 0 if untimed
+    uint64_t time_gps_pps;  // Sample time since the last GPS PPS (ns), restarts every second
     uint16_t ins_status;
+    float quaternion[4];    // Body relative to NED, x, y, z, w. Feeds pointing; the angles are for display
+};
+
+/*
+ * Publishing policy. A sample is routed if it is the first, if the keyframe
+ * interval has elapsed since the last published pose, or if the minimum interval
+ * has elapsed and at least one value has moved by its dead-band or more. A zero
+ * configuration publishes every sample.
+ */
+struct vn310_pose_publish_config_t {
+    uint64_t min_interval_ns;       // 1 / max publish rate, 0 for no limit
+    uint64_t keyframe_interval_ns;  // Publish at least this often, 0 to disable
+    float deadband_deg[3];          // Roll, pitch, yaw
+    float deadband_position_deg;    // Latitude and longitude
+};
+
+struct vn310_pose_publisher_t {
+    struct vn310_pose_publish_config_t config;
+    struct vn310_pose_t last_sent;
+    uint64_t last_sent_ns;
+    bool has_sent;
+    uint32_t sent_count;
+    uint32_t keyframe_count;             // Sent because the keyframe interval elapsed
+    uint32_t forced_count;               // Sent from the CLI overrides
+    uint32_t suppressed_rate_count;      // Held back by the rate limit
+    uint32_t suppressed_deadband_count;  // Held back because nothing moved enough
 };
 
 float vn310_pose_wrap_0_to_360_degrees(float input);
+float vn310_pose_wrap_180_degrees(float input);
 float vn310_pose_radians_to_degrees(float input);
-void vn310_pose_send_updated(struct app_vn310_state_t *state, struct vn310_pose_t *vn310_pose, bool forced); 
\ No newline at end of file
+void vn310_pose_publisher_init(struct vn310_pose_publisher_t *publisher, const struct vn310_pose_publish_config_t *config);
+void vn310_pose_send_updated(struct vn310_applet_state_t *state, struct vn310_pose_t *vn310_pose, bool forced); 
\ No newline at end of file
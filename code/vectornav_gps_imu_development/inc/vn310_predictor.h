@@ -0,0 +1,45 @@
+/**
+ * @file vn310_predictor.h
+ * @brief Header file for VectorNav attitude prediction.
+ *
+ * This file defines the structures and functions used to propagate the last
+ * VN310 attitude sample forward to the beam actuation time using the measured
+ * body angular rates and the GPS sample time stamp.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "vn310_pose.h"
+
+#define VN310_PREDICTOR_MAX_EXTRAPOLATION_NS    50000000ULL     // 50 ms, ten samples at 200 Hz
+
+enum vn310_predictor_mode
+{
+    PREDICTOR_MODE_HOLD          = 0,  // Forward the last sample unchanged
+    PREDICTOR_MODE_CONSTANT_RATE = 1,  // Integrate Euler angle rates derived from the body rates
+    PREDICTOR_MODE_QUATERNION    = 2   // Integrate the body rates on the attitude quaternion
+};
+
+struct vn310_predictor_config_t
+{
+    enum vn310_predictor_mode mode;
+    uint64_t max_extrapolation_ns;
+};
+
+struct vn310_predictor_state_t
+{
+    struct vn310_predictor_config_t config;
+    struct vn310_pose_t last_pose;
+    bool pose_valid;
+    uint32_t clamped_count;
+    uint32_t rejected_count;
+};
+
+STATUS vn310_predictor_init(struct vn310_predictor_state_t *state, const struct vn310_predictor_config_t *config);
+STATUS vn310_predictor_update(struct vn310_predictor_state_t *state, const struct vn310_pose_t *pose);
+STATUS vn310_predictor_predict(struct vn310_predictor_state_t *state, uint64_t actuation_time_ns, struct vn310_pose_t *predicted_pose);
@@ -0,0 +1,81 @@
+/**
+ * @file vn310_trace.h
+ * @brief Header file for VN310 pipeline latency tracing.
+ *
+ * This file defines the trace points a sample passes on its way from the UART DMA
+ * callback to the pose message router, and a fixed-size ring of per-sample records
+ * timestamped with the cycle counter. The ring is written by the applet only: the
+ * two receive-side timestamps travel with the frame through the mailbox.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "vn310_mailbox.h"
+
+#define VN310_TRACE_DEPTH            256     // Records kept for the histograms
+
+#if defined(__arm__)
+#define VN310_TRACE_CYCLES_PER_US    480u    // STM32H7 Cortex-M7 core clock (MHz)
+#else
+#define VN310_TRACE_CYCLES_PER_US    1000u   // Host timestamps are nanoseconds
+#endif
+
+enum vn310_trace_point
+{
+    TRACE_POINT_DMA       = 0,   // UART DMA idle-line callback entered
+    TRACE_POINT_READY     = 1,   // Frame checked and committed to the mailbox
+    TRACE_POINT_PARSED    = 2,   // Frame parsed into the pose
+    TRACE_POINT_PUBLISHED = 3,   // Pose handed to message_routing_send_message_to
+    TRACE_POINT_COUNT     = 4
+};
+
+enum vn310_trace_stage
+{
+    TRACE_STAGE_RECEIVE = 0,     // DMA to ready
+    TRACE_STAGE_PARSE   = 1,     // Ready to parsed, including mailbox wait
+    TRACE_STAGE_PUBLISH = 2,     // Parsed to published
+    TRACE_STAGE_TOTAL   = 3,     // DMA to published
+    TRACE_STAGE_COUNT   = 4
+};
+
+struct vn310_trace_record_t
+{
+    uint32_t time[TRACE_POINT_COUNT];   // Cycle counter at each trace point
+    uint8_t points;                     // Bit mask of the points reached
+};
+
+struct vn310_trace_summary_t
+{
+    uint32_t count;
+    uint32_t min_ns;
+    uint32_t p50_ns;
+    uint32_t p99_ns;
+    uint32_t max_ns;
+};
+
+struct vn310_trace_t
+{
+    bool enabled;
+    struct vn310_trace_record_t records[VN310_TRACE_DEPTH];
+    uint32_t head;                      // Next record to write, free running
+    struct vn310_trace_record_t current;
+    bool active;
+    uint32_t traced_count;              // Frames traced
+    uint32_t parse_failed_count;        // Frames that never reached TRACE_POINT_PARSED
+    uint32_t unpublished_count;         // Parsed but held back by the publishing policy
+};
+
+STATUS vn310_trace_init(struct vn310_trace_t *trace);
+void vn310_trace_clear(struct vn310_trace_t *trace);
+uint32_t vn310_trace_now(void);
+void vn310_trace_begin(struct vn310_trace_t *trace, const struct vn310_frame_t *frame);
+void vn310_trace_mark(struct vn310_trace_t *trace, enum vn310_trace_point point);
+void vn310_trace_end(struct vn310_trace_t *trace);
+STATUS vn310_trace_summarize(const struct vn310_trace_t *trace, enum vn310_trace_stage stage, struct vn310_trace_summary_t *summary);
+const char *vn310_trace_stage_name(enum vn310_trace_stage stage);
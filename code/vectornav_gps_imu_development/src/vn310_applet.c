@@ -8,8 +8,43 @@
  * @author Nicholas Antoniades
  * @date 15 Jan 2024
  */
+#include <string.h>
 #include "vn310_applet.h"
 #include "vn310_driver.h"
+#include "bsp_delay.h"
+
+#define NS_PER_S 1000000000ULL
+
+/**
+ * @brief Initialize the VN310 driver and leave the sensor powered down.
+ *
+ * @param state The state of the vn310 app.
+ * @return OK if the driver was initialized.
+ */
+static STATUS _init_hardware(struct vn310_applet_state_t *state)
+{
+    if (state->config.power_enable.port)
+    {
+        bsp_gpio_write(&state->config.power_enable, 0);
+    }
+
+    if (state->config.ipc_shared != NULL)
+    {
+        state->config.driver_config.shared_mailbox = &state->config.ipc_shared->rings[MERGE_SOURCE_PRIMARY];
+        state->config.secondary_driver_config.shared_mailbox = &state->config.ipc_shared->rings[MERGE_SOURCE_SECONDARY];
+    }
+
+    RETURN_ON_ERROR(vn310_driver_init(&state->driver_state, &state->config.driver_config));
+    RETURN_ON_ERROR(vn310_driver_configure(&state->driver_state));
+
+    if (state->config.secondary_enabled)
+    {
+        RETURN_ON_ERROR(vn310_driver_init(&state->secondary_driver_state, &state->config.secondary_driver_config));
+        RETURN_ON_ERROR(vn310_driver_configure(&state->secondary_driver_state));
+    }
+
+    return OK;
+}
 
 /**
  * @brief Initialize the vn310 app.
@@ -22,67 +57,282 @@ STATUS vn310_applet_init(struct vn310_applet_state_t *state, struct vn310_applet
 {
     state->config = *config;
     memset(&state->pose_data, 0, sizeof(state->pose_data));
+    memset(state->source_pose, 0, sizeof(state->source_pose));
+    memset(&state->site, 0, sizeof(state->site));
+    vn310_merge_init(&state->merge, &state->config.merge_config);
+
+    struct vn310_predictor_config_t predictor_config = {
+        .mode = PREDICTOR_MODE_QUATERNION,
+        .max_extrapolation_ns = VN310_PREDICTOR_MAX_EXTRAPOLATION_NS,
+    };
+    RETURN_ON_ERROR(vn310_predictor_init(&state->predictor, &predictor_config));
+
+    vn310_pose_publisher_init(&state->publisher, &state->config.publish_config);
+    RETURN_ON_ERROR(vn310_trace_init(&state->trace));
+    RETURN_ON_ERROR(vn310_log_init(&state->log, state->config.log_write, state->config.log_context));
+    RETURN_ON_ERROR(vn310_console_init(&state->console));
+
     return OK;
 }
 
+/**
+ * @brief Get the driver of an input.
+ */
+static struct vn310_driver_state_t *_driver(struct vn310_applet_state_t *state, uint8_t source)
+{
+    return (source == MERGE_SOURCE_SECONDARY) ? &state->secondary_driver_state : &state->driver_state;
+}
+
+/**
+ * @brief Handle a single frame taken from a driver mailbox.
+ *
+ * @param state The state of the vn310 app.
+ * @param source The input the frame arrived on.
+ * @param frame The frame to parse. Owned by the applet until released.
+ */
+static void _handle_frame(struct vn310_applet_state_t *state, uint8_t source, struct vn310_frame_t *frame)
+{
+    struct vn310_driver_state_t *driver_state = _driver(state, source);
+    struct vn310_pose_t *pose = &state->source_pose[source];
+
+    vn310_log_frame(&state->log, source, frame, bsp_delay_get_tick_ms());
+
+    if (driver_state->response_expected || driver_state->uart_stream)
+    {
+        vn310_console_stream(&state->console, frame, driver_state->response_expected);
+        driver_state->response_expected = false;
+    }
+
+    if (frame->type == MSG_RESPONSE || frame->type == MSG_ERROR)
+    {
+        vn310_command_handle_response(&driver_state->commands, (const char *)frame->data);
+        return;
+    }
+
+    vn310_trace_begin(&state->trace, frame);
+
+    int valid_data = 0;
+    if (frame->type == MSG_ASYNC)
+    {
+        if (vn310_parser_handle_pose_message((const char *)frame->data, pose) == OK)
+        {
+            // ASCII messages carry no GPS time, do not reuse the last binary one
+            pose->time_gps = 0;
+            pose->time_gps_pps = 0;
+            pose->rate[0] = 0.0f;
+            pose->rate[1] = 0.0f;
+            pose->rate[2] = 0.0f;
+            vn310_attitude_quaternion_from_ypr(pose->yaw, pose->pitch, pose->roll, pose->quaternion);
+            valid_data = 1;
+        }
+    }
+    else if (frame->type == MSG_BINARY)
+    {
+        const struct vn310_driver_binout_config0_data_t *data = NULL;
+        if (vn310_driver_get_configuration_0_data(frame, &data) == OK)
+        {
+            pose->ins_status = data->ins_status.sol_status;
+            pose->time_gps = data->gps_time.time_gps;
+            pose->time_gps_pps = pose->time_gps % NS_PER_S;
+            pose->latitude = data->position.latitude;
+            pose->longitude = data->position.longitude;
+            pose->altitude = data->position.altitude;
+            pose->yaw = data->yaw_pitch_roll.yaw;
+            pose->pitch = data->yaw_pitch_roll.pitch;
+            pose->roll = data->yaw_pitch_roll.roll;
+            memcpy(pose->quaternion, data->quaternion.q, sizeof(pose->quaternion));
+            pose->rate[0] = vn310_pose_radians_to_degrees(data->angular_rate.rate[0]);
+            pose->rate[1] = vn310_pose_radians_to_degrees(data->angular_rate.rate[1]);
+            pose->rate[2] = vn310_pose_radians_to_degrees(data->angular_rate.rate[2]);
+            valid_data = 1;
+        }
+    }
+
+    if (!valid_data)
+    {
+        vn310_merge_failed(&state->merge, source);
+    }
+    else
+    {
+        vn310_trace_mark(&state->trace, TRACE_POINT_PARSED);
+    }
+
+    if (valid_data && vn310_merge_offer(&state->merge, source, pose->time_gps, bsp_delay_get_tick_ms()) == MERGE_PUBLISH)
+    {
+        state->pose_data = *pose;
+        vn310_predictor_update(&state->predictor, &state->pose_data);
+        vn310_pose_send_updated(state, &state->pose_data, false);
+    }
+
+    vn310_trace_end(&state->trace);
+}
+
 /**
  * @brief Run the vn310 app.
  *
- * This function handles message processing and pose updates.
+ * This function drains every frame queued by the UART callbacks since the last
+ * run, handling message processing and pose updates for each in order, then
+ * lets the command engines send queued commands and expire unanswered ones.
+ * Frames from the two inputs are interleaved by their DMA timestamp, so the
+ * merge sees them in the order they arrived.
  *
  * @param state The state of the vn310 app.
  * @return OK if the run was successful.
  */
 STATUS vn310_applet_run(struct vn310_applet_state_t *state)
 {
-    if (state->driver_state.vn310_message_ready)
+    while (true)
     {
-        if (state->driver_state.response_expected || state->driver_state.uart_stream)
-        {
-            vn310_driver_print_stream(&state->driver_state, state->config.cli_state);
-            state->driver_state.response_expected = false;
-        }
+        struct vn310_frame_t *primary = vn310_mailbox_peek(state->driver_state.mailbox);
+        struct vn310_frame_t *secondary = state->config.secondary_enabled ?
+                                          vn310_mailbox_peek(state->secondary_driver_state.mailbox) : NULL;
+        uint8_t source;
 
-        int valid_data = 0;
-        if (state->driver_state.assembled_message_type == MSG_ASYNC)
+        if (primary == NULL && secondary == NULL)
         {
-            if (vn310_parser_handle_pose_message((const char *)&state->driver_state.assembled_message, &state->pose_data) == OK)
-            {
-                state->pose_data.rate[0] = 0.0f;
-                state->pose_data.rate[1] = 0.0f;
-                state->pose_data.rate[2] = 0.0f;
-                valid_data = 1;
-            }
+            break;
         }
-        else if (state->driver_state.assembled_message_type == MSG_BINARY)
+        if (primary == NULL || (secondary != NULL && (int32_t)(secondary->time_dma - primary->time_dma) < 0))
         {
-            const struct driver_vn310_binout_config0_data_t *data = NULL;
-            if (vn310_driver_get_configuration_0_data(&state->driver_state, &data) == OK)
-            {
-                state->pose_data.ins_status = data->ins_status.sol_status;
-                state->pose_data.latitude = data->position.latitude;
-                state->pose_data.longitude = data->position.longitude;
-                state->pose_data.yaw = data->yaw_pitch_roll.yaw;
-                state->pose_data.pitch = data->yaw_pitch_roll.pitch;
-                state->pose_data.roll = data->yaw_pitch_roll.roll;
-                state->pose_data.rate[0] = vn310_pose_radians_to_degrees(data->angular_rate.rate[0]);
-                state->pose_data.rate[1] = vn310_pose_radians_to_degrees(data->angular_rate.rate[1]);
-                state->pose_data.rate[2] = vn310_pose_radians_to_degrees(data->angular_rate.rate[2]);
-                valid_data = 1;
-            }
+            source = MERGE_SOURCE_SECONDARY;
         }
-
-        if (valid_data)
+        else
         {
-            vn310_pose_send_updated(state, &state->pose_data, false);
+            source = MERGE_SOURCE_PRIMARY;
         }
 
-        state->driver_state.vn310_message_ready = false;
+        struct vn310_mailbox_t *mailbox = _driver(state, source)->mailbox;
+        _handle_frame(state, source, vn310_mailbox_peek(mailbox));
+        vn310_mailbox_release(mailbox);
+    }
+
+    uint32_t now_ms = bsp_delay_get_tick_ms();
+
+    if (state->config.secondary_enabled)
+    {
+        RETURN_ON_ERROR(vn310_driver_process(&state->secondary_driver_state, now_ms));
+    }
+
+    return vn310_driver_process(&state->driver_state, now_ms);
+}
+
+/**
+ * @brief Get the pose predicted for the actuation time.
+ *
+ * ASCII samples carry no angular rates, so for those the predictor holds the
+ * last attitude.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param pose The predicted pose.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_predicted_pose(struct vn310_applet_state_t *state, uint64_t actuation_time_ns, struct vn310_pose_t *pose)
+{
+    return vn310_predictor_predict(&state->predictor, actuation_time_ns, pose);
+}
+
+/**
+ * @brief Predict the pose and its body to NED rotation for the actuation time.
+ */
+static STATUS _predicted_dcm(struct vn310_applet_state_t *state, uint64_t actuation_time_ns,
+                             struct vn310_pose_t *pose, struct vn310_dcm_t *dcm)
+{
+    RETURN_ON_ERROR(vn310_predictor_predict(&state->predictor, actuation_time_ns, pose));
+
+    if (vn310_attitude_quaternion_valid(pose->quaternion))
+    {
+        vn310_attitude_quaternion_to_dcm(pose->quaternion, dcm);
+    }
+    else
+    {
+        vn310_attitude_ypr_to_dcm(pose->yaw, pose->pitch, pose->roll, dcm);
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Get antenna frame steering vectors at the actuation time.
+ *
+ * The rotation is built once from the predicted quaternion and applied to every
+ * line of sight, so the Euler angles are never on the pointing path.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param los_ned Unit lines of sight in NED.
+ * @param los_antenna Output unit lines of sight in the antenna frame.
+ * @param count Number of lines of sight.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_steering_vectors(struct vn310_applet_state_t *state, uint64_t actuation_time_ns,
+                                         const float los_ned[][3], float los_antenna[][3], int count)
+{
+    struct vn310_pose_t pose;
+    struct vn310_dcm_t dcm;
+
+    RETURN_ON_ERROR(_predicted_dcm(state, actuation_time_ns, &pose, &dcm));
+
+    for (int i = 0; i < count; i++)
+    {
+        vn310_attitude_steering_vector(&dcm, los_ned[i], los_antenna[i]);
     }
 
     return OK;
 }
 
+/**
+ * @brief Get antenna frame lines of sight to satellites at the actuation time.
+ *
+ * @param state The state of the vn310 app.
+ * @param actuation_time_ns The actuation time in GPS time (ns).
+ * @param x Satellite ECEF x (m).
+ * @param y Satellite ECEF y (m).
+ * @param z Satellite ECEF z (m).
+ * @param los_x Output antenna frame x of the unit lines of sight.
+ * @param los_y Output antenna frame y of the unit lines of sight.
+ * @param los_z Output antenna frame z of the unit lines of sight.
+ * @param range Output ranges (m).
+ * @param count Number of satellites.
+ * @return OK if a pose was available.
+ */
+STATUS vn310_applet_get_satellite_los(struct vn310_applet_state_t *state, uint64_t actuation_time_ns,
+                                      const double *x, const double *y, const double *z,
+                                      float *los_x, float *los_y, float *los_z, float *range, int count)
+{
+    struct vn310_pose_t pose;
+    struct vn310_dcm_t dcm;
+
+    RETURN_ON_ERROR(_predicted_dcm(state, actuation_time_ns, &pose, &dcm));
+
+    vn310_frames_site_update(&state->site, pose.latitude, pose.longitude, pose.altitude);
+    vn310_frames_ecef_to_body_los_batch(&state->site, &dcm, x, y, z, los_x, los_y, los_z, range, count);
+
+    return OK;
+}
+
+/**
+ * @brief Write buffered log blocks to storage.
+ *
+ * @param state The state of the vn310 app.
+ * @return Number of blocks written.
+ */
+uint32_t vn310_applet_log_task(struct vn310_applet_state_t *state)
+{
+    return vn310_log_flush(&state->log);
+}
+
+/**
+ * @brief Print streamed frames to the CLI.
+ *
+ * @param state The state of the vn310 app.
+ * @return Number of lines printed.
+ */
+uint32_t vn310_applet_console_task(struct vn310_applet_state_t *state)
+{
+    return vn310_console_drain(&state->console, state->config.cli_state, VN310_CONSOLE_DRAIN_LINES);
+}
+
 /**
  * @brief Start the vn310 app.
  *
@@ -95,7 +345,7 @@ STATUS vn310_applet_start(struct vn310_applet_state_t *state)
 {
     vn310_cli_init(state, state->config.cli_state);
 
-    _init_hardware(struct vn310_applet_state_t *state);
+    RETURN_ON_ERROR(_init_hardware(state));
 
     return OK;
 } 
\ No newline at end of file
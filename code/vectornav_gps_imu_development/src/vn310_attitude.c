@@ -0,0 +1,222 @@
+/**
+ * @file vn310_attitude.c
+ * @brief Implementation of VN310 attitude conversions and steering vectors.
+ *
+ * The quaternion reported by the VN310 is carried with every pose, so beam pointing
+ * builds its rotation matrix straight from it: a handful of multiplies and one
+ * divide, no trigonometry, and no singularity at +/-90 degrees pitch. The yaw,
+ * pitch, roll path is kept for ASCII samples, which carry no quaternion, and as the
+ * reference the host benchmark compares against.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <math.h>
+#include "vn310_attitude.h"
+
+#define DEG_TO_RAD_F                ((float)M_PI / 180.0f)
+#define RAD_TO_DEG_F                (180.0f / (float)M_PI)
+#define DEG_TO_RAD                  (M_PI / 180.0)
+#define RAD_TO_DEG                  (180.0 / M_PI)
+#define QUATERNION_NORM_TOLERANCE   0.01f    // On the squared norm, well above float rounding
+
+/**
+ * @brief Convert a yaw, pitch, roll (3-2-1) attitude in degrees to a quaternion.
+ *
+ * @param yaw Yaw in degrees.
+ * @param pitch Pitch in degrees.
+ * @param roll Roll in degrees.
+ * @param q Output quaternion, x, y, z, w.
+ */
+void vn310_attitude_quaternion_from_ypr(float yaw, float pitch, float roll, float q[4])
+{
+    float cy = cosf(yaw * DEG_TO_RAD_F * 0.5f);
+    float sy = sinf(yaw * DEG_TO_RAD_F * 0.5f);
+    float cp = cosf(pitch * DEG_TO_RAD_F * 0.5f);
+    float sp = sinf(pitch * DEG_TO_RAD_F * 0.5f);
+    float cr = cosf(roll * DEG_TO_RAD_F * 0.5f);
+    float sr = sinf(roll * DEG_TO_RAD_F * 0.5f);
+
+    q[QUATERNION_X] = sr * cp * cy - cr * sp * sy;
+    q[QUATERNION_Y] = cr * sp * cy + sr * cp * sy;
+    q[QUATERNION_Z] = cr * cp * sy - sr * sp * cy;
+    q[QUATERNION_W] = cr * cp * cy + sr * sp * sy;
+}
+
+/**
+ * @brief Convert a quaternion to a yaw, pitch, roll (3-2-1) attitude in degrees.
+ *
+ * Close to +/-90 degrees pitch yaw and roll are no longer separable and the pitch
+ * loses precision, which is why pointing does not go through this function.
+ *
+ * @param q The quaternion, x, y, z, w.
+ * @param yaw Output yaw in degrees, (-180, 180].
+ * @param pitch Output pitch in degrees.
+ * @param roll Output roll in degrees.
+ */
+void vn310_attitude_quaternion_to_ypr(const float q[4], float *yaw, float *pitch, float *roll)
+{
+    float x = q[QUATERNION_X], y = q[QUATERNION_Y], z = q[QUATERNION_Z], w = q[QUATERNION_W];
+    float sin_pitch = 2.0f * (w * y - z * x);
+
+    if (sin_pitch > 1.0f)
+    {
+        sin_pitch = 1.0f;
+    }
+    else if (sin_pitch < -1.0f)
+    {
+        sin_pitch = -1.0f;
+    }
+
+    *roll = atan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)) * RAD_TO_DEG_F;
+    *pitch = asinf(sin_pitch) * RAD_TO_DEG_F;
+    *yaw = atan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)) * RAD_TO_DEG_F;
+}
+
+/**
+ * @brief Double precision vn310_attitude_quaternion_from_ypr, for integrating the attitude.
+ */
+void vn310_attitude_quaternion_from_ypr_double(double yaw, double pitch, double roll, double q[4])
+{
+    double cy = cos(yaw * DEG_TO_RAD * 0.5);
+    double sy = sin(yaw * DEG_TO_RAD * 0.5);
+    double cp = cos(pitch * DEG_TO_RAD * 0.5);
+    double sp = sin(pitch * DEG_TO_RAD * 0.5);
+    double cr = cos(roll * DEG_TO_RAD * 0.5);
+    double sr = sin(roll * DEG_TO_RAD * 0.5);
+
+    q[QUATERNION_X] = sr * cp * cy - cr * sp * sy;
+    q[QUATERNION_Y] = cr * sp * cy + sr * cp * sy;
+    q[QUATERNION_Z] = cr * cp * sy - sr * sp * cy;
+    q[QUATERNION_W] = cr * cp * cy + sr * sp * sy;
+}
+
+/**
+ * @brief Double precision vn310_attitude_quaternion_to_ypr.
+ */
+void vn310_attitude_quaternion_to_ypr_double(const double q[4], double *yaw, double *pitch, double *roll)
+{
+    double x = q[QUATERNION_X], y = q[QUATERNION_Y], z = q[QUATERNION_Z], w = q[QUATERNION_W];
+    double sin_pitch = 2.0 * (w * y - z * x);
+
+    if (sin_pitch > 1.0)
+    {
+        sin_pitch = 1.0;
+    }
+    else if (sin_pitch < -1.0)
+    {
+        sin_pitch = -1.0;
+    }
+
+    *roll = atan2(2.0 * (w * x + y * z), 1.0 - 2.0 * (x * x + y * y)) * RAD_TO_DEG;
+    *pitch = asin(sin_pitch) * RAD_TO_DEG;
+    *yaw = atan2(2.0 * (w * z + x * y), 1.0 - 2.0 * (y * y + z * z)) * RAD_TO_DEG;
+}
+
+/**
+ * @brief Check that a quaternion holds an attitude.
+ *
+ * Poses built before the quaternion was carried, or by hand, leave it zeroed.
+ *
+ * @param q The quaternion, x, y, z, w.
+ * @return true if the quaternion has unit norm.
+ */
+bool vn310_attitude_quaternion_valid(const float q[4])
+{
+    float norm_sq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+
+    return fabsf(norm_sq - 1.0f) < QUATERNION_NORM_TOLERANCE;
+}
+
+/**
+ * @brief Build the body to NED rotation matrix from a quaternion.
+ *
+ * Scaling by 2 / |q|^2 keeps the matrix a rotation for a quaternion that is only
+ * approximately unit, without the square root of a normalisation.
+ *
+ * @param q The quaternion, x, y, z, w.
+ * @param dcm Output rotation matrix.
+ */
+void vn310_attitude_quaternion_to_dcm(const float q[4], struct vn310_dcm_t *dcm)
+{
+    float x = q[QUATERNION_X], y = q[QUATERNION_Y], z = q[QUATERNION_Z], w = q[QUATERNION_W];
+    float s = 2.0f / (x * x + y * y + z * z + w * w);
+    float xs = x * s, ys = y * s, zs = z * s;
+    float wx = w * xs, wy = w * ys, wz = w * zs;
+    float xx = x * xs, xy = x * ys, xz = x * zs;
+    float yy = y * ys, yz = y * zs, zz = z * zs;
+
+    dcm->m[0][0] = 1.0f - (yy + zz);
+    dcm->m[0][1] = xy - wz;
+    dcm->m[0][2] = xz + wy;
+    dcm->m[1][0] = xy + wz;
+    dcm->m[1][1] = 1.0f - (xx + zz);
+    dcm->m[1][2] = yz - wx;
+    dcm->m[2][0] = xz - wy;
+    dcm->m[2][1] = yz + wx;
+    dcm->m[2][2] = 1.0f - (xx + yy);
+}
+
+/**
+ * @brief Build the body to NED rotation matrix from yaw, pitch, roll (3-2-1).
+ *
+ * @param yaw Yaw in degrees.
+ * @param pitch Pitch in degrees.
+ * @param roll Roll in degrees.
+ * @param dcm Output rotation matrix.
+ */
+void vn310_attitude_ypr_to_dcm(float yaw, float pitch, float roll, struct vn310_dcm_t *dcm)
+{
+    float cy = cosf(yaw * DEG_TO_RAD_F);
+    float sy = sinf(yaw * DEG_TO_RAD_F);
+    float cp = cosf(pitch * DEG_TO_RAD_F);
+    float sp = sinf(pitch * DEG_TO_RAD_F);
+    float cr = cosf(roll * DEG_TO_RAD_F);
+    float sr = sinf(roll * DEG_TO_RAD_F);
+
+    dcm->m[0][0] = cp * cy;
+    dcm->m[0][1] = sr * sp * cy - cr * sy;
+    dcm->m[0][2] = cr * sp * cy + sr * sy;
+    dcm->m[1][0] = cp * sy;
+    dcm->m[1][1] = sr * sp * sy + cr * cy;
+    dcm->m[1][2] = cr * sp * sy - sr * cy;
+    dcm->m[2][0] = -sp;
+    dcm->m[2][1] = sr * cp;
+    dcm->m[2][2] = cr * cp;
+}
+
+/**
+ * @brief Unit line of sight in NED from an azimuth and elevation.
+ *
+ * @param azimuth Azimuth in degrees, clockwise from north.
+ * @param elevation Elevation in degrees above the horizon.
+ * @param los_ned Output unit vector, north, east, down.
+ */
+void vn310_attitude_los_from_az_el(float azimuth, float elevation, float los_ned[3])
+{
+    float cos_el = cosf(elevation * DEG_TO_RAD_F);
+
+    los_ned[0] = cos_el * cosf(azimuth * DEG_TO_RAD_F);
+    los_ned[1] = cos_el * sinf(azimuth * DEG_TO_RAD_F);
+    los_ned[2] = -sinf(elevation * DEG_TO_RAD_F);
+}
+
+/**
+ * @brief Rotate a NED line of sight into the antenna frame.
+ *
+ * The result is the steering direction handed to the beamformer; its x and y
+ * components are the direction cosines across the array face.
+ *
+ * @param dcm Body to NED rotation matrix.
+ * @param los_ned Unit line of sight in NED.
+ * @param los_antenna Output unit line of sight in the antenna frame.
+ */
+void vn310_attitude_steering_vector(const struct vn310_dcm_t *dcm, const float los_ned[3], float los_antenna[3])
+{
+    // v_body = m^T * v_ned
+    for (int i = 0; i < 3; i++)
+    {
+        los_antenna[i] = dcm->m[0][i] * los_ned[0] + dcm->m[1][i] * los_ned[1] + dcm->m[2][i] * los_ned[2];
+    }
+}
@@ -9,32 +9,39 @@
  * @date 15 Jan 2024
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include "vn310_cli.h"
+#include "vn310_applet.h"
 #include "vn310_pose.h"
-#include "driver_vn310.h"
+#include "vn310_driver.h"
 #include "bsp_delay.h"
 
+static void _rate_negotiated(void *context, STATUS status, unsigned int baud_rate)
+{
+    struct cli_state_t *cli_state = context;
+
+    if (status == OK)
+    {
+        cli_printf(cli_state, "VN310 link verified at %u baud\r\n", baud_rate);
+    }
+    else
+    {
+        cli_printf(cli_state, "VN310 rate negotiation failed, link at %u baud\r\n", baud_rate);
+    }
+}
+
 static STATUS vn310_set_output(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct app_vn310_state_t *app_state = context;
-    struct driver_vn310_state_t *state = &app_state->driver_state;
+    struct vn310_applet_state_t *app_state = context;
+    struct vn310_driver_state_t *state = &app_state->driver_state;
 
     if (strcmp(argv[2], "freq") == 0)
     {
         int freq = atoi(argv[3]);
-        if (freq == 1   ||
-            freq == 2  ||
-            freq == 4  ||
-            freq == 5  ||
-            freq == 10 ||
-            freq == 20 ||
-            freq == 25 ||
-            freq == 40 ||
-            freq == 50||
-            freq == 100 ||
-            freq == 200)
+        if (freq > 0 && vn310_link_ascii_rate_valid((uint32_t)freq))
         {
-            driver_vn310_set_output_data_freq(state, (uint8_t)freq);
+            vn310_driver_set_output_data_freq(state, (uint8_t)freq, NULL, NULL);
             return OK;
         }
         else
@@ -42,9 +49,24 @@ static STATUS vn310_set_output(struct cli_state_t *cli_state, void *context, int
             cli_printf_line(cli_state, "Usage: vn310 output freq <1/ 2/ 4/ 5/ 10/ 20/ 25/ 40/ 50/ 100/ 200>");
         }
     }
+    if (strcmp(argv[2], "rate") == 0)
+    {
+        int binary_hz = (argc > 3) ? atoi(argv[3]) : 0;
+        int ascii_hz = (argc > 4) ? atoi(argv[4]) : 0;
+
+        if (binary_hz <= 0 || ascii_hz < 0 ||
+            vn310_link_negotiate(state, (uint32_t)binary_hz, (uint32_t)ascii_hz, _rate_negotiated, cli_state) != OK)
+        {
+            cli_printf_line(cli_state, "Usage: vn310 output rate <binary_hz (800/n)> [ascii_hz], at most 921600 baud");
+            return ERROR;
+        }
+        cli_printf(cli_state, "Negotiating %u B/s at %u baud\r\n",
+                   (unsigned int)state->link.required_bytes_per_s, state->link.target_baud);
+        return OK;
+    }
     if(strcmp(argv[2], "pause") == 0)
     {
-        driver_vn310_output_pause(state);
+        vn310_driver_output_pause(state);
         return OK;
     }
     if (strcmp(argv[2], "enable") == 0)
@@ -56,7 +78,7 @@ static STATUS vn310_set_output(struct cli_state_t *cli_state, void *context, int
             bsp_gpio_write(&app_state->config.sec_r_en_l, 0);
             bsp_gpio_write(&app_state->config.sec_d_en, 1);
         }
-        driver_vn310_output_enable_port_1(state);
+        vn310_driver_output_enable_port_1(state);
         return OK;
     }
     else if (strcmp(argv[2], "disable") == 0)
@@ -72,7 +94,7 @@ static STATUS vn310_set_output(struct cli_state_t *cli_state, void *context, int
     }
     if(strcmp(argv[2], "async") == 0)
     {
-        driver_vn310_set_asynchronous_output(state, argv[3]);
+        vn310_driver_set_asynchronous_output(state, argv[3]);
         return OK;
     }
 
@@ -81,11 +103,29 @@ static STATUS vn310_set_output(struct cli_state_t *cli_state, void *context, int
 
 static STATUS vn310_cli_stream(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct driver_vn310_state_t *state = context;
+    struct vn310_applet_state_t *applet = context;
+    struct vn310_driver_state_t *state = &applet->driver_state;
+
+    if (argc < 4)
+    {
+        if (argc > 2 && strcmp(argv[2], "pose_stream") == 0)
+        {
+            cli_printf_line(cli_state, "Usage: vn310 cli pose_stream <start|stop>");
+        }
+        else
+        {
+            cli_printf_line(cli_state, "Usage: vn310 cli stream <start [every_n] [text|hex]|stop|single|stats>");
+        }
+        return ERROR;
+    }
+
     if(strcmp(argv[2], "stream") == 0)
     {
         if(strcmp(argv[3], "start") == 0)
         {
+            uint32_t decimation = (argc > 4) ? (uint32_t)strtoul(argv[4], NULL, 10) : 1;
+            enum vn310_console_mode mode = (argc > 5 && strcmp(argv[5], "hex") == 0) ? CONSOLE_MODE_HEX : CONSOLE_MODE_TEXT;
+            vn310_console_configure(&applet->console, decimation, mode);
             state->uart_stream = true;
             state->response_expected = false;
             return OK;
@@ -102,6 +142,13 @@ static STATUS vn310_cli_stream(struct cli_state_t *cli_state, void *context, int
             state->response_expected = true;
             return OK;
         }
+        if(strcmp(argv[3], "stats") == 0)
+        {
+            cli_printf(cli_state, "queued %u printed %u dropped %u decimated %u\r\n",
+                       (unsigned)applet->console.queued_count, (unsigned)applet->console.printed_count,
+                       (unsigned)applet->console.dropped_count, (unsigned)applet->console.decimated_count);
+            return OK;
+        }
     }
 
     if (strcmp(argv[2], "pose_stream") == 0)
@@ -123,43 +170,33 @@ static STATUS vn310_cli_stream(struct cli_state_t *cli_state, void *context, int
     return ERROR;
 }
 
+static void _configure_complete(void *context, uint8_t failed_count)
+{
+    struct cli_state_t *cli_state = context;
+
+    if (failed_count == 0)
+    {
+        cli_printf(cli_state, "VN310 configured\r\n");
+    }
+    else
+    {
+        cli_printf(cli_state, "VN310 configuration: %u commands failed\r\n", failed_count);
+    }
+}
+
 static STATUS vn310_settings(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct driver_vn310_state_t *state = context;
+    struct vn310_driver_state_t *state = context;
 
     if (strcmp(argv[2], "write") == 0)
     {
-        return driver_vn310_write_settings(state);
+        return vn310_driver_write_settings(state);
     }
     if (strcmp(argv[2], "config") == 0)
     {
         if (strcmp(argv[3], "0") == 0)
         {
-            bsp_delay_ms(2);
-            if (driver_vn310_set_asynchronous_output(state, "0") != OK)
-            {
-                return ERROR;
-            }
-
-            bsp_delay_ms(4);
-            if (driver_vn310_set_vn310_baud_rate(state, 115200) != OK)
-            {
-                return ERROR;
-            }
-
-            bsp_delay_ms(4);
-            if (driver_vn310_set_uart_baud_rate(state, 115200) != OK)
-            {
-                return ERROR;
-            }
-
-            bsp_delay_ms(4);
-            if (driver_vn310_set_configuration_0(state) != OK)
-            {
-                return ERROR;
-            }
-
-            return OK;
+            return vn310_driver_configure_sensor(state, _configure_complete, cli_state);
         }
     }
     if (strcmp(argv[2], "device") == 0)
@@ -168,21 +205,14 @@ static STATUS vn310_settings(struct cli_state_t *cli_state, void *context, int a
         {
             int baud_rate = atoi(argv[4]);
 
-            if (baud_rate == 9600   ||
-                baud_rate == 19200  ||
-                baud_rate == 38400  ||
-                baud_rate == 57600  ||
-                baud_rate == 115200 ||
-                baud_rate == 128000 ||
-                baud_rate == 230400 ||
-                baud_rate == 460800)
+            if (baud_rate > 0 && vn310_link_baud_supported((unsigned int)baud_rate))
             {
-                return driver_vn310_set_vn310_baud_rate(state, baud_rate);
+                return vn310_driver_set_vectoranv_baud_rate(state, baud_rate);
             }
         }
         if (strcmp(argv[3], "reset") == 0)
         {
-            return driver_vn310_reset_device(state);
+            return vn310_driver_reset_device(state);
         }
     }
     if (strcmp(argv[2], "uart") == 0)
@@ -191,16 +221,9 @@ static STATUS vn310_settings(struct cli_state_t *cli_state, void *context, int a
         {
             int baud_rate = atoi(argv[4]);
 
-            if (baud_rate == 9600   ||
-                baud_rate == 19200  ||
-                baud_rate == 38400  ||
-                baud_rate == 57600  ||
-                baud_rate == 115200 ||
-                baud_rate == 128000 ||
-                baud_rate == 230400 ||
-                baud_rate == 460800)
+            if (baud_rate > 0 && vn310_link_baud_supported((unsigned int)baud_rate))
             {
-                return driver_vn310_set_uart_baud_rate(state, baud_rate);
+                return vn310_driver_set_uart_baud_rate(state, baud_rate);
             }
         }
     }
@@ -208,27 +231,37 @@ static STATUS vn310_settings(struct cli_state_t *cli_state, void *context, int a
     {
         if (strcmp(argv[3], "reset") == 0)
         {
-            return driver_vn310_factory_settings(state);
+            return vn310_driver_factory_settings(state);
         }
     }
     if (strcmp(argv[2], "set") == 0)
     {
         if (strcmp(argv[3], "ant") == 0)
         {
+            if (argc != 8 && !(argc == 11 && strcmp(argv[4], "b") == 0))
+            {
+                cli_printf_line(cli_state, "Usage: vn310 settings set ant <a|b> <x> <y> <z> [x_uncert y_uncert z_uncert (b only)]");
+                return ERROR;
+            }
+
             double x_pos = strtod(argv[5], NULL);
             double y_pos = strtod(argv[6], NULL);
             double z_pos = strtod(argv[7], NULL);
 
             if(strcmp(argv[4], "a") == 0)
             {
-                return driver_vn310_set_antenna_a(state, x_pos, y_pos, z_pos);
+                return vn310_driver_set_antenna_a(state, x_pos, y_pos, z_pos);
+            }
+            else if(strcmp(argv[4], "b") == 0 && argc == 8)
+            {
+                return vn310_driver_set_antenna_b(state, x_pos, y_pos, z_pos);
             }
             else if(strcmp(argv[4], "b") == 0)
             {
                 double x_uncert = strtod(argv[8], NULL);
                 double y_uncert = strtod(argv[9], NULL);
                 double z_uncert = strtod(argv[10], NULL);
-                return driver_vn310_set_antenna_baseline(state, x_pos, y_pos, z_pos, x_uncert, y_uncert, z_uncert);
+                return vn310_driver_set_antenna_baseline(state, x_pos, y_pos, z_pos, x_uncert, y_uncert, z_uncert);
             }
         }
     }
@@ -238,27 +271,27 @@ static STATUS vn310_settings(struct cli_state_t *cli_state, void *context, int a
 
 static STATUS vn310_read(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct driver_vn310_state_t *state = context;
+    struct vn310_driver_state_t *state = context;
 
     if(strcmp(argv[2], "model_number") == 0)
     {
         state->response_expected = true;
-        return driver_vn310_read_model_number(state);
+        return vn310_driver_read_model_number(state);
     }
     if(strcmp(argv[2], "hardware_revision") == 0)
     {
         state->response_expected = true;
-        return driver_vn310_read_hardware_revision(state);
+        return vn310_driver_read_hardware_revision(state);
     }
     if(strcmp(argv[2], "serial_number") == 0)
     {
         state->response_expected = true;
-        return driver_vn310_read_serial_number(state);
+        return vn310_driver_read_serial_number(state);
     }
     if(strcmp(argv[2], "firmware_version") == 0)
     {
         state->response_expected = true;
-        return driver_vn310_read_firmware_version(state);
+        return vn310_driver_read_firmware_version(state);
     }
 
     return ERROR;
@@ -266,7 +299,7 @@ static STATUS vn310_read(struct cli_state_t *cli_state, void *context, int argc,
 
 static STATUS vn310_register(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct driver_vn310_state_t *state = context;
+    struct vn310_driver_state_t *state = context;
 
     if (strcmp(argv[2], "read") == 0)
     {
@@ -277,7 +310,7 @@ static STATUS vn310_register(struct cli_state_t *cli_state, void *context, int a
         }
         state->response_expected = true;
         int register_id = atoi(argv[3]);
-        return driver_vn310_read_register(state, register_id);
+        return vn310_driver_read_register(state, register_id);
     }
     if (strcmp(argv[2], "write") == 0)
     {
@@ -287,12 +320,7 @@ static STATUS vn310_register(struct cli_state_t *cli_state, void *context, int a
             return ERROR;
         }
         int register_id = atoi(argv[3]);
-        uint8_t data[argc - 4];
-        for (int i = 0; i < argc - 4; ++i)
-        {
-            data[i] = atoi(argv[i + 4]);
-        }
-        return driver_vn310_write_register(state, register_id, data, argc - 4);
+        return vn310_driver_write_register(state, register_id, &argv[4], argc - 4);
     }
 
     return ERROR;
@@ -300,7 +328,7 @@ static STATUS vn310_register(struct cli_state_t *cli_state, void *context, int a
 
 static STATUS vn310_power(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct app_vn310_state_t *state = context;
+    struct vn310_applet_state_t *state = context;
 
     if (argc != 3)
         return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
@@ -325,7 +353,7 @@ static STATUS vn310_power(struct cli_state_t *cli_state, void *context, int argc
 
 static STATUS vn310_override(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct app_vn310_state_t *state = context;
+    struct vn310_applet_state_t *state = context;
 
     if (strcmp(argv[2], "pose") == 0)
     {
@@ -339,6 +367,7 @@ static STATUS vn310_override(struct cli_state_t *cli_state, void *context, int a
         state->pose_data.yaw = yaw;
         state->pose_data.pitch = pitch;
         state->pose_data.roll = roll;
+        vn310_attitude_quaternion_from_ypr(yaw, pitch, roll, state->pose_data.quaternion);
 
         cli_printf(cli_state, "Yaw: %0.3f Pitch: %0.3f Roll: %0.3f\n", 
                   state->pose_data.yaw, state->pose_data.pitch, state->pose_data.roll);
@@ -368,7 +397,7 @@ static STATUS vn310_override(struct cli_state_t *cli_state, void *context, int a
 
 static STATUS vn310_feed(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct app_vn310_state_t *state = context;
+    struct vn310_applet_state_t *state = context;
 
     if (strcmp(argv[2], "on") == 0)
     {
@@ -378,6 +407,33 @@ static STATUS vn310_feed(struct cli_state_t *cli_state, void *context, int argc,
     {
         state->driver_state.send_pose = false;
     }
+    else if (strcmp(argv[2], "policy") == 0)
+    {
+        if (argc != 6)
+            return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+
+        double max_rate_hz = strtod(argv[3], NULL);
+        float deadband_deg = strtof(argv[4], NULL);
+        long keyframe_ms = strtol(argv[5], NULL, 10);
+
+        struct vn310_pose_publish_config_t config = {
+            .min_interval_ns = (max_rate_hz > 0.0) ? (uint64_t)(1.0e9 / max_rate_hz) : 0,
+            .keyframe_interval_ns = (keyframe_ms > 0) ? (uint64_t)keyframe_ms * 1000000ULL : 0,
+            .deadband_deg = { deadband_deg, deadband_deg, deadband_deg },
+            .deadband_position_deg = state->publisher.config.deadband_position_deg,
+        };
+        vn310_pose_publisher_init(&state->publisher, &config);
+    }
+    else if (strcmp(argv[2], "stats") == 0)
+    {
+        const struct vn310_pose_publisher_t *publisher = &state->publisher;
+
+        cli_printf(cli_state, "Sent: %lu (keyframes %lu, forced %lu)\n",
+                  (unsigned long)publisher->sent_count, (unsigned long)publisher->keyframe_count,
+                  (unsigned long)publisher->forced_count);
+        cli_printf(cli_state, "Suppressed: rate %lu, dead-band %lu\n",
+                  (unsigned long)publisher->suppressed_rate_count, (unsigned long)publisher->suppressed_deadband_count);
+    }
     else
     {
         return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
@@ -387,7 +443,7 @@ static STATUS vn310_feed(struct cli_state_t *cli_state, void *context, int argc,
 
 static STATUS vn310_set(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct driver_vn310_state_t *state = context;
+    struct vn310_driver_state_t *state = context;
 
     if (strcmp(argv[2], "heading") == 0)
     {
@@ -395,7 +451,7 @@ static STATUS vn310_set(struct cli_state_t *cli_state, void *context, int argc,
             return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
 
         double heading = strtod(argv[3], NULL);
-        return driver_vn310_set_initial_heading(state, heading);
+        return vn310_driver_set_initial_heading(state, heading);
     }
     else
     {
@@ -403,6 +459,125 @@ static STATUS vn310_set(struct cli_state_t *cli_state, void *context, int argc,
     }
 }
 
+static STATUS vn310_trace(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
+{
+    struct vn310_applet_state_t *state = context;
+    struct vn310_trace_t *trace = &state->trace;
+
+    if (argc != 3)
+        return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+
+    if (strcmp(argv[2], "on") == 0)
+    {
+        trace->enabled = true;
+    }
+    else if (strcmp(argv[2], "off") == 0)
+    {
+        trace->enabled = false;
+    }
+    else if (strcmp(argv[2], "clear") == 0)
+    {
+        vn310_trace_clear(trace);
+    }
+    else if (strcmp(argv[2], "dump") == 0)
+    {
+        cli_printf(cli_state, "%-8s %6s %9s %9s %9s %9s (us)\n", "stage", "count", "min", "p50", "p99", "max");
+        for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+        {
+            struct vn310_trace_summary_t summary;
+            vn310_trace_summarize(trace, stage, &summary);
+            cli_printf(cli_state, "%-8s %6lu %9.1f %9.1f %9.1f %9.1f\n", vn310_trace_stage_name(stage),
+                      (unsigned long)summary.count, summary.min_ns / 1000.0f, summary.p50_ns / 1000.0f,
+                      summary.p99_ns / 1000.0f, summary.max_ns / 1000.0f);
+        }
+        cli_printf(cli_state, "Traced: %lu, parse failed: %lu, unpublished: %lu, mailbox overruns: %lu\n",
+                  (unsigned long)trace->traced_count, (unsigned long)trace->parse_failed_count,
+                  (unsigned long)trace->unpublished_count, (unsigned long)state->driver_state.mailbox->overrun_count);
+    }
+    else
+    {
+        return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+    }
+    return CLI_COMMAND_RETURN_CODE_OK;
+}
+
+static STATUS vn310_merge(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
+{
+    struct vn310_applet_state_t *state = context;
+    struct vn310_merge_t *merge = &state->merge;
+    static const char *source_names[VN310_MERGE_MAX_SOURCES] = { "primary", "secondary" };
+
+    if (argc == 5 && strcmp(argv[2], "window") == 0)
+    {
+        struct vn310_merge_config_t config = {
+            .epoch_window_ns = (uint64_t)strtoul(argv[3], NULL, 10) * 1000ULL,
+            .failover_ms = (uint32_t)strtoul(argv[4], NULL, 10),
+        };
+        vn310_merge_init(merge, &config);
+    }
+    else if (argc == 3 && strcmp(argv[2], "stats") == 0)
+    {
+        uint32_t now_ms = bsp_delay_get_tick_ms();
+
+        for (uint8_t source = 0; source < VN310_MERGE_MAX_SOURCES; source++)
+        {
+            const struct vn310_merge_source_stats_t *stats = &merge->sources[source];
+            cli_printf(cli_state, "%-9s %s: published %lu, duplicate %lu, stale %lu, standby %lu, failed %lu\n",
+                      source_names[source], vn310_merge_source_alive(merge, source, now_ms) ? "up  " : "down",
+                      (unsigned long)stats->published_count, (unsigned long)stats->duplicate_count,
+                      (unsigned long)stats->stale_count, (unsigned long)stats->inactive_count,
+                      (unsigned long)stats->failed_count);
+        }
+        cli_printf(cli_state, "Active: %s, failovers: %lu\n",
+                  source_names[merge->active_source], (unsigned long)merge->failover_count);
+    }
+    else
+    {
+        return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+    }
+    return CLI_COMMAND_RETURN_CODE_OK;
+}
+
+static STATUS vn310_log(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
+{
+    struct vn310_applet_state_t *state = context;
+    struct vn310_log_t *log = &state->log;
+
+    if (argc != 3)
+        return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+
+    if (strcmp(argv[2], "on") == 0)
+    {
+        if (log->write == NULL)
+        {
+            cli_printf(cli_state, "No log storage configured\n");
+            return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+        }
+        log->enabled = true;
+    }
+    else if (strcmp(argv[2], "off") == 0)
+    {
+        vn310_log_sync(log);
+        log->enabled = false;
+    }
+    else if (strcmp(argv[2], "sync") == 0)
+    {
+        vn310_log_sync(log);
+    }
+    else if (strcmp(argv[2], "stats") == 0)
+    {
+        cli_printf(cli_state, "Records: %lu, dropped: %lu, blocks stored: %lu, write errors: %lu, pending: %lu\n",
+                  (unsigned long)log->record_count, (unsigned long)log->dropped_count,
+                  (unsigned long)log->block_count, (unsigned long)log->write_error_count,
+                  (unsigned long)(log->head - log->tail));
+    }
+    else
+    {
+        return CLI_COMMAND_RETURN_CODE_INVALID_PARMS;
+    }
+    return CLI_COMMAND_RETURN_CODE_OK;
+}
+
 static void print_help(struct cli_state_t *cli_state)
 {
     cli_printf_line(cli_state, "");
@@ -419,7 +594,7 @@ static void print_help(struct cli_state_t *cli_state)
 
 static STATUS cli_vn310(struct cli_state_t *cli_state, void *context, int argc, char const *argv[])
 {
-    struct app_vn310_state_t *state = (struct app_vn310_state_t *)context;
+    struct vn310_applet_state_t *state = (struct vn310_applet_state_t *)context;
 
     if (argc < 2)
     {
@@ -433,7 +608,7 @@ static STATUS cli_vn310(struct cli_state_t *cli_state, void *context, int argc,
     }
     if (strcmp(argv[1], "cli") == 0)
     {
-        return vn310_cli_stream(cli_state, &state->driver_state, argc, argv);
+        return vn310_cli_stream(cli_state, context, argc, argv);
     }
     if (strcmp(argv[1], "output") == 0)
     {
@@ -467,11 +642,23 @@ static STATUS cli_vn310(struct cli_state_t *cli_state, void *context, int argc,
     {
         return vn310_set(cli_state, &state->driver_state, argc, argv);
     }
+    if (strcmp(argv[1], "trace") == 0)
+    {
+        return vn310_trace(cli_state, context, argc, argv);
+    }
+    if (strcmp(argv[1], "merge") == 0)
+    {
+        return vn310_merge(cli_state, context, argc, argv);
+    }
+    if (strcmp(argv[1], "log") == 0)
+    {
+        return vn310_log(cli_state, context, argc, argv);
+    }
 
     return ERROR;
 }
 
-void vn310_cli_init(struct app_vn310_state_t *state, struct cli_state_t *cli_state)
+void vn310_cli_init(struct vn310_applet_state_t *state, struct cli_state_t *cli_state)
 {
     cli_add_command(cli_state, "vn310", "vn310 commands", cli_vn310, state);
 } 
\ No newline at end of file
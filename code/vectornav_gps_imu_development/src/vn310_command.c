@@ -0,0 +1,437 @@
+/**
+ * @file vn310_command.c
+ * @brief Implementation of the VectorNav command/response engine.
+ *
+ * The VN310 answers commands in the order it receives them, echoing the command
+ * id and, for register access, the register number. Each response is matched to
+ * the oldest in-flight command with the same id and register, so several commands
+ * can be outstanding at once while the streaming output keeps flowing. A $VNERR
+ * response carries no command id and is attributed to the oldest in-flight command.
+ *
+ * Barrier commands, such as a baud rate change, are only sent once everything
+ * before them has completed and hold back everything after them until they have
+ * completed, so no command is ever on the wire while the link changes.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "vn310_command.h"
+
+#define VECTORNAV_ERROR_ID   "ERR"
+
+/**
+ * @brief Extract the command id and register number from a command or response.
+ *
+ * @param text Command or response text starting with "$VN".
+ * @param id Output three letter id, NUL terminated.
+ * @param register_id Output register number for RRG/WRG, -1 otherwise.
+ * @return OK if the text is a VectorNav command or response.
+ */
+static STATUS _parse_id(const char *text, char id[4], int16_t *register_id)
+{
+    if (text[0] != '$' || text[1] != 'V' || text[2] != 'N' || text[3] == '\0' || text[4] == '\0' || text[5] == '\0')
+    {
+        return ERROR;
+    }
+
+    memcpy(id, &text[3], 3);
+    id[3] = '\0';
+    *register_id = -1;
+
+    if ((strcmp(id, "RRG") == 0 || strcmp(id, "WRG") == 0) && text[6] == ',')
+    {
+        *register_id = (int16_t)strtol(&text[7], NULL, 10);
+    }
+
+    return OK;
+}
+
+static struct vn310_command_t *_oldest(struct vn310_command_engine_t *engine, enum vn310_command_slot_state slot_state)
+{
+    struct vn310_command_t *oldest = NULL;
+
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; i++)
+    {
+        struct vn310_command_t *command = &engine->commands[i];
+        if (command->slot_state == slot_state && (oldest == NULL || (int32_t)(command->sequence - oldest->sequence) < 0))
+        {
+            oldest = command;
+        }
+    }
+
+    return oldest;
+}
+
+static uint8_t _count(const struct vn310_command_engine_t *engine, enum vn310_command_slot_state slot_state, bool barrier_only)
+{
+    uint8_t count = 0;
+
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; i++)
+    {
+        if (engine->commands[i].slot_state == slot_state && (!barrier_only || engine->commands[i].barrier))
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void _complete(struct vn310_command_engine_t *engine, struct vn310_command_t *command, STATUS status, const char *response)
+{
+    vn310_command_callback_t callback = command->callback;
+    void *context = command->context;
+    bool in_batch = command->in_batch;
+
+    command->slot_state = COMMAND_SLOT_FREE;
+
+    if (status == OK)
+    {
+        engine->completed_count++;
+    }
+    else
+    {
+        engine->failed_count++;
+    }
+
+    if (callback != NULL)
+    {
+        callback(context, status, response);
+    }
+
+    if (in_batch)
+    {
+        engine->batch_outstanding--;
+        if (status != OK)
+        {
+            engine->batch_failed++;
+        }
+        if (engine->batch_outstanding == 0 && !engine->batch_open && engine->batch_callback != NULL)
+        {
+            vn310_command_batch_callback_t batch_callback = engine->batch_callback;
+            engine->batch_callback = NULL;
+            batch_callback(engine->batch_context, engine->batch_failed);
+        }
+    }
+}
+
+/**
+ * @brief Initialize the command engine.
+ *
+ * Zero configuration values are replaced with the defaults.
+ *
+ * @param engine The command engine.
+ * @param config The engine configuration.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_command_init(struct vn310_command_engine_t *engine, const struct vn310_command_config_t *config)
+{
+    memset(engine, 0, sizeof(*engine));
+    engine->config = *config;
+
+    if (engine->config.max_in_flight == 0)
+    {
+        engine->config.max_in_flight = VN310_COMMAND_DEFAULT_IN_FLIGHT;
+    }
+    if (engine->config.timeout_ms == 0)
+    {
+        engine->config.timeout_ms = VN310_COMMAND_DEFAULT_TIMEOUT_MS;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Reserve a free command slot so a command can be built in place.
+ *
+ * The slot's text buffer is what the UART transmits from, so building straight
+ * into it avoids a copy. The slot must be passed to vn310_command_commit or
+ * vn310_command_cancel before the next call to vn310_command_process.
+ *
+ * @param engine The command engine.
+ * @return The reserved slot, or NULL if the queue is full.
+ */
+struct vn310_command_t *vn310_command_reserve(struct vn310_command_engine_t *engine)
+{
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; i++)
+    {
+        struct vn310_command_t *slot = &engine->commands[i];
+        if (slot->slot_state == COMMAND_SLOT_FREE)
+        {
+            slot->slot_state = COMMAND_SLOT_RESERVED;
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Queue a command built in a reserved slot.
+ *
+ * The slot is released again if the command is invalid.
+ *
+ * @param engine The command engine.
+ * @param command The reserved slot holding the command text.
+ * @param command_size Length of the command.
+ * @param barrier True if the command changes the link and must be sent alone.
+ * @param callback Called with the response once the command completes, may be NULL.
+ * @param context Passed to the callback.
+ * @return OK if the command was queued.
+ */
+STATUS vn310_command_commit(struct vn310_command_engine_t *engine, struct vn310_command_t *command, size_t command_size, bool barrier, vn310_command_callback_t callback, void *context)
+{
+    if (command->slot_state != COMMAND_SLOT_RESERVED)
+    {
+        return ERROR;
+    }
+
+    if (command_size == 0 || command_size >= VN310_COMMAND_MAX_LENGTH)
+    {
+        command->slot_state = COMMAND_SLOT_FREE;
+        return ERROR;
+    }
+
+    command->text[command_size] = '\0';
+    if (_parse_id(command->text, command->match_id, &command->match_register) != OK)
+    {
+        command->slot_state = COMMAND_SLOT_FREE;
+        return ERROR;
+    }
+
+    command->length = (uint16_t)command_size;
+    command->barrier = barrier;
+    command->in_batch = engine->batch_open;
+    command->retries_left = engine->config.retries;
+    command->sequence = engine->next_sequence++;
+    command->callback = callback;
+    command->context = context;
+    command->slot_state = COMMAND_SLOT_QUEUED;
+
+    if (command->in_batch)
+    {
+        engine->batch_outstanding++;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Release a reserved slot without queueing it.
+ *
+ * @param engine The command engine.
+ * @param command The reserved slot.
+ */
+void vn310_command_cancel(struct vn310_command_engine_t *engine, struct vn310_command_t *command)
+{
+    (void)engine;
+
+    if (command->slot_state == COMMAND_SLOT_RESERVED)
+    {
+        command->slot_state = COMMAND_SLOT_FREE;
+    }
+}
+
+/**
+ * @brief Queue a complete command for transmission.
+ *
+ * @param engine The command engine.
+ * @param command Complete command text including checksum and line ending.
+ * @param command_size Length of the command.
+ * @param barrier True if the command changes the link and must be sent alone.
+ * @param callback Called with the response once the command completes, may be NULL.
+ * @param context Passed to the callback.
+ * @return OK if the command was queued, ERROR if the queue is full or the command invalid.
+ */
+STATUS vn310_command_submit(struct vn310_command_engine_t *engine, const char *command, size_t command_size, bool barrier, vn310_command_callback_t callback, void *context)
+{
+    if (command_size == 0 || command_size >= VN310_COMMAND_MAX_LENGTH)
+    {
+        return ERROR;
+    }
+
+    struct vn310_command_t *slot = vn310_command_reserve(engine);
+    if (slot == NULL)
+    {
+        return ERROR;
+    }
+
+    memcpy(slot->text, command, command_size);
+
+    return vn310_command_commit(engine, slot, command_size, barrier, callback, context);
+}
+
+/**
+ * @brief Send queued commands and expire unanswered ones.
+ *
+ * Called from the applet run loop.
+ *
+ * @param engine The command engine.
+ * @param uart_state The UART the sensor is connected to.
+ * @param now_ms Current time (ms).
+ * @return OK.
+ */
+STATUS vn310_command_process(struct vn310_command_engine_t *engine, struct driver_uart_state_t *uart_state, uint32_t now_ms)
+{
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; i++)
+    {
+        struct vn310_command_t *command = &engine->commands[i];
+
+        if (command->slot_state != COMMAND_SLOT_IN_FLIGHT || (now_ms - command->sent_ms) < engine->config.timeout_ms)
+        {
+            continue;
+        }
+
+        if (command->retries_left > 0 &&
+            driver_uart_transmit(uart_state, (uint8_t *)command->text, command->length) == OK)
+        {
+            command->retries_left--;
+            command->sent_ms = now_ms;
+            engine->retry_count++;
+        }
+        else
+        {
+            engine->timeout_count++;
+            _complete(engine, command, ERROR, NULL);
+        }
+    }
+
+    while (true)
+    {
+        struct vn310_command_t *next = _oldest(engine, COMMAND_SLOT_QUEUED);
+        uint8_t in_flight = _count(engine, COMMAND_SLOT_IN_FLIGHT, false);
+
+        if (next == NULL ||
+            in_flight >= engine->config.max_in_flight ||
+            _count(engine, COMMAND_SLOT_IN_FLIGHT, true) > 0 ||
+            (next->barrier && in_flight > 0))
+        {
+            break;
+        }
+
+        if (driver_uart_transmit(uart_state, (uint8_t *)next->text, next->length) != OK)
+        {
+            break;
+        }
+
+        next->slot_state = COMMAND_SLOT_IN_FLIGHT;
+        next->sent_ms = now_ms;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Match a response from the sensor to an in-flight command.
+ *
+ * @param engine The command engine.
+ * @param response The response text, starting with "$VN".
+ * @return OK if the response completed a command, ERROR if it matched none.
+ */
+STATUS vn310_command_handle_response(struct vn310_command_engine_t *engine, const char *response)
+{
+    char id[4];
+    int16_t register_id;
+
+    if (_parse_id(response, id, &register_id) != OK)
+    {
+        engine->unmatched_count++;
+        return ERROR;
+    }
+
+    bool is_error = (strcmp(id, VECTORNAV_ERROR_ID) == 0);
+    struct vn310_command_t *match = NULL;
+
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; i++)
+    {
+        struct vn310_command_t *command = &engine->commands[i];
+
+        if (command->slot_state != COMMAND_SLOT_IN_FLIGHT)
+        {
+            continue;
+        }
+        if (!is_error && (strcmp(command->match_id, id) != 0 || command->match_register != register_id))
+        {
+            continue;
+        }
+        if (match == NULL || (int32_t)(command->sequence - match->sequence) < 0)
+        {
+            match = command;
+        }
+    }
+
+    if (match == NULL)
+    {
+        engine->unmatched_count++;
+        return ERROR;
+    }
+
+    _complete(engine, match, is_error ? ERROR : OK, response);
+
+    return OK;
+}
+
+/**
+ * @brief Start grouping submitted commands into a batch.
+ *
+ * @param engine The command engine.
+ * @param callback Called once every command in the batch has completed.
+ * @param context Passed to the callback.
+ * @return OK if the batch was opened, ERROR if one is already in progress.
+ */
+STATUS vn310_command_batch_begin(struct vn310_command_engine_t *engine, vn310_command_batch_callback_t callback, void *context)
+{
+    if (engine->batch_open || engine->batch_outstanding > 0)
+    {
+        return ERROR;
+    }
+
+    engine->batch_open = true;
+    engine->batch_failed = 0;
+    engine->batch_callback = callback;
+    engine->batch_context = context;
+
+    return OK;
+}
+
+/**
+ * @brief Close the current batch.
+ *
+ * If every command in the batch has already completed the callback is called
+ * immediately.
+ *
+ * @param engine The command engine.
+ * @return OK if a batch was open.
+ */
+STATUS vn310_command_batch_end(struct vn310_command_engine_t *engine)
+{
+    if (!engine->batch_open)
+    {
+        return ERROR;
+    }
+
+    engine->batch_open = false;
+
+    if (engine->batch_outstanding == 0 && engine->batch_callback != NULL)
+    {
+        vn310_command_batch_callback_t batch_callback = engine->batch_callback;
+        engine->batch_callback = NULL;
+        batch_callback(engine->batch_context, engine->batch_failed);
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Get the number of commands queued or in flight.
+ *
+ * @param engine The command engine.
+ * @return Number of outstanding commands.
+ */
+uint8_t vn310_command_pending(const struct vn310_command_engine_t *engine)
+{
+    return (uint8_t)(_count(engine, COMMAND_SLOT_QUEUED, false) + _count(engine, COMMAND_SLOT_IN_FLIGHT, false));
+}
@@ -0,0 +1,250 @@
+/**
+ * @file vn310_command_builder.c
+ * @brief Implementation of the VectorNav ASCII command builder.
+ *
+ * Every add function writes a ',' followed by the field. Nothing is written past
+ * the capacity: a field that does not fit sets the overflow flag, and finish then
+ * refuses the command, so a truncated command is never handed to the UART.
+ *
+ * The checksum covers the bytes between '$' and '*', as in the VN310 user manual.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_command_builder.h"
+#include "vn310_driver.h"
+
+#define VN310_BUILDER_FIXED_LIMIT   1.0e12   // Largest magnitude formatted by add_fixed
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static void _put(struct vn310_command_builder_t *builder, const char *text, uint16_t length)
+{
+    if (builder->overflow || builder->length + length > builder->capacity)
+    {
+        builder->overflow = true;
+        return;
+    }
+
+    memcpy(&builder->buffer[builder->length], text, length);
+    builder->length += length;
+}
+
+/**
+ * @brief Format an unsigned integer in decimal, returning the number of digits.
+ */
+static uint16_t _format_u64(uint64_t value, char digits[20])
+{
+    char reversed[20];
+    uint16_t count = 0;
+
+    do
+    {
+        reversed[count++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        digits[i] = reversed[count - 1 - i];
+    }
+
+    return count;
+}
+
+/**
+ * @brief Start a command, writing "$VN" and the command id.
+ *
+ * @param builder The builder.
+ * @param buffer Destination buffer, written in place.
+ * @param capacity Size of the destination buffer.
+ * @param command_id Three letter command id, e.g. "WRG".
+ */
+void vn310_builder_begin(struct vn310_command_builder_t *builder, char *buffer, uint16_t capacity, const char *command_id)
+{
+    builder->buffer = buffer;
+    builder->capacity = capacity;
+    builder->length = 0;
+    builder->overflow = false;
+
+    _put(builder, VECTORNAV_HEADER, sizeof(VECTORNAV_HEADER) - 1);
+    _put(builder, command_id, (uint16_t)strlen(command_id));
+}
+
+/**
+ * @brief Append an unsigned decimal field.
+ */
+void vn310_builder_add_uint(struct vn310_command_builder_t *builder, uint32_t value)
+{
+    char field[21];
+
+    field[0] = ',';
+    _put(builder, field, (uint16_t)(1 + _format_u64(value, &field[1])));
+}
+
+/**
+ * @brief Append a signed decimal field.
+ */
+void vn310_builder_add_int(struct vn310_command_builder_t *builder, int32_t value)
+{
+    char field[22];
+    uint16_t length = 1;
+
+    field[0] = ',';
+    if (value < 0)
+    {
+        field[length++] = '-';
+    }
+    length += _format_u64((value < 0) ? (uint64_t)(-(int64_t)value) : (uint64_t)value, &field[length]);
+
+    _put(builder, field, length);
+}
+
+/**
+ * @brief Append a fixed point decimal field, rounded to the given number of decimals.
+ *
+ * Values that are not finite or exceed 1e12 in magnitude set the overflow flag.
+ *
+ * @param builder The builder.
+ * @param value The value to format.
+ * @param decimals Digits after the decimal point, at most VN310_BUILDER_MAX_DECIMALS.
+ */
+void vn310_builder_add_fixed(struct vn310_command_builder_t *builder, double value, uint8_t decimals)
+{
+    static const uint32_t scale[VN310_BUILDER_MAX_DECIMALS + 1] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+    // Written so NaN fails the check as well
+    if (decimals > VN310_BUILDER_MAX_DECIMALS || !(value > -VN310_BUILDER_FIXED_LIMIT && value < VN310_BUILDER_FIXED_LIMIT))
+    {
+        builder->overflow = true;
+        return;
+    }
+
+    bool negative = value < 0.0;
+    uint64_t scaled = (uint64_t)((negative ? -value : value) * scale[decimals] + 0.5);
+    uint64_t whole = scaled / scale[decimals];
+    uint32_t fraction = (uint32_t)(scaled % scale[decimals]);
+
+    char field[2 + 20 + 1 + VN310_BUILDER_MAX_DECIMALS];
+    uint16_t length = 1;
+
+    field[0] = ',';
+    if (negative && scaled != 0)
+    {
+        field[length++] = '-';
+    }
+    length += _format_u64(whole, &field[length]);
+
+    if (decimals > 0)
+    {
+        field[length++] = '.';
+        for (int i = decimals - 1; i >= 0; i--)
+        {
+            field[length + i] = (char)('0' + (fraction % 10));
+            fraction /= 10;
+        }
+        length += decimals;
+    }
+
+    _put(builder, field, length);
+}
+
+/**
+ * @brief Append an upper case hexadecimal field with a fixed number of digits.
+ */
+void vn310_builder_add_hex(struct vn310_command_builder_t *builder, uint32_t value, uint8_t digits)
+{
+    char field[1 + 8];
+
+    if (digits == 0 || digits > 8)
+    {
+        builder->overflow = true;
+        return;
+    }
+
+    field[0] = ',';
+    for (int i = digits; i > 0; i--)
+    {
+        field[i] = hex_digits[value & 0xF];
+        value >>= 4;
+    }
+
+    _put(builder, field, (uint16_t)(1 + digits));
+}
+
+/**
+ * @brief Append a field given as text, e.g. a register value typed on the CLI.
+ *
+ * The text must be non-empty and may not contain delimiters or control characters,
+ * so it cannot break the framing of the command.
+ */
+void vn310_builder_add_text(struct vn310_command_builder_t *builder, const char *text)
+{
+    size_t length = strlen(text);
+
+    if (length == 0)
+    {
+        builder->overflow = true;
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        if (text[i] < ' ' || text[i] > '~' || text[i] == ',' || text[i] == '*' || text[i] == '$')
+        {
+            builder->overflow = true;
+            return;
+        }
+    }
+
+    _put(builder, ",", 1);
+    _put(builder, text, (uint16_t)length);
+}
+
+/**
+ * @brief Terminate the command with its checksum and line ending.
+ *
+ * @param builder The builder.
+ * @param checksum Checksum to append.
+ * @return OK if the complete command fits, ERROR otherwise.
+ */
+STATUS vn310_builder_finish(struct vn310_command_builder_t *builder, enum vn310_checksum_type checksum)
+{
+    char trailer[1 + 4 + 2];
+    uint16_t length = 0;
+
+    if (builder->overflow)
+    {
+        return ERROR;
+    }
+
+    trailer[length++] = '*';
+
+    if (checksum == VN310_CHECKSUM_8BIT)
+    {
+        uint8_t crc = calculate_8_bit_crc((unsigned char *)&builder->buffer[1], builder->length - 1u);
+        trailer[length++] = hex_digits[crc >> 4];
+        trailer[length++] = hex_digits[crc & 0xF];
+    }
+    else if (checksum == VN310_CHECKSUM_16BIT)
+    {
+        uint16_t crc = calculate_16_bit_crc((unsigned char *)&builder->buffer[1], builder->length - 1u);
+        trailer[length++] = hex_digits[(crc >> 12) & 0xF];
+        trailer[length++] = hex_digits[(crc >> 8) & 0xF];
+        trailer[length++] = hex_digits[(crc >> 4) & 0xF];
+        trailer[length++] = hex_digits[crc & 0xF];
+    }
+    else
+    {
+        trailer[length++] = 'X';
+        trailer[length++] = 'X';
+    }
+
+    trailer[length++] = '\r';
+    trailer[length++] = '\n';
+
+    _put(builder, trailer, length);
+
+    return builder->overflow ? ERROR : OK;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file vn310_console.c
+ * @brief Implementation of the VN310 console stream queue.
+ *
+ * The queue is a single-producer/single-consumer ring like the frame mailbox, with
+ * one difference: when it is full the producer drops the oldest line instead of the
+ * new one. It does so by advancing the tail with a compare-and-swap, the same
+ * operation the consumer uses to release a line. The consumer copies a line out
+ * before claiming it; if the claim fails, the producer has dropped and possibly
+ * overwritten that line during the copy, so the copy is discarded and the next
+ * oldest line is taken instead. Neither side ever waits for the other.
+ *
+ * Formatting is a byte copy or a table-driven hex conversion, so a streamed frame
+ * costs the applet well under a microsecond whatever the console speed.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_console.h"
+#include "vn310_driver.h"
+
+#define CONSOLE_TRUNCATED_MARK      ".."
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Initialize the console queue.
+ *
+ * Streams every frame as text until configured otherwise.
+ *
+ * @param console The console queue.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_console_init(struct vn310_console_t *console)
+{
+    memset(console, 0, sizeof(*console));
+    console->decimation = 1;
+    return OK;
+}
+
+/**
+ * @brief Set the decimation and format of the stream.
+ *
+ * @param console The console queue.
+ * @param decimation Stream every Nth frame, 0 or 1 for every frame.
+ * @param mode Text or hex dump.
+ */
+void vn310_console_configure(struct vn310_console_t *console, uint32_t decimation, enum vn310_console_mode mode)
+{
+    console->decimation = decimation ? decimation : 1;
+    console->mode = mode;
+    console->frame_counter = 0;
+}
+
+/**
+ * @brief Format a frame as text, stopping at the line terminator.
+ */
+static uint16_t _format_text(const struct vn310_frame_t *frame, char *text)
+{
+    uint16_t length = 0;
+
+    for (uint16_t i = 0; i < frame->size && length < VN310_CONSOLE_LINE_SIZE - 1; i++)
+    {
+        char c = frame->data[i];
+        if (c == '\r' || c == '\n')
+        {
+            break;
+        }
+        text[length++] = (c >= ' ' && c <= '~') ? c : '.';
+    }
+
+    return length;
+}
+
+/**
+ * @brief Format a frame as hex, marking a truncated frame with "..".
+ */
+static uint16_t _format_hex(const struct vn310_frame_t *frame, char *text)
+{
+    const uint8_t *bytes = (const uint8_t *)frame->data;
+    uint16_t length = 0;
+    uint16_t i;
+
+    for (i = 0; i < frame->size && length + 2 + sizeof(CONSOLE_TRUNCATED_MARK) <= VN310_CONSOLE_LINE_SIZE; i++)
+    {
+        text[length++] = hex_digits[bytes[i] >> 4];
+        text[length++] = hex_digits[bytes[i] & 0x0F];
+    }
+
+    if (i < frame->size)
+    {
+        memcpy(&text[length], CONSOLE_TRUNCATED_MARK, sizeof(CONSOLE_TRUNCATED_MARK) - 1);
+        length += sizeof(CONSOLE_TRUNCATED_MARK) - 1;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Queue a frame for the console (producer side).
+ *
+ * Called by the applet for every frame while streaming. Only every Nth frame is
+ * formatted; if the queue is full the oldest line is dropped.
+ *
+ * @param console The console queue.
+ * @param frame The frame to stream.
+ * @param forced Queue this frame regardless of the decimation, e.g. a single-shot request.
+ */
+void vn310_console_stream(struct vn310_console_t *console, const struct vn310_frame_t *frame, bool forced)
+{
+    if (!forced && (console->frame_counter++ % console->decimation) != 0)
+    {
+        console->decimated_count++;
+        return;
+    }
+
+    uint32_t head = console->head;
+    uint32_t tail = __atomic_load_n(&console->tail, __ATOMIC_ACQUIRE);
+
+    // Drop the oldest line; fails only if the consumer has just taken it, which frees the slot anyway
+    if ((head - tail) >= VN310_CONSOLE_DEPTH &&
+        __atomic_compare_exchange_n(&console->tail, &tail, tail + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        console->dropped_count++;
+    }
+
+    struct vn310_console_line_t *line = &console->lines[head & VN310_CONSOLE_MASK];
+
+    if (console->mode == CONSOLE_MODE_HEX || frame->type == MSG_BINARY)
+    {
+        line->length = _format_hex(frame, line->text);
+    }
+    else
+    {
+        line->length = _format_text(frame, line->text);
+    }
+    line->text[line->length] = '\0';
+
+    console->queued_count++;
+    __atomic_store_n(&console->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Take the oldest queued line (consumer side).
+ *
+ * @param console The console queue.
+ * @param line Output copy of the line.
+ * @return true if a line was taken, false if the queue is empty.
+ */
+bool vn310_console_pop(struct vn310_console_t *console, struct vn310_console_line_t *line)
+{
+    while (true)
+    {
+        uint32_t tail = __atomic_load_n(&console->tail, __ATOMIC_ACQUIRE);
+        uint32_t head = __atomic_load_n(&console->head, __ATOMIC_ACQUIRE);
+
+        if (head == tail)
+        {
+            return false;
+        }
+
+        *line = console->lines[tail & VN310_CONSOLE_MASK];
+
+        if (__atomic_compare_exchange_n(&console->tail, &tail, tail + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            line->text[VN310_CONSOLE_LINE_SIZE - 1] = '\0';
+            console->printed_count++;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Print queued lines to the CLI (consumer side).
+ *
+ * Call from a low-priority task. Printing is bounded per call so a slow console
+ * cannot hold the task either.
+ *
+ * @param console The console queue.
+ * @param cli_state The CLI to print to.
+ * @param max_lines Most lines to print in this call.
+ * @return Number of lines printed.
+ */
+uint32_t vn310_console_drain(struct vn310_console_t *console, struct cli_state_t *cli_state, uint32_t max_lines)
+{
+    struct vn310_console_line_t line;
+    uint32_t printed = 0;
+
+    while (printed < max_lines && vn310_console_pop(console, &line))
+    {
+        cli_printf(cli_state, "%s\r\n", line.text);
+        printed++;
+    }
+
+    return printed;
+}
@@ -11,8 +11,8 @@
  *
  */
 
+#include <math.h>
 #include <string.h>
-#include <stdio.h>
 
 #include "vn310_driver.h"
     
@@ -29,6 +29,8 @@ STATUS vn310_driver_init(struct vn310_driver_state_t *state, const struct vn310_
 
     RETURN_ON_ERROR(driver_uart_init(&state->uart_state, &state->config.vectornav_uart_config));
 
+    state->baud_rate = state->config.vectornav_uart_config.baud_rate;
+
     return OK;
 }
 
@@ -40,9 +42,26 @@ STATUS vn310_driver_init(struct vn310_driver_state_t *state, const struct vn310_
  */
 STATUS vn310_driver_configure(struct vn310_driver_state_t *state)
 {
-    state->vectornav_message_ready = false;
     state->message_counter = 0;
 
+    // A shared ring is set up by vn310_ipc_init and is being written by the M4
+    if (state->config.shared_mailbox != NULL)
+    {
+        state->mailbox = state->config.shared_mailbox;
+    }
+    else
+    {
+        state->mailbox = &state->local_mailbox;
+        RETURN_ON_ERROR(vn310_mailbox_init(state->mailbox));
+    }
+    RETURN_ON_ERROR(vn310_command_init(&state->commands, &state->config.command_config));
+
+    state->binary_rate_divisor = state->config.sensor_config.binary_rate_divisor ?
+                                 state->config.sensor_config.binary_rate_divisor : RATE_DIVISOR_4;
+    state->ascii_rate_hz = 0;
+    state->baud_callback = NULL;
+    memset(&state->link, 0, sizeof(state->link));
+
     return OK;
 }
 
@@ -50,23 +69,44 @@ STATUS vn310_driver_configure(struct vn310_driver_state_t *state)
  * @brief Callback function for secondary VectorNav driver events.
  *
  * This function is called when an event occurs in the secondary VectorNav driver.
- * It assembles the received message and updates the state of the VectorNav driver accordingly.
+ * Valid messages are copied straight from the DMA buffer into a free mailbox slot
+ * and published to the applet, so the next DMA callback can never overwrite a
+ * message that is still being parsed. If the mailbox is full the message is
+ * dropped and counted as an overrun. Messages that would not fit a mailbox slot
+ * with their terminator are dropped before a slot is taken.
  *
  * @param vectornav_state The state of the VectorNav driver.
- * @param uart_assembled_message The assembled message from the UART.
  * @param message_size The size of the received message.
  */
 STATUS vn310_driver_eventcallback(struct vn310_driver_state_t *vectornav_driver_state, uint16_t message_size)
 {
+	uint32_t time_dma = vn310_trace_now();
 	char *uart_received_data = (char*) vectornav_driver_state->uart_state.config.rx_buf;
 
-	enum vectornav_msg_type recieved_msg_type = vn310_driver_message_check(uart_received_data, vectornav_driver_state->assembled_message, message_size,UART_DMA_READ_BUF_SIZE);
+	if (message_size == 0 || message_size >= UART_DMA_READ_BUF_SIZE)
+	{
+		memset(vectornav_driver_state->uart_state.config.rx_buf, 0, UART_DMA_READ_BUF_SIZE);
+		return ERROR;
+	}
+
+	struct vn310_frame_t *frame = vn310_mailbox_reserve(vectornav_driver_state->mailbox);
 
-	//check message type
-	if (MSG_ASYNC == recieved_msg_type || MSG_BINARY == recieved_msg_type)
+	if (NULL != frame)
 	{
-		vectornav_driver_state->vectornav_message_ready = true;
-		return OK;
+		enum vectornav_msg_type recieved_msg_type = vn310_driver_message_check(uart_received_data, frame->data, message_size, UART_DMA_READ_BUF_SIZE);
+
+		//check message type
+		if (MSG_ASYNC == recieved_msg_type || MSG_BINARY == recieved_msg_type ||
+		    MSG_RESPONSE == recieved_msg_type || MSG_ERROR == recieved_msg_type)
+		{
+			frame->type = recieved_msg_type;
+			frame->size = message_size;
+			frame->checked = false;
+			frame->time_dma = time_dma;
+			frame->time_ready = vn310_trace_now();
+			vn310_mailbox_commit(vectornav_driver_state->mailbox);
+			return OK;
+		}
 	}
 
     // Clear rx_buf
@@ -75,25 +115,6 @@ STATUS vn310_driver_eventcallback(struct vn310_driver_state_t *vectornav_driver_
 	return ERROR;
 }
 
-/**
- * @brief Print the stream from the VectorNav driver.
- *
- * @param state The state of the VectorNav driver.
- * @param cli_state The state of the CLI.
- * @return STATUS The status of the print operation.
- */
-STATUS vn310_driver_print_stream(struct vn310_driver_state_t *state, struct cli_state_t *cli_state)
-{
-	if(true == state->uart_stream )
-	{
-		cli_printf(cli_state, state->assembled_message);
-		memset(state->assembled_message, 0, UART_DMA_READ_BUF_SIZE);
-		return OK;
-	}
-
-    return ERROR;
-}
-
 /**
  * @brief Assemble a circular message from the VectorNav driver.
  * 
@@ -128,10 +149,20 @@ enum vectornav_msg_type vn310_driver_message_check(char *received_data, char *as
 
 	        return MSG_ERROR;
 	    }
+
+	    // Any other $VN message is a response to a command
+	    memset(assembled_data, 0, uart_dma_buffer_size);
+	    memcpy(assembled_data, received_data, recieved_message_size);
+
+	    return MSG_RESPONSE;
 	}
 
 	// config 0 binary message header
-	if (received_data[1] == 0xFA && received_data[2] == 0x16 && received_data[3] == 0x3)
+	const uint8_t *received_bytes = (const uint8_t *)received_data;
+	if (received_bytes[0] == VN310_BINARY_SYNC &&
+	    received_bytes[1] == VN310_BINARY_CONFIG0_GROUP &&
+	    received_bytes[2] == (VN310_BINARY_CONFIG0_FIELDS & 0xFF) &&
+	    received_bytes[3] == (VN310_BINARY_CONFIG0_FIELDS >> 8))
 	{
 		memset(assembled_data, 0, uart_dma_buffer_size);
 		memcpy(assembled_data, received_data, recieved_message_size);
@@ -139,7 +170,7 @@ enum vectornav_msg_type vn310_driver_message_check(char *received_data, char *as
 		return MSG_BINARY;
 	}
 
-	return MSG_ERROR;
+	return MSG_UNKNOWN;
 }
 
 /**
@@ -169,6 +200,151 @@ STATUS vn310_driver_read_byte(struct vn310_driver_state_t *state, uint8_t *data)
 	return OK;
 }
 
+/**
+ * @brief Reserve a command slot and start building a command in it.
+ *
+ * @param state The state of the UART driver.
+ * @param builder The builder to start.
+ * @param command_id Three letter command id.
+ * @return The reserved slot, or NULL if the command queue is full. The builder is then
+ *         left empty and overflowed, so adding fields to it is safe and does nothing.
+ */
+static struct vn310_command_t *_command_begin(struct vn310_driver_state_t *state, struct vn310_command_builder_t *builder, const char *command_id)
+{
+    struct vn310_command_t *command = vn310_command_reserve(&state->commands);
+
+    if (command == NULL)
+    {
+        // No buffer: the fields added by the caller are dropped and _command_queue fails
+        builder->buffer = NULL;
+        builder->capacity = 0;
+        builder->length = 0;
+        builder->overflow = true;
+        return NULL;
+    }
+
+    // Leave room for the terminator added on commit
+    vn310_builder_begin(builder, command->text, sizeof(command->text) - 1, command_id);
+
+    return command;
+}
+
+/**
+ * @brief Append the checksum and queue a command built with _command_begin.
+ *
+ * @param state The state of the UART driver.
+ * @param command The reserved slot, may be NULL if the reservation failed.
+ * @param builder The builder holding the command.
+ * @param barrier True if the command must be sent alone.
+ * @param callback Called with the response once the command completes, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the command was queued.
+ */
+static STATUS _command_queue(struct vn310_driver_state_t *state, struct vn310_command_t *command, struct vn310_command_builder_t *builder, bool barrier, vn310_command_callback_t callback, void *context)
+{
+    if (command == NULL)
+    {
+        return ERROR;
+    }
+
+    if (vn310_builder_finish(builder, state->config.checksum) != OK)
+    {
+        vn310_command_cancel(&state->commands, command);
+        return ERROR;
+    }
+
+    return vn310_command_commit(&state->commands, command, builder->length, barrier, callback, context);
+}
+
+/**
+ * @brief Queue a command for the VectorNav device.
+ *
+ * The command is sent by vn310_driver_process, pipelined with other commands, and
+ * completes when the matching response arrives or all retries have timed out.
+ *
+ * @param state The state of the UART driver.
+ * @param command Complete command text.
+ * @param command_size Length of the command.
+ * @param callback Called with the response once the command completes, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the command was queued.
+ */
+STATUS vn310_driver_send_command(struct vn310_driver_state_t *state, const char *command, size_t command_size, vn310_command_callback_t callback, void *context)
+{
+    return vn310_command_submit(&state->commands, command, command_size, false, callback, context);
+}
+
+/**
+ * @brief Send queued commands and handle command timeouts.
+ *
+ * @param state The state of the UART driver.
+ * @param now_ms Current time (ms).
+ * @return STATUS The status of the operation.
+ */
+STATUS vn310_driver_process(struct vn310_driver_state_t *state, uint32_t now_ms)
+{
+    return vn310_command_process(&state->commands, &state->uart_state, now_ms);
+}
+
+/**
+ * @brief Switch the UART once the device has acknowledged a baud rate change.
+ */
+static void _baud_rate_acknowledged(void *context, STATUS status, const char *response)
+{
+    struct vn310_driver_state_t *state = context;
+    vn310_command_callback_t callback = state->baud_callback;
+
+    state->baud_callback = NULL;
+
+    if (status == OK)
+    {
+        vn310_driver_set_uart_baud_rate(state, state->pending_baud_rate);
+    }
+
+    if (callback != NULL)
+    {
+        callback(state->baud_context, status, response);
+    }
+}
+
+/**
+ * @brief Apply the start-up sensor configuration as a single command batch.
+ *
+ * ASCII output is disabled, binary output configuration 0 and the GNSS antenna
+ * geometry are written, and finally the baud rate is changed. The commands are
+ * pipelined, so the batch completes within one round trip plus the baud change.
+ *
+ * @param state The state of the UART driver.
+ * @param callback Called with the number of failed commands once the batch completes.
+ * @param context Passed to the callback.
+ * @return STATUS OK if every command was queued.
+ */
+STATUS vn310_driver_configure_sensor(struct vn310_driver_state_t *state, vn310_command_batch_callback_t callback, void *context)
+{
+    const struct vn310_driver_sensor_config_t *sensor = &state->config.sensor_config;
+    STATUS status = OK;
+
+    RETURN_ON_ERROR(vn310_command_batch_begin(&state->commands, callback, context));
+
+    if (vn310_driver_set_asynchronous_output(state, "0") != OK ||
+        vn310_driver_set_configuration_0(state) != OK ||
+        vn310_driver_set_antenna_a(state, sensor->antenna_a[0], sensor->antenna_a[1], sensor->antenna_a[2]) != OK ||
+        vn310_driver_set_antenna_baseline(state, sensor->baseline[0], sensor->baseline[1], sensor->baseline[2],
+                                          sensor->baseline_uncertainty[0], sensor->baseline_uncertainty[1], sensor->baseline_uncertainty[2]) != OK)
+    {
+        status = ERROR;
+    }
+
+    if (status == OK && sensor->baud_rate != 0 && sensor->baud_rate != state->uart_state.config.baud_rate)
+    {
+        status = vn310_driver_set_vectoranv_baud_rate(state, sensor->baud_rate);
+    }
+
+    vn310_command_batch_end(&state->commands);
+
+    return status;
+}
+
 /*
 * Measurement #1:
 *
@@ -189,14 +365,94 @@ STATUS vn310_driver_read_byte(struct vn310_driver_state_t *state, uint8_t *data)
 */
 STATUS vn310_driver_set_antenna_a(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate)
 {
-	//	$VNWRG,57,x_cordinate,y_cordinate,z_cordinate*XX????
-	return OK;
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
+
+    vn310_builder_add_uint(&builder, GNSS_ANTENNA_A_OFFSET_REGISTER);
+    vn310_builder_add_fixed(&builder, x_cordinate, 3);
+    vn310_builder_add_fixed(&builder, y_cordinate, 3);
+    vn310_builder_add_fixed(&builder, z_cordinate, 3);
+
+    RETURN_ON_ERROR(_command_queue(state, command, &builder, false, NULL, NULL));
+
+    // Antenna B is written relative to antenna A
+    state->config.sensor_config.antenna_a[0] = x_cordinate;
+    state->config.sensor_config.antenna_a[1] = y_cordinate;
+    state->config.sensor_config.antenna_a[2] = z_cordinate;
+
+    return OK;
 }
+
+/**
+ * @brief Set the position of antenna B.
+ *
+ * The sensor has no antenna B offset register, so the position is written as the
+ * compass baseline from antenna A (measurement #2 above). The default uncertainty
+ * of 0.0254 m is scaled by the baseline length for baselines longer than 1 m.
+ *
+ * @param state The state of the UART driver.
+ * @param x_cordinate Antenna B offset from the IMU, X (m).
+ * @param y_cordinate Antenna B offset from the IMU, Y (m).
+ * @param z_cordinate Antenna B offset from the IMU, Z (m).
+ * @return STATUS The status of the command operation.
+ */
 STATUS vn310_driver_set_antenna_b(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate)
 {
-	//	$VNWRG,57,x_cordinate,y_cordinate,z_cordinate*XX????
+    const double *antenna_a = state->config.sensor_config.antenna_a;
+    double baseline[3] = {
+        x_cordinate - antenna_a[0],
+        y_cordinate - antenna_a[1],
+        z_cordinate - antenna_a[2],
+    };
+    double length = sqrt(baseline[0] * baseline[0] + baseline[1] * baseline[1] + baseline[2] * baseline[2]);
+    double uncertainty = VN310_BASELINE_DEFAULT_UNCERTAINTY * ((length > 1.0) ? length : 1.0);
+
+    return vn310_driver_set_antenna_baseline(state, baseline[0], baseline[1], baseline[2], uncertainty, uncertainty, uncertainty);
+}
 
-	return OK;
+/**
+ * @brief Write the GNSS compass baseline and its uncertainty.
+ *
+ * @param state The state of the UART driver.
+ * @param x_cordinate Baseline from antenna A to antenna B, X (m).
+ * @param y_cordinate Baseline from antenna A to antenna B, Y (m).
+ * @param z_cordinate Baseline from antenna A to antenna B, Z (m).
+ * @param x_uncertainty Uncertainty of the X measurement (m).
+ * @param y_uncertainty Uncertainty of the Y measurement (m).
+ * @param z_uncertainty Uncertainty of the Z measurement (m).
+ * @return STATUS The status of the command operation.
+ */
+STATUS vn310_driver_set_antenna_baseline(struct vn310_driver_state_t *state, double x_cordinate, double y_cordinate, double z_cordinate, double x_uncertainty, double y_uncertainty, double z_uncertainty)
+{
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
+
+    vn310_builder_add_uint(&builder, GNSS_COMPASS_BASELINE_REGISTER);
+    vn310_builder_add_fixed(&builder, x_cordinate, 3);
+    vn310_builder_add_fixed(&builder, y_cordinate, 3);
+    vn310_builder_add_fixed(&builder, z_cordinate, 3);
+    vn310_builder_add_fixed(&builder, x_uncertainty, 3);
+    vn310_builder_add_fixed(&builder, y_uncertainty, 3);
+    vn310_builder_add_fixed(&builder, z_uncertainty, 3);
+
+    return _command_queue(state, command, &builder, false, NULL, NULL);
+}
+
+/**
+ * @brief Send a set initial heading command to the VectorNav driver.
+ *
+ * @param state The state of the UART driver.
+ * @param heading Initial heading (degrees).
+ * @return STATUS The status of the command operation.
+ */
+STATUS vn310_driver_set_initial_heading(struct vn310_driver_state_t *state, double heading)
+{
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_SIH_CMD);
+
+    vn310_builder_add_fixed(&builder, heading, 3);
+
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -207,12 +463,10 @@ STATUS vn310_driver_set_antenna_b(struct vn310_driver_state_t *state, double x_c
  */
 STATUS vn310_driver_factory_settings(struct vn310_driver_state_t *state)
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s*%s%s",VECTORNAV_HEADER ,VECTORNAV_RESET_FS_CMD, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
-
-    size_t command_size = strlen(command);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_RESET_FS_CMD);
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -223,12 +477,10 @@ STATUS vn310_driver_factory_settings(struct vn310_driver_state_t *state)
  */
 STATUS vn310_driver_reset_device(struct vn310_driver_state_t *state)
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s*%s%s",VECTORNAV_HEADER ,VECTORNAV_RESET_CMD, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
-
-    size_t command_size = strlen(command);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_RESET_CMD);
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -239,30 +491,31 @@ STATUS vn310_driver_reset_device(struct vn310_driver_state_t *state)
  *
  * @param state Pointer to the VectorNav driver state structure.
  * @param freq Desired output data freq.
- * @return Status of the operation (success or failure).
- * @retval STATUS_SUCCESS If the command is sent successfully and acknowledged.
- * @retval STATUS_ERROR If an error occurs during command transmission or if the command is not acknowledged.
+ * @param callback Called with the result, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the command was queued.
  */
-STATUS vn310_driver_set_output_data_freq(struct vn310_driver_state_t *state, uint8_t data_freq)
+STATUS vn310_driver_set_output_data_freq(struct vn310_driver_state_t *state, uint8_t data_freq, vn310_command_callback_t callback, void *context)
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d,%d*%s%s",
-    		VECTORNAV_HEADER,
-			VECTORNAV_WRG_CMD,
-			ASYNC_DATA_OUTPUT_FREQUENCY_REGISTER,
-			data_freq,
-			VECTORNAV_NO_CRC,
-			VECTORNAV_CRLF);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
 
-    size_t command_size = strlen(command);
+    vn310_builder_add_uint(&builder, ASYNC_DATA_OUTPUT_FREQUENCY_REGISTER);
+    vn310_builder_add_uint(&builder, data_freq);
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    RETURN_ON_ERROR(_command_queue(state, command, &builder, false, callback, context));
+
+    state->ascii_rate_hz = data_freq;
+
+    return OK;
 }
 
 /**
  * @brief Sets the vectornav baud rate for the VectorNav device.
  *
  * This function sends a command to the VectorNav device to set the output baud rate.
+ * The command is queued as a barrier so nothing else is on the wire while the link
+ * changes, and the UART is switched to the new rate once the device acknowledges.
  *
  * @param state Pointer to the VectorNav driver state structure.
  * @param baud_rate Desired output baud rate.
@@ -272,18 +525,41 @@ STATUS vn310_driver_set_output_data_freq(struct vn310_driver_state_t *state, uin
  */
 STATUS vn310_driver_set_vectoranv_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate)
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d,%u*%s%s",
-    		VECTORNAV_HEADER,
-			VECTORNAV_WRG_CMD,
-			SERIAL_BAUD_RATE_REGISTER,
-			baud_rate,
-			VECTORNAV_NO_CRC,
-			VECTORNAV_CRLF);
+    return vn310_driver_set_baud_rate(state, baud_rate, NULL, NULL);
+}
 
-    size_t command_size = strlen(command);
+/**
+ * @brief Change the baud rate at both ends of the link.
+ *
+ * As vn310_driver_set_vectoranv_baud_rate, with a callback once the device has
+ * answered and, on success, the UART has been switched.
+ *
+ * @param state Pointer to the VectorNav driver state structure.
+ * @param baud_rate Desired baud rate.
+ * @param callback Called with the result, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the command was queued, ERROR if a baud change is already pending.
+ */
+STATUS vn310_driver_set_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate, vn310_command_callback_t callback, void *context)
+{
+    if (state->baud_callback != NULL)
+    {
+        return ERROR;
+    }
+
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
+
+    vn310_builder_add_uint(&builder, SERIAL_BAUD_RATE_REGISTER);
+    vn310_builder_add_uint(&builder, baud_rate);
+
+    RETURN_ON_ERROR(_command_queue(state, command, &builder, true, _baud_rate_acknowledged, state));
+
+    state->pending_baud_rate = baud_rate;
+    state->baud_callback = callback;
+    state->baud_context = context;
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    return OK;
 }
 
 /**
@@ -299,48 +575,103 @@ STATUS vn310_driver_set_vectoranv_baud_rate(struct vn310_driver_state_t *state,
  */
 STATUS vn310_driver_set_uart_baud_rate(struct vn310_driver_state_t *state, unsigned int baud_rate)
 {
-	return driver_uart_set_baud_rate(&state->uart_state, baud_rate, (uint8_t *)state->assembled_message, UART_DMA_READ_BUF_SIZE);
+	RETURN_ON_ERROR(driver_uart_set_baud_rate(&state->uart_state, baud_rate, state->uart_state.config.rx_buf, UART_DMA_READ_BUF_SIZE));
+
+	state->baud_rate = baud_rate;
+
+	return OK;
 }
 
 
 /**
  * @brief Sets configuration for the VectorNav sensor.
  *
- * Configures the VectorNav sensor driver using predefined settings. The function
- * defines output groups and their respective fields, and sends a formatted command
- * to the sensor. It configures time, IMU, and attitude data groups with specific 
- * field selections.
+ * Configures binary output register 1 so the sensor streams everything the applet
+ * needs in a single common group packet on port 1.
  * 
- * Output groups and fields:
- * - Time Group		: TimeGpsPps (0x0001)
- * - IMU Group		: Accel, AngularRate (0x0600)
- * - Attitude Group	: YawPitchRoll, Quaternion (0x0006)
+ * Common group fields (0x107A):
+ * - TimeGps		(bit 1)
+ * - YawPitchRoll	(bit 3)
+ * - Quaternion		(bit 4)
+ * - AngularRate	(bit 5)
+ * - Position		(bit 6)
+ * - InsStatus		(bit 12)
  *
  * @param state Pointer to the VectorNav driver state structure.
  * @return STATUS indicating the success or failure of the configuration operation.
  */
 STATUS vn310_driver_set_configuration_0(struct vn310_driver_state_t *state) 
 {
-    int output_group 	 	 = 0x0012;	// Group selection: 0b00000010010 0x0016: Time Group, IMU Group, Attitude Group
-    int group_field_1 		 = 0x0003;	// Time Group:	    0b00000000001 0x0001: TimeGpsPps
-    int group_field_4 		 = 0x0006;  // Attitude Group:  0b00000000110 0x0006: YawPitchRoll, Quaternion
+    return vn310_driver_set_binary_output_rate(state, state->binary_rate_divisor, NULL, NULL);
+}
+
+/**
+ * @brief Write binary output configuration 0 with a new rate divisor.
+ *
+ * The output rate is the IMU rate (VN310_IMU_RATE_HZ) divided by the divisor.
+ *
+ * @param state Pointer to the VectorNav driver state structure.
+ * @param rate_divisor IMU rate divisor.
+ * @param callback Called with the result, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the command was queued.
+ */
+STATUS vn310_driver_set_binary_output_rate(struct vn310_driver_state_t *state, uint16_t rate_divisor, vn310_command_callback_t callback, void *context)
+{
+    if (rate_divisor == 0)
+    {
+        return ERROR;
+    }
+
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
+
+    // Streaming on both ports lets the applet merge the two copies of each sample
+    uint8_t async_mode = state->config.sensor_config.binary_async_mode;
 
-    char command[64]; 
-    snprintf(command, sizeof(command), "%s%s,%d,%d,%d,%x,%x,%x*%s%s",
-		VECTORNAV_HEADER,
-		VECTORNAV_WRG_CMD,
-		BINARY_OUTPUT_REGISTER_1,
-		ASYNC_MODE_PORT_1,
-		RATE_DIVISOR_4,
-		output_group,
-		group_field_1,
-		group_field_4,
-		VECTORNAV_NO_CRC,
-		VECTORNAV_CRLF);
+    vn310_builder_add_uint(&builder, BINARY_OUTPUT_REGISTER_1);
+    vn310_builder_add_uint(&builder, (async_mode != ASYNC_MODE_NONE) ? async_mode : ASYNC_MODE_PORT_1);
+    vn310_builder_add_uint(&builder, rate_divisor);
+    vn310_builder_add_hex(&builder, VN310_BINARY_CONFIG0_GROUP, 2);
+    vn310_builder_add_hex(&builder, VN310_BINARY_CONFIG0_FIELDS, 4);
 
-    size_t command_size = strlen(command);
+    RETURN_ON_ERROR(_command_queue(state, command, &builder, false, callback, context));
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    state->binary_rate_divisor = rate_divisor;
+
+    return OK;
+}
+
+/**
+ * @brief Get the payload of a configuration 0 binary frame.
+ *
+ * The frame length and header are checked against configuration 0 and the CRC is
+ * verified before the payload is handed out. Running the CRC over everything after
+ * the sync byte, including the transmitted CRC, yields zero for an intact frame.
+ *
+ * @param frame The received binary frame.
+ * @param data Set to point at the payload inside the frame.
+ * @return STATUS OK if the frame is a valid configuration 0 packet.
+ */
+STATUS vn310_driver_get_configuration_0_data(const struct vn310_frame_t *frame, const struct vn310_driver_binout_config0_data_t **data)
+{
+    const uint8_t *bytes = (const uint8_t *)frame->data;
+
+    if (frame->size != VN310_BINARY_CONFIG0_SIZE ||
+        bytes[0] != VN310_BINARY_SYNC ||
+        bytes[1] != VN310_BINARY_CONFIG0_GROUP)
+    {
+        return ERROR;
+    }
+
+    if (!frame->checked && calculate_16_bit_crc((unsigned char *)&bytes[1], frame->size - 1) != 0)
+    {
+        return ERROR;
+    }
+
+    *data = (const struct vn310_driver_binout_config0_data_t *)&bytes[VN310_BINARY_CONFIG0_HEADER_SIZE];
+
+    return OK;
 }
 
 
@@ -355,18 +686,21 @@ STATUS vn310_driver_set_configuration_0(struct vn310_driver_state_t *state)
  */
 STATUS vn310_driver_set_asynchronous_output(struct vn310_driver_state_t *state, char const *setting)
 {
-    char command[64]; 
-    snprintf(command, sizeof(command), "%s%s,%d,%s*%s%s",
-		VECTORNAV_HEADER,
-		VECTORNAV_WRG_CMD,
-		ASYNC_DATA_OUTPUT_TYPE_REGISTER,
-		setting,
-		VECTORNAV_NO_CRC,
-		VECTORNAV_CRLF);
- 
-    size_t command_size = strlen(command);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
+
+    vn310_builder_add_uint(&builder, ASYNC_DATA_OUTPUT_TYPE_REGISTER);
+    vn310_builder_add_text(&builder, setting);
+
+    RETURN_ON_ERROR(_command_queue(state, command, &builder, false, NULL, NULL));
 
-    return vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    // Output type 0 turns the ASCII output off
+    if (strcmp(setting, "0") == 0)
+    {
+        state->ascii_rate_hz = 0;
+    }
+
+    return OK;
 }
 
 /**
@@ -419,6 +753,63 @@ unsigned short calculate_16_bit_crc(unsigned char data[], unsigned int length)
 	return crc;
 }
 
+/**
+ * @brief Verify the checksum of an ASCII message from the sensor.
+ *
+ * Both the 8-bit (two hex digit) and 16-bit (four hex digit) forms are accepted.
+ * Messages with the XX placeholder are rejected, since nothing was checked.
+ *
+ * @param message The message, starting with '$'.
+ * @param size Length of the message.
+ * @return STATUS OK if the checksum matches.
+ */
+STATUS vn310_driver_verify_checksum(const char *message, size_t size)
+{
+    const char *star = memchr(message, '*', size);
+
+    if (size < 4 || message[0] != '$' || star == NULL)
+    {
+        return ERROR;
+    }
+
+    size_t payload_size = (size_t)(star - message) - 1;
+    size_t digits = 0;
+    uint16_t received = 0;
+
+    for (const char *c = star + 1; c < message + size && digits < 5; c++, digits++)
+    {
+        uint8_t value;
+        if (*c >= '0' && *c <= '9')
+        {
+            value = (uint8_t)(*c - '0');
+        }
+        else if (*c >= 'A' && *c <= 'F')
+        {
+            value = (uint8_t)(*c - 'A' + 10);
+        }
+        else if (*c >= 'a' && *c <= 'f')
+        {
+            value = (uint8_t)(*c - 'a' + 10);
+        }
+        else
+        {
+            break;
+        }
+        received = (uint16_t)((received << 4) | value);
+    }
+
+    if (digits == 2)
+    {
+        return (calculate_8_bit_crc((unsigned char *)&message[1], payload_size) == received) ? OK : ERROR;
+    }
+    if (digits == 4)
+    {
+        return (calculate_16_bit_crc((unsigned char *)&message[1], payload_size) == received) ? OK : ERROR;
+    }
+
+    return ERROR;
+}
+
 /**
  * @brief Read the value of a register
  *
@@ -430,37 +821,53 @@ unsigned short calculate_16_bit_crc(unsigned char data[], unsigned int length)
  */
 STATUS vn310_driver_read_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id) 
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d*%s%s",VECTORNAV_HEADER,VECTORNAV_RRG_CMD, register_id, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
+    return vn310_driver_read_register_async(state, register_id, NULL, NULL);
+}
 
-    size_t command_size = strlen(command);
+/**
+ * @brief Read the value of a register and report it through a callback.
+ *
+ * @param state Pointer to the VectorNav driver state structure.
+ * @param register_id The ID of the register to be read.
+ * @param callback Called with the $VNRRG response, or an error status on timeout.
+ * @param context Passed to the callback.
+ * @return Status of the operation (success or failure).
+ */
+STATUS vn310_driver_read_register_async(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, vn310_command_callback_t callback, void *context)
+{
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_RRG_CMD);
 
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    vn310_builder_add_uint(&builder, register_id);
 
-    return status;
+    return _command_queue(state, command, &builder, false, callback, context);
 }
 
 /**
  * @brief Write data values to a specified register on the VN-310 device.
  *
  * This function sends a command to write data values to a specified register.
+ * Every value is written as its own field, so multi-value registers such as the
+ * antenna offset or baseline registers can be written from text, e.g. from the CLI.
  *
  * @param state Pointer to the VectorNav driver state structure.
  * @param register_id The ID of the register to be written to.
- * @param data Pointer to the data values to be written.
- * @param data_size Size of the data to be written.
+ * @param values The register fields, in register order.
+ * @param value_count Number of fields.
  * @return Status of the operation (success or failure).
  */
-STATUS vn310_driver_write_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, const uint8_t *data, size_t data_size) 
+STATUS vn310_driver_write_register(struct vn310_driver_state_t *state, enum vectornav_register_id register_id, const char *const values[], size_t value_count)
 {
-    char command[32 + 2 * data_size];
-
-    snprintf(command, sizeof(command), "%s%s,%d,%d*%s%s",VECTORNAV_HEADER, VECTORNAV_WRG_CMD, register_id, data[0], VECTORNAV_NO_CRC, VECTORNAV_CRLF);
-    size_t command_size = strlen(command);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRG_CMD);
 
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
+    vn310_builder_add_uint(&builder, register_id);
+    for (size_t i = 0; i < value_count; i++)
+    {
+        vn310_builder_add_text(&builder, values[i]);
+    }
 
-    return status;
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -472,15 +879,10 @@ STATUS vn310_driver_write_register(struct vn310_driver_state_t *state, enum vect
  * @return Status of the operation (success or failure).
  */
 STATUS vn310_driver_write_settings(struct vn310_driver_state_t *state) {
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_WRITE_SETTINGS_CMD);
 
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s*%s%s",VECTORNAV_HEADER,VECTORNAV_WRITE_SETTINGS_CMD, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
-
-    size_t command_size = strlen(command);
-
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
-    
-    return status;
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -493,18 +895,12 @@ STATUS vn310_driver_write_settings(struct vn310_driver_state_t *state) {
  */
 STATUS vn310_driver_output_pause(struct vn310_driver_state_t *state) 
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d*%s%s",
-		VECTORNAV_HEADER,
-		VECTORNAV_ASYNC_CMD, 
-		ASYNC_MODE_NONE, 
-		VECTORNAV_NO_CRC, 
-		VECTORNAV_CRLF);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_ASYNC_CMD);
 
-    size_t command_size = strlen(command);
+    vn310_builder_add_uint(&builder, ASYNC_MODE_NONE);
 
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
-    return status;
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -517,13 +913,12 @@ STATUS vn310_driver_output_pause(struct vn310_driver_state_t *state)
  */
 STATUS vn310_driver_output_enable_port_1(struct vn310_driver_state_t *state)
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d*%s%s",VECTORNAV_HEADER, VECTORNAV_ASYNC_CMD, ASYNC_MODE_PORT_1, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_ASYNC_CMD);
 
-    size_t command_size = strlen(command);
+    vn310_builder_add_uint(&builder, ASYNC_MODE_PORT_1);
 
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
-    return status;
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -537,14 +932,12 @@ STATUS vn310_driver_output_enable_port_1(struct vn310_driver_state_t *state)
  */
 STATUS vn310_driver_binary_output_poll(struct vn310_driver_state_t *state, uint8_t register_num) 
 {
-    char command[32];
-    snprintf(command, sizeof(command), "%s%s,%d*%s%s",VECTORNAV_HEADER ,VECTORNAV_BOM_CMD , register_num, VECTORNAV_NO_CRC, VECTORNAV_CRLF);
+    struct vn310_command_builder_t builder;
+    struct vn310_command_t *command = _command_begin(state, &builder, VECTORNAV_BOM_CMD);
 
-    size_t command_size = strlen(command);
+    vn310_builder_add_uint(&builder, register_num);
 
-    STATUS status = vn310_driver_send_byte(state, (uint8_t*)command, command_size);
-
-    return status;
+    return _command_queue(state, command, &builder, false, NULL, NULL);
 }
 
 /**
@@ -0,0 +1,279 @@
+/**
+ * @file vn310_frames.c
+ * @brief Implementation of the VN310 coordinate frame transforms.
+ *
+ * Satellite positions are tens of thousands of kilometres out, so the ECEF
+ * difference to the platform is taken in double; once rotated into NED and scaled
+ * to a unit line of sight, float is ample for the attitude rotation and the
+ * element path differences, which run on every element of every beam.
+ *
+ * The per-satellite loops read and write separate coordinate arrays through
+ * restrict pointers and contain no calls or branches, so the compiler can keep
+ * the site and attitude matrices in registers and vectorize across satellites.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <math.h>
+#include "vn310_frames.h"
+
+#define DEG_TO_RAD                  (M_PI / 180.0)
+
+/**
+ * @brief Convert a geodetic position to ECEF.
+ *
+ * @param latitude Latitude in degrees.
+ * @param longitude Longitude in degrees.
+ * @param altitude Altitude above the WGS84 ellipsoid in metres.
+ * @param ecef Output ECEF position in metres.
+ */
+void vn310_frames_lla_to_ecef(double latitude, double longitude, double altitude, double ecef[3])
+{
+    double sin_lat = sin(latitude * DEG_TO_RAD);
+    double cos_lat = cos(latitude * DEG_TO_RAD);
+    double sin_lon = sin(longitude * DEG_TO_RAD);
+    double cos_lon = cos(longitude * DEG_TO_RAD);
+
+    // Prime vertical radius of curvature
+    double radius = VN310_FRAMES_WGS84_A / sqrt(1.0 - VN310_FRAMES_WGS84_E2 * sin_lat * sin_lat);
+
+    ecef[0] = (radius + altitude) * cos_lat * cos_lon;
+    ecef[1] = (radius + altitude) * cos_lat * sin_lon;
+    ecef[2] = (radius * (1.0 - VN310_FRAMES_WGS84_E2) + altitude) * sin_lat;
+}
+
+/**
+ * @brief Convert geodetic positions to ECEF.
+ *
+ * @param latitude Latitudes in degrees.
+ * @param longitude Longitudes in degrees.
+ * @param altitude Altitudes above the WGS84 ellipsoid in metres.
+ * @param x Output ECEF x in metres.
+ * @param y Output ECEF y in metres.
+ * @param z Output ECEF z in metres.
+ * @param count Number of positions.
+ */
+void vn310_frames_lla_to_ecef_batch(const double *latitude, const double *longitude, const double *altitude,
+                                    double *x, double *y, double *z, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        double ecef[3];
+        vn310_frames_lla_to_ecef(latitude[i], longitude[i], altitude[i], ecef);
+        x[i] = ecef[0];
+        y[i] = ecef[1];
+        z[i] = ecef[2];
+    }
+}
+
+/**
+ * @brief Move the site to the platform position.
+ *
+ * The ECEF origin and rotation are only recomputed once the platform has moved by
+ * more than the site tolerance, so this may be called with every pose.
+ *
+ * @param site The site.
+ * @param latitude Platform latitude in degrees.
+ * @param longitude Platform longitude in degrees.
+ * @param altitude Platform altitude above the WGS84 ellipsoid in metres.
+ * @return true if the site was recomputed.
+ */
+bool vn310_frames_site_update(struct vn310_frames_site_t *site, double latitude, double longitude, double altitude)
+{
+    if (site->valid &&
+        fabs(latitude - site->latitude) < VN310_FRAMES_SITE_TOLERANCE_DEG &&
+        fabs(longitude - site->longitude) < VN310_FRAMES_SITE_TOLERANCE_DEG &&
+        fabs(altitude - site->altitude) < VN310_FRAMES_SITE_TOLERANCE_M)
+    {
+        return false;
+    }
+
+    double sin_lat = sin(latitude * DEG_TO_RAD);
+    double cos_lat = cos(latitude * DEG_TO_RAD);
+    double sin_lon = sin(longitude * DEG_TO_RAD);
+    double cos_lon = cos(longitude * DEG_TO_RAD);
+
+    site->ecef_to_ned[0][0] = -sin_lat * cos_lon;
+    site->ecef_to_ned[0][1] = -sin_lat * sin_lon;
+    site->ecef_to_ned[0][2] = cos_lat;
+    site->ecef_to_ned[1][0] = -sin_lon;
+    site->ecef_to_ned[1][1] = cos_lon;
+    site->ecef_to_ned[1][2] = 0.0;
+    site->ecef_to_ned[2][0] = -cos_lat * cos_lon;
+    site->ecef_to_ned[2][1] = -cos_lat * sin_lon;
+    site->ecef_to_ned[2][2] = -sin_lat;
+
+    vn310_frames_lla_to_ecef(latitude, longitude, altitude, site->origin_ecef);
+
+    site->latitude = latitude;
+    site->longitude = longitude;
+    site->altitude = altitude;
+    site->valid = true;
+    site->update_count++;
+
+    return true;
+}
+
+/**
+ * @brief Convert ECEF positions to NED relative to the site.
+ *
+ * @param site The site, updated at least once.
+ * @param x ECEF x in metres.
+ * @param y ECEF y in metres.
+ * @param z ECEF z in metres.
+ * @param n Output north in metres.
+ * @param e Output east in metres.
+ * @param d Output down in metres.
+ * @param count Number of positions.
+ */
+void vn310_frames_ecef_to_ned_batch(const struct vn310_frames_site_t *site, const double *x, const double *y, const double *z,
+                                    double *n, double *e, double *d, int count)
+{
+    const double (*r)[3] = site->ecef_to_ned;
+    const double ox = site->origin_ecef[0], oy = site->origin_ecef[1], oz = site->origin_ecef[2];
+    const double *restrict px = x, *restrict py = y, *restrict pz = z;
+    double *restrict pn = n, *restrict pe = e, *restrict pd = d;
+
+    for (int i = 0; i < count; i++)
+    {
+        double dx = px[i] - ox, dy = py[i] - oy, dz = pz[i] - oz;
+        pn[i] = r[0][0] * dx + r[0][1] * dy + r[0][2] * dz;
+        pe[i] = r[1][0] * dx + r[1][1] * dy;
+        pd[i] = r[2][0] * dx + r[2][1] * dy + r[2][2] * dz;
+    }
+}
+
+/**
+ * @brief Rotate NED vectors into the body frame.
+ *
+ * @param dcm Body to NED rotation.
+ * @param n North components.
+ * @param e East components.
+ * @param d Down components.
+ * @param bx Output body x components.
+ * @param by Output body y components.
+ * @param bz Output body z components.
+ * @param count Number of vectors.
+ */
+void vn310_frames_ned_to_body_batch(const struct vn310_dcm_t *dcm, const double *n, const double *e, const double *d,
+                                    double *bx, double *by, double *bz, int count)
+{
+    const struct vn310_dcm_t m = *dcm;
+    const double *restrict pn = n, *restrict pe = e, *restrict pd = d;
+    double *restrict px = bx, *restrict py = by, *restrict pz = bz;
+
+    // v_body = m^T * v_ned
+    for (int i = 0; i < count; i++)
+    {
+        px[i] = m.m[0][0] * pn[i] + m.m[1][0] * pe[i] + m.m[2][0] * pd[i];
+        py[i] = m.m[0][1] * pn[i] + m.m[1][1] * pe[i] + m.m[2][1] * pd[i];
+        pz[i] = m.m[0][2] * pn[i] + m.m[1][2] * pe[i] + m.m[2][2] * pd[i];
+    }
+}
+
+/**
+ * @brief Unit lines of sight in the body frame from ECEF positions.
+ *
+ * The pointing hot path: ECEF to NED, normalization and the attitude rotation in
+ * one pass over the satellites.
+ *
+ * @param site The site, updated at least once.
+ * @param dcm Body to NED rotation.
+ * @param x ECEF x in metres.
+ * @param y ECEF y in metres.
+ * @param z ECEF z in metres.
+ * @param los_x Output body x of the unit line of sight.
+ * @param los_y Output body y of the unit line of sight.
+ * @param los_z Output body z of the unit line of sight.
+ * @param range Output range in metres.
+ * @param count Number of positions.
+ */
+void vn310_frames_ecef_to_body_los_batch(const struct vn310_frames_site_t *site, const struct vn310_dcm_t *dcm,
+                                         const double *x, const double *y, const double *z,
+                                         float *los_x, float *los_y, float *los_z, float *range, int count)
+{
+    const double (*r)[3] = site->ecef_to_ned;
+    const double ox = site->origin_ecef[0], oy = site->origin_ecef[1], oz = site->origin_ecef[2];
+    const struct vn310_dcm_t m = *dcm;
+    const double *restrict px = x, *restrict py = y, *restrict pz = z;
+    float *restrict lx = los_x, *restrict ly = los_y, *restrict lz = los_z, *restrict pr = range;
+
+    for (int i = 0; i < count; i++)
+    {
+        double dx = px[i] - ox, dy = py[i] - oy, dz = pz[i] - oz;
+        double dn = r[0][0] * dx + r[0][1] * dy + r[0][2] * dz;
+        double de = r[1][0] * dx + r[1][1] * dy;
+        double dd = r[2][0] * dx + r[2][1] * dy + r[2][2] * dz;
+        double distance = sqrt(dn * dn + de * de + dd * dd);
+
+        float scale = (float)(1.0 / distance);
+        float n = (float)dn * scale, e = (float)de * scale, d = (float)dd * scale;
+
+        lx[i] = m.m[0][0] * n + m.m[1][0] * e + m.m[2][0] * d;
+        ly[i] = m.m[0][1] * n + m.m[1][1] * e + m.m[2][1] * d;
+        lz[i] = m.m[0][2] * n + m.m[1][2] * e + m.m[2][2] * d;
+        pr[i] = (float)distance;
+    }
+}
+
+/**
+ * @brief Element positions of a tile in the array frame.
+ *
+ * Lays the tile out with phased_array_calc_patch_pose and converts the patch
+ * positions to the body x/y plane, element index y * nx + x.
+ *
+ * @param tile_col Column of the tile in the array.
+ * @param tile_row Row of the tile in the array.
+ * @param nx Number of elements in the x direction.
+ * @param ny Number of elements in the y direction.
+ * @param spacing Element spacing in metres.
+ * @param patches Scratch of nx * ny patches.
+ * @param element_x Output element x in metres.
+ * @param element_y Output element y in metres.
+ * @return OK if the layout was calculated.
+ */
+STATUS vn310_frames_tile_offsets(uint16_t tile_col, uint16_t tile_row, int nx, int ny, double spacing,
+                                 struct algorithm_EW_patch_t *patches, float *element_x, float *element_y)
+{
+    if (nx <= 0 || ny <= 0)
+    {
+        return ERROR;
+    }
+
+    RETURN_ON_ERROR(phased_array_calc_patch_pose(tile_col, tile_row, nx, ny, spacing, patches));
+
+    for (int i = 0; i < nx * ny; i++)
+    {
+        element_x[i] = (float)patches[i].pose.t_x;
+        element_y[i] = (float)patches[i].pose.t_y;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Path length of each element towards a line of sight.
+ *
+ * The distance each element is ahead of the array origin along the line of sight;
+ * the steering phase of an element is 2 pi path / wavelength.
+ *
+ * @param element_x Element x in metres.
+ * @param element_y Element y in metres.
+ * @param los_body Unit line of sight in the body frame.
+ * @param path Output path lengths in metres.
+ * @param count Number of elements.
+ */
+void vn310_frames_path_difference_batch(const float *element_x, const float *element_y, const float los_body[3],
+                                        float *path, int count)
+{
+    const float lx = los_body[0], ly = los_body[1];
+    const float *restrict px = element_x, *restrict py = element_y;
+    float *restrict out = path;
+
+    // Elements lie in the body x/y plane
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = px[i] * lx + py[i] * ly;
+    }
+}
@@ -0,0 +1,241 @@
+/**
+ * @file vn310_handover.c
+ * @brief Implementation of the satellite look-angle cache and handover scheduler.
+ *
+ * A LEO satellite's ECEF position is smooth on the scale of tens of seconds, so
+ * cubic Hermite interpolation between SGP4 states 30 s apart stays within a metre,
+ * far inside a beamwidth at any slant range. Knots advance one interval at a time,
+ * so steady tracking runs one SGP4 batch per interval; a jump in time restarts the
+ * cache from the new time.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include "vn310_handover.h"
+
+#define RAD_TO_DEG_F                (180.0f / (float)M_PI)
+#define SECONDS_PER_DAY             86400.0
+
+/**
+ * @brief Initialize the scheduler for a set of candidate satellites.
+ *
+ * @param handover The scheduler.
+ * @param config The configuration. A zero knot interval and VN310_HANDOVER_USE_DEFAULT
+ *               angle limits take the defaults.
+ * @param orbits The candidates, must outlive the scheduler.
+ * @param count Number of candidates.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_handover_init(struct vn310_handover_t *handover, const struct vn310_handover_config_t *config,
+                           const struct vn310_orbit_t *orbits, int count)
+{
+    if (count < 0 || count > VN310_HANDOVER_MAX_SATELLITES || (count > 0 && orbits == NULL))
+    {
+        return ERROR;
+    }
+
+    memset(handover, 0, sizeof(*handover));
+    handover->config = *config;
+    handover->orbits = orbits;
+    handover->count = count;
+    handover->serving = VN310_HANDOVER_NONE;
+
+    if (handover->config.knot_interval_s <= 0.0)
+    {
+        handover->config.knot_interval_s = VN310_HANDOVER_KNOT_INTERVAL_S;
+    }
+    if (isnan(handover->config.max_scan_deg))
+    {
+        handover->config.max_scan_deg = VN310_HANDOVER_MAX_SCAN_DEG;
+    }
+    if (isnan(handover->config.min_elevation_deg))
+    {
+        handover->config.min_elevation_deg = VN310_HANDOVER_MIN_ELEVATION_DEG;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Propagate every candidate to a knot.
+ */
+static void _propagate_knot(struct vn310_handover_t *handover, double time_s, double p[3][VN310_HANDOVER_MAX_SATELLITES],
+                            double v[3][VN310_HANDOVER_MAX_SATELLITES], bool *valid)
+{
+    double jd = handover->config.epoch_jd + time_s / SECONDS_PER_DAY;
+
+    vn310_orbit_propagate_batch(handover->orbits, handover->count, jd, p[0], p[1], p[2], v[0], v[1], v[2], valid);
+    handover->propagation_count++;
+}
+
+/**
+ * @brief Move the knots so that they bracket the time.
+ */
+static void _advance_knots(struct vn310_handover_t *handover, double time_s)
+{
+    const double interval = handover->config.knot_interval_s;
+
+    if (handover->knots_valid && time_s >= handover->knot_time_s + interval &&
+        time_s < handover->knot_time_s + 2.0 * interval)
+    {
+        memcpy(handover->p0, handover->p1, sizeof(handover->p0));
+        memcpy(handover->v0, handover->v1, sizeof(handover->v0));
+        memcpy(handover->valid0, handover->valid1, sizeof(handover->valid0));
+        handover->knot_time_s += interval;
+        _propagate_knot(handover, handover->knot_time_s + interval, handover->p1, handover->v1, handover->valid1);
+    }
+    else if (!handover->knots_valid || time_s < handover->knot_time_s || time_s >= handover->knot_time_s + interval)
+    {
+        handover->knot_time_s = time_s;
+        _propagate_knot(handover, time_s, handover->p0, handover->v0, handover->valid0);
+        _propagate_knot(handover, time_s + interval, handover->p1, handover->v1, handover->valid1);
+        handover->knots_valid = true;
+    }
+}
+
+/**
+ * @brief Interpolate the ECEF positions of every candidate.
+ *
+ * @param handover The scheduler.
+ * @param time_s Seconds since the configured epoch.
+ * @param x Output ECEF x in metres.
+ * @param y Output ECEF y in metres.
+ * @param z Output ECEF z in metres.
+ * @param valid Output per candidate, false if it could not be propagated.
+ * @return OK if the positions were interpolated.
+ */
+STATUS vn310_handover_interpolate(struct vn310_handover_t *handover, double time_s,
+                                  double *x, double *y, double *z, bool *valid)
+{
+    if (handover->count == 0)
+    {
+        return ERROR;
+    }
+
+    _advance_knots(handover, time_s);
+
+    const double h = handover->config.knot_interval_s;
+    const double s = (time_s - handover->knot_time_s) / h;
+    const double s2 = s * s, s3 = s2 * s;
+    const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    const double h10 = (s3 - 2.0 * s2 + s) * h;
+    const double h01 = -2.0 * s3 + 3.0 * s2;
+    const double h11 = (s3 - s2) * h;
+    double *out[3] = {x, y, z};
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const double *restrict p0 = handover->p0[axis], *restrict v0 = handover->v0[axis];
+        const double *restrict p1 = handover->p1[axis], *restrict v1 = handover->v1[axis];
+        double *restrict p = out[axis];
+
+        for (int i = 0; i < handover->count; i++)
+        {
+            p[i] = h00 * p0[i] + h10 * v0[i] + h01 * p1[i] + h11 * v1[i];
+        }
+    }
+
+    for (int i = 0; i < handover->count; i++)
+    {
+        valid[i] = handover->valid0[i] && handover->valid1[i];
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Update the look angles and pick the serving satellite.
+ *
+ * Call at the pointing rate with the pose predicted for the actuation time.
+ *
+ * @param handover The scheduler.
+ * @param time_s Seconds since the configured epoch.
+ * @param pose The platform pose.
+ * @param target Output pointing target.
+ * @return OK if a satellite is eligible, ERROR if none is.
+ */
+STATUS vn310_handover_update(struct vn310_handover_t *handover, double time_s, const struct vn310_pose_t *pose,
+                             struct vn310_handover_target_t *target)
+{
+    bool valid[VN310_HANDOVER_MAX_SATELLITES];
+    float los_x[VN310_HANDOVER_MAX_SATELLITES];
+    float los_y[VN310_HANDOVER_MAX_SATELLITES];
+    float los_z[VN310_HANDOVER_MAX_SATELLITES];
+    struct vn310_dcm_t dcm;
+    const int count = handover->count;
+
+    memset(target, 0, sizeof(*target));
+    target->satellite = VN310_HANDOVER_NONE;
+
+    RETURN_ON_ERROR(vn310_handover_interpolate(handover, time_s, handover->position[0], handover->position[1],
+                                               handover->position[2], valid));
+
+    if (vn310_attitude_quaternion_valid(pose->quaternion))
+    {
+        vn310_attitude_quaternion_to_dcm(pose->quaternion, &dcm);
+    }
+    else
+    {
+        vn310_attitude_ypr_to_dcm(pose->yaw, pose->pitch, pose->roll, &dcm);
+    }
+
+    vn310_frames_site_update(&handover->site, pose->latitude, pose->longitude, pose->altitude);
+    vn310_frames_ecef_to_body_los_batch(&handover->site, &dcm, handover->position[0], handover->position[1],
+                                        handover->position[2], los_x, los_y, los_z, handover->range, count);
+
+    int best = VN310_HANDOVER_NONE;
+    bool serving_eligible = false;
+
+    for (int i = 0; i < count; i++)
+    {
+        // Down component of the line of sight in NED, for the elevation
+        float down = dcm.m[2][0] * los_x[i] + dcm.m[2][1] * los_y[i] + dcm.m[2][2] * los_z[i];
+        float phi = atan2f(los_y[i], los_x[i]) * RAD_TO_DEG_F;
+
+        handover->theta[i] = acosf(fminf(fmaxf(-los_z[i], -1.0f), 1.0f)) * RAD_TO_DEG_F;
+        handover->phi[i] = (phi < 0.0f) ? phi + 360.0f : phi;
+        handover->elevation[i] = asinf(fminf(fmaxf(-down, -1.0f), 1.0f)) * RAD_TO_DEG_F;
+
+        bool eligible = valid[i] && handover->theta[i] <= handover->config.max_scan_deg &&
+                        handover->elevation[i] >= handover->config.min_elevation_deg;
+
+        if (eligible && i == handover->serving)
+        {
+            serving_eligible = true;
+        }
+        if (eligible && (best == VN310_HANDOVER_NONE || handover->theta[i] < handover->theta[best]))
+        {
+            best = i;
+        }
+    }
+
+    handover->update_count++;
+
+    if (!serving_eligible)
+    {
+        if (best != VN310_HANDOVER_NONE && handover->serving != VN310_HANDOVER_NONE)
+        {
+            handover->handover_count++;
+            target->handover = true;
+        }
+        handover->serving = best;
+    }
+
+    if (handover->serving == VN310_HANDOVER_NONE)
+    {
+        handover->outage_count++;
+        return ERROR;
+    }
+
+    int serving = handover->serving;
+    target->satellite = serving;
+    target->theta = handover->theta[serving];
+    target->phi = handover->phi[serving];
+    target->elevation = handover->elevation[serving];
+    target->range = handover->range[serving];
+
+    return OK;
+}
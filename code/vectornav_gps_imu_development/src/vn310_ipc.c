@@ -0,0 +1,243 @@
+/**
+ * @file vn310_ipc.c
+ * @brief Implementation of the VN310 dual-core frame hand-off.
+ *
+ * The M4 receive path replaces vn310_driver_eventcallback: each DMA idle-line event
+ * is framed straight into a slot of the shared ring, its checksum verified, and the
+ * slot committed with release ordering. Frames that fail are never committed, so
+ * the M7 only ever sees checked frames and skips the CRC when it parses them.
+ *
+ * After each commit the M4 takes and immediately releases the doorbell semaphore.
+ * The release raises the HSEM interrupt on the M7, which may already be draining;
+ * notifications are not counted, the M7 simply drains every ring until empty.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_ipc.h"
+#include "vn310_driver.h"
+#include "vn310_trace.h"
+#include "bsp_delay.h"
+
+#if defined(__arm__)
+#define HSEM_BASE           0x58026400u
+#define HSEM_R(id)          (*(volatile uint32_t *)(HSEM_BASE + 0x000u + 4u * (id)))
+#define HSEM_RLR(id)        (*(volatile uint32_t *)(HSEM_BASE + 0x080u + 4u * (id)))
+#define HSEM_C1IER          (*(volatile uint32_t *)(HSEM_BASE + 0x100u))
+#define HSEM_C1ICR          (*(volatile uint32_t *)(HSEM_BASE + 0x104u))
+#define HSEM_LOCK           (1u << 31)
+#define HSEM_COREID_CM4     1u
+#define HSEM_COREID_SHIFT   8u
+#define HSEM_BIT            (1u << VN310_IPC_HSEM_ID)
+
+// Set by the M7 semaphore interrupt, cleared by vn310_ipc_wait
+static volatile bool doorbell_pending;
+#else
+#include <errno.h>
+#include <time.h>
+#endif
+
+/**
+ * @brief Check the checksum of a framed message.
+ */
+static STATUS _checksum_valid(enum vectornav_msg_type type, const char *data, uint16_t size)
+{
+    if (type == MSG_BINARY)
+    {
+        if (size != VN310_BINARY_CONFIG0_SIZE)
+        {
+            return ERROR;
+        }
+        return (calculate_16_bit_crc((unsigned char *)&data[1], size - 1) == 0) ? OK : ERROR;
+    }
+
+    return vn310_driver_verify_checksum(data, size);
+}
+
+/**
+ * @brief Ring the M7 doorbell (M4 side).
+ */
+static void _notify(struct vn310_ipc_shared_t *shared)
+{
+    shared->notify_count++;
+
+#if defined(__arm__)
+    // One-step lock, then release: the release raises the M7 interrupt
+    if (HSEM_RLR(VN310_IPC_HSEM_ID) == (HSEM_LOCK | (HSEM_COREID_CM4 << HSEM_COREID_SHIFT)))
+    {
+        HSEM_R(VN310_IPC_HSEM_ID) = HSEM_COREID_CM4 << HSEM_COREID_SHIFT;
+    }
+#else
+    pthread_mutex_lock(&shared->doorbell_lock);
+    shared->doorbell_rung = true;
+    pthread_cond_signal(&shared->doorbell);
+    pthread_mutex_unlock(&shared->doorbell_lock);
+#endif
+}
+
+/**
+ * @brief Initialize the shared block (M7 side).
+ *
+ * Must be called before the M4 is released from its boot hold, and enables the
+ * semaphore interrupt on the M7. The M4 waits for vn310_ipc_ready.
+ *
+ * @param shared The shared block.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_ipc_init(struct vn310_ipc_shared_t *shared)
+{
+    memset(shared, 0, sizeof(*shared));
+
+    for (int source = 0; source < VN310_MERGE_MAX_SOURCES; source++)
+    {
+        RETURN_ON_ERROR(vn310_mailbox_init(&shared->rings[source]));
+    }
+
+#if defined(__arm__)
+    doorbell_pending = false;
+    HSEM_C1ICR = HSEM_BIT;
+    HSEM_C1IER |= HSEM_BIT;
+#else
+    pthread_mutex_init(&shared->doorbell_lock, NULL);
+    pthread_cond_init(&shared->doorbell, NULL);
+#endif
+
+    __atomic_store_n(&shared->ready, VN310_IPC_READY_MAGIC, __ATOMIC_RELEASE);
+
+    return OK;
+}
+
+/**
+ * @brief Check that the M7 has set up the shared block (M4 side).
+ *
+ * @param shared The shared block.
+ * @return true once the rings may be written.
+ */
+bool vn310_ipc_ready(const struct vn310_ipc_shared_t *shared)
+{
+    return __atomic_load_n(&shared->ready, __ATOMIC_ACQUIRE) == VN310_IPC_READY_MAGIC;
+}
+
+/**
+ * @brief Frame, check and hand over one received message (M4 side).
+ *
+ * Called from the M4 UART DMA idle-line callback of the input. If the ring is
+ * full the message is dropped and counted as an overrun by the ring.
+ *
+ * @param shared The shared block.
+ * @param source The input the message arrived on, enum vn310_merge_source.
+ * @param rx_buf The UART DMA receive buffer.
+ * @param message_size The size of the received message.
+ * @return OK if the message was committed to the ring.
+ */
+STATUS vn310_ipc_receive(struct vn310_ipc_shared_t *shared, uint8_t source, char *rx_buf, uint16_t message_size)
+{
+    uint32_t time_dma = vn310_trace_now();
+
+    if (source >= VN310_MERGE_MAX_SOURCES || message_size == 0 || message_size >= UART_DMA_READ_BUF_SIZE)
+    {
+        return ERROR;
+    }
+
+    struct vn310_mailbox_t *ring = &shared->rings[source];
+    struct vn310_frame_t *frame = vn310_mailbox_reserve(ring);
+
+    if (NULL != frame)
+    {
+        enum vectornav_msg_type type = vn310_driver_message_check(rx_buf, frame->data, message_size, UART_DMA_READ_BUF_SIZE);
+
+        if (MSG_UNKNOWN == type)
+        {
+            shared->unknown_count++;
+        }
+        else if (_checksum_valid(type, frame->data, message_size) != OK)
+        {
+            shared->checksum_failed_count++;
+        }
+        else
+        {
+            frame->type = type;
+            frame->size = message_size;
+            frame->checked = true;
+            frame->time_dma = time_dma;
+            frame->time_ready = vn310_trace_now();
+            vn310_mailbox_commit(ring);
+            shared->received_count++;
+            _notify(shared);
+            return OK;
+        }
+    }
+
+    memset(rx_buf, 0, UART_DMA_READ_BUF_SIZE);
+
+    return ERROR;
+}
+
+/**
+ * @brief Wait for the M4 to commit frames (M7 side).
+ *
+ * Returns straight away if frames were committed since the last call. Frames may
+ * also be waiting after a timeout, so drain the rings either way.
+ *
+ * @param shared The shared block.
+ * @param timeout_ms Longest time to wait.
+ * @return true if the doorbell rang, false on timeout.
+ */
+bool vn310_ipc_wait(struct vn310_ipc_shared_t *shared, uint32_t timeout_ms)
+{
+#if defined(__arm__)
+    (void)shared;
+    uint32_t start_ms = bsp_delay_get_tick_ms();
+
+    while (!doorbell_pending && (bsp_delay_get_tick_ms() - start_ms) < timeout_ms)
+    {
+        __asm volatile ("wfi");
+    }
+
+    bool rung = doorbell_pending;
+    doorbell_pending = false;
+    return rung;
+#else
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000u;
+    deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&shared->doorbell_lock);
+    while (!shared->doorbell_rung)
+    {
+        if (pthread_cond_timedwait(&shared->doorbell, &shared->doorbell_lock, &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+    }
+    bool rung = shared->doorbell_rung;
+    shared->doorbell_rung = false;
+    pthread_mutex_unlock(&shared->doorbell_lock);
+
+    return rung;
+#endif
+}
+
+#if defined(__arm__)
+/**
+ * @brief HSEM1 interrupt handler body (M7 side).
+ *
+ * Call from HSEM1_IRQHandler.
+ *
+ * @param shared The shared block.
+ */
+void vn310_ipc_irq_handler(struct vn310_ipc_shared_t *shared)
+{
+    (void)shared;
+    HSEM_C1ICR = HSEM_BIT;
+    doorbell_pending = true;
+}
+#endif
@@ -0,0 +1,354 @@
+/**
+ * @file vn310_link.c
+ * @brief Implementation of VN310 link rate negotiation.
+ *
+ * The link is sized for the outputs rather than fixed: the required byte rate is
+ * compared against each standard baud rate at VN310_LINK_MAX_UTILIZATION_PERCENT,
+ * and the lowest one that fits is used. Lower baud rates tolerate more clock error
+ * and cable length, so there is no benefit in running faster than needed.
+ *
+ * The negotiation is ordered so the sensor never sends more than the link carries.
+ * When the baud rate goes down the output rates are lowered first, when it goes up
+ * they are raised last. The baud rate change is a barrier command, so no other
+ * command is on the wire while the two ends switch, and the local UART switches
+ * only once the sensor has acknowledged. The new link is then proved by reading
+ * the baud rate register back with a verified checksum. If the acknowledgement is
+ * lost the new baud rate is tried anyway, and if the probe fails the previous baud
+ * rate is restored and probed.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "vn310_link.h"
+#include "vn310_driver.h"
+
+static const unsigned int supported_baud_rates[] = {
+    9600, 19200, 38400, 57600, 115200, 128000, 230400, 460800, 921600
+};
+
+static const uint8_t ascii_rates_hz[] = { 1, 2, 4, 5, 10, 20, 25, 40, 50, 100, 200 };
+
+#define ARRAY_COUNT(array)  (sizeof(array) / sizeof((array)[0]))
+
+/**
+ * @brief Bytes per second needed by the binary and ASCII outputs.
+ *
+ * @param binary_size Size of one binary packet, including sync and CRC.
+ * @param binary_rate_hz Binary output rate, 0 if off.
+ * @param ascii_size Size of one ASCII message, including CRLF.
+ * @param ascii_rate_hz ASCII output rate, 0 if off.
+ * @return Required bytes per second.
+ */
+uint32_t vn310_link_required_bytes_per_s(uint32_t binary_size, uint32_t binary_rate_hz, uint32_t ascii_size, uint32_t ascii_rate_hz)
+{
+    return (binary_size * binary_rate_hz) + (ascii_size * ascii_rate_hz);
+}
+
+/**
+ * @brief Select the lowest supported baud rate that carries a byte rate.
+ *
+ * @param bytes_per_s Required bytes per second.
+ * @param max_utilization_percent Highest acceptable share of the line rate.
+ * @return The baud rate, or 0 if no supported baud rate is fast enough.
+ */
+unsigned int vn310_link_select_baud(uint32_t bytes_per_s, uint8_t max_utilization_percent)
+{
+    uint64_t required_bits = (uint64_t)bytes_per_s * VN310_LINK_BITS_PER_BYTE * 100u;
+
+    for (size_t i = 0; i < ARRAY_COUNT(supported_baud_rates); i++)
+    {
+        if (required_bits <= (uint64_t)supported_baud_rates[i] * max_utilization_percent)
+        {
+            return supported_baud_rates[i];
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check a baud rate is one the VN310 supports.
+ */
+bool vn310_link_baud_supported(unsigned int baud_rate)
+{
+    for (size_t i = 0; i < ARRAY_COUNT(supported_baud_rates); i++)
+    {
+        if (supported_baud_rates[i] == baud_rate)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check a rate is one the asynchronous data output frequency register accepts.
+ */
+bool vn310_link_ascii_rate_valid(uint32_t rate_hz)
+{
+    for (size_t i = 0; i < ARRAY_COUNT(ascii_rates_hz); i++)
+    {
+        if (ascii_rates_hz[i] == rate_hz)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get the IMU rate divisor for a binary output rate.
+ *
+ * @param rate_hz The binary output rate.
+ * @param divisor The divisor.
+ * @return STATUS ERROR if the rate is not VN310_IMU_RATE_HZ divided by an integer.
+ */
+STATUS vn310_link_divisor_for_rate(uint32_t rate_hz, uint16_t *divisor)
+{
+    if (rate_hz == 0 || rate_hz > VN310_IMU_RATE_HZ || (VN310_IMU_RATE_HZ % rate_hz) != 0)
+    {
+        return ERROR;
+    }
+
+    *divisor = (uint16_t)(VN310_IMU_RATE_HZ / rate_hz);
+
+    return OK;
+}
+
+/**
+ * @brief Finish the negotiation and report the baud rate the link is running at.
+ */
+static void _finish(struct vn310_link_t *link, STATUS status)
+{
+    vn310_link_callback_t callback = link->callback;
+
+    link->phase = LINK_PHASE_IDLE;
+    link->callback = NULL;
+
+    if (status == OK)
+    {
+        link->negotiated_count++;
+    }
+    else
+    {
+        link->failed_count++;
+    }
+
+    if (callback != NULL)
+    {
+        callback(link->context, status, link->driver->baud_rate);
+    }
+}
+
+/**
+ * @brief Check a baud rate register response is intact and matches the local UART.
+ *
+ * The response is $VNRRG,05,<baud>*<checksum>.
+ */
+static bool _probe_valid(const struct vn310_link_t *link, STATUS status, const char *response)
+{
+    if (status != OK || response == NULL)
+    {
+        return false;
+    }
+
+    size_t size = strcspn(response, "\r\n");
+    if (vn310_driver_verify_checksum(response, size) != OK)
+    {
+        return false;
+    }
+
+    const char *value = strchr(response, ',');
+    value = (value != NULL) ? strchr(value + 1, ',') : NULL;
+    if (value == NULL)
+    {
+        return false;
+    }
+
+    return strtoul(value + 1, NULL, 10) == link->driver->baud_rate;
+}
+
+static void _step(void *context, STATUS status, const char *response);
+
+/**
+ * @brief Record the result of the ASCII rate change for the binary rate step.
+ */
+static void _ascii_rate_done(void *context, STATUS status, const char *response)
+{
+    struct vn310_link_t *link = context;
+    (void)response;
+
+    if (status != OK)
+    {
+        link->ascii_rate_failed = true;
+    }
+}
+
+/**
+ * @brief Queue the output rate changes, completing through _step.
+ *
+ * The ASCII rate is queued first so the callback on the binary rate command
+ * only runs once both have been answered, and sees the ASCII result.
+ */
+static STATUS _apply_rates(struct vn310_link_t *link)
+{
+    struct vn310_driver_state_t *driver = link->driver;
+
+    link->rates_applied = true;
+    link->ascii_rate_failed = false;
+
+    // Written even when 0, so ASCII output left on does not exceed the budget
+    RETURN_ON_ERROR(vn310_driver_set_output_data_freq(driver, (uint8_t)link->target_ascii_hz, _ascii_rate_done, link));
+
+    return vn310_driver_set_binary_output_rate(driver, link->target_divisor, _step, link);
+}
+
+static STATUS _probe(struct vn310_link_t *link, enum vn310_link_phase phase)
+{
+    link->phase = phase;
+
+    return vn310_driver_read_register_async(link->driver, SERIAL_BAUD_RATE_REGISTER, _step, link);
+}
+
+/**
+ * @brief Advance the negotiation as each command completes.
+ */
+static void _step(void *context, STATUS status, const char *response)
+{
+    struct vn310_link_t *link = context;
+    struct vn310_driver_state_t *driver = link->driver;
+    STATUS next = OK;
+
+    switch (link->phase)
+    {
+        case LINK_PHASE_LOWER_RATE:
+            // A lower baud rate cannot carry an ASCII rate the sensor kept
+            if (status != OK || link->ascii_rate_failed)
+            {
+                _finish(link, ERROR);
+                return;
+            }
+            link->phase = LINK_PHASE_SWITCH_BAUD;
+            next = vn310_driver_set_baud_rate(driver, link->target_baud, _step, link);
+            break;
+
+        case LINK_PHASE_SWITCH_BAUD:
+            // Without an acknowledgement the sensor may still have switched, so try the new rate
+            if (status != OK)
+            {
+                vn310_driver_set_uart_baud_rate(driver, link->target_baud);
+            }
+            next = _probe(link, LINK_PHASE_PROBE);
+            break;
+
+        case LINK_PHASE_PROBE:
+            if (_probe_valid(link, status, response))
+            {
+                if (link->rates_applied)
+                {
+                    _finish(link, OK);
+                    return;
+                }
+                link->phase = LINK_PHASE_RAISE_RATE;
+                next = _apply_rates(link);
+                break;
+            }
+            vn310_driver_set_uart_baud_rate(driver, link->previous_baud);
+            next = _probe(link, LINK_PHASE_PROBE_PREVIOUS);
+            break;
+
+        case LINK_PHASE_PROBE_PREVIOUS:
+            if (_probe_valid(link, status, response))
+            {
+                link->recovered_count++;
+            }
+            _finish(link, ERROR);
+            return;
+
+        case LINK_PHASE_RAISE_RATE:
+            _finish(link, (status == OK && !link->ascii_rate_failed) ? OK : ERROR);
+            return;
+
+        default:
+            return;
+    }
+
+    if (next != OK)
+    {
+        _finish(link, ERROR);
+    }
+}
+
+/**
+ * @brief Size the link for new output rates and switch to it.
+ *
+ * The binary output uses configuration 0. Completes through the callback with
+ * the baud rate the link ended up on, which on failure is the previous rate if
+ * the sensor could still be reached there.
+ *
+ * @param state Pointer to the VectorNav driver state structure.
+ * @param binary_rate_hz Binary output rate, VN310_IMU_RATE_HZ divided by an integer.
+ * @param ascii_rate_hz ASCII output rate, 0 if off.
+ * @param callback Called once the negotiation completes, may be NULL.
+ * @param context Passed to the callback.
+ * @return STATUS OK if the negotiation started, ERROR if the rates are invalid,
+ *         no baud rate carries them, or a negotiation is already running.
+ */
+STATUS vn310_link_negotiate(struct vn310_driver_state_t *state, uint32_t binary_rate_hz, uint32_t ascii_rate_hz, vn310_link_callback_t callback, void *context)
+{
+    struct vn310_link_t *link = &state->link;
+    uint16_t divisor;
+
+    if (link->phase != LINK_PHASE_IDLE)
+    {
+        return ERROR;
+    }
+    RETURN_ON_ERROR(vn310_link_divisor_for_rate(binary_rate_hz, &divisor));
+    if (ascii_rate_hz != 0 && !vn310_link_ascii_rate_valid(ascii_rate_hz))
+    {
+        return ERROR;
+    }
+
+    uint32_t required = vn310_link_required_bytes_per_s(VN310_BINARY_CONFIG0_SIZE, binary_rate_hz,
+                                                        VN310_LINK_ASCII_INS_SIZE, ascii_rate_hz);
+    unsigned int target = vn310_link_select_baud(required, VN310_LINK_MAX_UTILIZATION_PERCENT);
+    if (target == 0)
+    {
+        return ERROR;
+    }
+
+    link->driver = state;
+    link->previous_baud = state->baud_rate;
+    link->target_baud = target;
+    link->target_divisor = divisor;
+    link->target_ascii_hz = (uint16_t)ascii_rate_hz;
+    link->required_bytes_per_s = required;
+    link->rates_applied = false;
+    link->callback = callback;
+    link->context = context;
+
+    STATUS status;
+    if (target < state->baud_rate)
+    {
+        link->phase = LINK_PHASE_LOWER_RATE;
+        status = _apply_rates(link);
+    }
+    else
+    {
+        link->phase = LINK_PHASE_SWITCH_BAUD;
+        status = vn310_driver_set_baud_rate(state, target, _step, link);
+    }
+
+    if (status != OK)
+    {
+        link->phase = LINK_PHASE_IDLE;
+        link->callback = NULL;
+    }
+
+    return status;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file vn310_log.c
+ * @brief Implementation of the VN310 binary log.
+ *
+ * The RAM blocks form a single-producer/single-consumer ring, in the same way as
+ * the frame mailbox: the applet fills the block at the head and publishes it by
+ * advancing the head with release ordering, the storage task writes out blocks
+ * from the tail. Appending is a bounded copy into RAM. If storage falls behind
+ * and every block is waiting to be written, new records are dropped and counted
+ * rather than waiting.
+ *
+ * Each record carries its own sync byte, length and CRC, so a reader can resume
+ * after a torn block or a corrupted record.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_log.h"
+#include "vn310_driver.h"
+
+#define RECORD_SIZE(length)     (VN310_LOG_HEADER_SIZE + (length) + VN310_LOG_CRC_SIZE)
+
+/**
+ * @brief Initialize the log, disabled.
+ *
+ * @param log The log state.
+ * @param write Storage sink for full blocks.
+ * @param context Passed to the sink.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_log_init(struct vn310_log_t *log, vn310_log_write_t write, void *context)
+{
+    memset(log, 0, sizeof(*log));
+    log->write = write;
+    log->context = context;
+
+    return OK;
+}
+
+/**
+ * @brief Pad the block being filled and hand it to the storage task.
+ */
+static void _commit_block(struct vn310_log_t *log)
+{
+    uint8_t *block = log->blocks[log->head % VN310_LOG_BLOCK_COUNT].data;
+
+    memset(&block[log->fill], VN310_LOG_PAD, VN310_LOG_BLOCK_SIZE - log->fill);
+    log->fill = 0;
+    __atomic_store_n(&log->head, log->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Append a record (applet side).
+ *
+ * @param log The log state.
+ * @param type enum vn310_log_record_type.
+ * @param tick_ms Time stamp of the record.
+ * @param payload The record payload.
+ * @param length Payload length.
+ * @return OK if the record was appended or logging is off, ERROR if it was dropped.
+ */
+STATUS vn310_log_append(struct vn310_log_t *log, uint8_t type, uint32_t tick_ms, const void *payload, uint16_t length)
+{
+    if (!log->enabled)
+    {
+        return OK;
+    }
+    if (RECORD_SIZE(length) > VN310_LOG_BLOCK_SIZE)
+    {
+        log->dropped_count++;
+        return ERROR;
+    }
+
+    if (log->fill + RECORD_SIZE(length) > VN310_LOG_BLOCK_SIZE)
+    {
+        _commit_block(log);
+    }
+
+    uint32_t tail = __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE);
+    if ((log->head - tail) >= VN310_LOG_BLOCK_COUNT)
+    {
+        log->dropped_count++;
+        return ERROR;
+    }
+
+    uint8_t *record = &log->blocks[log->head % VN310_LOG_BLOCK_COUNT].data[log->fill];
+    struct vn310_log_header_t header = {
+        .sync = VN310_LOG_SYNC,
+        .type = type,
+        .length = length,
+        .tick_ms = tick_ms,
+    };
+
+    memcpy(record, &header, VN310_LOG_HEADER_SIZE);
+    memcpy(&record[VN310_LOG_HEADER_SIZE], payload, length);
+
+    uint16_t crc = calculate_16_bit_crc(&record[1], VN310_LOG_HEADER_SIZE - 1 + length);
+    record[VN310_LOG_HEADER_SIZE + length] = (uint8_t)(crc & 0xFF);
+    record[VN310_LOG_HEADER_SIZE + length + 1] = (uint8_t)(crc >> 8);
+
+    log->fill += RECORD_SIZE(length);
+    log->record_count++;
+
+    return OK;
+}
+
+/**
+ * @brief Append a raw frame as received from an input.
+ *
+ * @param log The log state.
+ * @param source The input the frame arrived on, enum vn310_merge_source.
+ * @param frame The frame.
+ * @param tick_ms Time stamp of the record.
+ * @return As vn310_log_append.
+ */
+STATUS vn310_log_frame(struct vn310_log_t *log, uint8_t source, const struct vn310_frame_t *frame, uint32_t tick_ms)
+{
+    uint8_t payload[VN310_LOG_MAX_PAYLOAD];
+    uint16_t size = (frame->size < VN310_FRAME_MAX_SIZE) ? frame->size : VN310_FRAME_MAX_SIZE;
+
+    if (!log->enabled)
+    {
+        return OK;
+    }
+
+    payload[0] = source;
+    payload[1] = frame->type;
+    memcpy(&payload[2], frame->data, size);
+
+    return vn310_log_append(log, LOG_RECORD_FRAME, tick_ms, payload, (uint16_t)(size + 2));
+}
+
+/**
+ * @brief Append a published pose.
+ *
+ * @param log The log state.
+ * @param pose The pose as published.
+ * @param tick_ms Time stamp of the record.
+ * @return As vn310_log_append.
+ */
+STATUS vn310_log_pose(struct vn310_log_t *log, const struct vn310_pose_t *pose, uint32_t tick_ms)
+{
+    struct vn310_log_pose_t record = {
+        .time_gps_pps = pose->time_gps_pps,
+        .roll = pose->roll,
+        .pitch = pose->pitch,
+        .yaw = pose->yaw,
+        .latitude = pose->latitude,
+        .longitude = pose->longitude,
+        .altitude = pose->altitude,
+        .rate = { pose->rate[0], pose->rate[1], pose->rate[2] },
+        .ins_status = pose->ins_status,
+        .quaternion = { pose->quaternion[0], pose->quaternion[1], pose->quaternion[2], pose->quaternion[3] },
+    };
+
+    return vn310_log_append(log, LOG_RECORD_POSE, tick_ms, &record, sizeof(record));
+}
+
+/**
+ * @brief Hand the partly filled block to the storage task (applet side).
+ *
+ * Call before stopping the log, or periodically to bound how much is lost on a
+ * power failure. Wastes the unused part of the block.
+ *
+ * @param log The log state.
+ */
+void vn310_log_sync(struct vn310_log_t *log)
+{
+    if (log->fill > 0)
+    {
+        _commit_block(log);
+    }
+}
+
+/**
+ * @brief Write every full block to storage (storage task side).
+ *
+ * Call from a low-priority task. A block the sink fails to store is counted
+ * and released, so a failed card cannot stop logging of later data.
+ *
+ * @param log The log state.
+ * @return Number of blocks handed to the sink.
+ */
+uint32_t vn310_log_flush(struct vn310_log_t *log)
+{
+    uint32_t head = __atomic_load_n(&log->head, __ATOMIC_ACQUIRE);
+    uint32_t written = 0;
+
+    while (log->tail != head)
+    {
+        const uint8_t *block = log->blocks[log->tail % VN310_LOG_BLOCK_COUNT].data;
+
+        if (log->write != NULL && log->write(log->context, block, VN310_LOG_BLOCK_SIZE) == OK)
+        {
+            log->block_count++;
+        }
+        else
+        {
+            log->write_error_count++;
+        }
+
+        written++;
+        __atomic_store_n(&log->tail, log->tail + 1, __ATOMIC_RELEASE);
+    }
+
+    return written;
+}
+
+/**
+ * @brief Find the next intact record in a stretch of log data.
+ *
+ * Padding and damaged records are skipped.
+ *
+ * @param data Log data.
+ * @param size Bytes available.
+ * @param header The record header.
+ * @param payload Set to the record payload inside data.
+ * @return Bytes consumed up to the end of the record, 0 if no complete record was found.
+ */
+size_t vn310_log_parse(const uint8_t *data, size_t size, struct vn310_log_header_t *header, const uint8_t **payload)
+{
+    for (size_t offset = 0; offset + RECORD_SIZE(0) <= size; offset++)
+    {
+        const uint8_t *record = &data[offset];
+
+        if (record[0] != VN310_LOG_SYNC)
+        {
+            continue;
+        }
+
+        memcpy(header, record, VN310_LOG_HEADER_SIZE);
+        if (header->length > VN310_LOG_MAX_PAYLOAD || offset + RECORD_SIZE(header->length) > size)
+        {
+            continue;
+        }
+
+        uint16_t crc = (uint16_t)(record[VN310_LOG_HEADER_SIZE + header->length] |
+                                  (record[VN310_LOG_HEADER_SIZE + header->length + 1] << 8));
+        if (calculate_16_bit_crc((unsigned char *)&record[1], VN310_LOG_HEADER_SIZE - 1 + header->length) != crc)
+        {
+            continue;
+        }
+
+        *payload = &record[VN310_LOG_HEADER_SIZE];
+        return offset + RECORD_SIZE(header->length);
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file vn310_mailbox.c
+ * @brief Implementation of the VectorNav frame mailbox.
+ *
+ * The producer writes a frame directly into a reserved slot and publishes it by
+ * advancing the head index with release ordering. The consumer observes the head
+ * with acquire ordering, processes the frame in place and hands the slot back by
+ * advancing the tail. The indices are free running and only masked on access, so
+ * a full ring is distinguished from an empty one without a spare slot.
+ *
+ * If the ring is full the new frame is dropped and counted as an overrun. Frames
+ * already queued are never overwritten.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_mailbox.h"
+
+/**
+ * @brief Initialize the mailbox.
+ *
+ * Must be called before the UART receive interrupt is enabled.
+ *
+ * @param mailbox The mailbox to initialize.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_mailbox_init(struct vn310_mailbox_t *mailbox)
+{
+    memset(mailbox, 0, sizeof(*mailbox));
+    return OK;
+}
+
+/**
+ * @brief Reserve the next free frame slot (producer side).
+ *
+ * @param mailbox The mailbox.
+ * @return Pointer to the slot to fill, or NULL if the mailbox is full.
+ */
+struct vn310_frame_t *vn310_mailbox_reserve(struct vn310_mailbox_t *mailbox)
+{
+    uint32_t head = mailbox->head;
+    uint32_t tail = __atomic_load_n(&mailbox->tail, __ATOMIC_ACQUIRE);
+
+    if ((head - tail) >= VN310_MAILBOX_DEPTH)
+    {
+        mailbox->overrun_count++;
+        return NULL;
+    }
+
+    return &mailbox->frames[head & VN310_MAILBOX_MASK];
+}
+
+/**
+ * @brief Publish the slot returned by the last reserve (producer side).
+ *
+ * @param mailbox The mailbox.
+ */
+void vn310_mailbox_commit(struct vn310_mailbox_t *mailbox)
+{
+    mailbox->committed_count++;
+    __atomic_store_n(&mailbox->head, mailbox->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Get the oldest queued frame without removing it (consumer side).
+ *
+ * The frame stays owned by the consumer until vn310_mailbox_release is called.
+ *
+ * @param mailbox The mailbox.
+ * @return Pointer to the oldest frame, or NULL if the mailbox is empty.
+ */
+struct vn310_frame_t *vn310_mailbox_peek(struct vn310_mailbox_t *mailbox)
+{
+    uint32_t tail = mailbox->tail;
+    uint32_t head = __atomic_load_n(&mailbox->head, __ATOMIC_ACQUIRE);
+    uint32_t count = head - tail;
+
+    if (count == 0)
+    {
+        return NULL;
+    }
+
+    if (count > mailbox->high_water)
+    {
+        mailbox->high_water = count;
+    }
+
+    return &mailbox->frames[tail & VN310_MAILBOX_MASK];
+}
+
+/**
+ * @brief Return the frame obtained by the last peek to the producer (consumer side).
+ *
+ * @param mailbox The mailbox.
+ */
+void vn310_mailbox_release(struct vn310_mailbox_t *mailbox)
+{
+    mailbox->consumed_count++;
+    __atomic_store_n(&mailbox->tail, mailbox->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Get the number of frames currently queued.
+ *
+ * @param mailbox The mailbox.
+ * @return Number of queued frames, a snapshot that may be stale immediately.
+ */
+uint32_t vn310_mailbox_count(struct vn310_mailbox_t *mailbox)
+{
+    uint32_t head = __atomic_load_n(&mailbox->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&mailbox->tail, __ATOMIC_ACQUIRE);
+
+    return head - tail;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file vn310_merge.c
+ * @brief Implementation of the VN310 redundancy merge.
+ *
+ * The applet offers samples in arrival order, so publishing the first copy of
+ * each epoch gives the lower latency of the two inputs sample by sample, and the
+ * surviving input takes over as soon as the other stops delivering, without any
+ * explicit switch. Samples are only compared against the other input, so a
+ * single input behaves exactly as before. If nothing has been published for the
+ * failover timeout, the next timed sample is taken regardless of its time.
+ *
+ * Untimed (ASCII) samples cannot be aligned, so for those one input is active
+ * and the other is only used once the active one goes quiet.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_merge.h"
+
+/**
+ * @brief Initialize the merge.
+ *
+ * @param merge The merge state.
+ * @param config The merge configuration, zero fields select the defaults.
+ */
+void vn310_merge_init(struct vn310_merge_t *merge, const struct vn310_merge_config_t *config)
+{
+    memset(merge, 0, sizeof(*merge));
+    merge->config = *config;
+
+    if (merge->config.epoch_window_ns == 0)
+    {
+        merge->config.epoch_window_ns = VN310_MERGE_DEFAULT_EPOCH_WINDOW_NS;
+    }
+    if (merge->config.failover_ms == 0)
+    {
+        merge->config.failover_ms = VN310_MERGE_DEFAULT_FAILOVER_MS;
+    }
+}
+
+/**
+ * @brief Check an input has delivered a valid sample within the failover timeout.
+ */
+bool vn310_merge_source_alive(const struct vn310_merge_t *merge, uint8_t source, uint32_t now_ms)
+{
+    const struct vn310_merge_source_stats_t *stats = &merge->sources[source];
+
+    return stats->seen && (now_ms - stats->last_valid_ms) <= merge->config.failover_ms;
+}
+
+static void _activate(struct vn310_merge_t *merge, uint8_t source, uint32_t now_ms)
+{
+    if (source != merge->active_source)
+    {
+        // Only a switch away from a silent input is a failover, alternating
+        // winners are not
+        if (merge->sources[merge->active_source].seen && !vn310_merge_source_alive(merge, merge->active_source, now_ms))
+        {
+            merge->failover_count++;
+        }
+        merge->active_source = source;
+    }
+}
+
+/**
+ * @brief Decide whether a valid sample is published.
+ *
+ * @param merge The merge state.
+ * @param source The input the sample arrived on.
+ * @param time_ns GPS time of the sample since the GPS epoch, 0 if it carries none.
+ *                The PPS relative time restarts every second and cannot be used.
+ * @param now_ms Current tick.
+ * @return MERGE_PUBLISH if the sample should be published.
+ */
+enum vn310_merge_result vn310_merge_offer(struct vn310_merge_t *merge, uint8_t source, uint64_t time_ns, uint32_t now_ms)
+{
+    struct vn310_merge_source_stats_t *stats = &merge->sources[source];
+    bool active_alive = vn310_merge_source_alive(merge, merge->active_source, now_ms);
+    bool resync = (now_ms - merge->last_publish_ms) > merge->config.failover_ms;
+    enum vn310_merge_result result;
+
+    if (time_ns == 0)
+    {
+        result = (source == merge->active_source || !active_alive) ? MERGE_PUBLISH : MERGE_INACTIVE;
+    }
+    else if (source == merge->active_source || resync)
+    {
+        // The active input is never held back by its own time stamps. If nothing
+        // has been published for a while, e.g. after a sensor reset moved GPS
+        // time back, either input may take over.
+        result = MERGE_PUBLISH;
+    }
+    else if (time_ns + merge->config.epoch_window_ns <= merge->last_time_ns)
+    {
+        result = MERGE_STALE;
+    }
+    else if (time_ns < merge->last_time_ns + merge->config.epoch_window_ns && merge->last_time_ns != 0)
+    {
+        result = MERGE_DUPLICATE;
+    }
+    else
+    {
+        result = MERGE_PUBLISH;
+    }
+
+    switch (result)
+    {
+        case MERGE_PUBLISH:
+            _activate(merge, source, now_ms);
+            if (time_ns != 0)
+            {
+                merge->last_time_ns = time_ns;
+            }
+            merge->last_publish_ms = now_ms;
+            stats->published_count++;
+            break;
+        case MERGE_DUPLICATE:
+            stats->duplicate_count++;
+            break;
+        case MERGE_STALE:
+            stats->stale_count++;
+            break;
+        default:
+            stats->inactive_count++;
+            break;
+    }
+
+    // A stale sample is valid but says nothing about the input being current
+    if (result != MERGE_STALE)
+    {
+        stats->last_valid_ms = now_ms;
+        stats->seen = true;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Count a frame that failed its CRC or could not be parsed.
+ */
+void vn310_merge_failed(struct vn310_merge_t *merge, uint8_t source)
+{
+    merge->sources[source].failed_count++;
+}
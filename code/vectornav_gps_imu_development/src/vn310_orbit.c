@@ -0,0 +1,570 @@
+/**
+ * @file vn310_orbit.c
+ * @brief Implementation of SGP4 near-earth orbit propagation.
+ *
+ * This follows the SGP4 near-earth model of Spacetrack Report #3 as revised by
+ * Vallado et al. (2006), with WGS72 constants as the element sets are fitted with
+ * them. Everything that depends only on the element set is computed once by
+ * vn310_orbit_parse_tle, so a propagation is the secular and drag updates, one
+ * Kepler solve and the short-period corrections.
+ *
+ * The batch propagation computes the Earth rotation once for all satellites and
+ * writes one array per coordinate for the frame transforms.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vn310_orbit.h"
+
+#define TWO_PI                      (2.0 * M_PI)
+#define DEG_TO_RAD                  (M_PI / 180.0)
+#define MINUTES_PER_DAY             1440.0
+#define SECONDS_PER_DAY             86400.0
+#define JD_J2000                    2451545.0
+
+// WGS72, as used to fit the element sets
+#define EARTH_RADIUS_KM             6378.135
+#define EARTH_MU_KM3S2              398600.8
+#define J2                          0.001082616
+#define J3                          (-0.00000253881)
+#define J4                          (-0.00000165597)
+#define J3OJ2                       (J3 / J2)
+#define X2O3                        (2.0 / 3.0)
+#define EARTH_ROTATION_RADS         7.29211514670698e-5
+
+static double _xke(void)
+{
+    return 60.0 / sqrt(EARTH_RADIUS_KM * EARTH_RADIUS_KM * EARTH_RADIUS_KM / EARTH_MU_KM3S2);
+}
+
+/**
+ * @brief Check the modulo 10 checksum of a TLE line.
+ */
+static STATUS _line_valid(const char *line, char number)
+{
+    int sum = 0;
+
+    if (strlen(line) < VN310_ORBIT_TLE_LINE_LENGTH || line[0] != number)
+    {
+        return ERROR;
+    }
+
+    for (int i = 0; i < VN310_ORBIT_TLE_LINE_LENGTH - 1; i++)
+    {
+        if (line[i] >= '0' && line[i] <= '9')
+        {
+            sum += line[i] - '0';
+        }
+        else if (line[i] == '-')
+        {
+            sum += 1;
+        }
+    }
+
+    return (sum % 10 == line[VN310_ORBIT_TLE_LINE_LENGTH - 1] - '0') ? OK : ERROR;
+}
+
+/**
+ * @brief Parse a fixed-width TLE field as a double.
+ */
+static double _field(const char *line, int start, int length)
+{
+    char buffer[24];
+    memcpy(buffer, &line[start], length);
+    buffer[length] = '\0';
+    return strtod(buffer, NULL);
+}
+
+/**
+ * @brief Parse a TLE field in assumed-decimal exponent form, e.g. " 28098-4".
+ */
+static double _exponent_field(const char *line, int start)
+{
+    char mantissa[10];
+    int sign = (line[start] == '-') ? -1 : 1;
+
+    mantissa[0] = '.';
+    memcpy(&mantissa[1], &line[start + 1], 5);
+    mantissa[6] = '\0';
+
+    return sign * strtod(mantissa, NULL) * pow(10.0, _field(line, start + 6, 2));
+}
+
+/**
+ * @brief Julian date of 0h UTC on 1 January of a year.
+ */
+static double _jd_year_start(int year)
+{
+    int y = year - 1;
+    return 1721425.5 + 365.0 * y + y / 4 - y / 100 + y / 400;
+}
+
+/**
+ * @brief Precompute the SGP4 constants of an element set.
+ */
+static STATUS _sgp4_init(struct vn310_orbit_t *orbit, double mean_motion_kozai)
+{
+    const double xke = _xke();
+    const double ecco = orbit->eccentricity;
+    const double cosio = cos(orbit->inclination);
+    const double sinio = sin(orbit->inclination);
+    const double cosio2 = cosio * cosio;
+    const double eccsq = ecco * ecco;
+    const double omeosq = 1.0 - eccsq;
+    const double rteosq = sqrt(omeosq);
+
+    // Recover the original mean motion and semi-major axis from the Kozai mean motion
+    double ak = pow(xke / mean_motion_kozai, X2O3);
+    double d1 = 0.75 * J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    double no = mean_motion_kozai / (1.0 + del);
+    double ao = pow(xke / no, X2O3);
+
+    if (TWO_PI / no >= VN310_ORBIT_MAX_PERIOD_MIN || ecco >= 1.0)
+    {
+        return ERROR;
+    }
+
+    double po = ao * omeosq;
+    double posq = po * po;
+    double rp = ao * (1.0 - ecco);
+    double con42 = 1.0 - 5.0 * cosio2;
+
+    orbit->mean_motion = no;
+    orbit->semi_major_axis = ao;
+    orbit->con41 = -con42 - cosio2 - cosio2;
+    orbit->simple = rp < (220.0 / EARTH_RADIUS_KM + 1.0);
+
+    // Atmospheric density parameters, lowered for low perigees
+    double sfour = 78.0 / EARTH_RADIUS_KM + 1.0;
+    double qzms24 = pow((120.0 - 78.0) / EARTH_RADIUS_KM, 4);
+    double perigee_km = (rp - 1.0) * EARTH_RADIUS_KM;
+    if (perigee_km < 156.0)
+    {
+        sfour = (perigee_km < 98.0) ? 20.0 : perigee_km - 78.0;
+        qzms24 = pow((120.0 - sfour) / EARTH_RADIUS_KM, 4);
+        sfour = sfour / EARTH_RADIUS_KM + 1.0;
+    }
+
+    double pinvsq = 1.0 / posq;
+    double tsi = 1.0 / (ao - sfour);
+    double eta = ao * ecco * tsi;
+    double etasq = eta * eta;
+    double eeta = ecco * eta;
+    double psisq = fabs(1.0 - etasq);
+    double coef = qzms24 * pow(tsi, 4);
+    double coef1 = coef / pow(psisq, 3.5);
+    double cc2 = coef1 * no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
+                 0.375 * J2 * tsi / psisq * orbit->con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+    double cc3 = (ecco > 1.0e-4) ? -2.0 * coef * tsi * J3OJ2 * no * sinio / ecco : 0.0;
+
+    orbit->eta = eta;
+    orbit->cc1 = orbit->bstar * cc2;
+    orbit->x1mth2 = 1.0 - cosio2;
+    orbit->cc4 = 2.0 * no * coef1 * ao * omeosq *
+                 (eta * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq) -
+                  J2 * tsi / (ao * psisq) *
+                  (-3.0 * orbit->con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+                   0.75 * orbit->x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * cos(2.0 * orbit->argument_of_perigee)));
+    orbit->cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    // Secular rates from J2 and J4
+    double cosio4 = cosio2 * cosio2;
+    double temp1 = 1.5 * J2 * pinvsq * no;
+    double temp2 = 0.5 * temp1 * J2 * pinvsq;
+    double temp3 = -0.46875 * J4 * pinvsq * pinvsq * no;
+    double xhdot1 = -temp1 * cosio;
+
+    orbit->mdot = no + 0.5 * temp1 * rteosq * orbit->con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+    orbit->argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+                     temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+    orbit->nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+    orbit->omgcof = orbit->bstar * cc3 * cos(orbit->argument_of_perigee);
+    orbit->xmcof = (ecco > 1.0e-4) ? -X2O3 * coef * orbit->bstar / eeta : 0.0;
+    orbit->nodecf = 3.5 * omeosq * xhdot1 * orbit->cc1;
+    orbit->t2cof = 1.5 * orbit->cc1;
+
+    // Long-period periodics, guarding the 180 degree inclination singularity
+    double one_plus_cosio = (fabs(cosio + 1.0) > 1.5e-12) ? 1.0 + cosio : 1.5e-12;
+    orbit->xlcof = -0.25 * J3OJ2 * sinio * (3.0 + 5.0 * cosio) / one_plus_cosio;
+    orbit->aycof = -0.5 * J3OJ2 * sinio;
+    orbit->delmo = pow(1.0 + eta * cos(orbit->mean_anomaly), 3);
+    orbit->sinmao = sin(orbit->mean_anomaly);
+    orbit->x7thm1 = 7.0 * cosio2 - 1.0;
+
+    if (!orbit->simple)
+    {
+        double cc1sq = orbit->cc1 * orbit->cc1;
+        orbit->d2 = 4.0 * ao * tsi * cc1sq;
+        double temp = orbit->d2 * tsi * orbit->cc1 / 3.0;
+        orbit->d3 = (17.0 * ao + sfour) * temp;
+        orbit->d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * orbit->cc1;
+        orbit->t3cof = orbit->d2 + 2.0 * cc1sq;
+        orbit->t4cof = 0.25 * (3.0 * orbit->d3 + orbit->cc1 * (12.0 * orbit->d2 + 10.0 * cc1sq));
+        orbit->t5cof = 0.2 * (3.0 * orbit->d4 + 12.0 * orbit->cc1 * orbit->d3 + 6.0 * orbit->d2 * orbit->d2 +
+                              15.0 * cc1sq * (2.0 * orbit->d2 + cc1sq));
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Parse a two-line element set and initialize its propagator.
+ *
+ * @param line1 First element line, checksum verified.
+ * @param line2 Second element line, checksum verified.
+ * @param name Satellite name, may be NULL.
+ * @param orbit Output orbit.
+ * @return OK if the lines were valid and the orbit is near-earth.
+ */
+STATUS vn310_orbit_parse_tle(const char *line1, const char *line2, const char *name, struct vn310_orbit_t *orbit)
+{
+    RETURN_ON_ERROR(_line_valid(line1, '1'));
+    RETURN_ON_ERROR(_line_valid(line2, '2'));
+
+    memset(orbit, 0, sizeof(*orbit));
+
+    if (name != NULL)
+    {
+        size_t length = strcspn(name, "\r\n");
+        while (length > 0 && name[length - 1] == ' ')
+        {
+            length--;
+        }
+        if (length >= VN310_ORBIT_NAME_SIZE)
+        {
+            length = VN310_ORBIT_NAME_SIZE - 1;
+        }
+        memcpy(orbit->name, name, length);
+    }
+
+    orbit->catalog_number = (uint32_t)_field(line1, 2, 5);
+    if ((uint32_t)_field(line2, 2, 5) != orbit->catalog_number)
+    {
+        return ERROR;
+    }
+
+    int year = (int)_field(line1, 18, 2);
+    year += (year < 57) ? 2000 : 1900;
+    orbit->epoch_jd = _jd_year_start(year) + _field(line1, 20, 12) - 1.0;
+    orbit->bstar = _exponent_field(line1, 53);
+
+    orbit->inclination = _field(line2, 8, 8) * DEG_TO_RAD;
+    orbit->raan = _field(line2, 17, 8) * DEG_TO_RAD;
+    orbit->eccentricity = _field(line2, 26, 7) * 1.0e-7;
+    orbit->argument_of_perigee = _field(line2, 34, 8) * DEG_TO_RAD;
+    orbit->mean_anomaly = _field(line2, 43, 8) * DEG_TO_RAD;
+    double revs_per_day = _field(line2, 52, 11);
+
+    if (revs_per_day <= 0.0)
+    {
+        return ERROR;
+    }
+
+    return _sgp4_init(orbit, revs_per_day * TWO_PI / MINUTES_PER_DAY);
+}
+
+/**
+ * @brief Parse every element set in a TLE file.
+ *
+ * Accepts two-line sets and three-line sets with a name line. Sets that fail
+ * their checksum or are deep-space orbits are skipped.
+ *
+ * @param text The file contents, NUL terminated.
+ * @param orbits Output orbits.
+ * @param max_orbits Capacity of orbits.
+ * @return Number of orbits parsed.
+ */
+int vn310_orbit_parse_tles(const char *text, struct vn310_orbit_t *orbits, int max_orbits)
+{
+    const char *lines[3] = {NULL, NULL, NULL};
+    int count = 0;
+
+    for (const char *line = text; line != NULL && *line != '\0' && count < max_orbits; )
+    {
+        lines[0] = lines[1];
+        lines[1] = lines[2];
+        lines[2] = line;
+
+        if (line[0] == '2' && lines[1] != NULL && lines[1][0] == '1')
+        {
+            char line1[VN310_ORBIT_TLE_LINE_LENGTH + 1];
+            char line2[VN310_ORBIT_TLE_LINE_LENGTH + 1];
+            size_t length1 = strcspn(lines[1], "\r\n");
+            size_t length2 = strcspn(line, "\r\n");
+
+            if (length1 >= VN310_ORBIT_TLE_LINE_LENGTH && length2 >= VN310_ORBIT_TLE_LINE_LENGTH)
+            {
+                memcpy(line1, lines[1], VN310_ORBIT_TLE_LINE_LENGTH);
+                memcpy(line2, line, VN310_ORBIT_TLE_LINE_LENGTH);
+                line1[VN310_ORBIT_TLE_LINE_LENGTH] = '\0';
+                line2[VN310_ORBIT_TLE_LINE_LENGTH] = '\0';
+
+                const char *name = (lines[0] != NULL && lines[0][0] != '1' && lines[0][0] != '2') ? lines[0] : NULL;
+                if (vn310_orbit_parse_tle(line1, line2, name, &orbits[count]) == OK)
+                {
+                    count++;
+                }
+            }
+            lines[0] = lines[1] = lines[2] = NULL;
+        }
+
+        line = strchr(line, '\n');
+        if (line != NULL)
+        {
+            line++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Greenwich mean sidereal time (IAU 1982).
+ *
+ * @param jd_ut1 UT1 Julian date; UTC is within a second.
+ * @return GMST in radians, 0 to 2 pi.
+ */
+double vn310_orbit_gmst(double jd_ut1)
+{
+    double t = (jd_ut1 - JD_J2000) / 36525.0;
+    double seconds = -6.2e-6 * t * t * t + 0.093104 * t * t + (876600.0 * 3600.0 + 8640184.812866) * t + 67310.54841;
+    double gmst = fmod(seconds * TWO_PI / SECONDS_PER_DAY, TWO_PI);
+
+    return (gmst < 0.0) ? gmst + TWO_PI : gmst;
+}
+
+/**
+ * @brief Propagate an orbit to a time in the TEME frame.
+ *
+ * @param orbit The orbit.
+ * @param minutes_since_epoch Time from the element epoch in minutes.
+ * @param r_km Output position in km.
+ * @param v_kms Output velocity in km/s.
+ * @return OK, or ERROR if the orbit has decayed or the elements have diverged.
+ */
+STATUS vn310_orbit_propagate_teme(const struct vn310_orbit_t *orbit, double minutes_since_epoch, double r_km[3], double v_kms[3])
+{
+    const double xke = _xke();
+    const double t = minutes_since_epoch;
+    const double t2 = t * t;
+
+    // Secular gravity and atmospheric drag
+    double xmdf = orbit->mean_anomaly + orbit->mdot * t;
+    double argpdf = orbit->argument_of_perigee + orbit->argpdot * t;
+    double nodedf = orbit->raan + orbit->nodedot * t;
+    double argpm = argpdf;
+    double mm = xmdf;
+    double nodem = nodedf + orbit->nodecf * t2;
+    double tempa = 1.0 - orbit->cc1 * t;
+    double tempe = orbit->bstar * orbit->cc4 * t;
+    double templ = orbit->t2cof * t2;
+
+    if (!orbit->simple)
+    {
+        double delomg = orbit->omgcof * t;
+        double delm = orbit->xmcof * (pow(1.0 + orbit->eta * cos(xmdf), 3) - orbit->delmo);
+        double temp = delomg + delm;
+        double t3 = t2 * t;
+        double t4 = t3 * t;
+
+        mm = xmdf + temp;
+        argpm = argpdf - temp;
+        tempa = tempa - orbit->d2 * t2 - orbit->d3 * t3 - orbit->d4 * t4;
+        tempe = tempe + orbit->bstar * orbit->cc5 * (sin(mm) - orbit->sinmao);
+        templ = templ + orbit->t3cof * t3 + t4 * (orbit->t4cof + t * orbit->t5cof);
+    }
+
+    double am = pow(xke / orbit->mean_motion, X2O3) * tempa * tempa;
+    double nm = xke / pow(am, 1.5);
+    double em = orbit->eccentricity - tempe;
+
+    if (em >= 1.0 || em < -0.001 || am < 0.95)
+    {
+        return ERROR;
+    }
+    if (em < 1.0e-6)
+    {
+        em = 1.0e-6;
+    }
+
+    mm = mm + orbit->mean_motion * templ;
+    double xlm = mm + argpm + nodem;
+    nodem = fmod(nodem, TWO_PI);
+    argpm = fmod(argpm, TWO_PI);
+    xlm = fmod(xlm, TWO_PI);
+    mm = fmod(xlm - argpm - nodem, TWO_PI);
+
+    double sinip = sin(orbit->inclination);
+    double cosip = cos(orbit->inclination);
+
+    // Long-period periodics
+    double axnl = em * cos(argpm);
+    double temp = 1.0 / (am * (1.0 - em * em));
+    double aynl = em * sin(argpm) + temp * orbit->aycof;
+    double xl = mm + argpm + nodem + temp * orbit->xlcof * axnl;
+
+    // Kepler's equation
+    double u = fmod(xl - nodem, TWO_PI);
+    double eo1 = u;
+    double sineo1 = 0.0, coseo1 = 1.0;
+    double tem5 = 9999.9;
+    for (int k = 0; k < 10 && fabs(tem5) >= 1.0e-12; k++)
+    {
+        sineo1 = sin(eo1);
+        coseo1 = cos(eo1);
+        tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+        tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+        if (fabs(tem5) >= 0.95)
+        {
+            tem5 = (tem5 > 0.0) ? 0.95 : -0.95;
+        }
+        eo1 = eo1 + tem5;
+    }
+
+    // Short-period periodics
+    double ecose = axnl * coseo1 + aynl * sineo1;
+    double esine = axnl * sineo1 - aynl * coseo1;
+    double el2 = axnl * axnl + aynl * aynl;
+    double pl = am * (1.0 - el2);
+
+    if (pl < 0.0)
+    {
+        return ERROR;
+    }
+
+    double rl = am * (1.0 - ecose);
+    double rdotl = sqrt(am) * esine / rl;
+    double rvdotl = sqrt(pl) / rl;
+    double betal = sqrt(1.0 - el2);
+    temp = esine / (1.0 + betal);
+    double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = atan2(sinu, cosu);
+    double sin2u = (cosu + cosu) * sinu;
+    double cos2u = 1.0 - 2.0 * sinu * sinu;
+    temp = 1.0 / pl;
+    double temp1 = 0.5 * J2 * temp;
+    double temp2 = temp1 * temp;
+
+    double mrt = rl * (1.0 - 1.5 * temp2 * betal * orbit->con41) + 0.5 * temp1 * orbit->x1mth2 * cos2u;
+    su = su - 0.25 * temp2 * orbit->x7thm1 * sin2u;
+    double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+    double xinc = orbit->inclination + 1.5 * temp2 * cosip * sinip * cos2u;
+    double mvt = rdotl - nm * temp1 * orbit->x1mth2 * sin2u / xke;
+    double rvdot = rvdotl + nm * temp1 * (orbit->x1mth2 * cos2u + 1.5 * orbit->con41) / xke;
+
+    if (mrt < 1.0)
+    {
+        return ERROR;
+    }
+
+    // Orientation vectors
+    double sinsu = sin(su), cossu = cos(su);
+    double snod = sin(xnode), cnod = cos(xnode);
+    double sini = sin(xinc), cosi = cos(xinc);
+    double xmx = -snod * cosi;
+    double xmy = cnod * cosi;
+    double ux = xmx * sinsu + cnod * cossu;
+    double uy = xmy * sinsu + snod * cossu;
+    double uz = sini * sinsu;
+    double vx = xmx * cossu - cnod * sinsu;
+    double vy = xmy * cossu - snod * sinsu;
+    double vz = sini * cossu;
+    double v_scale = EARTH_RADIUS_KM * xke / 60.0;
+
+    r_km[0] = mrt * ux * EARTH_RADIUS_KM;
+    r_km[1] = mrt * uy * EARTH_RADIUS_KM;
+    r_km[2] = mrt * uz * EARTH_RADIUS_KM;
+    v_kms[0] = (mvt * ux + rvdot * vx) * v_scale;
+    v_kms[1] = (mvt * uy + rvdot * vy) * v_scale;
+    v_kms[2] = (mvt * uz + rvdot * vz) * v_scale;
+
+    return OK;
+}
+
+/**
+ * @brief Rotate a TEME state into ECEF in metres.
+ */
+static void _teme_to_ecef(double sin_gmst, double cos_gmst, const double r_km[3], const double v_kms[3],
+                          double position[3], double velocity[3])
+{
+    position[0] = (cos_gmst * r_km[0] + sin_gmst * r_km[1]) * 1000.0;
+    position[1] = (-sin_gmst * r_km[0] + cos_gmst * r_km[1]) * 1000.0;
+    position[2] = r_km[2] * 1000.0;
+
+    // Velocity relative to the rotating Earth
+    velocity[0] = (cos_gmst * v_kms[0] + sin_gmst * v_kms[1]) * 1000.0 + EARTH_ROTATION_RADS * position[1];
+    velocity[1] = (-sin_gmst * v_kms[0] + cos_gmst * v_kms[1]) * 1000.0 - EARTH_ROTATION_RADS * position[0];
+    velocity[2] = v_kms[2] * 1000.0;
+}
+
+/**
+ * @brief Propagate an orbit to a time in ECEF.
+ *
+ * @param orbit The orbit.
+ * @param jd UTC Julian date.
+ * @param position Output ECEF position in metres.
+ * @param velocity Output ECEF velocity in metres per second.
+ * @return OK, or ERROR if the orbit has decayed or the elements have diverged.
+ */
+STATUS vn310_orbit_propagate_ecef(const struct vn310_orbit_t *orbit, double jd, double position[3], double velocity[3])
+{
+    double r_km[3], v_kms[3];
+    double gmst = vn310_orbit_gmst(jd);
+
+    RETURN_ON_ERROR(vn310_orbit_propagate_teme(orbit, (jd - orbit->epoch_jd) * MINUTES_PER_DAY, r_km, v_kms));
+    _teme_to_ecef(sin(gmst), cos(gmst), r_km, v_kms, position, velocity);
+
+    return OK;
+}
+
+/**
+ * @brief Propagate many orbits to one time in ECEF.
+ *
+ * @param orbits The orbits.
+ * @param count Number of orbits.
+ * @param jd UTC Julian date.
+ * @param x Output ECEF x in metres.
+ * @param y Output ECEF y in metres.
+ * @param z Output ECEF z in metres.
+ * @param vx Output ECEF x velocity in metres per second.
+ * @param vy Output ECEF y velocity in metres per second.
+ * @param vz Output ECEF z velocity in metres per second.
+ * @param valid Output per orbit, false if it could not be propagated.
+ * @return Number of orbits propagated.
+ */
+int vn310_orbit_propagate_batch(const struct vn310_orbit_t *orbits, int count, double jd,
+                                double *x, double *y, double *z, double *vx, double *vy, double *vz, bool *valid)
+{
+    double gmst = vn310_orbit_gmst(jd);
+    double sin_gmst = sin(gmst), cos_gmst = cos(gmst);
+    int propagated = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        double r_km[3], v_kms[3], position[3] = {0.0, 0.0, 0.0}, velocity[3] = {0.0, 0.0, 0.0};
+
+        valid[i] = vn310_orbit_propagate_teme(&orbits[i], (jd - orbits[i].epoch_jd) * MINUTES_PER_DAY, r_km, v_kms) == OK;
+        if (valid[i])
+        {
+            _teme_to_ecef(sin_gmst, cos_gmst, r_km, v_kms, position, velocity);
+            propagated++;
+        }
+
+        x[i] = position[0];
+        y[i] = position[1];
+        z[i] = position[2];
+        vx[i] = velocity[0];
+        vy[i] = velocity[1];
+        vz[i] = velocity[2];
+    }
+
+    return propagated;
+}
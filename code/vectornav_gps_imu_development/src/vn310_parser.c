@@ -43,7 +43,7 @@ enum {toknum_insstatus = 3, toknum_yaw, toknum_pitch, toknum_roll, toknum_poslat
 
 STATUS vn310_parser_parse_VNINS(const char *recieved_string, struct vn310_pose_t *vn310_pose)
 {
-    char *str_token= strtok((char *)recieved_string, ",");
+    char *t = strtok((char *)recieved_string, ",");
     int i = 0;
     while (t)
     {
@@ -79,7 +79,7 @@ STATUS vn310_parser_parse_VNINS(const char *recieved_string, struct vn310_pose_t
             default:
                 break;
         }
-        str_token= strtok(NULL, ",");
+        t = strtok(NULL, ",");
         i++;
     }
 
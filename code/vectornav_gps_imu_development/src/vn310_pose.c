@@ -4,23 +4,43 @@
  * 
  * This file contains functions for handling pose data, including coordinate transformations,
  * angle conversions, and pose data updates from the VectorNav sensor.
+ *
+ * Pose updates are routed to the tiles through a publishing policy, so a stream at the
+ * full sensor rate only generates messages when the pose has moved enough to matter or
+ * a keyframe is due.
  * 
  * @author Nicholas Antoniades
  * @date 15 Jan 2024
  */
 
+#include <string.h>
 #include "vn310_pose.h"
+#include "vn310_applet.h"
+#include "bsp_delay.h"
 #include "message_routing.h"
 #include "message_pose.h"
 
+#define NS_PER_MS   1000000ULL
+
+/**
+ * @brief Wrap an angle into [0, 360) degrees.
+ *
+ * Uses a single floor instead of fmod, which is a library call on the MCU.
+ */
 float vn310_pose_wrap_0_to_360_degrees(float input)
 {
-    input = fmod(input, 360.0);
-    if (input < 0)
-    {
-        input = 360 + input;
-    }
-    return input;
+    input -= 360.0f * floorf(input * (1.0f / 360.0f));
+
+    // Tiny negative inputs can round up to exactly 360
+    return (input >= 360.0f) ? 0.0f : input;
+}
+
+/**
+ * @brief Wrap an angle difference into [-180, 180) degrees.
+ */
+float vn310_pose_wrap_180_degrees(float input)
+{
+    return input - 360.0f * floorf((input + 180.0f) * (1.0f / 360.0f));
 }
 
 float vn310_pose_radians_to_degrees(float input)
@@ -28,26 +48,109 @@ float vn310_pose_radians_to_degrees(float input)
     return input * (360.0f / (2.0f * M_PI));
 }
 
-void vn310_pose_send_updated(struct app_vn310_state_t *state, struct vn310_pose_t *vn310_pose, bool forced)
+/**
+ * @brief Initialize the pose publishing policy.
+ *
+ * @param publisher The publisher state.
+ * @param config The publishing policy.
+ */
+void vn310_pose_publisher_init(struct vn310_pose_publisher_t *publisher, const struct vn310_pose_publish_config_t *config)
+{
+    memset(publisher, 0, sizeof(*publisher));
+    publisher->config = *config;
+}
+
+/**
+ * @brief Check whether any value has moved by its dead-band since the last published pose.
+ */
+static bool _pose_moved(const struct vn310_pose_publish_config_t *config, const struct vn310_pose_t *last, const struct vn310_pose_t *pose)
 {
-    if (state->driver_state.send_pose || forced)
+    return fabsf(vn310_pose_wrap_180_degrees(pose->roll - last->roll)) >= config->deadband_deg[0] ||
+           fabsf(vn310_pose_wrap_180_degrees(pose->pitch - last->pitch)) >= config->deadband_deg[1] ||
+           fabsf(vn310_pose_wrap_180_degrees(pose->yaw - last->yaw)) >= config->deadband_deg[2] ||
+           fabsf(pose->latitude - last->latitude) >= config->deadband_position_deg ||
+           fabsf(pose->longitude - last->longitude) >= config->deadband_position_deg;
+}
+
+/**
+ * @brief Decide whether a sample should be published, updating the counters.
+ *
+ * Binary samples are timed by their GPS time stamp, so replayed streams behave
+ * exactly as live ones. ASCII samples carry no time stamp and use the system tick.
+ */
+static bool _should_publish(struct vn310_pose_publisher_t *publisher, const struct vn310_pose_t *pose, bool forced, uint64_t *now_ns)
+{
+    const struct vn310_pose_publish_config_t *config = &publisher->config;
+
+    *now_ns = (pose->time_gps != 0) ? pose->time_gps : (uint64_t)bsp_delay_get_tick_ms() * NS_PER_MS;
+
+    if (forced)
     {
-        struct message_pose_t message;
-        message_pose_init(&message);
-        struct vn310_pose_t vn310_update_pose = *vn310_pose;
-        vn310_update_pose.roll = vn310_pose_wrap_0_to_360_degrees(vn310_pose->roll);
-        vn310_update_pose.pitch = vn310_pose_wrap_0_to_360_degrees(vn310_pose->pitch);
-        vn310_update_pose.yaw = vn310_pose_wrap_0_to_360_degrees(vn310_pose->yaw);
-        // TODO: Add this in properly. This is intended to be distance from sea level, but this
-        // may be defined differently by the vertornav?
-        vn310_update_pose.altitude = 0;
-
-        message_pose_update_message(&message, vn310_update_pose);
-
-        if (OK != message_routing_send_message_to((uint8_t*)&message,
-                BOARD_TYPE_ACON_MAJ_INT, TILE_INDEX_UNSPECIFIED))
-        {
-            WARN("Routing failed for message_pose from app_vn310");
-        }
+        publisher->forced_count++;
+        return true;
     }
-} 
\ No newline at end of file
+
+    // First sample, or the time base went backwards (sensor restart or replay loop)
+    if (!publisher->has_sent || *now_ns < publisher->last_sent_ns)
+    {
+        return true;
+    }
+
+    uint64_t elapsed_ns = *now_ns - publisher->last_sent_ns;
+
+    if (config->keyframe_interval_ns != 0 && elapsed_ns >= config->keyframe_interval_ns)
+    {
+        publisher->keyframe_count++;
+        return true;
+    }
+    if (elapsed_ns < config->min_interval_ns)
+    {
+        publisher->suppressed_rate_count++;
+        return false;
+    }
+    if (!_pose_moved(config, &publisher->last_sent, pose))
+    {
+        publisher->suppressed_deadband_count++;
+        return false;
+    }
+
+    return true;
+}
+
+void vn310_pose_send_updated(struct vn310_applet_state_t *state, struct vn310_pose_t *vn310_pose, bool forced)
+{
+    struct vn310_pose_publisher_t *publisher = &state->publisher;
+    uint64_t now_ns;
+
+    if (!(state->driver_state.send_pose || forced) || !_should_publish(publisher, vn310_pose, forced, &now_ns))
+    {
+        return;
+    }
+
+    struct message_pose_t message;
+    message_pose_init(&message);
+    struct vn310_pose_t vn310_update_pose = *vn310_pose;
+    vn310_update_pose.roll = vn310_pose_wrap_0_to_360_degrees(vn310_pose->roll);
+    vn310_update_pose.pitch = vn310_pose_wrap_0_to_360_degrees(vn310_pose->pitch);
+    vn310_update_pose.yaw = vn310_pose_wrap_0_to_360_degrees(vn310_pose->yaw);
+    // TODO: Add this in properly. This is intended to be distance from sea level, but this
+    // may be defined differently by the vertornav?
+    vn310_update_pose.altitude = 0;
+
+    message_pose_update_message(&message, vn310_update_pose);
+
+    vn310_trace_mark(&state->trace, TRACE_POINT_PUBLISHED);
+    if (OK != message_routing_send_message_to((uint8_t*)&message,
+            BOARD_TYPE_ACON_MAJ_INT, TILE_INDEX_UNSPECIFIED))
+    {
+        WARN("Routing failed for message_pose from app_vn310");
+        return;
+    }
+
+    publisher->last_sent = *vn310_pose;
+    publisher->last_sent_ns = now_ns;
+    publisher->has_sent = true;
+    publisher->sent_count++;
+
+    vn310_log_pose(&state->log, vn310_pose, bsp_delay_get_tick_ms());
+}
@@ -0,0 +1,219 @@
+/**
+ * @file vn310_predictor.c
+ * @brief Implementation of the VectorNav attitude prediction functions.
+ *
+ * This file contains functions for propagating the most recent VN310 attitude
+ * sample to an arbitrary actuation time. The sample carries the body angular
+ * rates captured from the binary output and the GPS time stamp, which allows
+ * the beam pointing consumer to be fed the attitude at the instant the beam is
+ * actually switched rather than when the sample was received.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <string.h>
+#include "vn310_predictor.h"
+
+#define DEG_TO_RAD                  (M_PI / 180.0)
+#define NS_TO_S                     1.0e-9
+#define NS_PER_S                    1000000000ULL
+#define GIMBAL_LOCK_COS_PITCH       0.01     // Below this the Euler rate equations are ill conditioned
+
+/**
+ * @brief Rotate the attitude quaternion by a constant body rate over dt.
+ *
+ * The body rates are applied as a single exact rotation increment, q' = q * dq,
+ * which is exact for a constant rate and avoids the normalisation drift of a
+ * first order integration.
+ */
+static void _quaternion_propagate(double q[4], const float rate_dps[3], double dt_s)
+{
+    double wx = rate_dps[0] * DEG_TO_RAD;
+    double wy = rate_dps[1] * DEG_TO_RAD;
+    double wz = rate_dps[2] * DEG_TO_RAD;
+    double rate_norm = sqrt(wx * wx + wy * wy + wz * wz);
+    double half_angle = 0.5 * rate_norm * dt_s;
+
+    if (rate_norm < 1.0e-12)
+    {
+        return;
+    }
+
+    double scale = sin(half_angle) / rate_norm;
+    double dw = cos(half_angle), dx = wx * scale, dy = wy * scale, dz = wz * scale;
+    double x = q[QUATERNION_X], y = q[QUATERNION_Y], z = q[QUATERNION_Z], w = q[QUATERNION_W];
+
+    q[QUATERNION_W] = w * dw - x * dx - y * dy - z * dz;
+    q[QUATERNION_X] = w * dx + x * dw + y * dz - z * dy;
+    q[QUATERNION_Y] = w * dy - x * dz + y * dw + z * dx;
+    q[QUATERNION_Z] = w * dz + x * dy - y * dx + z * dw;
+}
+
+/**
+ * @brief Propagate the attitude by integrating the quaternion.
+ *
+ * Starts from the quaternion carried in the sample, falling back to the Euler
+ * angles for poses that have none, and writes both representations back.
+ */
+static void _predict_quaternion(const struct vn310_pose_t *pose, double dt_s, struct vn310_pose_t *predicted_pose)
+{
+    double q[4];
+    double yaw, pitch, roll;
+
+    if (vn310_attitude_quaternion_valid(pose->quaternion))
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            q[i] = pose->quaternion[i];
+        }
+    }
+    else
+    {
+        vn310_attitude_quaternion_from_ypr_double(pose->yaw, pose->pitch, pose->roll, q);
+    }
+
+    _quaternion_propagate(q, pose->rate, dt_s);
+    vn310_attitude_quaternion_to_ypr_double(q, &yaw, &pitch, &roll);
+
+    predicted_pose->yaw = (float)yaw;
+    predicted_pose->pitch = (float)pitch;
+    predicted_pose->roll = (float)roll;
+    for (int i = 0; i < 4; i++)
+    {
+        predicted_pose->quaternion[i] = (float)q[i];
+    }
+}
+
+/**
+ * @brief Propagate the attitude assuming constant Euler angle rates.
+ *
+ * The body rates (p, q, r) are mapped to Euler angle rates at the sampled attitude
+ * and held constant over dt. Close to +/-90 degrees pitch the mapping is singular so
+ * the quaternion integration is used instead.
+ */
+static void _predict_constant_rate(const struct vn310_pose_t *pose, double dt_s, struct vn310_pose_t *predicted_pose)
+{
+    double sin_roll = sin(pose->roll * DEG_TO_RAD);
+    double cos_roll = cos(pose->roll * DEG_TO_RAD);
+    double cos_pitch = cos(pose->pitch * DEG_TO_RAD);
+
+    if (fabs(cos_pitch) < GIMBAL_LOCK_COS_PITCH)
+    {
+        _predict_quaternion(pose, dt_s, predicted_pose);
+        return;
+    }
+
+    double tan_pitch = tan(pose->pitch * DEG_TO_RAD);
+    double p = pose->rate[0];
+    double q = pose->rate[1];
+    double r = pose->rate[2];
+    double q_r_term = q * sin_roll + r * cos_roll;
+
+    double roll_rate = p + q_r_term * tan_pitch;
+    double pitch_rate = q * cos_roll - r * sin_roll;
+    double yaw_rate = q_r_term / cos_pitch;
+
+    predicted_pose->roll = (float)(pose->roll + roll_rate * dt_s);
+    predicted_pose->pitch = (float)(pose->pitch + pitch_rate * dt_s);
+    predicted_pose->yaw = (float)(pose->yaw + yaw_rate * dt_s);
+    vn310_attitude_quaternion_from_ypr(predicted_pose->yaw, predicted_pose->pitch, predicted_pose->roll,
+                                       predicted_pose->quaternion);
+}
+
+/**
+ * @brief Initialize the attitude predictor.
+ *
+ * @param state The state of the predictor.
+ * @param config The configuration for the predictor.
+ * @return OK if the initialization was successful.
+ */
+STATUS vn310_predictor_init(struct vn310_predictor_state_t *state, const struct vn310_predictor_config_t *config)
+{
+    memset(state, 0, sizeof(*state));
+    state->config = *config;
+
+    if (state->config.max_extrapolation_ns == 0)
+    {
+        state->config.max_extrapolation_ns = VN310_PREDICTOR_MAX_EXTRAPOLATION_NS;
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Feed a new VN310 sample to the predictor.
+ *
+ * Samples that are older than the one already held are rejected, so an out of
+ * order delivery never moves the prediction backwards. Samples are ordered by
+ * GPS time; the PPS relative time restarts every second and cannot be compared.
+ *
+ * @param state The state of the predictor.
+ * @param pose The latest pose, including angular rates and GPS time stamp.
+ * @return OK if the sample was accepted, ERROR if it was stale.
+ */
+STATUS vn310_predictor_update(struct vn310_predictor_state_t *state, const struct vn310_pose_t *pose)
+{
+    if (state->pose_valid && pose->time_gps < state->last_pose.time_gps)
+    {
+        state->rejected_count++;
+        return ERROR;
+    }
+
+    state->last_pose = *pose;
+    state->pose_valid = true;
+
+    return OK;
+}
+
+/**
+ * @brief Predict the attitude at the actuation time.
+ *
+ * The position, rates and status are carried over from the last sample, while the
+ * attitude is propagated by the configured method. The propagation interval is
+ * clamped to the configured maximum so a stalled sensor cannot drive the
+ * prediction arbitrarily far.
+ *
+ * @param state The state of the predictor.
+ * @param actuation_time_ns The time the beam will be actuated, in GPS time (ns).
+ * @param predicted_pose Output pose at the actuation time.
+ * @return OK if a prediction was produced, ERROR if no sample has been received yet.
+ */
+STATUS vn310_predictor_predict(struct vn310_predictor_state_t *state, uint64_t actuation_time_ns, struct vn310_pose_t *predicted_pose)
+{
+    if (!state->pose_valid)
+    {
+        return ERROR;
+    }
+
+    const struct vn310_pose_t *pose = &state->last_pose;
+    int64_t dt_ns = (int64_t)(actuation_time_ns - pose->time_gps);
+    int64_t max_ns = (int64_t)state->config.max_extrapolation_ns;
+
+    if (dt_ns > max_ns || dt_ns < -max_ns)
+    {
+        dt_ns = (dt_ns > 0) ? max_ns : -max_ns;
+        state->clamped_count++;
+    }
+
+    double dt_s = (double)dt_ns * NS_TO_S;
+
+    *predicted_pose = *pose;
+    predicted_pose->time_gps = pose->time_gps + (uint64_t)dt_ns;
+    predicted_pose->time_gps_pps = predicted_pose->time_gps % NS_PER_S;
+
+    switch (state->config.mode)
+    {
+        case PREDICTOR_MODE_CONSTANT_RATE:
+            _predict_constant_rate(pose, dt_s, predicted_pose);
+            break;
+        case PREDICTOR_MODE_QUATERNION:
+            _predict_quaternion(pose, dt_s, predicted_pose);
+            break;
+        case PREDICTOR_MODE_HOLD:
+        default:
+            break;
+    }
+
+    return OK;
+}
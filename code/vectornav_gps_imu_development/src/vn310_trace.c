@@ -0,0 +1,228 @@
+/**
+ * @file vn310_trace.c
+ * @brief Implementation of VN310 pipeline latency tracing.
+ *
+ * On target the timestamps are the Cortex-M7 DWT cycle counter, which costs a single
+ * load to read. On the host they are the monotonic clock in nanoseconds. Both wrap
+ * at 32 bits, which only limits a single stage to a few seconds, far longer than any
+ * sample spends in the pipeline.
+ *
+ * The ring keeps the most recent VN310_TRACE_DEPTH records, so the histograms always
+ * describe the last few seconds of traffic.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "vn310_trace.h"
+
+#if defined(__arm__)
+#define DWT_CTRL        (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004)
+#define DWT_LAR         (*(volatile uint32_t *)0xE0001FB0)
+#define DEMCR           (*(volatile uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA    (1u << 24)
+#define DWT_CYCCNTENA   (1u << 0)
+#define DWT_UNLOCK_KEY  0xC5ACCE55u
+#else
+#include <time.h>
+#endif
+
+#define TRACE_POINT_BIT(point)  (1u << (point))
+
+static const char *stage_names[TRACE_STAGE_COUNT] = { "receive", "parse", "publish", "total" };
+
+// Stage start and end points, indexed by enum vn310_trace_stage
+static const uint8_t stage_points[TRACE_STAGE_COUNT][2] = {
+    { TRACE_POINT_DMA,    TRACE_POINT_READY },
+    { TRACE_POINT_READY,  TRACE_POINT_PARSED },
+    { TRACE_POINT_PARSED, TRACE_POINT_PUBLISHED },
+    { TRACE_POINT_DMA,    TRACE_POINT_PUBLISHED },
+};
+
+/**
+ * @brief Initialize tracing and start the cycle counter.
+ *
+ * Tracing starts disabled.
+ *
+ * @param trace The trace state.
+ * @return OK.
+ */
+STATUS vn310_trace_init(struct vn310_trace_t *trace)
+{
+    memset(trace, 0, sizeof(*trace));
+
+#if defined(__arm__)
+    DEMCR |= DEMCR_TRCENA;
+    DWT_LAR = DWT_UNLOCK_KEY;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CYCCNTENA;
+#endif
+
+    return OK;
+}
+
+/**
+ * @brief Discard all records and counters, keeping the enabled state.
+ *
+ * @param trace The trace state.
+ */
+void vn310_trace_clear(struct vn310_trace_t *trace)
+{
+    bool enabled = trace->enabled;
+
+    memset(trace, 0, sizeof(*trace));
+    trace->enabled = enabled;
+}
+
+/**
+ * @brief Read the trace timestamp.
+ *
+ * Safe to call from interrupt context.
+ *
+ * @return Cycle counter on target, nanoseconds on the host.
+ */
+uint32_t vn310_trace_now(void)
+{
+#if defined(__arm__)
+    return DWT_CYCCNT;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Start the record for a frame taken from the mailbox.
+ *
+ * @param trace The trace state.
+ * @param frame The frame, carrying its DMA and ready timestamps.
+ */
+void vn310_trace_begin(struct vn310_trace_t *trace, const struct vn310_frame_t *frame)
+{
+    if (!trace->enabled)
+    {
+        return;
+    }
+
+    trace->current.time[TRACE_POINT_DMA] = frame->time_dma;
+    trace->current.time[TRACE_POINT_READY] = frame->time_ready;
+    trace->current.points = TRACE_POINT_BIT(TRACE_POINT_DMA) | TRACE_POINT_BIT(TRACE_POINT_READY);
+    trace->active = true;
+}
+
+/**
+ * @brief Timestamp a trace point of the current frame.
+ *
+ * @param trace The trace state.
+ * @param point The point reached.
+ */
+void vn310_trace_mark(struct vn310_trace_t *trace, enum vn310_trace_point point)
+{
+    if (!trace->active)
+    {
+        return;
+    }
+
+    trace->current.time[point] = vn310_trace_now();
+    trace->current.points |= TRACE_POINT_BIT(point);
+}
+
+/**
+ * @brief Store the record of the current frame in the ring.
+ *
+ * @param trace The trace state.
+ */
+void vn310_trace_end(struct vn310_trace_t *trace)
+{
+    if (!trace->active)
+    {
+        return;
+    }
+
+    if (!(trace->current.points & TRACE_POINT_BIT(TRACE_POINT_PARSED)))
+    {
+        trace->parse_failed_count++;
+    }
+    else if (!(trace->current.points & TRACE_POINT_BIT(TRACE_POINT_PUBLISHED)))
+    {
+        trace->unpublished_count++;
+    }
+
+    trace->records[trace->head % VN310_TRACE_DEPTH] = trace->current;
+    trace->head++;
+    trace->traced_count++;
+    trace->active = false;
+}
+
+static int _compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t _cycles_to_ns(uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)cycles * 1000u) / VN310_TRACE_CYCLES_PER_US);
+}
+
+/**
+ * @brief Summarize the latency of one stage over the records in the ring.
+ *
+ * Percentiles are nearest rank over the records that reached both ends of the
+ * stage. Uses a static scratch buffer, so call it from one context only (the CLI
+ * or the host benchmark).
+ *
+ * @param trace The trace state.
+ * @param stage The stage to summarize.
+ * @param summary The summary, all zero if no record covers the stage.
+ * @return OK if at least one record covers the stage.
+ */
+STATUS vn310_trace_summarize(const struct vn310_trace_t *trace, enum vn310_trace_stage stage, struct vn310_trace_summary_t *summary)
+{
+    static uint32_t durations[VN310_TRACE_DEPTH];
+    uint8_t start = stage_points[stage][0];
+    uint8_t end = stage_points[stage][1];
+    uint8_t required = TRACE_POINT_BIT(start) | TRACE_POINT_BIT(end);
+    uint32_t records = (trace->head < VN310_TRACE_DEPTH) ? trace->head : VN310_TRACE_DEPTH;
+    uint32_t count = 0;
+
+    memset(summary, 0, sizeof(*summary));
+
+    for (uint32_t i = 0; i < records; i++)
+    {
+        const struct vn310_trace_record_t *record = &trace->records[i];
+        if ((record->points & required) == required)
+        {
+            durations[count++] = record->time[end] - record->time[start];
+        }
+    }
+
+    if (count == 0)
+    {
+        return ERROR;
+    }
+
+    qsort(durations, count, sizeof(durations[0]), _compare_u32);
+
+    summary->count = count;
+    summary->min_ns = _cycles_to_ns(durations[0]);
+    summary->p50_ns = _cycles_to_ns(durations[((count - 1) * 50) / 100]);
+    summary->p99_ns = _cycles_to_ns(durations[((count - 1) * 99) / 100]);
+    summary->max_ns = _cycles_to_ns(durations[count - 1]);
+
+    return OK;
+}
+
+/**
+ * @brief Get the display name of a stage.
+ */
+const char *vn310_trace_stage_name(enum vn310_trace_stage stage)
+{
+    return (stage < TRACE_STAGE_COUNT) ? stage_names[stage] : "?";
+}
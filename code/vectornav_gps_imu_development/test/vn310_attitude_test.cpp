@@ -0,0 +1,297 @@
+/**
+ * @file vn310_attitude_test.cpp
+ * @brief Host tests and benchmark for the VN310 attitude pipeline.
+ *
+ * This file contains Google Test-based tests for the quaternion and Euler angle
+ * rotation matrices: the two must agree away from gimbal lock, the quaternion path
+ * must keep its accuracy through +/-90 degrees pitch, and the steering vectors of a
+ * simulated stream must be built from the carried quaternion. A benchmark reports
+ * the cost of both paths from attitude to steering vectors.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern "C"
+{
+    #include "vn310_attitude.h"
+    #include "vn310_sim.h"
+}
+
+const int BENCHMARK_ATTITUDES = 1024;
+const int BENCHMARK_ITERATIONS = 500000;
+const int BENCHMARK_LINES_OF_SIGHT = 4;   // Satellites tracked per pointing update
+
+struct Attitude
+{
+    float yaw, pitch, roll;
+    float q[4];
+};
+
+/**
+ * @brief Reference body to NED matrix in double precision.
+ */
+static void _reference_dcm(double yaw, double pitch, double roll, double m[3][3])
+{
+    const double d2r = M_PI / 180.0;
+    double cy = cos(yaw * d2r), sy = sin(yaw * d2r);
+    double cp = cos(pitch * d2r), sp = sin(pitch * d2r);
+    double cr = cos(roll * d2r), sr = sin(roll * d2r);
+
+    m[0][0] = cp * cy; m[0][1] = sr * sp * cy - cr * sy; m[0][2] = cr * sp * cy + sr * sy;
+    m[1][0] = cp * sy; m[1][1] = sr * sp * sy + cr * cy; m[1][2] = cr * sp * sy - sr * cy;
+    m[2][0] = -sp;     m[2][1] = sr * cp;                m[2][2] = cr * cp;
+}
+
+/**
+ * @brief Quaternion of a yaw, pitch, roll attitude computed in double precision.
+ */
+static void _reference_quaternion(double yaw, double pitch, double roll, float q[4])
+{
+    const double h = M_PI / 360.0;
+    double cy = cos(yaw * h), sy = sin(yaw * h);
+    double cp = cos(pitch * h), sp = sin(pitch * h);
+    double cr = cos(roll * h), sr = sin(roll * h);
+
+    q[QUATERNION_X] = (float)(sr * cp * cy - cr * sp * sy);
+    q[QUATERNION_Y] = (float)(cr * sp * cy + sr * cp * sy);
+    q[QUATERNION_Z] = (float)(cr * cp * sy - sr * sp * cy);
+    q[QUATERNION_W] = (float)(cr * cp * cy + sr * sp * sy);
+}
+
+/**
+ * @brief Angle in degrees between a steering vector and the reference one.
+ */
+static double _steering_error_deg(const double m[3][3], const float los_ned[3], const float los_antenna[3])
+{
+    double chord_sq = 0.0;
+
+    // From the chord rather than the dot product, which has no resolution near zero
+    for (int i = 0; i < 3; ++i)
+    {
+        double expected = m[0][i] * los_ned[0] + m[1][i] * los_ned[1] + m[2][i] * los_ned[2];
+        double diff = expected - los_antenna[i];
+        chord_sq += diff * diff;
+    }
+
+    return 2.0 * std::asin(std::min(0.5 * std::sqrt(chord_sq), 1.0)) * 180.0 / M_PI;
+}
+
+static std::vector<Attitude> _random_attitudes(int count, float max_pitch)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> pitch(-max_pitch, max_pitch);
+    std::vector<Attitude> attitudes(count);
+
+    for (Attitude &a : attitudes)
+    {
+        a.yaw = angle(rng);
+        a.pitch = pitch(rng);
+        a.roll = angle(rng);
+        _reference_quaternion(a.yaw, a.pitch, a.roll, a.q);
+    }
+
+    return attitudes;
+}
+
+TEST(vn310_attitude, QuaternionAndEulerMatricesAgree) {
+    for (const Attitude &a : _random_attitudes(1000, 85.0f))
+    {
+        struct vn310_dcm_t from_quaternion, from_euler;
+        vn310_attitude_quaternion_to_dcm(a.q, &from_quaternion);
+        vn310_attitude_ypr_to_dcm(a.yaw, a.pitch, a.roll, &from_euler);
+
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                EXPECT_NEAR(from_quaternion.m[r][c], from_euler.m[r][c], 2e-5f);
+            }
+        }
+
+        float q[4], yaw, pitch, roll;
+        vn310_attitude_quaternion_from_ypr(a.yaw, a.pitch, a.roll, q);
+        EXPECT_TRUE(vn310_attitude_quaternion_valid(q));
+        vn310_attitude_quaternion_to_ypr(q, &yaw, &pitch, &roll);
+        EXPECT_NEAR(pitch, a.pitch, 1e-2f);
+
+        // The double precision pair used by the predictor round trips exactly
+        double qd[4], yaw_d, pitch_d, roll_d;
+        vn310_attitude_quaternion_from_ypr_double(a.yaw, a.pitch, a.roll, qd);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_NEAR(qd[i], q[i], 1e-6);
+        }
+        vn310_attitude_quaternion_to_ypr_double(qd, &yaw_d, &pitch_d, &roll_d);
+        EXPECT_NEAR(yaw_d, a.yaw, 1e-9);
+        EXPECT_NEAR(pitch_d, a.pitch, 1e-9);
+        EXPECT_NEAR(roll_d, a.roll, 1e-9);
+    }
+}
+
+TEST(vn310_attitude, NonUnitQuaternionStillRotates) {
+    float q[4];
+    struct vn310_dcm_t dcm;
+
+    _reference_quaternion(40.0, -20.0, 10.0, q);
+    for (float &component : q)
+    {
+        component *= 1.004f;
+    }
+    vn310_attitude_quaternion_to_dcm(q, &dcm);
+
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            float dot = dcm.m[r][0] * dcm.m[c][0] + dcm.m[r][1] * dcm.m[c][1] + dcm.m[r][2] * dcm.m[c][2];
+            EXPECT_NEAR(dot, r == c ? 1.0f : 0.0f, 1e-5f);
+        }
+    }
+
+    const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    EXPECT_FALSE(vn310_attitude_quaternion_valid(zero));
+}
+
+/**
+ * @brief Sweep the pitch through +90 degrees and compare both paths to the truth.
+ *
+ * The Euler path goes through the angles a downstream consumer would have
+ * received, so it inherits their loss of precision near gimbal lock.
+ */
+TEST(vn310_attitude, SteeringThroughGimbalLock) {
+    float los_ned[3];
+    double quaternion_max = 0.0, euler_max = 0.0;
+
+    vn310_attitude_los_from_az_el(75.0f, 35.0f, los_ned);
+
+    for (int i = 0; i <= 400; ++i)
+    {
+        double pitch = 89.0 + i * 0.0025;
+        double m[3][3];
+        float q[4], yaw_f, pitch_f, roll_f, los_antenna[3];
+        struct vn310_dcm_t dcm;
+
+        _reference_dcm(30.0, pitch, 20.0, m);
+        _reference_quaternion(30.0, pitch, 20.0, q);
+
+        vn310_attitude_quaternion_to_dcm(q, &dcm);
+        vn310_attitude_steering_vector(&dcm, los_ned, los_antenna);
+        quaternion_max = std::max(quaternion_max, _steering_error_deg(m, los_ned, los_antenna));
+
+        vn310_attitude_quaternion_to_ypr(q, &yaw_f, &pitch_f, &roll_f);
+        vn310_attitude_ypr_to_dcm(yaw_f, pitch_f, roll_f, &dcm);
+        vn310_attitude_steering_vector(&dcm, los_ned, los_antenna);
+        euler_max = std::max(euler_max, _steering_error_deg(m, los_ned, los_antenna));
+    }
+
+    std::cout << "Max steering error near 90 deg pitch: quaternion " << quaternion_max
+              << " deg, euler " << euler_max << " deg" << std::endl;
+
+    EXPECT_LT(quaternion_max, 0.01);
+    EXPECT_GT(euler_max, quaternion_max);
+}
+
+/**
+ * @brief Benchmark attitude to steering vectors for both paths.
+ */
+TEST(vn310_attitude, BenchmarkQuaternionAgainstEuler) {
+    std::vector<Attitude> attitudes = _random_attitudes(BENCHMARK_ATTITUDES, 90.0f);
+    float los_ned[BENCHMARK_LINES_OF_SIGHT][3];
+    volatile float sink = 0.0f;
+
+    for (int i = 0; i < BENCHMARK_LINES_OF_SIGHT; ++i)
+    {
+        vn310_attitude_los_from_az_el(i * 90.0f, 20.0f + i * 15.0f, los_ned[i]);
+    }
+
+    auto run = [&](bool quaternion) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        {
+            const Attitude &a = attitudes[i % BENCHMARK_ATTITUDES];
+            struct vn310_dcm_t dcm;
+            float los_antenna[3];
+
+            if (quaternion)
+            {
+                vn310_attitude_quaternion_to_dcm(a.q, &dcm);
+            }
+            else
+            {
+                vn310_attitude_ypr_to_dcm(a.yaw, a.pitch, a.roll, &dcm);
+            }
+            for (int j = 0; j < BENCHMARK_LINES_OF_SIGHT; ++j)
+            {
+                vn310_attitude_steering_vector(&dcm, los_ned[j], los_antenna);
+                sink = sink + los_antenna[0];
+            }
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / BENCHMARK_ITERATIONS;
+    };
+
+    double euler_ns = run(false);
+    double quaternion_ns = run(true);
+
+    std::cout << "Attitude to " << BENCHMARK_LINES_OF_SIGHT << " steering vectors: euler "
+              << euler_ns << " ns, quaternion " << quaternion_ns << " ns" << std::endl;
+
+    EXPECT_LT(quaternion_ns, euler_ns);
+}
+
+TEST(vn310_attitude, SimulatedStreamCarriesQuaternion) {
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+    config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    sim_config.seed = 1;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+
+    struct vn310_sim_trajectory_t trajectory = {};
+    trajectory.format = SIM_FORMAT_BINARY;
+    trajectory.output_rate_hz = 200.0;
+    trajectory.duration_s = 1.0;
+    trajectory.yaw_rate_dps = 10.0;
+    trajectory.motion_period_s = 4.0;
+    trajectory.latitude_deg = 51.5;
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    const struct vn310_pose_t &pose = applet.pose_data;
+    ASSERT_TRUE(vn310_attitude_quaternion_valid(pose.quaternion));
+
+    float los_ned[1][3], los_antenna[1][3];
+    double m[3][3];
+    vn310_attitude_los_from_az_el(120.0f, 45.0f, los_ned[0]);
+    ASSERT_EQ(vn310_applet_get_steering_vectors(&applet, pose.time_gps, los_ned, los_antenna, 1), OK);
+
+    _reference_dcm(pose.yaw, pose.pitch, pose.roll, m);
+    EXPECT_LT(_steering_error_deg(m, los_ned[0], los_antenna[0]), 0.01);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file vn310_command_builder_test.cpp
+ * @brief Host tests for the VN310 command builder.
+ *
+ * This file contains Google Test-based tests for the snprintf-free command
+ * builder: number formatting, checksums against the VN310 user manual, the
+ * multi-value antenna registers and overflow handling.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+extern "C"
+{
+    #include "vn310_command_builder.h"
+    #include "vn310_driver.h"
+}
+
+class vn310_command_builder : public ::testing::Test
+{
+protected:
+    char buffer[VN310_COMMAND_MAX_LENGTH];
+    struct vn310_command_builder_t builder;
+
+    std::string text() const
+    {
+        return std::string(buffer, builder.length);
+    }
+};
+
+TEST_F(vn310_command_builder, EightBitChecksumMatchesManual)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "RRG");
+    vn310_builder_add_uint(&builder, 5);
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), OK);
+    EXPECT_EQ(text(), "$VNRRG,5*46\r\n");
+}
+
+TEST_F(vn310_command_builder, SixteenBitChecksum)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "RRG");
+    vn310_builder_add_uint(&builder, 5);
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_16BIT), OK);
+    EXPECT_EQ(text(), "$VNRRG,5*D5A3\r\n");
+
+    // The checksum of the checksummed part must agree with calculate_16_bit_crc
+    EXPECT_EQ(calculate_16_bit_crc((unsigned char *)"VNRRG,5", 7), 0xD5A3);
+}
+
+TEST_F(vn310_command_builder, NoChecksumPlaceholder)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WNV");
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_NONE), OK);
+    EXPECT_EQ(text(), "$VNWNV*XX\r\n");
+}
+
+TEST_F(vn310_command_builder, BinaryOutputRegister)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_uint(&builder, 75);
+    vn310_builder_add_uint(&builder, 1);
+    vn310_builder_add_uint(&builder, 4);
+    vn310_builder_add_hex(&builder, 0x01, 2);
+    vn310_builder_add_hex(&builder, 0x5078, 4);
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), OK);
+    EXPECT_EQ(text(), "$VNWRG,75,1,4,01,5078*7A\r\n");
+}
+
+TEST_F(vn310_command_builder, AntennaOffsetRegister)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_uint(&builder, 57);
+    vn310_builder_add_fixed(&builder, 0.0, 3);
+    vn310_builder_add_fixed(&builder, -0.25, 3);
+    vn310_builder_add_fixed(&builder, 1.1249996, 3);
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), OK);
+    EXPECT_EQ(text(), "$VNWRG,57,0.000,-0.250,1.125*5B\r\n");
+}
+
+TEST_F(vn310_command_builder, FixedPointFormatting)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_fixed(&builder, 359.9996, 3);   // Rounds up into the whole part
+    vn310_builder_add_fixed(&builder, -0.0001, 3);    // Rounds to zero, no sign
+    vn310_builder_add_fixed(&builder, 12.5, 0);
+    vn310_builder_add_fixed(&builder, 0.038, 6);
+    vn310_builder_add_int(&builder, -42);
+    vn310_builder_add_int(&builder, INT32_MIN);
+    vn310_builder_add_uint(&builder, UINT32_MAX);
+
+    ASSERT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_NONE), OK);
+    EXPECT_EQ(text(), "$VNWRG,360.000,0.000,13,0.038000,-42,-2147483648,4294967295*XX\r\n");
+}
+
+TEST_F(vn310_command_builder, RejectsUnformattableValues)
+{
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_fixed(&builder, NAN, 3);
+    EXPECT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), ERROR);
+
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_fixed(&builder, 1.0, VN310_BUILDER_MAX_DECIMALS + 1);
+    EXPECT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), ERROR);
+
+    vn310_builder_begin(&builder, buffer, sizeof(buffer), "WRG");
+    vn310_builder_add_text(&builder, "1*00\r\n$VNRST");
+    EXPECT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), ERROR);
+}
+
+TEST_F(vn310_command_builder, NeverWritesPastCapacity)
+{
+    char small[16];
+    memset(small, '#', sizeof(small));
+
+    vn310_builder_begin(&builder, small, 12, "WRG");
+    vn310_builder_add_uint(&builder, 93);
+    vn310_builder_add_fixed(&builder, 1.5, 3);
+
+    EXPECT_EQ(vn310_builder_finish(&builder, VN310_CHECKSUM_8BIT), ERROR);
+    EXPECT_LE(builder.length, 12);
+    for (size_t i = 12; i < sizeof(small); ++i)
+    {
+        EXPECT_EQ(small[i], '#');
+    }
+}
+
+TEST(vn310_driver_command, AntennaBWritesScaledBaseline)
+{
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct vn310_driver_state_t state;
+    struct vn310_driver_config_t config = {};
+    config.vectornav_uart_config.rx_buf = rx_buf;
+    config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+
+    ASSERT_EQ(vn310_driver_init(&state, &config), OK);
+    ASSERT_EQ(vn310_driver_configure(&state), OK);
+    ASSERT_EQ(vn310_driver_set_antenna_a(&state, 0.0, -0.75, -0.5), OK);
+    ASSERT_EQ(vn310_driver_set_antenna_b(&state, 0.0, 0.75, -0.5), OK);
+    ASSERT_EQ(vn310_driver_process(&state, 0), OK);
+
+    std::string sent(reinterpret_cast<const char *>(state.uart_state.tx_log), state.uart_state.tx_log_size);
+    EXPECT_EQ(sent,
+              "$VNWRG,57,0.000,-0.750,-0.500*71\r\n"
+              "$VNWRG,93,0.000,1.500,0.000,0.038,0.038,0.038*73\r\n");
+}
+
+TEST(vn310_driver_command, SetterFailsCleanlyWhenQueueFull)
+{
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct vn310_driver_state_t state;
+    struct vn310_driver_config_t config = {};
+    config.vectornav_uart_config.rx_buf = rx_buf;
+    config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+
+    ASSERT_EQ(vn310_driver_init(&state, &config), OK);
+    ASSERT_EQ(vn310_driver_configure(&state), OK);
+
+    const char command[] = "$VNRRG,5*XX\r\n";
+    while (vn310_driver_send_command(&state, command, sizeof(command) - 1, NULL, NULL) == OK)
+    {
+    }
+
+    // The fields are added to a builder with no slot behind it
+    EXPECT_EQ(vn310_driver_set_antenna_a(&state, 1.0, 2.0, 3.0), ERROR);
+    EXPECT_EQ(vn310_driver_set_antenna_baseline(&state, 1.0, 0.0, 0.0, 0.038, 0.038, 0.038), ERROR);
+    EXPECT_EQ(vn310_driver_set_initial_heading(&state, 90.0), ERROR);
+    EXPECT_EQ(state.config.sensor_config.antenna_a[0], 0.0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
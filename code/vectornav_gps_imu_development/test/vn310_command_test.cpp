@@ -0,0 +1,220 @@
+/**
+ * @file vn310_command_test.cpp
+ * @brief Host tests for the VN310 command/response engine.
+ *
+ * This file contains Google Test-based tests for pipelined command submission,
+ * response matching, timeouts and retries, barrier ordering and batch completion.
+ * Transmitted commands are read back from the host UART shim's transmit log.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+extern "C"
+{
+    #include "vn310_command.h"
+}
+
+struct callback_record_t
+{
+    int calls;
+    STATUS status;
+    std::string response;
+};
+
+static void _record_callback(void *context, STATUS status, const char *response)
+{
+    callback_record_t *record = static_cast<callback_record_t *>(context);
+    record->calls++;
+    record->status = status;
+    record->response = (response != NULL) ? response : "";
+}
+
+static void _batch_callback(void *context, uint8_t failed_count)
+{
+    int *result = static_cast<int *>(context);
+    *result = failed_count;
+}
+
+class vn310_command : public ::testing::Test
+{
+protected:
+    struct vn310_command_engine_t engine;
+    struct driver_uart_state_t uart;
+
+    void SetUp() override
+    {
+        struct vn310_command_config_t config = {};
+        config.max_in_flight = 4;
+        config.timeout_ms = 100;
+        config.retries = 1;
+        ASSERT_EQ(vn310_command_init(&engine, &config), OK);
+        memset(&uart, 0, sizeof(uart));
+    }
+
+    STATUS submit(const char *command, bool barrier = false, callback_record_t *record = NULL)
+    {
+        return vn310_command_submit(&engine, command, strlen(command), barrier, record ? _record_callback : NULL, record);
+    }
+
+    std::string tx_log() const
+    {
+        return std::string(reinterpret_cast<const char *>(uart.tx_log), uart.tx_log_size);
+    }
+};
+
+TEST_F(vn310_command, PipelinesUpToMaxInFlight)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        ASSERT_EQ(submit("$VNRRG,1*XX\r\n"), OK);
+    }
+
+    vn310_command_process(&engine, &uart, 0);
+
+    EXPECT_EQ(uart.tx_count, 4u);
+    EXPECT_EQ(vn310_command_pending(&engine), 6);
+
+    EXPECT_EQ(vn310_command_handle_response(&engine, "$VNRRG,01,VN-310*XX"), OK);
+    vn310_command_process(&engine, &uart, 1);
+
+    EXPECT_EQ(uart.tx_count, 5u);
+    EXPECT_EQ(vn310_command_pending(&engine), 5);
+}
+
+TEST_F(vn310_command, MatchesResponsesByIdAndRegister)
+{
+    callback_record_t model = {}, baud = {};
+
+    ASSERT_EQ(submit("$VNRRG,1*XX\r\n", false, &model), OK);
+    ASSERT_EQ(submit("$VNRRG,5*XX\r\n", false, &baud), OK);
+    vn310_command_process(&engine, &uart, 0);
+
+    // Responses for other registers or commands do not complete anything
+    EXPECT_EQ(vn310_command_handle_response(&engine, "$VNWRG,5,115200*XX"), ERROR);
+    EXPECT_EQ(engine.unmatched_count, 1u);
+
+    EXPECT_EQ(vn310_command_handle_response(&engine, "$VNRRG,05,115200*XX"), OK);
+    EXPECT_EQ(baud.calls, 1);
+    EXPECT_EQ(baud.status, OK);
+    EXPECT_EQ(baud.response, "$VNRRG,05,115200*XX");
+    EXPECT_EQ(model.calls, 0);
+
+    EXPECT_EQ(vn310_command_handle_response(&engine, "$VNRRG,01,VN-310*XX"), OK);
+    EXPECT_EQ(model.calls, 1);
+    EXPECT_EQ(vn310_command_pending(&engine), 0);
+}
+
+TEST_F(vn310_command, ErrorResponseFailsOldestInFlight)
+{
+    callback_record_t first = {}, second = {};
+
+    ASSERT_EQ(submit("$VNWRG,6,0*XX\r\n", false, &first), OK);
+    ASSERT_EQ(submit("$VNWRG,7,50*XX\r\n", false, &second), OK);
+    vn310_command_process(&engine, &uart, 0);
+
+    EXPECT_EQ(vn310_command_handle_response(&engine, "$VNERR,03*XX"), OK);
+    EXPECT_EQ(first.calls, 1);
+    EXPECT_EQ(first.status, ERROR);
+    EXPECT_EQ(second.calls, 0);
+    EXPECT_EQ(engine.failed_count, 1u);
+}
+
+TEST_F(vn310_command, RetriesThenTimesOut)
+{
+    callback_record_t record = {};
+
+    ASSERT_EQ(submit("$VNRRG,1*XX\r\n", false, &record), OK);
+    vn310_command_process(&engine, &uart, 0);
+    vn310_command_process(&engine, &uart, 99);
+    EXPECT_EQ(uart.tx_count, 1u);
+
+    vn310_command_process(&engine, &uart, 100);
+    EXPECT_EQ(uart.tx_count, 2u);
+    EXPECT_EQ(engine.retry_count, 1u);
+    EXPECT_EQ(record.calls, 0);
+
+    vn310_command_process(&engine, &uart, 200);
+    EXPECT_EQ(uart.tx_count, 2u);
+    EXPECT_EQ(record.calls, 1);
+    EXPECT_EQ(record.status, ERROR);
+    EXPECT_EQ(engine.timeout_count, 1u);
+    EXPECT_EQ(vn310_command_pending(&engine), 0);
+}
+
+TEST_F(vn310_command, BarrierIsSentAlone)
+{
+    ASSERT_EQ(submit("$VNWRG,6,0*XX\r\n"), OK);
+    ASSERT_EQ(submit("$VNWRG,5,230400*XX\r\n", true), OK);
+    ASSERT_EQ(submit("$VNRRG,1*XX\r\n"), OK);
+
+    // Only the command ahead of the barrier goes out
+    vn310_command_process(&engine, &uart, 0);
+    EXPECT_EQ(tx_log(), "$VNWRG,6,0*XX\r\n");
+
+    // The barrier goes out on its own
+    ASSERT_EQ(vn310_command_handle_response(&engine, "$VNWRG,06,0*XX"), OK);
+    vn310_command_process(&engine, &uart, 1);
+    EXPECT_EQ(tx_log(), "$VNWRG,6,0*XX\r\n$VNWRG,5,230400*XX\r\n");
+
+    // And holds back everything behind it until it completes
+    vn310_command_process(&engine, &uart, 2);
+    EXPECT_EQ(uart.tx_count, 2u);
+
+    ASSERT_EQ(vn310_command_handle_response(&engine, "$VNWRG,05,230400*XX"), OK);
+    vn310_command_process(&engine, &uart, 3);
+    EXPECT_EQ(uart.tx_count, 3u);
+}
+
+TEST_F(vn310_command, BatchReportsFailedCount)
+{
+    int failed = -1;
+
+    ASSERT_EQ(vn310_command_batch_begin(&engine, _batch_callback, &failed), OK);
+    ASSERT_EQ(submit("$VNWRG,6,0*XX\r\n"), OK);
+    ASSERT_EQ(submit("$VNWRG,57,0.000,0.000,0.000*XX\r\n"), OK);
+    ASSERT_EQ(submit("$VNWRG,93,1.500,0.000,0.000,0.038,0.038,0.038*XX\r\n"), OK);
+    EXPECT_EQ(vn310_command_batch_begin(&engine, _batch_callback, &failed), ERROR);
+    ASSERT_EQ(vn310_command_batch_end(&engine), OK);
+
+    vn310_command_process(&engine, &uart, 0);
+    EXPECT_EQ(uart.tx_count, 3u);
+
+    ASSERT_EQ(vn310_command_handle_response(&engine, "$VNWRG,06,0*XX"), OK);
+    ASSERT_EQ(vn310_command_handle_response(&engine, "$VNERR,05*XX"), OK);
+    EXPECT_EQ(failed, -1);
+
+    ASSERT_EQ(vn310_command_handle_response(&engine, "$VNWRG,93,+1.500,+0.000,+0.000,+0.038,+0.038,+0.038*XX"), OK);
+    EXPECT_EQ(failed, 1);
+}
+
+TEST_F(vn310_command, EmptyBatchCompletesImmediately)
+{
+    int failed = -1;
+
+    ASSERT_EQ(vn310_command_batch_begin(&engine, _batch_callback, &failed), OK);
+    ASSERT_EQ(vn310_command_batch_end(&engine), OK);
+    EXPECT_EQ(failed, 0);
+}
+
+TEST_F(vn310_command, RejectsInvalidCommands)
+{
+    EXPECT_EQ(submit("garbage\r\n"), ERROR);
+    EXPECT_EQ(vn310_command_submit(&engine, "$VNRRG,1*XX\r\n", 0, false, NULL, NULL), ERROR);
+
+    for (int i = 0; i < VN310_COMMAND_QUEUE_DEPTH; ++i)
+    {
+        ASSERT_EQ(submit("$VNRRG,1*XX\r\n"), OK);
+    }
+    EXPECT_EQ(submit("$VNRRG,1*XX\r\n"), ERROR);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
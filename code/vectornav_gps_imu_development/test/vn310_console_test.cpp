@@ -0,0 +1,266 @@
+/**
+ * @file vn310_console_test.cpp
+ * @brief Host tests for the VN310 console stream queue.
+ *
+ * This file contains Google Test-based tests for the queue that streams raw frames
+ * to the CLI: decimation, text and hex formatting, dropping the oldest lines when
+ * the console falls behind, and the CLI commands that drive it. A stress test runs
+ * the applet side and the console side on separate threads and checks that every
+ * line is either printed whole and in order or counted as dropped.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+extern "C"
+{
+    #include "vn310_console.h"
+    #include "vn310_sim.h"
+}
+
+const uint32_t STRESS_FRAME_COUNT = 500000;
+
+/**
+ * @brief Fills an ASCII frame with its sequence number written twice, so a torn line shows.
+ */
+static void _frame_fill(struct vn310_frame_t *frame, uint32_t sequence)
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->type = MSG_ASYNC;
+    frame->size = (uint16_t)snprintf(frame->data, sizeof(frame->data), "$SEQ,%010u,%010u\r\n", sequence, sequence);
+}
+
+TEST(vn310_console, decimation_and_forced_frames)
+{
+    static struct vn310_console_t console;
+    struct vn310_console_line_t line;
+    struct vn310_frame_t frame;
+
+    ASSERT_EQ(vn310_console_init(&console), OK);
+    vn310_console_configure(&console, 4, CONSOLE_MODE_TEXT);
+
+    for (uint32_t i = 0; i < 12; ++i)
+    {
+        _frame_fill(&frame, i);
+        vn310_console_stream(&console, &frame, false);
+    }
+    EXPECT_EQ(console.queued_count, 3u);
+    EXPECT_EQ(console.decimated_count, 9u);
+
+    // A single-shot request is never decimated away
+    _frame_fill(&frame, 99);
+    vn310_console_stream(&console, &frame, true);
+
+    const char *expected[] = {"$SEQ,0000000000,0000000000", "$SEQ,0000000004,0000000004",
+                              "$SEQ,0000000008,0000000008", "$SEQ,0000000099,0000000099"};
+    for (const char *text : expected)
+    {
+        ASSERT_TRUE(vn310_console_pop(&console, &line));
+        EXPECT_STREQ(line.text, text);
+        EXPECT_EQ(line.length, strlen(text));
+    }
+    EXPECT_FALSE(vn310_console_pop(&console, &line));
+    EXPECT_EQ(console.printed_count, 4u);
+}
+
+TEST(vn310_console, text_and_hex_formatting)
+{
+    static struct vn310_console_t console;
+    struct vn310_console_line_t line;
+    struct vn310_frame_t frame = {};
+
+    ASSERT_EQ(vn310_console_init(&console), OK);
+
+    // Control characters are not passed through to the terminal
+    frame.type = MSG_ASYNC;
+    frame.size = 9;
+    memcpy(frame.data, "$VN\x1b[2J\r\n", 9);
+    vn310_console_stream(&console, &frame, false);
+    ASSERT_TRUE(vn310_console_pop(&console, &line));
+    EXPECT_STREQ(line.text, "$VN.[2J");
+
+    // Binary frames are always dumped as hex
+    struct vn310_pose_t pose = {};
+    pose.yaw = 45.0f;
+    size_t size = vn310_sim_build_binary(&pose, (uint8_t *)frame.data, sizeof(frame.data));
+    ASSERT_EQ(size, (size_t)VN310_BINARY_CONFIG0_SIZE);
+    frame.type = MSG_BINARY;
+    frame.size = (uint16_t)size;
+    vn310_console_stream(&console, &frame, false);
+    ASSERT_TRUE(vn310_console_pop(&console, &line));
+    EXPECT_EQ(line.length, 2 * size);
+    EXPECT_EQ(strncmp(line.text, "FA", 2), 0);
+
+    // A frame too long for one line is cut short and marked
+    vn310_console_configure(&console, 1, CONSOLE_MODE_HEX);
+    frame.type = MSG_ASYNC;
+    frame.size = VN310_CONSOLE_LINE_SIZE;
+    memset(frame.data, 0xAB, frame.size);
+    vn310_console_stream(&console, &frame, false);
+    ASSERT_TRUE(vn310_console_pop(&console, &line));
+    EXPECT_LT(line.length, VN310_CONSOLE_LINE_SIZE);
+    EXPECT_EQ(strlen(line.text), line.length);
+    EXPECT_STREQ(&line.text[line.length - 4], "AB..");
+}
+
+TEST(vn310_console, drops_oldest_when_full)
+{
+    static struct vn310_console_t console;
+    struct vn310_console_line_t line;
+    struct vn310_frame_t frame;
+
+    ASSERT_EQ(vn310_console_init(&console), OK);
+
+    for (uint32_t i = 0; i < VN310_CONSOLE_DEPTH + 5; ++i)
+    {
+        _frame_fill(&frame, i);
+        vn310_console_stream(&console, &frame, false);
+    }
+    EXPECT_EQ(console.dropped_count, 5u);
+
+    // The console shows the newest lines, not the ones it fell behind on
+    uint32_t sequence = 5;
+    while (vn310_console_pop(&console, &line))
+    {
+        char expected[VN310_CONSOLE_LINE_SIZE];
+        snprintf(expected, sizeof(expected), "$SEQ,%010u,%010u", sequence, sequence);
+        EXPECT_STREQ(line.text, expected);
+        sequence++;
+    }
+    EXPECT_EQ(sequence, (uint32_t)VN310_CONSOLE_DEPTH + 5);
+}
+
+/**
+ * @brief Runs the applet side and a slow console side on separate threads.
+ */
+TEST(vn310_console, two_thread_stress)
+{
+    static struct vn310_console_t console;
+    ASSERT_EQ(vn310_console_init(&console), OK);
+
+    std::atomic<bool> done(false);
+    uint32_t printed = 0;
+    uint32_t torn = 0;
+    uint32_t reordered = 0;
+
+    std::thread producer([&]() {
+        struct vn310_frame_t frame;
+        for (uint32_t i = 0; i < STRESS_FRAME_COUNT; ++i)
+        {
+            _frame_fill(&frame, i);
+            vn310_console_stream(&console, &frame, false);
+        }
+        done.store(true);
+    });
+
+    std::thread consumer([&]() {
+        struct vn310_console_line_t line;
+        int64_t last = -1;
+        while (true)
+        {
+            bool finished = done.load();
+            if (!vn310_console_pop(&console, &line))
+            {
+                if (finished)
+                {
+                    break;
+                }
+                continue;
+            }
+            unsigned first = 0;
+            unsigned second = 0;
+            if (sscanf(line.text, "$SEQ,%u,%u", &first, &second) != 2 || first != second)
+            {
+                torn++;
+                continue;
+            }
+            if ((int64_t)first <= last)
+            {
+                reordered++;
+            }
+            last = first;
+            printed++;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    std::cout << "Console stress: " << printed << " printed, " << console.dropped_count << " dropped of "
+              << STRESS_FRAME_COUNT << std::endl;
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(reordered, 0u);
+    EXPECT_EQ(printed + console.dropped_count, STRESS_FRAME_COUNT);
+    EXPECT_EQ(console.printed_count, printed);
+}
+
+TEST(vn310_console, cli_commands_and_applet)
+{
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+    config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+
+    struct vn310_pose_t pose = {};
+    pose.time_gps_pps = 1000000000ULL;
+    uint8_t binary[UART_DMA_READ_BUF_SIZE];
+    size_t size = vn310_sim_build_binary(&pose, binary, sizeof(binary));
+
+    EXPECT_EQ(cli_execute(&cli_state, "vn310 cli stream"), ERROR);
+
+    // The usage printed is for the command that was typed
+    cli_state.quiet = false;
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(cli_execute(&cli_state, "vn310 cli pose_stream"), ERROR);
+    std::string usage = testing::internal::GetCapturedStdout();
+    cli_state.quiet = true;
+    EXPECT_NE(usage.find("vn310 cli pose_stream <start|stop>"), std::string::npos) << usage;
+    EXPECT_EQ(usage.find("every_n"), std::string::npos) << usage;
+
+    ASSERT_EQ(cli_execute(&cli_state, "vn310 cli stream start 10 hex"), OK);
+    EXPECT_EQ(applet.console.decimation, 10u);
+    EXPECT_EQ(applet.console.mode, CONSOLE_MODE_HEX);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(vn310_sim_deliver(&sim, binary, (uint16_t)size, 0), OK);
+    }
+    EXPECT_EQ(applet.console.queued_count, 10u);
+    EXPECT_EQ(applet.console.printed_count, 10u);
+
+    // A single frame is printed even after streaming was stopped
+    ASSERT_EQ(cli_execute(&cli_state, "vn310 cli stream single"), OK);
+    ASSERT_EQ(vn310_sim_deliver(&sim, binary, (uint16_t)size, 0), OK);
+    ASSERT_EQ(vn310_sim_deliver(&sim, binary, (uint16_t)size, 0), OK);
+    EXPECT_EQ(applet.console.queued_count, 11u);
+    EXPECT_EQ(cli_execute(&cli_state, "vn310 cli stream stats"), OK);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,339 @@
+/**
+ * @file vn310_frames_test.cpp
+ * @brief Host tests and benchmark for the VN310 coordinate frame transforms.
+ *
+ * This file contains Google Test-based tests for the geodetic, ECEF, NED and body
+ * frame transforms, the cached platform site, the tile element layout and the
+ * satellite lines of sight of a simulated stream. A benchmark reports the cost per
+ * satellite of a pointing update for a LEO constellation, batched with the cached
+ * site against a per-satellite path that recomputes the trigonometry each time.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+extern "C"
+{
+    #include "vn310_frames.h"
+    #include "vn310_sim.h"
+}
+
+const int BENCHMARK_SATELLITES = 1024;     // Visible and candidate satellites per pointing update
+const int BENCHMARK_UPDATES = 2000;
+const double GEO_RADIUS_M = 42164000.0;
+const double WGS84_B = VN310_FRAMES_WGS84_A * (1.0 - VN310_FRAMES_WGS84_F);
+
+/**
+ * @brief ECEF of a point straight above a geodetic position.
+ */
+static void _above(double latitude, double longitude, double altitude, double height, double ecef[3])
+{
+    vn310_frames_lla_to_ecef(latitude, longitude, altitude + height, ecef);
+}
+
+TEST(vn310_frames, LlaToEcefReferencePoints) {
+    double ecef[3];
+
+    vn310_frames_lla_to_ecef(0.0, 0.0, 0.0, ecef);
+    EXPECT_NEAR(ecef[0], VN310_FRAMES_WGS84_A, 1e-6);
+    EXPECT_NEAR(ecef[1], 0.0, 1e-6);
+    EXPECT_NEAR(ecef[2], 0.0, 1e-6);
+
+    vn310_frames_lla_to_ecef(90.0, 0.0, 0.0, ecef);
+    EXPECT_NEAR(ecef[2], WGS84_B, 1e-6);
+
+    vn310_frames_lla_to_ecef(0.0, 90.0, 100.0, ecef);
+    EXPECT_NEAR(ecef[1], VN310_FRAMES_WGS84_A + 100.0, 1e-6);
+
+    // Batch and single conversions agree
+    double latitude[2] = {51.5, -33.9}, longitude[2] = {-0.1, 151.2}, altitude[2] = {50.0, 2000.0};
+    double x[2], y[2], z[2];
+    vn310_frames_lla_to_ecef_batch(latitude, longitude, altitude, x, y, z, 2);
+    for (int i = 0; i < 2; ++i)
+    {
+        vn310_frames_lla_to_ecef(latitude[i], longitude[i], altitude[i], ecef);
+        EXPECT_DOUBLE_EQ(x[i], ecef[0]);
+        EXPECT_DOUBLE_EQ(y[i], ecef[1]);
+        EXPECT_DOUBLE_EQ(z[i], ecef[2]);
+    }
+}
+
+TEST(vn310_frames, EcefToNedAroundTheSite) {
+    struct vn310_frames_site_t site = {};
+    ASSERT_TRUE(vn310_frames_site_update(&site, 51.5, -0.1, 50.0));
+
+    double x[3], y[3], z[3], ecef[3];
+    _above(51.5, -0.1, 50.0, 1000.0, ecef);
+    x[0] = ecef[0]; y[0] = ecef[1]; z[0] = ecef[2];
+    vn310_frames_lla_to_ecef(51.501, -0.1, 50.0, ecef);
+    x[1] = ecef[0]; y[1] = ecef[1]; z[1] = ecef[2];
+    vn310_frames_lla_to_ecef(51.5, -0.099, 50.0, ecef);
+    x[2] = ecef[0]; y[2] = ecef[1]; z[2] = ecef[2];
+
+    double n[3], e[3], d[3];
+    vn310_frames_ecef_to_ned_batch(&site, x, y, z, n, e, d, 3);
+
+    // Straight up
+    EXPECT_NEAR(n[0], 0.0, 1e-6);
+    EXPECT_NEAR(e[0], 0.0, 1e-6);
+    EXPECT_NEAR(d[0], -1000.0, 1e-6);
+
+    // A thousandth of a degree north and east, slightly below the local horizon
+    EXPECT_NEAR(n[1], 111.26, 0.05);
+    EXPECT_NEAR(e[1], 0.0, 1e-6);
+    EXPECT_GT(d[1], 0.0);
+    EXPECT_NEAR(n[2], 0.0, 0.01);
+    EXPECT_NEAR(e[2], 69.5, 0.1);
+}
+
+TEST(vn310_frames, SiteIsOnlyRecomputedWhenThePlatformMoves) {
+    struct vn310_frames_site_t site = {};
+
+    EXPECT_TRUE(vn310_frames_site_update(&site, 51.5, -0.1, 50.0));
+    EXPECT_FALSE(vn310_frames_site_update(&site, 51.5 + 5e-6, -0.1 - 5e-6, 50.5));
+    EXPECT_TRUE(vn310_frames_site_update(&site, 51.5 + 2e-5, -0.1, 50.0));
+    EXPECT_TRUE(vn310_frames_site_update(&site, 51.5 + 2e-5, -0.1, 52.0));
+    EXPECT_EQ(site.update_count, 3u);
+
+    // Small moves accumulate against the last recomputed position, not the last call
+    for (int i = 1; i <= 10; ++i)
+    {
+        vn310_frames_site_update(&site, 51.5 + 2e-5 + i * 4e-6, -0.1, 52.0);
+    }
+    EXPECT_EQ(site.update_count, 6u);
+}
+
+TEST(vn310_frames, GeostationaryLineOfSight) {
+    struct vn310_frames_site_t site = {};
+    vn310_frames_site_update(&site, 0.0, 10.0, 0.0);
+
+    double x = GEO_RADIUS_M * cos(10.0 * M_PI / 180.0);
+    double y = GEO_RADIUS_M * sin(10.0 * M_PI / 180.0);
+    double z = 0.0;
+    float los[3], range;
+    struct vn310_dcm_t dcm;
+
+    // Level, any heading: straight up is -z in the body frame
+    vn310_attitude_ypr_to_dcm(73.0f, 0.0f, 0.0f, &dcm);
+    vn310_frames_ecef_to_body_los_batch(&site, &dcm, &x, &y, &z, &los[0], &los[1], &los[2], &range, 1);
+    EXPECT_NEAR(los[0], 0.0f, 1e-6f);
+    EXPECT_NEAR(los[1], 0.0f, 1e-6f);
+    EXPECT_NEAR(los[2], -1.0f, 1e-6f);
+    EXPECT_NEAR(range, GEO_RADIUS_M - VN310_FRAMES_WGS84_A, 4.0);
+
+    // Nose up by 30 degrees: the satellite moves 30 degrees towards the nose
+    vn310_attitude_ypr_to_dcm(0.0f, 30.0f, 0.0f, &dcm);
+    vn310_frames_ecef_to_body_los_batch(&site, &dcm, &x, &y, &z, &los[0], &los[1], &los[2], &range, 1);
+    EXPECT_NEAR(los[0], sinf(30.0f * (float)M_PI / 180.0f), 1e-6f);
+    EXPECT_NEAR(los[2], -cosf(30.0f * (float)M_PI / 180.0f), 1e-6f);
+}
+
+TEST(vn310_frames, FusedPathMatchesTheSeparateStages) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> latitude(-60.0, 60.0), longitude(-180.0, 180.0);
+    const int count = 64;
+
+    struct vn310_frames_site_t site = {};
+    vn310_frames_site_update(&site, 51.5, -0.1, 50.0);
+    struct vn310_dcm_t dcm;
+    float q[4];
+    vn310_attitude_quaternion_from_ypr(120.0f, 12.0f, -7.0f, q);
+    vn310_attitude_quaternion_to_dcm(q, &dcm);
+
+    std::vector<double> lat(count), lon(count), alt(count, 550000.0), x(count), y(count), z(count);
+    for (int i = 0; i < count; ++i)
+    {
+        lat[i] = latitude(rng);
+        lon[i] = longitude(rng);
+    }
+    vn310_frames_lla_to_ecef_batch(lat.data(), lon.data(), alt.data(), x.data(), y.data(), z.data(), count);
+
+    std::vector<float> lx(count), ly(count), lz(count), range(count);
+    vn310_frames_ecef_to_body_los_batch(&site, &dcm, x.data(), y.data(), z.data(),
+                                        lx.data(), ly.data(), lz.data(), range.data(), count);
+
+    // The NED output feeds the body rotation directly
+    std::vector<double> n(count), e(count), d(count), bx(count), by(count), bz(count);
+    vn310_frames_ecef_to_ned_batch(&site, x.data(), y.data(), z.data(), n.data(), e.data(), d.data(), count);
+    vn310_frames_ned_to_body_batch(&dcm, n.data(), e.data(), d.data(), bx.data(), by.data(), bz.data(), count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        double norm = sqrt(n[i] * n[i] + e[i] * e[i] + d[i] * d[i]);
+        EXPECT_NEAR(range[i], norm, norm * 1e-6);
+        EXPECT_NEAR(sqrt(bx[i] * bx[i] + by[i] * by[i] + bz[i] * bz[i]), norm, norm * 1e-6);
+
+        float los_ned[3] = {(float)(n[i] / norm), (float)(e[i] / norm), (float)(d[i] / norm)}, los_antenna[3];
+        vn310_attitude_steering_vector(&dcm, los_ned, los_antenna);
+
+        EXPECT_NEAR(lx[i], bx[i] / norm, 1e-6);
+        EXPECT_NEAR(ly[i], by[i] / norm, 1e-6);
+        EXPECT_NEAR(lz[i], bz[i] / norm, 1e-6);
+        EXPECT_NEAR(bx[i] / norm, los_antenna[0], 1e-6);
+        EXPECT_NEAR(by[i] / norm, los_antenna[1], 1e-6);
+        EXPECT_NEAR(bz[i] / norm, los_antenna[2], 1e-6);
+    }
+}
+
+TEST(vn310_frames, TileOffsetsAndPathDifferences) {
+    const int nx = 4, ny = 4;
+    const double spacing = 0.0125;
+    struct algorithm_EW_patch_t patches[nx * ny];
+    float ex[nx * ny], ey[nx * ny], path[nx * ny];
+
+    EXPECT_EQ(vn310_frames_tile_offsets(0, 0, 0, ny, spacing, patches, ex, ey), ERROR);
+    ASSERT_EQ(vn310_frames_tile_offsets(1, 2, nx, ny, spacing, patches, ex, ey), OK);
+
+    EXPECT_FLOAT_EQ(ex[0], 0.05f);
+    EXPECT_FLOAT_EQ(ey[0], 0.10f);
+    EXPECT_FLOAT_EQ(ex[1 * nx + 3], 0.05f + 3 * 0.0125f);
+    EXPECT_FLOAT_EQ(ey[1 * nx + 3], 0.10f + 0.0125f);
+
+    // 30 degrees off boresight towards +x: only the x offsets contribute
+    float los[3] = {0.5f, 0.0f, -sqrtf(3.0f) / 2.0f};
+    vn310_frames_path_difference_batch(ex, ey, los, path, nx * ny);
+    for (int i = 0; i < nx * ny; ++i)
+    {
+        EXPECT_FLOAT_EQ(path[i], 0.5f * ex[i]);
+    }
+
+    // At boresight every element is in phase
+    float boresight[3] = {0.0f, 0.0f, -1.0f};
+    vn310_frames_path_difference_batch(ex, ey, boresight, path, nx * ny);
+    for (int i = 0; i < nx * ny; ++i)
+    {
+        EXPECT_FLOAT_EQ(path[i], 0.0f);
+    }
+}
+
+TEST(vn310_frames, SimulatedStreamPointsAtSatellites) {
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+    config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+
+    struct vn310_sim_trajectory_t trajectory = {};
+    trajectory.format = SIM_FORMAT_BINARY;
+    trajectory.output_rate_hz = 200.0;
+    trajectory.duration_s = 1.0;
+    trajectory.yaw_rate_dps = 10.0;
+    trajectory.pitch_amplitude_deg = 5.0;
+    trajectory.motion_period_s = 4.0;
+    trajectory.latitude_deg = 51.5;
+    trajectory.longitude_deg = -0.1;
+    trajectory.altitude_m = 120.0;
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    const struct vn310_pose_t &pose = applet.pose_data;
+    EXPECT_NEAR(pose.altitude, 120.0f, 1e-3f);
+
+    // A satellite straight above the platform
+    double ecef[3];
+    _above(pose.latitude, pose.longitude, pose.altitude, 550000.0, ecef);
+    float los[3], range;
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ(vn310_applet_get_satellite_los(&applet, pose.time_gps, &ecef[0], &ecef[1], &ecef[2],
+                                                 &los[0], &los[1], &los[2], &range, 1), OK);
+    }
+    EXPECT_EQ(applet.site.update_count, 1u);
+    EXPECT_NEAR(range, 550000.0f, 1.0f);
+
+    // Up in NED seen from the reported attitude
+    struct vn310_dcm_t dcm;
+    float up[3] = {0.0f, 0.0f, -1.0f}, expected[3];
+    vn310_attitude_quaternion_to_dcm(pose.quaternion, &dcm);
+    vn310_attitude_steering_vector(&dcm, up, expected);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_NEAR(los[i], expected[i], 1e-5f);
+    }
+}
+
+/**
+ * @brief Benchmark a pointing update for a LEO constellation.
+ */
+TEST(vn310_frames, BenchmarkBatchedAgainstPerSatellite) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> latitude(-70.0, 70.0), longitude(-180.0, 180.0);
+    std::vector<double> lat(BENCHMARK_SATELLITES), lon(BENCHMARK_SATELLITES), alt(BENCHMARK_SATELLITES, 550000.0);
+    std::vector<double> x(BENCHMARK_SATELLITES), y(BENCHMARK_SATELLITES), z(BENCHMARK_SATELLITES);
+    std::vector<float> lx(BENCHMARK_SATELLITES), ly(BENCHMARK_SATELLITES), lz(BENCHMARK_SATELLITES), range(BENCHMARK_SATELLITES);
+
+    for (int i = 0; i < BENCHMARK_SATELLITES; ++i)
+    {
+        lat[i] = latitude(rng);
+        lon[i] = longitude(rng);
+    }
+    vn310_frames_lla_to_ecef_batch(lat.data(), lon.data(), alt.data(), x.data(), y.data(), z.data(), BENCHMARK_SATELLITES);
+
+    volatile float sink = 0.0f;
+    float q[4];
+    vn310_attitude_quaternion_from_ypr(120.0f, 12.0f, -7.0f, q);
+
+    // Per satellite: the platform trigonometry and attitude matrix are rebuilt for each one
+    auto start = std::chrono::steady_clock::now();
+    for (int u = 0; u < BENCHMARK_UPDATES; ++u)
+    {
+        double platform_latitude = 51.5 + u * 1e-7;
+        for (int i = 0; i < BENCHMARK_SATELLITES; ++i)
+        {
+            struct vn310_frames_site_t site = {};
+            struct vn310_dcm_t dcm;
+            vn310_frames_site_update(&site, platform_latitude, -0.1, 50.0);
+            vn310_attitude_ypr_to_dcm(120.0f, 12.0f, -7.0f, &dcm);
+            vn310_frames_ecef_to_body_los_batch(&site, &dcm, &x[i], &y[i], &z[i], &lx[i], &ly[i], &lz[i], &range[i], 1);
+        }
+        sink = sink + lx[u % BENCHMARK_SATELLITES];
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double per_satellite_ns = elapsed.count() / BENCHMARK_UPDATES / BENCHMARK_SATELLITES;
+
+    // Batched: the cached site and one attitude matrix per update
+    struct vn310_frames_site_t site = {};
+    start = std::chrono::steady_clock::now();
+    for (int u = 0; u < BENCHMARK_UPDATES; ++u)
+    {
+        struct vn310_dcm_t dcm;
+        vn310_frames_site_update(&site, 51.5 + u * 1e-7, -0.1, 50.0);
+        vn310_attitude_quaternion_to_dcm(q, &dcm);
+        vn310_frames_ecef_to_body_los_batch(&site, &dcm, x.data(), y.data(), z.data(),
+                                            lx.data(), ly.data(), lz.data(), range.data(), BENCHMARK_SATELLITES);
+        sink = sink + lx[u % BENCHMARK_SATELLITES];
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    double batched_ns = elapsed.count() / BENCHMARK_UPDATES / BENCHMARK_SATELLITES;
+
+    std::cout << "ECEF to antenna frame for " << BENCHMARK_SATELLITES << " satellites: per satellite "
+              << per_satellite_ns << " ns, batched " << batched_ns << " ns per satellite, "
+              << site.update_count << " site updates in " << BENCHMARK_UPDATES << std::endl;
+
+    EXPECT_LT(batched_ns, per_satellite_ns);
+    EXPECT_LT(site.update_count, (uint32_t)BENCHMARK_UPDATES / 10);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file vn310_ipc_test.cpp
+ * @brief Host tests for the VN310 dual-core frame hand-off.
+ *
+ * This file contains Google Test-based tests for the M4 receive path, which must
+ * only commit frames with a valid checksum, for the doorbell that wakes the M7, and
+ * for a simulated stream received on one thread and parsed and published on another.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C"
+{
+    #include "vn310_ipc.h"
+    #include "vn310_sim.h"
+}
+
+class vn310_ipc : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(vn310_ipc_init(&shared), OK);
+        struct vn310_pose_t pose = {};
+        pose.yaw = 45.0f;
+        pose.time_gps_pps = 1000000000ULL;
+        binary_size = vn310_sim_build_binary(&pose, binary, sizeof(binary));
+        ascii_size = vn310_sim_build_ascii(&pose, 1.0, ascii, sizeof(ascii));
+    }
+
+    STATUS receive(const void *bytes, size_t size) {
+        memset(rx_buf, 0, sizeof(rx_buf));
+        memcpy(rx_buf, bytes, size);
+        return vn310_ipc_receive(&shared, MERGE_SOURCE_PRIMARY, rx_buf, (uint16_t)size);
+    }
+
+    struct vn310_ipc_shared_t shared;
+    char rx_buf[UART_DMA_READ_BUF_SIZE];
+    uint8_t binary[UART_DMA_READ_BUF_SIZE];
+    char ascii[UART_DMA_READ_BUF_SIZE];
+    size_t binary_size;
+    size_t ascii_size;
+};
+
+TEST_F(vn310_ipc, CommitsOnlyCheckedFrames) {
+    EXPECT_TRUE(vn310_ipc_ready(&shared));
+
+    EXPECT_EQ(receive(binary, binary_size), OK);
+    EXPECT_EQ(receive(ascii, ascii_size), OK);
+
+    binary[20] ^= 0x04;
+    EXPECT_EQ(receive(binary, binary_size), ERROR);
+    ascii[10] ^= 0x01;
+    EXPECT_EQ(receive(ascii, ascii_size), ERROR);
+    EXPECT_EQ(receive("hello", 5), ERROR);
+
+    EXPECT_EQ(shared.received_count, 2u);
+    EXPECT_EQ(shared.checksum_failed_count, 2u);
+    EXPECT_EQ(shared.unknown_count, 1u);
+
+    struct vn310_mailbox_t *ring = &shared.rings[MERGE_SOURCE_PRIMARY];
+    ASSERT_EQ(vn310_mailbox_count(ring), 2u);
+    struct vn310_frame_t *frame = vn310_mailbox_peek(ring);
+    EXPECT_EQ(frame->type, MSG_BINARY);
+    EXPECT_TRUE(frame->checked);
+
+    // The M7 takes the M4's word for the CRC
+    const struct vn310_driver_binout_config0_data_t *data = NULL;
+    EXPECT_EQ(vn310_driver_get_configuration_0_data(frame, &data), OK);
+    EXPECT_FLOAT_EQ(data->yaw_pitch_roll.yaw, 45.0f);
+}
+
+TEST_F(vn310_ipc, OverrunWhenTheM7FallsBehind) {
+    for (int i = 0; i < VN310_MAILBOX_DEPTH + 3; ++i)
+    {
+        receive(binary, binary_size);
+    }
+
+    EXPECT_EQ(shared.received_count, (uint32_t)VN310_MAILBOX_DEPTH);
+    EXPECT_EQ(shared.rings[MERGE_SOURCE_PRIMARY].overrun_count, 3u);
+    EXPECT_EQ(vn310_mailbox_count(&shared.rings[MERGE_SOURCE_SECONDARY]), 0u);
+}
+
+TEST_F(vn310_ipc, DoorbellWakesTheM7) {
+    EXPECT_FALSE(vn310_ipc_wait(&shared, 2));
+
+    ASSERT_EQ(receive(binary, binary_size), OK);
+    ASSERT_EQ(receive(binary, binary_size), OK);
+    EXPECT_EQ(shared.notify_count, 2u);
+
+    // Notifications coalesce, the M7 drains everything on one wake-up
+    EXPECT_TRUE(vn310_ipc_wait(&shared, 1000));
+    EXPECT_FALSE(vn310_ipc_wait(&shared, 2));
+}
+
+TEST(vn310_ipc_stream, ReceiveAndPublishOnTwoThreads) {
+    static struct vn310_ipc_shared_t shared;
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+
+    ASSERT_EQ(vn310_ipc_init(&shared), OK);
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.ipc_shared = &shared;
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+    applet.driver_state.send_pose = true;
+    applet.trace.enabled = true;
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    sim_config.seed = 3;
+    sim_config.corrupt_probability = 0.05;
+    sim_config.ipc = &shared;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+    ASSERT_EQ(vn310_sim_m7_start(&sim), OK);
+
+    struct vn310_sim_trajectory_t trajectory = {};
+    trajectory.format = SIM_FORMAT_BINARY;
+    trajectory.output_rate_hz = 400.0;
+    trajectory.duration_s = 10.0;
+    trajectory.yaw_rate_dps = 10.0;
+    trajectory.motion_period_s = 4.0;
+    trajectory.latitude_deg = 51.5;
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+    ASSERT_EQ(vn310_sim_m7_stop(&sim), OK);
+
+    // Every frame is committed, dropped on a full ring or rejected by the M4
+    // (a flipped header bit leaves a frame that is not recognised at all)
+    uint32_t overruns = shared.rings[MERGE_SOURCE_PRIMARY].overrun_count;
+    uint32_t rejected = shared.checksum_failed_count + shared.unknown_count;
+    EXPECT_EQ(shared.received_count + overruns + rejected, sim.stats.frames);
+    EXPECT_GT(shared.received_count, 0u);
+
+    // The M7 publishes every committed frame and never sees a corrupted one
+    EXPECT_EQ(sim.stats.poses_published, shared.received_count);
+    EXPECT_EQ(applet.trace.traced_count, shared.received_count);
+    EXPECT_EQ(applet.trace.parse_failed_count, 0u);
+    EXPECT_EQ(vn310_mailbox_count(&shared.rings[MERGE_SOURCE_PRIMARY]), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file vn310_link_test.cpp
+ * @brief Host tests for VN310 link rate negotiation.
+ *
+ * This file contains Google Test-based tests for the link budget (required byte
+ * rate, baud rate selection and rate divisors), the checksum check used by the
+ * link probe, and negotiations run end to end against the simulated sensor,
+ * including a sensor that acknowledges a baud rate change without switching.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+extern "C"
+{
+    #include "vn310_link.h"
+    #include "vn310_sim.h"
+}
+
+TEST(vn310_link_budget, SelectsLowestBaudWithHeadroom)
+{
+    // 80 byte packets at 200 Hz need 160 kbit/s, over 70% of 115200 baud
+    uint32_t required = vn310_link_required_bytes_per_s(VN310_BINARY_CONFIG0_SIZE, 200, 0, 0);
+    EXPECT_EQ(required, 16000u);
+    EXPECT_EQ(vn310_link_select_baud(required, VN310_LINK_MAX_UTILIZATION_PERCENT), 230400u);
+
+    EXPECT_EQ(vn310_link_select_baud(vn310_link_required_bytes_per_s(80, 50, 0, 0), 70), 57600u);
+    EXPECT_EQ(vn310_link_select_baud(vn310_link_required_bytes_per_s(80, 800, 0, 0), 70), 921600u);
+    EXPECT_EQ(vn310_link_select_baud(vn310_link_required_bytes_per_s(80, 800, 140, 200), 70), 0u);
+    EXPECT_EQ(vn310_link_select_baud(0, 70), 9600u);
+}
+
+TEST(vn310_link_budget, RatesAndBauds)
+{
+    uint16_t divisor = 0;
+
+    EXPECT_EQ(vn310_link_divisor_for_rate(200, &divisor), OK);
+    EXPECT_EQ(divisor, 4u);
+    EXPECT_EQ(vn310_link_divisor_for_rate(800, &divisor), OK);
+    EXPECT_EQ(divisor, 1u);
+    EXPECT_EQ(vn310_link_divisor_for_rate(300, &divisor), ERROR);
+    EXPECT_EQ(vn310_link_divisor_for_rate(0, &divisor), ERROR);
+    EXPECT_EQ(vn310_link_divisor_for_rate(1600, &divisor), ERROR);
+
+    EXPECT_TRUE(vn310_link_ascii_rate_valid(40));
+    EXPECT_FALSE(vn310_link_ascii_rate_valid(30));
+    EXPECT_TRUE(vn310_link_baud_supported(921600));
+    EXPECT_FALSE(vn310_link_baud_supported(100000));
+}
+
+TEST(vn310_link_budget, VerifiesResponseChecksums)
+{
+    const char *eight_bit = "$VNRRG,5*46";
+    const char *sixteen_bit = "$VNRRG,5*D5A3";
+
+    EXPECT_EQ(vn310_driver_verify_checksum(eight_bit, strlen(eight_bit)), OK);
+    EXPECT_EQ(vn310_driver_verify_checksum(sixteen_bit, strlen(sixteen_bit)), OK);
+    EXPECT_EQ(vn310_driver_verify_checksum("$VNRRG,6*46", 11), ERROR);
+    EXPECT_EQ(vn310_driver_verify_checksum("$VNRRG,5*XX", 11), ERROR);
+    EXPECT_EQ(vn310_driver_verify_checksum("$VNRRG,5", 8), ERROR);
+}
+
+class vn310_link_negotiation : public ::testing::Test
+{
+protected:
+    void start(unsigned int baud_rate, bool baud_change_fails = false)
+    {
+        memset(&applet, 0, sizeof(applet));
+        cli_state.quiet = true;
+
+        struct vn310_applet_config_t config = {};
+        config.cli_state = &cli_state;
+        config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+        config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+        config.driver_config.vectornav_uart_config.baud_rate = baud_rate;
+        ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+        ASSERT_EQ(vn310_applet_start(&applet), OK);
+
+        struct vn310_sim_config_t sim_config = {};
+        sim_config.baud_rate = baud_rate;
+        sim_config.frames_per_run = 1;
+        sim_config.respond_to_commands = true;
+        sim_config.baud_change_fails = baud_change_fails;
+        ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+    }
+
+    std::string sent() const
+    {
+        const struct driver_uart_state_t *uart = &applet.driver_state.uart_state;
+        return std::string(reinterpret_cast<const char *>(uart->tx_log), uart->tx_log_size);
+    }
+
+    uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    struct cli_state_t cli_state;
+    struct vn310_applet_state_t applet;
+    struct vn310_sim_state_t sim;
+};
+
+TEST_F(vn310_link_negotiation, RaisesBaudBeforeRate)
+{
+    start(115200);
+
+    ASSERT_EQ(vn310_sim_negotiate(&sim, 800, 0), OK);
+    EXPECT_EQ(applet.driver_state.baud_rate, 921600u);
+    EXPECT_EQ(sim.device_baud, 921600u);
+    EXPECT_EQ(applet.driver_state.binary_rate_divisor, 1u);
+    EXPECT_EQ(applet.driver_state.link.negotiated_count, 1u);
+    EXPECT_EQ(sim.stats.commands_garbled, 0u);
+
+    std::string commands = sent();
+    size_t baud = commands.find("$VNWRG,5,921600*");
+    size_t probe = commands.find("$VNRRG,5*");
+    size_t rate = commands.find("$VNWRG,75,1,1,01,107A*");
+    ASSERT_NE(baud, std::string::npos);
+    ASSERT_NE(probe, std::string::npos);
+    ASSERT_NE(rate, std::string::npos);
+    EXPECT_LT(baud, probe);
+    EXPECT_LT(probe, rate);
+}
+
+TEST_F(vn310_link_negotiation, LowersRateBeforeBaud)
+{
+    start(921600);
+
+    ASSERT_EQ(vn310_sim_negotiate(&sim, 50, 0), OK);
+    EXPECT_EQ(applet.driver_state.baud_rate, 57600u);
+    EXPECT_EQ(sim.device_baud, 57600u);
+    EXPECT_EQ(applet.driver_state.binary_rate_divisor, 16u);
+
+    std::string commands = sent();
+    size_t rate = commands.find("$VNWRG,75,1,16,01,107A*");
+    size_t baud = commands.find("$VNWRG,5,57600*");
+    ASSERT_NE(rate, std::string::npos);
+    ASSERT_NE(baud, std::string::npos);
+    EXPECT_LT(rate, baud);
+}
+
+TEST_F(vn310_link_negotiation, RecoversPreviousBaudWhenProbeFails)
+{
+    start(115200, true);
+
+    EXPECT_EQ(vn310_sim_negotiate(&sim, 800, 0), ERROR);
+    EXPECT_EQ(applet.driver_state.baud_rate, 115200u);
+    EXPECT_EQ(sim.device_baud, 115200u);
+    EXPECT_EQ(applet.driver_state.link.failed_count, 1u);
+    EXPECT_EQ(applet.driver_state.link.recovered_count, 1u);
+    EXPECT_GT(sim.stats.commands_garbled, 0u);
+
+    // Output rate untouched, the link is usable again
+    EXPECT_EQ(applet.driver_state.binary_rate_divisor, 4u);
+    EXPECT_EQ(vn310_sim_negotiate(&sim, 50, 0), ERROR);
+}
+
+TEST_F(vn310_link_negotiation, TurnsAsciiOffWhenNotBudgeted)
+{
+    start(115200);
+
+    ASSERT_EQ(vn310_sim_negotiate(&sim, 200, 40), OK);
+    EXPECT_EQ(applet.driver_state.ascii_rate_hz, 40u);
+    size_t ascii_on = sent().find("$VNWRG,7,40*");
+    ASSERT_NE(ascii_on, std::string::npos);
+
+    ASSERT_EQ(vn310_sim_negotiate(&sim, 200, 0), OK);
+    EXPECT_EQ(applet.driver_state.ascii_rate_hz, 0u);
+    EXPECT_EQ(applet.driver_state.baud_rate, 230400u);
+    EXPECT_NE(sent().find("$VNWRG,7,0*", ascii_on), std::string::npos);
+}
+
+TEST_F(vn310_link_negotiation, FailsWhenAsciiRateIsRejected)
+{
+    start(115200);
+    sim.config.ascii_rate_fails = true;
+
+    // Raising: the baud rate has changed but the negotiation reports the rejection
+    EXPECT_EQ(vn310_sim_negotiate(&sim, 200, 40), ERROR);
+    EXPECT_EQ(applet.driver_state.baud_rate, 460800u);
+    EXPECT_EQ(applet.driver_state.link.failed_count, 1u);
+    EXPECT_EQ(applet.driver_state.link.negotiated_count, 0u);
+
+    // Lowering: the baud rate is left alone
+    EXPECT_EQ(vn310_sim_negotiate(&sim, 50, 0), ERROR);
+    EXPECT_EQ(applet.driver_state.baud_rate, 460800u);
+    EXPECT_EQ(sent().find("$VNWRG,5,57600*"), std::string::npos);
+    EXPECT_EQ(applet.driver_state.link.failed_count, 2u);
+}
+
+TEST_F(vn310_link_negotiation, RejectsUnreachableRates)
+{
+    start(115200);
+
+    EXPECT_EQ(vn310_link_negotiate(&applet.driver_state, 300, 0, NULL, NULL), ERROR);
+    EXPECT_EQ(vn310_link_negotiate(&applet.driver_state, 800, 200, NULL, NULL), ERROR);
+    EXPECT_EQ(vn310_link_negotiate(&applet.driver_state, 200, 30, NULL, NULL), ERROR);
+    EXPECT_EQ(applet.driver_state.link.phase, LINK_PHASE_IDLE);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
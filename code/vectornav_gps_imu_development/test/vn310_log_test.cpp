@@ -0,0 +1,208 @@
+/**
+ * @file vn310_log_test.cpp
+ * @brief Host tests for the VN310 binary log.
+ *
+ * This file contains Google Test-based tests for the log record framing, block
+ * padding, dropping when storage falls behind, resynchronisation after damaged
+ * records, and logging of raw frames and published poses by the applet.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+    #include "vn310_log.h"
+    #include "vn310_sim.h"
+}
+
+static STATUS _store_block(void *context, const uint8_t *block, size_t size)
+{
+    auto *storage = static_cast<std::vector<uint8_t> *>(context);
+    storage->insert(storage->end(), block, block + size);
+    return OK;
+}
+
+struct parsed_record_t
+{
+    struct vn310_log_header_t header;
+    std::vector<uint8_t> payload;
+};
+
+static std::vector<parsed_record_t> _parse_all(const std::vector<uint8_t> &data)
+{
+    std::vector<parsed_record_t> records;
+    size_t offset = 0;
+    size_t consumed;
+    parsed_record_t record;
+    const uint8_t *payload;
+
+    while ((consumed = vn310_log_parse(&data[offset], data.size() - offset, &record.header, &payload)) > 0)
+    {
+        record.payload.assign(payload, payload + record.header.length);
+        records.push_back(record);
+        offset += consumed;
+    }
+
+    return records;
+}
+
+class vn310_log : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(vn310_log_init(&log, _store_block, &storage), OK);
+        log.enabled = true;
+    }
+
+    static struct vn310_log_t log;
+    std::vector<uint8_t> storage;
+};
+
+struct vn310_log_t vn310_log::log;
+
+TEST_F(vn310_log, RecordsRoundTripThroughBlocks)
+{
+    const uint8_t payload[100] = { 1, 2, 3 };
+    const int count = 100;
+
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(vn310_log_append(&log, LOG_RECORD_FRAME, (uint32_t)i, payload, sizeof(payload)), OK);
+    }
+    vn310_log_sync(&log);
+    EXPECT_EQ(vn310_log_flush(&log), 3u);
+
+    // 110 byte records, 37 to a block, padded with erased flash
+    ASSERT_EQ(storage.size(), 3u * VN310_LOG_BLOCK_SIZE);
+    EXPECT_EQ(storage[37 * 110], VN310_LOG_PAD);
+    EXPECT_EQ(storage[VN310_LOG_BLOCK_SIZE - 1], VN310_LOG_PAD);
+
+    std::vector<parsed_record_t> records = _parse_all(storage);
+    ASSERT_EQ(records.size(), (size_t)count);
+    for (int i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(records[i].header.tick_ms, (uint32_t)i);
+        EXPECT_EQ(records[i].header.type, LOG_RECORD_FRAME);
+        EXPECT_EQ(records[i].payload.size(), sizeof(payload));
+    }
+}
+
+TEST_F(vn310_log, DropsInsteadOfWaitingForStorage)
+{
+    const uint8_t payload[1000] = {};
+
+    // Fill every block without the storage task running
+    int appended = 0;
+    while (vn310_log_append(&log, LOG_RECORD_FRAME, 0, payload, sizeof(payload)) == OK)
+    {
+        appended++;
+    }
+    EXPECT_EQ(appended, 4 * VN310_LOG_BLOCK_COUNT);
+    EXPECT_EQ(log.dropped_count, 1u);
+
+    // Once storage catches up logging resumes
+    EXPECT_EQ(vn310_log_flush(&log), (uint32_t)VN310_LOG_BLOCK_COUNT);
+    EXPECT_EQ(vn310_log_append(&log, LOG_RECORD_FRAME, 0, payload, sizeof(payload)), OK);
+}
+
+TEST_F(vn310_log, SkipsDamagedRecords)
+{
+    struct vn310_pose_t pose = {};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        pose.time_gps_pps = (uint64_t)(i + 1) * 5000000ULL;
+        ASSERT_EQ(vn310_log_pose(&log, &pose, 10), OK);
+    }
+    vn310_log_sync(&log);
+    vn310_log_flush(&log);
+
+    // Flip a payload bit of the middle record
+    storage[VN310_LOG_HEADER_SIZE + sizeof(struct vn310_log_pose_t) + VN310_LOG_CRC_SIZE + VN310_LOG_HEADER_SIZE] ^= 0x01;
+
+    std::vector<parsed_record_t> records = _parse_all(storage);
+    ASSERT_EQ(records.size(), 2u);
+
+    struct vn310_log_pose_t last;
+    memcpy(&last, records[1].payload.data(), sizeof(last));
+    EXPECT_EQ(last.time_gps_pps, 15000000ULL);
+}
+
+TEST_F(vn310_log, DisabledLogIsFree)
+{
+    const uint8_t payload[10] = {};
+
+    log.enabled = false;
+    EXPECT_EQ(vn310_log_append(&log, LOG_RECORD_FRAME, 0, payload, sizeof(payload)), OK);
+    EXPECT_EQ(log.record_count, 0u);
+    EXPECT_EQ(log.fill, 0u);
+}
+
+TEST(vn310_applet_log, LogsFramesAndPublishedPoses)
+{
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+    std::vector<uint8_t> storage;
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+    config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+    config.publish_config.min_interval_ns = 20000000ULL;    // 50 Hz
+    config.log_write = _store_block;
+    config.log_context = &storage;
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+    applet.driver_state.send_pose = true;
+    applet.log.enabled = true;
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+
+    struct vn310_sim_trajectory_t trajectory = {};
+    trajectory.format = SIM_FORMAT_BINARY;
+    trajectory.output_rate_hz = 200.0;
+    trajectory.duration_s = 1.0;
+    trajectory.yaw_rate_dps = 10.0;
+    trajectory.motion_period_s = 4.0;
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+    vn310_log_sync(&applet.log);
+    vn310_applet_log_task(&applet);
+
+    size_t frames = 0;
+    size_t poses = 0;
+    for (const parsed_record_t &record : _parse_all(storage))
+    {
+        if (record.header.type == LOG_RECORD_FRAME)
+        {
+            EXPECT_EQ(record.payload[1], MSG_BINARY);
+            EXPECT_EQ(record.payload.size(), 2 + VN310_BINARY_CONFIG0_SIZE);
+            frames++;
+        }
+        else if (record.header.type == LOG_RECORD_POSE)
+        {
+            poses++;
+        }
+    }
+    EXPECT_EQ(frames, 200u);
+    EXPECT_EQ(poses, (size_t)applet.publisher.sent_count);
+    EXPECT_LT(poses, frames);
+    EXPECT_EQ(applet.log.dropped_count, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file vn310_mailbox_test.cpp
+ * @brief Host tests for the VN310 frame mailbox.
+ *
+ * This file contains Google Test-based tests for the single-producer/single-consumer
+ * frame mailbox. Besides the basic ordering and overrun behaviour, a stress test runs
+ * the producer (standing in for the UART DMA callback) and the consumer (standing in
+ * for the applet) on separate threads and checks that no frame is torn, reordered
+ * or lost without being counted.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+extern "C"
+{
+    #include "vn310_mailbox.h"
+}
+
+#define ENABLE_DEBUG_PRINT false  // Set this to true for detailed debug outputs during tests
+
+const uint32_t STRESS_FRAME_COUNT = 2000000;
+
+/**
+ * @brief Fills a frame with a pattern derived from its sequence number.
+ */
+static void _frame_fill(struct vn310_frame_t *frame, uint32_t sequence)
+{
+    frame->type = (uint8_t)(sequence & 0x1);
+    frame->size = (uint16_t)(sizeof(uint32_t) + (sequence % (VN310_FRAME_MAX_SIZE - sizeof(uint32_t))));
+    memcpy(frame->data, &sequence, sizeof(sequence));
+    memset(frame->data + sizeof(sequence), (int)(sequence & 0xFF), frame->size - sizeof(sequence));
+}
+
+/**
+ * @brief Checks a frame pattern and returns its sequence number, or -1 if torn.
+ */
+static int64_t _frame_check(const struct vn310_frame_t *frame)
+{
+    uint32_t sequence;
+    memcpy(&sequence, frame->data, sizeof(sequence));
+
+    if (frame->type != (uint8_t)(sequence & 0x1) ||
+        frame->size != sizeof(uint32_t) + (sequence % (VN310_FRAME_MAX_SIZE - sizeof(uint32_t))))
+    {
+        return -1;
+    }
+    for (size_t i = sizeof(sequence); i < frame->size; ++i)
+    {
+        if ((uint8_t)frame->data[i] != (uint8_t)(sequence & 0xFF))
+        {
+            return -1;
+        }
+    }
+    return sequence;
+}
+
+TEST(vn310_mailbox, fifo_order_and_overrun)
+{
+    static struct vn310_mailbox_t mailbox;
+    vn310_mailbox_init(&mailbox);
+
+    EXPECT_EQ(vn310_mailbox_peek(&mailbox), nullptr);
+
+    for (uint32_t i = 0; i < VN310_MAILBOX_DEPTH; ++i)
+    {
+        struct vn310_frame_t *frame = vn310_mailbox_reserve(&mailbox);
+        ASSERT_NE(frame, nullptr);
+        _frame_fill(frame, i);
+        vn310_mailbox_commit(&mailbox);
+    }
+
+    EXPECT_EQ(vn310_mailbox_reserve(&mailbox), nullptr);
+    EXPECT_EQ(mailbox.overrun_count, 1u);
+    EXPECT_EQ(vn310_mailbox_count(&mailbox), (uint32_t)VN310_MAILBOX_DEPTH);
+
+    for (uint32_t i = 0; i < VN310_MAILBOX_DEPTH; ++i)
+    {
+        struct vn310_frame_t *frame = vn310_mailbox_peek(&mailbox);
+        ASSERT_NE(frame, nullptr);
+        EXPECT_EQ(_frame_check(frame), (int64_t)i);
+        vn310_mailbox_release(&mailbox);
+    }
+
+    EXPECT_EQ(vn310_mailbox_peek(&mailbox), nullptr);
+    EXPECT_EQ(mailbox.high_water, (uint32_t)VN310_MAILBOX_DEPTH);
+}
+
+/**
+ * @brief Runs the producer and consumer on separate threads.
+ *
+ * The consumer must see strictly increasing sequence numbers with intact payloads,
+ * and every frame the producer attempted must be either consumed or counted as
+ * an overrun.
+ */
+TEST(vn310_mailbox, two_thread_stress)
+{
+    static struct vn310_mailbox_t mailbox;
+    std::atomic<bool> producer_done(false);
+    uint32_t torn_count = 0;
+    uint32_t order_errors = 0;
+    uint32_t received = 0;
+
+    vn310_mailbox_init(&mailbox);
+
+    std::thread producer([&]() {
+        for (uint32_t sequence = 0; sequence < STRESS_FRAME_COUNT; ++sequence)
+        {
+            struct vn310_frame_t *frame = vn310_mailbox_reserve(&mailbox);
+            if (frame != nullptr)
+            {
+                _frame_fill(frame, sequence);
+                vn310_mailbox_commit(&mailbox);
+            }
+        }
+        producer_done.store(true, std::memory_order_release);
+    });
+
+    std::thread consumer([&]() {
+        int64_t last_sequence = -1;
+        while (true)
+        {
+            struct vn310_frame_t *frame = vn310_mailbox_peek(&mailbox);
+            if (frame == nullptr)
+            {
+                if (producer_done.load(std::memory_order_acquire) && vn310_mailbox_count(&mailbox) == 0)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            int64_t sequence = _frame_check(frame);
+            if (sequence < 0)
+            {
+                torn_count++;
+            }
+            else if (sequence <= last_sequence)
+            {
+                order_errors++;
+            }
+            else
+            {
+                last_sequence = sequence;
+            }
+            received++;
+            vn310_mailbox_release(&mailbox);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    if (ENABLE_DEBUG_PRINT)
+    {
+        std::cout << "received " << received << " overruns " << mailbox.overrun_count
+                  << " high water " << mailbox.high_water << std::endl;
+    }
+
+    EXPECT_EQ(torn_count, 0u);
+    EXPECT_EQ(order_errors, 0u);
+    EXPECT_EQ(received, mailbox.consumed_count);
+    EXPECT_EQ(mailbox.committed_count, mailbox.consumed_count);
+    EXPECT_EQ(mailbox.committed_count + mailbox.overrun_count, STRESS_FRAME_COUNT);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+/**
+ * @file vn310_merge_test.cpp
+ * @brief Host tests for the VN310 redundancy merge.
+ *
+ * This file contains Google Test-based tests for the merge rules (first copy of
+ * an epoch wins, stale and duplicate samples are discarded, untimed samples fail
+ * over after the timeout, GPS time carries on across a PPS) and for an applet fed on both inputs by two simulated
+ * sensors, including failover and CRC-failed frames on one input.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C"
+{
+    #include "vn310_merge.h"
+    #include "vn310_sim.h"
+}
+
+const uint64_t NS_PER_MS = 1000000ULL;
+
+class vn310_merge : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        struct vn310_merge_config_t config = {};
+        config.epoch_window_ns = 1 * NS_PER_MS;
+        config.failover_ms = 20;
+        vn310_merge_init(&merge, &config);
+    }
+
+    struct vn310_merge_t merge;
+};
+
+TEST_F(vn310_merge, FirstCopyOfEachEpochWins)
+{
+    const uint32_t now = 1000;
+
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 5 * NS_PER_MS, now), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, 5 * NS_PER_MS, now), MERGE_DUPLICATE);
+
+    // The secondary input is faster for the next epoch
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, 10 * NS_PER_MS, now), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 10 * NS_PER_MS + 500000, now), MERGE_DUPLICATE);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 5 * NS_PER_MS, now), MERGE_STALE);
+    EXPECT_EQ(merge.active_source, MERGE_SOURCE_SECONDARY);
+
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_PRIMARY].published_count, 1u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_SECONDARY].published_count, 1u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_PRIMARY].duplicate_count, 1u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_PRIMARY].stale_count, 1u);
+    EXPECT_EQ(merge.failover_count, 0u);
+}
+
+TEST_F(vn310_merge, ActiveInputFollowsItsOwnTime)
+{
+    // A sensor reset moves GPS time back on the only input
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 500 * NS_PER_MS, 1000), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 5 * NS_PER_MS, 1005), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 5 * NS_PER_MS, 1010), MERGE_PUBLISH);
+}
+
+TEST_F(vn310_merge, UntimedSamplesFailOver)
+{
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 0, 1000), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, 0, 1001), MERGE_INACTIVE);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, 0, 1020), MERGE_INACTIVE);
+
+    // Primary silent for longer than the failover timeout
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, 0, 1021), MERGE_PUBLISH);
+    EXPECT_EQ(merge.failover_count, 1u);
+    EXPECT_EQ(merge.active_source, MERGE_SOURCE_SECONDARY);
+    EXPECT_FALSE(vn310_merge_source_alive(&merge, MERGE_SOURCE_PRIMARY, 1021));
+    EXPECT_TRUE(vn310_merge_source_alive(&merge, MERGE_SOURCE_SECONDARY, 1021));
+
+    // The primary input is back but stays on standby
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, 0, 1022), MERGE_INACTIVE);
+}
+
+TEST_F(vn310_merge, FreshSamplesAfterPpsAreNotStale)
+{
+    // The PPS relative time restarts at the second, GPS time does not
+    const uint64_t second = 1000 * NS_PER_MS;
+    const uint32_t now = 1000;
+
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, second - 5 * NS_PER_MS, now), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, second - 5 * NS_PER_MS, now), MERGE_DUPLICATE);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, second, now), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, second, now), MERGE_DUPLICATE);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_PRIMARY, second + 5 * NS_PER_MS, now), MERGE_PUBLISH);
+    EXPECT_EQ(vn310_merge_offer(&merge, MERGE_SOURCE_SECONDARY, second + 5 * NS_PER_MS, now), MERGE_DUPLICATE);
+
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_PRIMARY].stale_count, 0u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_SECONDARY].stale_count, 0u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_PRIMARY].inactive_count, 0u);
+    EXPECT_EQ(merge.sources[MERGE_SOURCE_SECONDARY].inactive_count, 0u);
+    EXPECT_EQ(merge.last_time_ns, second + 5 * NS_PER_MS);
+}
+
+class vn310_dual_input : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        memset(&applet, 0, sizeof(applet));
+        cli_state.quiet = true;
+
+        struct vn310_applet_config_t config = {};
+        config.cli_state = &cli_state;
+        config.driver_config.vectornav_uart_config.rx_buf = rx_buf[0];
+        config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf[0]);
+        config.secondary_driver_config.vectornav_uart_config.rx_buf = rx_buf[1];
+        config.secondary_driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf[1]);
+        config.secondary_enabled = true;
+        ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+        ASSERT_EQ(vn310_applet_start(&applet), OK);
+        applet.driver_state.send_pose = true;
+
+        for (uint8_t port = 0; port < VN310_MERGE_MAX_SOURCES; port++)
+        {
+            struct vn310_sim_config_t sim_config = {};
+            sim_config.baud_rate = 921600;
+            sim_config.frames_per_run = 1000;
+            sim_config.port = port;
+            ASSERT_EQ(vn310_sim_init(&sim[port], &sim_config, &applet), OK);
+        }
+    }
+
+    void deliver(uint8_t port, uint64_t time_ns, bool corrupt = false)
+    {
+        uint8_t frame[UART_DMA_READ_BUF_SIZE];
+        struct vn310_pose_t pose = {};
+        pose.yaw = (float)(time_ns / NS_PER_MS) * 0.1f;
+        pose.latitude = 51.5f;
+        pose.time_gps = time_ns;
+
+        size_t size = vn310_sim_build_binary(&pose, frame, sizeof(frame));
+        if (corrupt)
+        {
+            frame[10] ^= 0x01;
+        }
+        ASSERT_EQ(vn310_sim_deliver(&sim[port], frame, (uint16_t)size, 0), OK);
+    }
+
+    uint8_t rx_buf[VN310_MERGE_MAX_SOURCES][UART_DMA_READ_BUF_SIZE];
+    struct cli_state_t cli_state;
+    struct vn310_applet_state_t applet;
+    struct vn310_sim_state_t sim[VN310_MERGE_MAX_SOURCES];
+};
+
+TEST_F(vn310_dual_input, PublishesEachEpochOnceAndFailsOver)
+{
+    // Both inputs carry every sample, the secondary one slightly later
+    for (uint64_t n = 1; n <= 6; n++)
+    {
+        deliver(MERGE_SOURCE_PRIMARY, n * 5 * NS_PER_MS);
+        deliver(MERGE_SOURCE_SECONDARY, n * 5 * NS_PER_MS);
+    }
+    ASSERT_EQ(vn310_applet_run(&applet), OK);
+
+    EXPECT_EQ(applet.publisher.sent_count, 6u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_PRIMARY].published_count, 6u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_SECONDARY].duplicate_count, 6u);
+
+    // The primary input goes quiet and starts corrupting frames
+    for (uint64_t n = 7; n <= 10; n++)
+    {
+        deliver(MERGE_SOURCE_PRIMARY, n * 5 * NS_PER_MS, true);
+        deliver(MERGE_SOURCE_SECONDARY, n * 5 * NS_PER_MS);
+    }
+    ASSERT_EQ(vn310_applet_run(&applet), OK);
+
+    EXPECT_EQ(applet.publisher.sent_count, 10u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_PRIMARY].failed_count, 4u);
+    EXPECT_EQ(applet.merge.active_source, MERGE_SOURCE_SECONDARY);
+    EXPECT_EQ(applet.pose_data.time_gps_pps, 50 * NS_PER_MS);
+}
+
+TEST_F(vn310_dual_input, PublishesEachEpochOnceAcrossPps)
+{
+    // Samples from 980 ms to 1015 ms, one of them exactly on the PPS
+    const uint64_t second = 1000 * NS_PER_MS;
+    for (uint64_t n = 0; n < 8; n++)
+    {
+        deliver(MERGE_SOURCE_PRIMARY, second - 20 * NS_PER_MS + n * 5 * NS_PER_MS);
+        deliver(MERGE_SOURCE_SECONDARY, second - 20 * NS_PER_MS + n * 5 * NS_PER_MS);
+    }
+    ASSERT_EQ(vn310_applet_run(&applet), OK);
+
+    EXPECT_EQ(applet.publisher.sent_count, 8u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_PRIMARY].published_count, 8u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_SECONDARY].duplicate_count, 8u);
+    EXPECT_EQ(applet.merge.sources[MERGE_SOURCE_SECONDARY].stale_count, 0u);
+    EXPECT_EQ(applet.pose_data.time_gps, second + 15 * NS_PER_MS);
+    EXPECT_EQ(applet.pose_data.time_gps_pps, 15 * NS_PER_MS);
+
+    // An ASCII sample does not inherit the time of the last binary one
+    struct vn310_pose_t pose = {};
+    pose.latitude = 51.5;
+    char message[256];
+    size_t size = vn310_sim_build_ascii(&pose, 1.0, message, sizeof(message));
+    ASSERT_GT(size, 0u);
+    ASSERT_EQ(vn310_sim_deliver(&sim[MERGE_SOURCE_PRIMARY], (const uint8_t *)message, (uint16_t)size, 0), OK);
+    ASSERT_EQ(vn310_applet_run(&applet), OK);
+
+    EXPECT_EQ(applet.publisher.sent_count, 9u);
+    EXPECT_EQ(applet.pose_data.time_gps, 0u);
+    EXPECT_EQ(applet.pose_data.time_gps_pps, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
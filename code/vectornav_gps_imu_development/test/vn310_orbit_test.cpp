@@ -0,0 +1,391 @@
+/**
+ * @file vn310_orbit_test.cpp
+ * @brief Host tests and benchmark for SGP4 propagation and the handover scheduler.
+ *
+ * This file contains Google Test-based tests for TLE parsing, the SGP4 propagator
+ * against the published verification vectors of Vallado et al. (2006), the Hermite
+ * interpolation cache against direct propagation, and the handover scheduler over
+ * a small Walker constellation. A benchmark reports the cost of a 200 Hz pointing
+ * update from the cache against propagating every candidate on every update.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+extern "C"
+{
+    #include "vn310_handover.h"
+}
+
+const char *TLE_00005_LINE1 = "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753";
+const char *TLE_00005_LINE2 = "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667";
+
+const int WALKER_PLANES = 4;
+const int WALKER_PER_PLANE = 4;
+const double POINTING_RATE_HZ = 200.0;
+const int BENCHMARK_UPDATES = 200000;
+
+/**
+ * @brief Append the modulo 10 checksum to a 68 character TLE line.
+ */
+static std::string _with_checksum(const char *line)
+{
+    int sum = 0;
+    for (int i = 0; i < 68; ++i)
+    {
+        if (line[i] >= '0' && line[i] <= '9')
+        {
+            sum += line[i] - '0';
+        }
+        else if (line[i] == '-')
+        {
+            sum += 1;
+        }
+    }
+    return std::string(line, 68) + (char)('0' + sum % 10);
+}
+
+/**
+ * @brief Format an element set as a TLE, epoch in 2026.
+ */
+static void _make_tle(unsigned catalog, double day, double inclination, double raan, double mean_anomaly,
+                      double revs_per_day, const char *bstar, std::string &line1, std::string &line2)
+{
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "1 %05uU %-8s %02d%012.8f %10s %8s %8s 0 %4d",
+             catalog, "26001A", 26, day, " .00000000", " 00000-0", bstar, 999);
+    line1 = _with_checksum(buffer);
+    snprintf(buffer, sizeof(buffer), "2 %05u %8.4f %8.4f %07d %8.4f %8.4f %11.8f%5d",
+             catalog, inclination, raan, 1000, 0.0, mean_anomaly, revs_per_day, 1);
+    line2 = _with_checksum(buffer);
+}
+
+/**
+ * @brief A 53 degree, 550 km Walker constellation.
+ */
+static std::string _walker_tles(void)
+{
+    std::string text;
+    for (int plane = 0; plane < WALKER_PLANES; ++plane)
+    {
+        for (int slot = 0; slot < WALKER_PER_PLANE; ++slot)
+        {
+            std::string line1, line2;
+            double raan = plane * 360.0 / WALKER_PLANES;
+            double mean_anomaly = fmod(slot * 360.0 / WALKER_PER_PLANE + plane * 22.5, 360.0);
+            _make_tle(40000 + plane * 10 + slot, 100.5, 53.0, raan, mean_anomaly, 15.05, " 10000-3", line1, line2);
+            text += "SAT-" + std::to_string(plane) + "-" + std::to_string(slot) + "\n" + line1 + "\n" + line2 + "\n";
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief A level platform at a fixed position.
+ */
+static struct vn310_pose_t _platform(float latitude, float longitude, float yaw)
+{
+    struct vn310_pose_t pose = {};
+    pose.latitude = latitude;
+    pose.longitude = longitude;
+    pose.altitude = 50.0f;
+    pose.yaw = yaw;
+    vn310_attitude_quaternion_from_ypr(pose.yaw, pose.pitch, pose.roll, pose.quaternion);
+    return pose;
+}
+
+TEST(vn310_orbit, ParsesAndRejectsElementSets) {
+    struct vn310_orbit_t orbit;
+
+    ASSERT_EQ(vn310_orbit_parse_tle(TLE_00005_LINE1, TLE_00005_LINE2, "VANGUARD 1  \r\n", &orbit), OK);
+    EXPECT_STREQ(orbit.name, "VANGUARD 1");
+    EXPECT_EQ(orbit.catalog_number, 5u);
+    EXPECT_NEAR(orbit.bstar, 0.28098e-4, 1e-12);
+    EXPECT_NEAR(orbit.eccentricity, 0.1859667, 1e-12);
+    EXPECT_NEAR(orbit.epoch_jd, 2451723.28495062, 1e-8);
+
+    // A flipped digit fails the checksum
+    std::string damaged(TLE_00005_LINE2);
+    damaged[10] = '5';
+    EXPECT_EQ(vn310_orbit_parse_tle(TLE_00005_LINE1, damaged.c_str(), NULL, &orbit), ERROR);
+
+    // Geostationary orbits need the deep-space model
+    std::string line1, line2;
+    _make_tle(40001, 100.5, 0.05, 0.0, 0.0, 1.0027, " 00000-0", line1, line2);
+    EXPECT_EQ(vn310_orbit_parse_tle(line1.c_str(), line2.c_str(), NULL, &orbit), ERROR);
+
+    // Two- and three-line sets mixed in one file
+    std::string text = std::string(TLE_00005_LINE1) + "\r\n" + TLE_00005_LINE2 + "\r\n" + _walker_tles();
+    struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES + 4];
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES + 4);
+    EXPECT_EQ(count, 1 + WALKER_PLANES * WALKER_PER_PLANE);
+    EXPECT_STREQ(orbits[0].name, "");
+    EXPECT_STREQ(orbits[1].name, "SAT-0-0");
+    EXPECT_STREQ(orbits[count - 1].name, "SAT-3-3");
+}
+
+TEST(vn310_orbit, MatchesSgp4VerificationVectors) {
+    struct vn310_orbit_t orbit;
+    ASSERT_EQ(vn310_orbit_parse_tle(TLE_00005_LINE1, TLE_00005_LINE2, NULL, &orbit), OK);
+
+    // Vallado et al. (2006), tcppver.out, satellite 00005
+    const struct
+    {
+        double minutes;
+        double r[3];
+        double v[3];
+    } expected[] = {
+        {0.0, {7022.46529266, -1400.08296755, 0.03995155}, {1.893841015, 6.405893759, 4.534807250}},
+        {360.0, {-7154.03120202, -3783.17682504, -3536.19412294}, {4.741887409, -4.151817765, -2.093935425}},
+        {720.0, {-7134.59340119, 6531.68641334, 3260.27186483}, {-4.113793027, -2.911922039, -2.557327851}},
+        {1440.0, {-938.55923943, -6268.18748831, -4294.02924751}, {7.536105209, -0.427127707, 0.989878080}},
+    };
+
+    for (const auto &point : expected)
+    {
+        double r[3], v[3];
+        ASSERT_EQ(vn310_orbit_propagate_teme(&orbit, point.minutes, r, v), OK);
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_NEAR(r[i], point.r[i], 1e-6) << point.minutes << " min";
+            EXPECT_NEAR(v[i], point.v[i], 1e-8) << point.minutes << " min";
+        }
+    }
+
+    EXPECT_NEAR(vn310_orbit_gmst(2451545.0) * 180.0 / M_PI, 280.46061837, 1e-7);
+}
+
+TEST(vn310_orbit, LowOrbitDecays) {
+    std::string line1, line2;
+    struct vn310_orbit_t orbit;
+    double r[3], v[3];
+
+    _make_tle(40002, 100.5, 51.6, 0.0, 0.0, 16.3, " 50000-3", line1, line2);
+    ASSERT_EQ(vn310_orbit_parse_tle(line1.c_str(), line2.c_str(), NULL, &orbit), OK);
+    EXPECT_TRUE(orbit.simple);
+
+    EXPECT_EQ(vn310_orbit_propagate_teme(&orbit, 0.0, r, v), OK);
+    EXPECT_NEAR(sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]) - 6378.135, 200.0, 25.0);
+    EXPECT_EQ(vn310_orbit_propagate_teme(&orbit, 60.0 * 1440.0, r, v), ERROR);
+}
+
+TEST(vn310_orbit, HermiteCacheTracksDirectPropagation) {
+    std::string text = _walker_tles();
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES);
+
+    struct vn310_handover_config_t config = {};
+    config.epoch_jd = orbits[0].epoch_jd + 0.25;
+    config.max_scan_deg = VN310_HANDOVER_USE_DEFAULT;
+    config.min_elevation_deg = VN310_HANDOVER_USE_DEFAULT;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+
+    double worst_m = 0.0;
+    double x[VN310_HANDOVER_MAX_SATELLITES], y[VN310_HANDOVER_MAX_SATELLITES], z[VN310_HANDOVER_MAX_SATELLITES];
+    bool valid[VN310_HANDOVER_MAX_SATELLITES];
+
+    for (double t = 0.0; t < 1200.0; t += 0.37)
+    {
+        ASSERT_EQ(vn310_handover_interpolate(&handover, t, x, y, z, valid), OK);
+        for (int i = 0; i < count; ++i)
+        {
+            double position[3], velocity[3];
+            ASSERT_TRUE(valid[i]);
+            ASSERT_EQ(vn310_orbit_propagate_ecef(&orbits[i], config.epoch_jd + t / 86400.0, position, velocity), OK);
+            double error = sqrt(pow(x[i] - position[0], 2) + pow(y[i] - position[1], 2) + pow(z[i] - position[2], 2));
+            worst_m = fmax(worst_m, error);
+        }
+    }
+
+    std::cout << "Hermite cache, " << VN310_HANDOVER_KNOT_INTERVAL_S << " s knots: worst position error "
+              << worst_m << " m, " << handover.propagation_count << " SGP4 batches in 1200 s" << std::endl;
+
+    EXPECT_LT(worst_m, 1.0);
+    EXPECT_LE(handover.propagation_count, (uint32_t)(1200.0 / VN310_HANDOVER_KNOT_INTERVAL_S) + 2);
+
+    // A jump back in time restarts the knots
+    uint32_t batches = handover.propagation_count;
+    ASSERT_EQ(vn310_handover_interpolate(&handover, 10.0, x, y, z, valid), OK);
+    EXPECT_EQ(handover.propagation_count, batches + 2);
+}
+
+TEST(vn310_orbit, SchedulerHandsOverWithinTheScanCone) {
+    std::string text = _walker_tles();
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES);
+
+    struct vn310_handover_config_t config = {};
+    config.epoch_jd = orbits[0].epoch_jd;
+    config.max_scan_deg = 60.0f;
+    config.min_elevation_deg = 20.0f;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+
+    struct vn310_pose_t pose = _platform(40.0f, 10.0f, 35.0f);
+    uint32_t tracked = 0;
+    double worst_theta_error = 0.0;
+
+    for (double t = 0.0; t < 6.0 * 3600.0; t += 1.0)
+    {
+        struct vn310_handover_target_t target;
+        if (vn310_handover_update(&handover, t, &pose, &target) != OK)
+        {
+            EXPECT_EQ(target.satellite, VN310_HANDOVER_NONE);
+            continue;
+        }
+
+        tracked++;
+        EXPECT_LE(target.theta, config.max_scan_deg);
+        EXPECT_GE(target.elevation, config.min_elevation_deg);
+
+        // The serving satellite is only dropped when it leaves the cone or the mask
+        if (target.handover)
+        {
+            EXPECT_NE(target.satellite, VN310_HANDOVER_NONE);
+        }
+
+        // Look angles from the cache agree with direct propagation
+        double position[3], velocity[3];
+        ASSERT_EQ(vn310_orbit_propagate_ecef(&orbits[target.satellite], config.epoch_jd + t / 86400.0, position, velocity), OK);
+        struct vn310_dcm_t dcm;
+        float los[3], range;
+        vn310_attitude_quaternion_to_dcm(pose.quaternion, &dcm);
+        vn310_frames_ecef_to_body_los_batch(&handover.site, &dcm, &position[0], &position[1], &position[2],
+                                            &los[0], &los[1], &los[2], &range, 1);
+        double theta = acos(-los[2]) * 180.0 / M_PI;
+        worst_theta_error = fmax(worst_theta_error, fabs(theta - target.theta));
+    }
+
+    std::cout << "Scheduler over 6 h: tracked " << tracked << " s, " << handover.handover_count << " handovers, "
+              << handover.outage_count << " s without a satellite, worst theta error " << worst_theta_error
+              << " deg" << std::endl;
+
+    EXPECT_GT(tracked, 0u);
+    EXPECT_GT(handover.handover_count, 0u);
+    EXPECT_LT(worst_theta_error, 0.01);
+    EXPECT_EQ(handover.site.update_count, 1u);
+}
+
+TEST(vn310_orbit, ThetaPhiFollowTheAttitude) {
+    std::string text = _walker_tles();
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES);
+
+    struct vn310_handover_config_t config = {};
+    config.epoch_jd = orbits[0].epoch_jd;
+    config.max_scan_deg = 90.0f;
+    config.min_elevation_deg = 0.1f;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+
+    // Find a satellite in view
+    struct vn310_pose_t pose = _platform(40.0f, 10.0f, 0.0f);
+    struct vn310_handover_target_t level, turned;
+    double t = 0.0;
+    while (vn310_handover_update(&handover, t, &pose, &level) != OK)
+    {
+        t += 10.0;
+        ASSERT_LT(t, 86400.0);
+    }
+
+    // Turning the platform moves phi by the same angle the other way, theta stays
+    pose = _platform(40.0f, 10.0f, 30.0f);
+    ASSERT_EQ(vn310_handover_update(&handover, t, &pose, &turned), OK);
+    EXPECT_EQ(turned.satellite, level.satellite);
+    EXPECT_NEAR(turned.theta, level.theta, 1e-3f);
+    EXPECT_NEAR(turned.elevation, level.elevation, 1e-3f);
+    EXPECT_NEAR(fmod(turned.phi + 30.0f + 360.0f, 360.0f), level.phi, 1e-3f);
+
+    // Level, theta is the zenith angle
+    EXPECT_NEAR(level.theta, 90.0f - level.elevation, 1e-3f);
+}
+
+TEST(vn310_orbit, ZeroLimitsAreTakenAsGiven) {
+    std::string text = _walker_tles();
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES);
+
+    struct vn310_handover_config_t config = {};
+    config.epoch_jd = orbits[0].epoch_jd;
+    config.max_scan_deg = 90.0f;
+    config.min_elevation_deg = 0.0f;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+    EXPECT_EQ(handover.config.max_scan_deg, 90.0f);
+    EXPECT_EQ(handover.config.min_elevation_deg, 0.0f);
+
+    config.max_scan_deg = VN310_HANDOVER_USE_DEFAULT;
+    config.min_elevation_deg = VN310_HANDOVER_USE_DEFAULT;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+    EXPECT_EQ(handover.config.max_scan_deg, VN310_HANDOVER_MAX_SCAN_DEG);
+    EXPECT_EQ(handover.config.min_elevation_deg, VN310_HANDOVER_MIN_ELEVATION_DEG);
+}
+
+/**
+ * @brief Benchmark a 200 Hz pointing update over 16 candidates.
+ */
+TEST(vn310_orbit, BenchmarkCachedAgainstDirectPropagation) {
+    std::string text = _walker_tles();
+    static struct vn310_orbit_t orbits[VN310_HANDOVER_MAX_SATELLITES];
+    static struct vn310_handover_t handover;
+    int count = vn310_orbit_parse_tles(text.c_str(), orbits, VN310_HANDOVER_MAX_SATELLITES);
+
+    struct vn310_handover_config_t config = {};
+    config.epoch_jd = orbits[0].epoch_jd;
+    config.max_scan_deg = VN310_HANDOVER_USE_DEFAULT;
+    config.min_elevation_deg = VN310_HANDOVER_USE_DEFAULT;
+    ASSERT_EQ(vn310_handover_init(&handover, &config, orbits, count), OK);
+    struct vn310_pose_t pose = _platform(40.0f, 10.0f, 35.0f);
+    volatile float sink = 0.0f;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < BENCHMARK_UPDATES; ++n)
+    {
+        struct vn310_handover_target_t target;
+        vn310_handover_update(&handover, n / POINTING_RATE_HZ, &pose, &target);
+        sink = sink + target.theta;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    double cached_ns = elapsed.count() / BENCHMARK_UPDATES;
+
+    // Every candidate through SGP4 on every update
+    double x[VN310_HANDOVER_MAX_SATELLITES], y[VN310_HANDOVER_MAX_SATELLITES], z[VN310_HANDOVER_MAX_SATELLITES];
+    double vx[VN310_HANDOVER_MAX_SATELLITES], vy[VN310_HANDOVER_MAX_SATELLITES], vz[VN310_HANDOVER_MAX_SATELLITES];
+    float lx[VN310_HANDOVER_MAX_SATELLITES], ly[VN310_HANDOVER_MAX_SATELLITES], lz[VN310_HANDOVER_MAX_SATELLITES];
+    float range[VN310_HANDOVER_MAX_SATELLITES];
+    bool valid[VN310_HANDOVER_MAX_SATELLITES];
+    struct vn310_dcm_t dcm;
+    vn310_attitude_quaternion_to_dcm(pose.quaternion, &dcm);
+
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < BENCHMARK_UPDATES; ++n)
+    {
+        double jd = config.epoch_jd + n / POINTING_RATE_HZ / 86400.0;
+        vn310_orbit_propagate_batch(orbits, count, jd, x, y, z, vx, vy, vz, valid);
+        vn310_frames_ecef_to_body_los_batch(&handover.site, &dcm, x, y, z, lx, ly, lz, range, count);
+        sink = sink + lz[0];
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    double direct_ns = elapsed.count() / BENCHMARK_UPDATES;
+
+    std::cout << "Pointing update for " << count << " candidates: direct SGP4 " << direct_ns << " ns, cached "
+              << cached_ns << " ns (" << handover.propagation_count << " SGP4 batches in "
+              << BENCHMARK_UPDATES / POINTING_RATE_HZ << " s)" << std::endl;
+
+    EXPECT_LT(cached_ns, direct_ns);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
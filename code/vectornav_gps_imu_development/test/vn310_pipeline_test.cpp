@@ -0,0 +1,129 @@
+/**
+ * @file vn310_pipeline_test.cpp
+ * @brief Host regression tests for the VN310 receive pipeline.
+ *
+ * This file contains Google Test-based tests that drive the real driver, parser and
+ * applet through the host simulator. Synthetic ASCII and binary streams must be
+ * published one pose per frame, corrupted binary frames must be rejected by the CRC
+ * check, and bursts larger than the mailbox must be counted as overruns.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+extern "C"
+{
+    #include "vn310_sim.h"
+}
+
+class vn310_pipeline : public ::testing::Test {
+protected:
+    void SetUp() override {
+        memset(&applet, 0, sizeof(applet));
+        memset(&cli_state, 0, sizeof(cli_state));
+        cli_state.quiet = true;
+
+        struct vn310_applet_config_t config = {};
+        config.cli_state = &cli_state;
+        config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+        config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+
+        ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+        ASSERT_EQ(vn310_applet_start(&applet), OK);
+        applet.driver_state.send_pose = true;
+
+        trajectory = {};
+        trajectory.format = SIM_FORMAT_BINARY;
+        trajectory.output_rate_hz = 200.0;
+        trajectory.duration_s = 5.0;
+        trajectory.yaw_rate_dps = 10.0;
+        trajectory.pitch_amplitude_deg = 5.0;
+        trajectory.roll_amplitude_deg = 8.0;
+        trajectory.motion_period_s = 4.0;
+        trajectory.latitude_deg = 51.5;
+        trajectory.longitude_deg = -0.1;
+    }
+
+    struct vn310_sim_config_t sim_config(double corrupt, double fragment, uint32_t burst) {
+        struct vn310_sim_config_t config = {};
+        config.speed = 0.0;
+        config.baud_rate = 921600;
+        config.corrupt_probability = corrupt;
+        config.fragment_probability = fragment;
+        config.frames_per_run = burst;
+        config.seed = 1234;
+        return config;
+    }
+
+    uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    struct cli_state_t cli_state;
+    struct vn310_applet_state_t applet;
+    struct vn310_sim_state_t sim;
+    struct vn310_sim_trajectory_t trajectory;
+};
+
+TEST_F(vn310_pipeline, BinaryStreamPublishesEveryFrame) {
+    struct vn310_sim_config_t config = sim_config(0.0, 0.0, 1);
+    ASSERT_EQ(vn310_sim_init(&sim, &config, &applet), OK);
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    EXPECT_EQ(sim.stats.frames, 1000u);
+    EXPECT_EQ(sim.stats.poses_published, sim.stats.frames);
+    EXPECT_EQ(applet.driver_state.mailbox->overrun_count, 0u);
+    EXPECT_NE(applet.pose_data.rate[2], 0.0f);
+    EXPECT_EQ(applet.pose_data.time_gps, VN310_SIM_GPS_START_NS + 4995000000ULL);
+
+    // Five PPS rollovers, every sample still reached the predictor in order
+    EXPECT_EQ(applet.pose_data.time_gps_pps, 245000000ULL);
+    EXPECT_EQ(applet.predictor.rejected_count, 0u);
+}
+
+TEST_F(vn310_pipeline, AsciiStreamPublishesEveryFrame) {
+    struct vn310_sim_config_t config = sim_config(0.0, 0.0, 1);
+    trajectory.format = SIM_FORMAT_ASCII;
+    ASSERT_EQ(vn310_sim_init(&sim, &config, &applet), OK);
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    EXPECT_EQ(sim.stats.poses_published, sim.stats.frames);
+    EXPECT_NEAR(applet.pose_data.latitude, 51.5, 0.01);
+}
+
+TEST_F(vn310_pipeline, CorruptAndFragmentedBinaryFramesAreRejected) {
+    struct vn310_sim_config_t config = sim_config(0.1, 0.1, 1);
+    ASSERT_EQ(vn310_sim_init(&sim, &config, &applet), OK);
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    EXPECT_GT(sim.stats.corrupted, 0u);
+    EXPECT_GT(sim.stats.fragmented, 0u);
+    EXPECT_LT(sim.stats.poses_published, sim.stats.frames);
+    EXPECT_GE(sim.stats.poses_published, sim.stats.frames - sim.stats.corrupted - sim.stats.fragmented);
+}
+
+TEST_F(vn310_pipeline, BurstBeyondMailboxDepthOverruns) {
+    struct vn310_sim_config_t config = sim_config(0.0, 0.0, VN310_MAILBOX_DEPTH + 2);
+    ASSERT_EQ(vn310_sim_init(&sim, &config, &applet), OK);
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    EXPECT_GT(applet.driver_state.mailbox->overrun_count, 0u);
+    EXPECT_EQ(sim.stats.poses_published + applet.driver_state.mailbox->overrun_count, sim.stats.frames);
+}
+
+TEST_F(vn310_pipeline, OversizedDmaMessageIsRejected) {
+    // A message filling the whole DMA buffer leaves no room for its terminator
+    memset(rx_buf, 'A', sizeof(rx_buf));
+    memcpy(rx_buf, "$VNINS,", 7);
+
+    EXPECT_EQ(vn310_driver_eventcallback(&applet.driver_state, UART_DMA_READ_BUF_SIZE), ERROR);
+    EXPECT_EQ(vn310_driver_eventcallback(&applet.driver_state, 0), ERROR);
+    EXPECT_EQ(vn310_mailbox_count(applet.driver_state.mailbox), 0u);
+    EXPECT_EQ(applet.driver_state.mailbox->overrun_count, 0u);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+/**
+ * @file vn310_pose_test.cpp
+ * @brief Host tests for VN310 pose wrapping and the pose publishing policy.
+ *
+ * This file contains Google Test-based tests for the fmod-free angle wrapping and
+ * for the rate limit, dead-band and keyframe rules that decide which samples are
+ * routed to the tiles. Routed messages are counted through the message routing hook.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+
+extern "C"
+{
+    #include "vn310_applet.h"
+    #include "message_routing.h"
+}
+
+const uint64_t NS_PER_MS = 1000000ULL;
+const uint64_t START_TIME_MS = 1000;  // A zero time stamp means "no time stamp"
+
+static void _count_routed(void *context, const uint8_t *message, int board_type, int tile_index)
+{
+    (void)message;
+    (void)board_type;
+    (void)tile_index;
+    (*static_cast<int *>(context))++;
+}
+
+class vn310_pose : public ::testing::Test {
+protected:
+    void SetUp() override {
+        memset(&applet, 0, sizeof(applet));
+        applet.driver_state.send_pose = true;
+        routed = 0;
+        message_routing_set_hook(_count_routed, &routed);
+    }
+
+    void TearDown() override {
+        message_routing_set_hook(NULL, NULL);
+    }
+
+    void set_policy(uint64_t min_interval_ms, uint64_t keyframe_ms, float deadband_deg, float deadband_position_deg) {
+        struct vn310_pose_publish_config_t config = {};
+        config.min_interval_ns = min_interval_ms * NS_PER_MS;
+        config.keyframe_interval_ns = keyframe_ms * NS_PER_MS;
+        config.deadband_deg[0] = deadband_deg;
+        config.deadband_deg[1] = deadband_deg;
+        config.deadband_deg[2] = deadband_deg;
+        config.deadband_position_deg = deadband_position_deg;
+        vn310_pose_publisher_init(&applet.publisher, &config);
+    }
+
+    void send(uint64_t time_ms, float yaw, bool forced = false) {
+        struct vn310_pose_t pose = {};
+        pose.yaw = yaw;
+        pose.latitude = 51.5f;
+        pose.longitude = -0.1f;
+        pose.time_gps = (START_TIME_MS + time_ms) * NS_PER_MS;
+        vn310_pose_send_updated(&applet, &pose, forced);
+    }
+
+    struct vn310_applet_state_t applet;
+    int routed;
+};
+
+TEST(vn310_pose_wrap, WrapsTo0To360) {
+    const float inputs[] = { 0.0f, 359.5f, 360.0f, 725.0f, -0.5f, -360.0f, -721.0f, 180.0f, -1.0e-7f };
+
+    for (float input : inputs) {
+        float expected = std::fmod(input, 360.0f);
+        if (expected < 0.0f) {
+            expected += 360.0f;
+        }
+        if (expected >= 360.0f) {
+            expected = 0.0f;
+        }
+
+        float wrapped = vn310_pose_wrap_0_to_360_degrees(input);
+        EXPECT_GE(wrapped, 0.0f) << input;
+        EXPECT_LT(wrapped, 360.0f) << input;
+        EXPECT_NEAR(wrapped, expected, 1e-3f) << input;
+    }
+}
+
+TEST(vn310_pose_wrap, WrapsDifferencesTo180) {
+    EXPECT_NEAR(vn310_pose_wrap_180_degrees(359.0f - 1.0f), -2.0f, 1e-4f);
+    EXPECT_NEAR(vn310_pose_wrap_180_degrees(1.0f - 359.0f), 2.0f, 1e-4f);
+    EXPECT_NEAR(vn310_pose_wrap_180_degrees(90.0f), 90.0f, 1e-4f);
+    EXPECT_NEAR(vn310_pose_wrap_180_degrees(180.0f), -180.0f, 1e-4f);
+}
+
+TEST_F(vn310_pose, ZeroPolicyPublishesEverySample) {
+    set_policy(0, 0, 0.0f, 0.0f);
+
+    for (int i = 0; i < 100; ++i) {
+        send(i * 5, 10.0f);
+    }
+
+    EXPECT_EQ(routed, 100);
+    EXPECT_EQ(applet.publisher.sent_count, 100u);
+}
+
+TEST_F(vn310_pose, RateLimit) {
+    set_policy(20, 0, 0.0f, 0.0f);
+
+    // 200 Hz for one second, yaw moving every sample
+    for (int i = 0; i < 200; ++i) {
+        send(i * 5, i * 0.05f);
+    }
+
+    EXPECT_EQ(routed, 50);
+    EXPECT_EQ(applet.publisher.suppressed_rate_count, 150u);
+}
+
+TEST_F(vn310_pose, DeadBandAcrossWrap) {
+    set_policy(0, 0, 0.5f, 0.001f);
+
+    send(0, 359.9f);
+    send(5, 0.2f);      // 0.3 degrees across the wrap, held back
+    send(10, 0.45f);    // 0.55 degrees from the last published pose
+    send(15, 0.5f);
+
+    EXPECT_EQ(routed, 2);
+    EXPECT_EQ(applet.publisher.suppressed_deadband_count, 2u);
+}
+
+TEST_F(vn310_pose, KeyframeWhenStationary) {
+    set_policy(0, 100, 0.5f, 0.001f);
+
+    for (int i = 0; i <= 100; ++i) {
+        send(i * 5, 10.0f);
+    }
+
+    // First sample plus a keyframe every 100 ms over 500 ms
+    EXPECT_EQ(routed, 6);
+    EXPECT_EQ(applet.publisher.keyframe_count, 5u);
+}
+
+TEST_F(vn310_pose, ForcedAndDisabled) {
+    set_policy(1000, 0, 10.0f, 1.0f);
+
+    send(0, 10.0f);
+    send(1, 10.0f, true);
+    EXPECT_EQ(routed, 2);
+    EXPECT_EQ(applet.publisher.forced_count, 1u);
+
+    applet.driver_state.send_pose = false;
+    send(2000, 90.0f);
+    EXPECT_EQ(routed, 2);
+    EXPECT_EQ(applet.publisher.suppressed_rate_count + applet.publisher.suppressed_deadband_count, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,319 @@
+/**
+ * @file vn310_predictor_test.cpp
+ * @brief Host tests for the VN310 attitude predictor.
+ *
+ * This file contains Google Test-based tests that replay a VN310 attitude stream
+ * through the predictor. Each sample is propagated forward by a range of latencies
+ * and compared against the sample that was actually recorded at that time, giving
+ * the pointing error as a function of latency for each prediction mode.
+ *
+ * A recorded stream is read from CSV when available, otherwise a synthetic
+ * manoeuvring trajectory is generated.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+extern "C"
+{
+    #include "vn310_predictor.h"
+}
+
+#define ENABLE_DEBUG_PRINT false  // Set this to true for detailed debug outputs during tests
+const std::string base_directory = "vectornav_gps_imu_development/test/";
+const std::string recorded_stream_file = "vn310_recorded_stream.csv";
+
+const uint64_t SAMPLE_PERIOD_NS = 5000000ULL;   // 200 Hz stream
+const int LATENCY_STEPS[] = {1, 2, 4, 8};       // 5, 10, 20, 40 ms
+
+struct Quaternion
+{
+    double w, x, y, z;
+};
+
+static Quaternion _ypr_to_quaternion(double yaw, double pitch, double roll)
+{
+    const double d2r = M_PI / 180.0;
+    double cy = cos(yaw * d2r * 0.5), sy = sin(yaw * d2r * 0.5);
+    double cp = cos(pitch * d2r * 0.5), sp = sin(pitch * d2r * 0.5);
+    double cr = cos(roll * d2r * 0.5), sr = sin(roll * d2r * 0.5);
+
+    return Quaternion{cr * cp * cy + sr * sp * sy,
+                      sr * cp * cy - cr * sp * sy,
+                      cr * sp * cy + sr * cp * sy,
+                      cr * cp * sy - sr * sp * cy};
+}
+
+/**
+ * @brief Angle of the rotation between two attitudes, in degrees.
+ */
+static double _pointing_error_deg(const vn310_pose_t &a, const vn310_pose_t &b)
+{
+    Quaternion qa = _ypr_to_quaternion(a.yaw, a.pitch, a.roll);
+    Quaternion qb = _ypr_to_quaternion(b.yaw, b.pitch, b.roll);
+    double dot = std::fabs(qa.w * qb.w + qa.x * qb.x + qa.y * qb.y + qa.z * qb.z);
+
+    return 2.0 * std::acos(std::min(dot, 1.0)) * 180.0 / M_PI;
+}
+
+/**
+ * @brief Reads a recorded VN310 stream from a CSV file.
+ *
+ * Expected columns: time_gps_ns, yaw, pitch, roll, rate_x, rate_y, rate_z
+ * with angles in degrees and rates in degrees per second.
+ */
+static std::vector<vn310_pose_t> _stream_read_in_csv(const std::string &filename)
+{
+    std::vector<vn310_pose_t> stream;
+    std::ifstream file(base_directory + filename);
+    std::string line;
+
+    if (!file.is_open())
+    {
+        return {};
+    }
+
+    std::getline(file, line); // Skip the header
+
+    while (std::getline(file, line))
+    {
+        std::stringstream ss(line);
+        std::string cell;
+        vn310_pose_t pose = {};
+
+        std::getline(ss, cell, ','); pose.time_gps = std::stoull(cell);
+        std::getline(ss, cell, ','); pose.yaw = std::stof(cell);
+        std::getline(ss, cell, ','); pose.pitch = std::stof(cell);
+        std::getline(ss, cell, ','); pose.roll = std::stof(cell);
+        std::getline(ss, cell, ','); pose.rate[0] = std::stof(cell);
+        std::getline(ss, cell, ','); pose.rate[1] = std::stof(cell);
+        std::getline(ss, cell, ','); pose.rate[2] = std::stof(cell);
+        stream.push_back(pose);
+    }
+
+    if (ENABLE_DEBUG_PRINT) std::cout << "Samples read: " << stream.size() << std::endl;
+    return stream;
+}
+
+/**
+ * @brief Generates a manoeuvring platform trajectory sampled at 200 Hz.
+ *
+ * The body rates are sinusoidal so that a constant-rate prediction is not exact.
+ * The attitude is integrated at 1 kHz and every fifth step is recorded.
+ */
+static std::vector<vn310_pose_t> _stream_generate_synthetic(int sample_count)
+{
+    const double d2r = M_PI / 180.0;
+    const int substeps = 5;
+    const double dt = (SAMPLE_PERIOD_NS / substeps) * 1.0e-9;
+    std::vector<vn310_pose_t> stream;
+    Quaternion q = _ypr_to_quaternion(30.0, 5.0, -3.0);
+
+    for (int i = 0; i < sample_count * substeps; ++i)
+    {
+        double t = i * dt;
+        double rate[3] = {20.0 * sin(2.0 * M_PI * 0.5 * t),
+                          10.0 * sin(2.0 * M_PI * 0.3 * t + 1.0),
+                          30.0 + 15.0 * sin(2.0 * M_PI * 0.2 * t)};
+
+        if (i % substeps == 0)
+        {
+            vn310_pose_t pose = {};
+            pose.time_gps = (uint64_t)(i / substeps) * SAMPLE_PERIOD_NS;
+            pose.roll = atan2(2.0 * (q.w * q.x + q.y * q.z), 1.0 - 2.0 * (q.x * q.x + q.y * q.y)) / d2r;
+            pose.pitch = asin(2.0 * (q.w * q.y - q.z * q.x)) / d2r;
+            pose.yaw = atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z)) / d2r;
+            pose.rate[0] = rate[0];
+            pose.rate[1] = rate[1];
+            pose.rate[2] = rate[2];
+            stream.push_back(pose);
+        }
+
+        double wx = rate[0] * d2r, wy = rate[1] * d2r, wz = rate[2] * d2r;
+        Quaternion dq = {1.0, 0.5 * wx * dt, 0.5 * wy * dt, 0.5 * wz * dt};
+        Quaternion r = {q.w * dq.w - q.x * dq.x - q.y * dq.y - q.z * dq.z,
+                        q.w * dq.x + q.x * dq.w + q.y * dq.z - q.z * dq.y,
+                        q.w * dq.y - q.x * dq.z + q.y * dq.w + q.z * dq.x,
+                        q.w * dq.z + q.x * dq.y - q.y * dq.x + q.z * dq.w};
+        double n = sqrt(r.w * r.w + r.x * r.x + r.y * r.y + r.z * r.z);
+        q = Quaternion{r.w / n, r.x / n, r.y / n, r.z / n};
+    }
+
+    return stream;
+}
+
+static std::vector<vn310_pose_t> _stream_load()
+{
+    std::vector<vn310_pose_t> stream = _stream_read_in_csv(recorded_stream_file);
+    if (stream.empty())
+    {
+        stream = _stream_generate_synthetic(2000);
+    }
+    return stream;
+}
+
+/**
+ * @brief Replays the stream and returns the RMS pointing error for a latency.
+ */
+static double _replay_rms_error(const std::vector<vn310_pose_t> &stream, enum vn310_predictor_mode mode, int latency_steps)
+{
+    struct vn310_predictor_config_t config = {mode, VN310_PREDICTOR_MAX_EXTRAPOLATION_NS};
+    struct vn310_predictor_state_t predictor;
+    double sum_sq = 0.0;
+    int count = 0;
+
+    vn310_predictor_init(&predictor, &config);
+
+    for (size_t i = 0; i + latency_steps < stream.size(); ++i)
+    {
+        const vn310_pose_t &truth = stream[i + latency_steps];
+        vn310_pose_t predicted;
+
+        EXPECT_EQ(vn310_predictor_update(&predictor, &stream[i]), OK);
+        EXPECT_EQ(vn310_predictor_predict(&predictor, truth.time_gps, &predicted), OK);
+
+        double error = _pointing_error_deg(predicted, truth);
+        sum_sq += error * error;
+        count++;
+    }
+
+    return count ? std::sqrt(sum_sq / count) : 0.0;
+}
+
+/**
+ * @brief Report pointing error against latency for each prediction mode.
+ *
+ * Both propagating modes must beat holding the last sample at every latency.
+ */
+TEST(vn310_predictor, pointing_error_against_latency)
+{
+    std::vector<vn310_pose_t> stream = _stream_load();
+    ASSERT_GT(stream.size(), 16u);
+
+    std::cout << "latency_ms  hold_deg  const_rate_deg  quaternion_deg" << std::endl;
+
+    for (int steps : LATENCY_STEPS)
+    {
+        double hold = _replay_rms_error(stream, PREDICTOR_MODE_HOLD, steps);
+        double constant_rate = _replay_rms_error(stream, PREDICTOR_MODE_CONSTANT_RATE, steps);
+        double quaternion = _replay_rms_error(stream, PREDICTOR_MODE_QUATERNION, steps);
+
+        std::cout << std::setw(10) << steps * SAMPLE_PERIOD_NS / 1000000ULL
+                  << std::fixed << std::setprecision(5)
+                  << std::setw(10) << hold
+                  << std::setw(16) << constant_rate
+                  << std::setw(16) << quaternion << std::endl;
+
+        EXPECT_LT(constant_rate, hold);
+        EXPECT_LT(quaternion, hold);
+    }
+}
+
+TEST(vn310_predictor, no_sample_returns_error)
+{
+    struct vn310_predictor_config_t config = {PREDICTOR_MODE_QUATERNION, 0};
+    struct vn310_predictor_state_t predictor;
+    vn310_pose_t predicted;
+
+    vn310_predictor_init(&predictor, &config);
+    EXPECT_EQ(vn310_predictor_predict(&predictor, 0, &predicted), ERROR);
+    EXPECT_EQ(predictor.config.max_extrapolation_ns, VN310_PREDICTOR_MAX_EXTRAPOLATION_NS);
+}
+
+TEST(vn310_predictor, constant_yaw_rate_is_exact)
+{
+    struct vn310_predictor_config_t config = {PREDICTOR_MODE_QUATERNION, 0};
+    struct vn310_predictor_state_t predictor;
+    vn310_pose_t pose = {};
+    vn310_pose_t predicted;
+
+    pose.yaw = 10.0f;
+    pose.rate[2] = 100.0f;
+    pose.time_gps = 1000000000ULL;
+
+    vn310_predictor_init(&predictor, &config);
+    vn310_predictor_update(&predictor, &pose);
+    EXPECT_EQ(vn310_predictor_predict(&predictor, pose.time_gps + 20000000ULL, &predicted), OK);
+
+    EXPECT_NEAR(predicted.yaw, 12.0f, 1e-4);
+    EXPECT_NEAR(predicted.pitch, 0.0f, 1e-4);
+    EXPECT_NEAR(predicted.roll, 0.0f, 1e-4);
+}
+
+TEST(vn310_predictor, extrapolation_is_clamped)
+{
+    struct vn310_predictor_config_t config = {PREDICTOR_MODE_CONSTANT_RATE, 10000000ULL};
+    struct vn310_predictor_state_t predictor;
+    vn310_pose_t pose = {};
+    vn310_pose_t predicted;
+
+    pose.rate[2] = 100.0f;
+
+    vn310_predictor_init(&predictor, &config);
+    vn310_predictor_update(&predictor, &pose);
+    vn310_predictor_predict(&predictor, 1000000000ULL, &predicted);
+
+    EXPECT_NEAR(predicted.yaw, 1.0f, 1e-4);
+    EXPECT_EQ(predictor.clamped_count, 1u);
+}
+
+TEST(vn310_predictor, stale_sample_is_rejected)
+{
+    struct vn310_predictor_config_t config = {PREDICTOR_MODE_HOLD, 0};
+    struct vn310_predictor_state_t predictor;
+    vn310_pose_t pose = {};
+
+    vn310_predictor_init(&predictor, &config);
+    pose.time_gps = 200;
+    EXPECT_EQ(vn310_predictor_update(&predictor, &pose), OK);
+    pose.time_gps = 100;
+    EXPECT_EQ(vn310_predictor_update(&predictor, &pose), ERROR);
+    EXPECT_EQ(predictor.rejected_count, 1u);
+}
+
+TEST(vn310_predictor, pps_rollover_keeps_samples_and_interval)
+{
+    struct vn310_predictor_config_t config = {PREDICTOR_MODE_QUATERNION, 0};
+    struct vn310_predictor_state_t predictor;
+    vn310_pose_t pose = {};
+    vn310_pose_t predicted;
+
+    vn310_predictor_init(&predictor, &config);
+    pose.rate[2] = 100.0f;
+
+    // 5 ms samples across a PPS pulse, the PPS relative time restarts at 0
+    for (uint64_t time_ns = 1980000000ULL; time_ns <= 2020000000ULL; time_ns += 5000000ULL)
+    {
+        pose.time_gps = time_ns;
+        pose.time_gps_pps = time_ns % 1000000000ULL;
+        EXPECT_EQ(vn310_predictor_update(&predictor, &pose), OK);
+    }
+    EXPECT_EQ(predictor.rejected_count, 0u);
+
+    // Predicting from just before the pulse to just after it spans 10 ms
+    pose.time_gps = 1995000000ULL;
+    pose.time_gps_pps = 995000000ULL;
+    pose.yaw = 0.0f;
+    vn310_predictor_init(&predictor, &config);
+    vn310_predictor_update(&predictor, &pose);
+    EXPECT_EQ(vn310_predictor_predict(&predictor, 2005000000ULL, &predicted), OK);
+
+    EXPECT_NEAR(predicted.yaw, 1.0f, 1e-4);
+    EXPECT_EQ(predicted.time_gps_pps, 5000000ULL);
+    EXPECT_EQ(predictor.clamped_count, 0u);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+/**
+ * @file vn310_trace_test.cpp
+ * @brief Host tests for VN310 pipeline latency tracing.
+ *
+ * This file contains Google Test-based tests for the trace ring: records built from
+ * known timestamps must produce the expected stage percentiles, frames that fail to
+ * parse or are not published must be counted, and the ring must only describe the
+ * most recent records. A final test traces a simulated stream end to end.
+ *
+ * @author Nicholas Antoniades
+ * @date 16 Oct 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C"
+{
+    #include "vn310_trace.h"
+    #include "vn310_sim.h"
+}
+
+/**
+ * @brief Add a record with the given stage durations (in timestamp units).
+ */
+static void _add_record(struct vn310_trace_t *trace, uint32_t start, uint32_t receive, uint32_t parse, int32_t publish)
+{
+    struct vn310_frame_t frame = {};
+    frame.time_dma = start;
+    frame.time_ready = start + receive;
+
+    vn310_trace_begin(trace, &frame);
+    if (parse > 0)
+    {
+        trace->current.time[TRACE_POINT_PARSED] = frame.time_ready + parse;
+        trace->current.points |= 1u << TRACE_POINT_PARSED;
+    }
+    if (publish >= 0)
+    {
+        trace->current.time[TRACE_POINT_PUBLISHED] = frame.time_ready + parse + (uint32_t)publish;
+        trace->current.points |= 1u << TRACE_POINT_PUBLISHED;
+    }
+    vn310_trace_end(trace);
+}
+
+static uint32_t _units_to_ns(uint32_t units)
+{
+    return (uint32_t)(((uint64_t)units * 1000u) / VN310_TRACE_CYCLES_PER_US);
+}
+
+TEST(vn310_trace, DisabledRecordsNothing) {
+    struct vn310_trace_t trace;
+    struct vn310_trace_summary_t summary;
+
+    vn310_trace_init(&trace);
+    _add_record(&trace, 0, 10, 10, 10);
+
+    EXPECT_EQ(trace.traced_count, 0u);
+    EXPECT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_TOTAL, &summary), ERROR);
+    EXPECT_EQ(summary.count, 0u);
+}
+
+TEST(vn310_trace, StagePercentiles) {
+    static struct vn310_trace_t trace;
+    struct vn310_trace_summary_t summary;
+
+    vn310_trace_init(&trace);
+    trace.enabled = true;
+
+    // Parse stage takes 1000..1099 units, in shuffled order
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        _add_record(&trace, 0xFFFFFF00u + i, 50, 1000 + (i * 37) % 100, 20);
+    }
+
+    ASSERT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_PARSE, &summary), OK);
+    EXPECT_EQ(summary.count, 100u);
+    EXPECT_EQ(summary.min_ns, _units_to_ns(1000));
+    EXPECT_EQ(summary.p50_ns, _units_to_ns(1049));
+    EXPECT_EQ(summary.p99_ns, _units_to_ns(1098));
+    EXPECT_EQ(summary.max_ns, _units_to_ns(1099));
+
+    // Timestamps wrap mid-record without affecting the durations
+    ASSERT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_RECEIVE, &summary), OK);
+    EXPECT_EQ(summary.min_ns, _units_to_ns(50));
+    EXPECT_EQ(summary.max_ns, _units_to_ns(50));
+
+    ASSERT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_TOTAL, &summary), OK);
+    EXPECT_EQ(summary.min_ns, _units_to_ns(1070));
+    EXPECT_EQ(summary.max_ns, _units_to_ns(1169));
+}
+
+TEST(vn310_trace, CountsDropsAndKeepsRecentRecords) {
+    static struct vn310_trace_t trace;
+    struct vn310_trace_summary_t summary;
+
+    vn310_trace_init(&trace);
+    trace.enabled = true;
+
+    _add_record(&trace, 0, 10, 0, -1);      // Parse failed
+    _add_record(&trace, 0, 10, 10, -1);     // Held back by the publishing policy
+    EXPECT_EQ(trace.parse_failed_count, 1u);
+    EXPECT_EQ(trace.unpublished_count, 1u);
+
+    for (int i = 0; i < VN310_TRACE_DEPTH; ++i)
+    {
+        _add_record(&trace, 0, 10, 10, 500);
+    }
+
+    ASSERT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_PUBLISH, &summary), OK);
+    EXPECT_EQ(summary.count, (uint32_t)VN310_TRACE_DEPTH);
+    EXPECT_EQ(trace.traced_count, (uint32_t)VN310_TRACE_DEPTH + 2);
+
+    vn310_trace_clear(&trace);
+    EXPECT_TRUE(trace.enabled);
+    EXPECT_EQ(vn310_trace_summarize(&trace, TRACE_STAGE_PUBLISH, &summary), ERROR);
+}
+
+TEST(vn310_trace, TracesSimulatedStream) {
+    static uint8_t rx_buf[UART_DMA_READ_BUF_SIZE];
+    static struct cli_state_t cli_state;
+    static struct vn310_applet_state_t applet;
+    static struct vn310_sim_state_t sim;
+
+    cli_state.quiet = true;
+    struct vn310_applet_config_t config = {};
+    config.cli_state = &cli_state;
+    config.driver_config.vectornav_uart_config.rx_buf = rx_buf;
+    config.driver_config.vectornav_uart_config.rx_buf_size = sizeof(rx_buf);
+    ASSERT_EQ(vn310_applet_init(&applet, &config), OK);
+    ASSERT_EQ(vn310_applet_start(&applet), OK);
+    applet.driver_state.send_pose = true;
+    applet.trace.enabled = true;
+
+    struct vn310_sim_config_t sim_config = {};
+    sim_config.baud_rate = 921600;
+    sim_config.frames_per_run = 1;
+    sim_config.seed = 1;
+    ASSERT_EQ(vn310_sim_init(&sim, &sim_config, &applet), OK);
+
+    struct vn310_sim_trajectory_t trajectory = {};
+    trajectory.format = SIM_FORMAT_BINARY;
+    trajectory.output_rate_hz = 200.0;
+    trajectory.duration_s = 2.0;
+    trajectory.yaw_rate_dps = 10.0;
+    trajectory.motion_period_s = 4.0;
+    trajectory.latitude_deg = 51.5;
+    ASSERT_EQ(vn310_sim_run_trajectory(&sim, &trajectory), OK);
+
+    struct vn310_trace_summary_t summary;
+    ASSERT_EQ(vn310_trace_summarize(&applet.trace, TRACE_STAGE_TOTAL, &summary), OK);
+    EXPECT_EQ(summary.count, (uint32_t)VN310_TRACE_DEPTH);
+    EXPECT_LE(summary.min_ns, summary.p50_ns);
+    EXPECT_LE(summary.p50_ns, summary.p99_ns);
+    EXPECT_LE(summary.p99_ns, summary.max_ns);
+    EXPECT_EQ(applet.trace.traced_count, sim.stats.frames);
+    EXPECT_EQ(applet.trace.parse_failed_count, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}